@@ -0,0 +1,172 @@
+/*
+ * bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: cycle counting benchmark of the driver entry points
+ *
+ *      Timer1 counts the CPU clock (no prescaler) and its overflow interrupt
+ *      extends it to 32 bits, so the numbers are valid on the board and on any
+ *      cycle accurate simulator. The stack high-water is found by painting the
+ *      free RAM before every case and looking for the lowest changed byte after.
+ */
+
+#include "bench.h"
+#include "uart.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <util/delay.h>
+#include <stdlib.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* first free RAM byte after the variables, defined by the linker */
+extern uint8 __heap_start;
+
+static volatile uint16 g_overflows = 0;
+static uint8 * g_stackTop;
+static uint32 g_cyclesOverhead = 0;
+static uint16 g_stackOverhead = 0;
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+
+ISR(TIMER1_OVF_vect)
+{
+	g_overflows++;
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Paint the free RAM between the variables and the stack of this function.
+ */
+static void BENCH_paint(void)
+{
+	uint8 * ptr = &__heap_start;
+	uint8 * end = (uint8 *)SP - BENCH_STACK_MARGIN;
+
+	while (ptr < end)
+	{
+		*ptr++ = BENCH_STACK_PAINT;
+	}
+}
+
+/*
+ * Description :
+ * Bytes of stack used below g_stackTop since the last painting.
+ */
+static uint16 BENCH_stackUsed(void)
+{
+	uint8 * ptr = &__heap_start;
+
+	while ((ptr < g_stackTop) && (*ptr == BENCH_STACK_PAINT))
+	{
+		ptr++;
+	}
+
+	return (uint16)(g_stackTop - ptr);
+}
+
+/*
+ * Description :
+ * Run one case and return its cycles, a_stack gets its stack high-water.
+ */
+static uint32 BENCH_measure(uint8 (*a_run)(void), uint8 * a_status, uint16 * a_stack)
+{
+	uint16 count;
+
+	BENCH_paint();
+	g_stackTop = (uint8 *)SP;
+
+	g_overflows = 0;
+	TCNT1 = 0;
+	TIFR = (1<<TOV1);
+	TCCR1B = (1<<CS10);
+
+	*a_status = a_run();
+
+	TCCR1B = 0;
+	count = TCNT1;
+	/* an overflow which came after the last interrupt */
+	if (TIFR & (1<<TOV1))
+	{
+		TIFR = (1<<TOV1);
+		g_overflows++;
+	}
+
+	*a_stack = BENCH_stackUsed();
+	return ((uint32)g_overflows << 16) + count;
+}
+
+/*
+ * Description :
+ * The empty case, it measures the measurement itself.
+ */
+static uint8 BENCH_empty(void)
+{
+	return BENCH_OK;
+}
+
+static void BENCH_sendNumber(uint32 a_value)
+{
+	char buffer[11];
+
+	ultoa(a_value, buffer, 10);
+	UART_sendByte(',');
+	UART_sendString((const uint8 *)buffer);
+}
+
+void BENCH_runAll(const char * a_ecu, const BENCH_CaseType * a_cases, uint8 a_count)
+{
+	uint8 status;
+	uint8 i;
+	uint16 stack;
+	uint32 cycles;
+
+	/* Timer1 in normal mode, only the overflow interrupt is used */
+	TCCR1A = 0;
+	TCCR1B = 0;
+	TIMSK |= (1<<TOIE1);
+	sei();
+
+	g_cyclesOverhead = BENCH_measure(BENCH_empty, &status, &g_stackOverhead);
+
+	for (i = 0; i < a_count; i++)
+	{
+		cycles = BENCH_measure(a_cases[i].run, &status, &stack);
+
+		UART_sendString((const uint8 *)"BENCH,");
+		UART_sendString((const uint8 *)a_ecu);
+		UART_sendByte(',');
+		UART_sendString((const uint8 *)a_cases[i].name);
+		BENCH_sendNumber((cycles > g_cyclesOverhead) ? (cycles - g_cyclesOverhead) : 0);
+		BENCH_sendNumber((stack > g_stackOverhead) ? (stack - g_stackOverhead) : 0);
+		BENCH_sendNumber(status);
+		UART_sendString((const uint8 *)"\r\n");
+	}
+
+	UART_sendString((const uint8 *)"BENCH,");
+	UART_sendString((const uint8 *)a_ecu);
+	UART_sendString((const uint8 *)",done\r\n");
+}
+
+void BENCH_end(void)
+{
+	/* let the UART shift out the last bytes */
+	_delay_ms(5);
+	cli();
+	set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+	sleep_enable();
+	sleep_cpu();
+	for (;;)
+	{
+	}
+}
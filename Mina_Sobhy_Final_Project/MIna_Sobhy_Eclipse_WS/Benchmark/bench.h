@@ -0,0 +1,53 @@
+/*
+ * bench.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: cycle counting benchmark of the driver entry points, the
+ *      			 results are sent on the UART as "BENCH,..." lines which the
+ *      			 run_bench.sh script collects from the simulator
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define BENCH_OK				1		/* status of a case which did its job */
+#define BENCH_STACK_PAINT		0xC5	/* value painted on the free RAM */
+#define BENCH_STACK_MARGIN		8		/* bytes kept free below the painting function */
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef struct
+{
+	const char * name;
+	uint8 (*run)(void);		/* runs the entry point once, returns BENCH_OK on success */
+} BENCH_CaseType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Measure every case and send one line for each of them:
+ * 		BENCH,<ecu>,<case>,<cycles>,<stack bytes>,<status>
+ * followed by BENCH,<ecu>,done. The UART must be initialized by the caller.
+ * The cycles and the stack of an empty case are subtracted from the results.
+ */
+void BENCH_runAll(const char * a_ecu, const BENCH_CaseType * a_cases, uint8 a_count);
+
+/*
+ * Description :
+ * Stop the CPU with the interrupts disabled, the simulator quits on it.
+ */
+void BENCH_end(void);
+
+#endif /* BENCH_H_ */
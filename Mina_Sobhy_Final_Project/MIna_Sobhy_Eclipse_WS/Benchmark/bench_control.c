@@ -0,0 +1,199 @@
+/*
+ * bench_control.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: benchmark cases of the Control_ECU drivers, built with the
+ *      			 Control_ECU sources and flags by run_bench.sh
+ */
+
+#include "bench.h"
+#include "uart.h"
+#include "twi.h"
+#include "external_eeprom.h"
+#include "eeprom_map.h"
+#include "digest.h"
+#include "policy.h"
+#include "trace.h"
+#include "log_export.h"
+#include "clock.h"
+#include "schedule.h"
+#include <util/delay.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define BENCH_TWI_ADDRESS		0x01
+#define BENCH_TWI_BITRATE		0x02
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static const uint8 g_pass[POLICY_DEFAULT_PASS_MIN] = {'1', '2', '3', '4', '5'};
+
+/* one export block: a door opening, two wrong passwords 12 s apart and the lockout */
+static const LOG_RecordType g_records[EXPORT_BLOCK_RECORDS] = {
+	{LOG_EVENT_DOOR_OPEN, 3, LOG_RESULT_SUCCESS, 0, {0x10, 0x27, 0x00, 0x00}},
+	{LOG_EVENT_DOOR_OPEN, LOG_USER_MAIN, LOG_RESULT_WRONG_PASS, 0, {0x1C, 0x27, 0x00, 0x00}},
+	{LOG_EVENT_DOOR_OPEN, LOG_USER_MAIN, LOG_RESULT_WRONG_PASS, 0, {0x28, 0x27, 0x00, 0x00}},
+	{LOG_EVENT_LOCKOUT, LOG_USER_NONE, 1, 0, {0x28, 0x27, 0x00, 0x00}},
+};
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+static uint8 BENCH_eepromReadByte(void)
+{
+	uint8 data;
+
+	return EEPROM_readByte(EEPROM_PASS_FLAG_ADDRESS, &data);
+}
+
+static uint8 BENCH_eepromReadBlock(void)
+{
+	uint8 salt[DIGEST_SALT_SIZE];
+
+	return EEPROM_readBlock(EEPROM_PASS_SALT_ADDRESS, salt, DIGEST_SALT_SIZE);
+}
+
+static uint8 BENCH_uartSendByte(void)
+{
+	UART_sendByte('H');
+	return BENCH_OK;
+}
+
+static uint8 BENCH_traceEmit(void)
+{
+	/* expands to nothing and measures no cycles when TRACE_ENABLE is off */
+	TRACE(TRACE_STATE, 0);
+	return BENCH_OK;
+}
+
+static uint8 BENCH_digest(void)
+{
+	uint8 salt[DIGEST_SALT_SIZE] = {0};
+	uint8 tag[DIGEST_TAG_SIZE];
+
+	DIGEST_calculate(salt, g_pass, sizeof(g_pass), tag);
+	return BENCH_OK;
+}
+
+/*
+ * Description :
+ * The work CONTROL_checkPass does for one password once the characters are
+ * received: read the salt and the digest, hash the password and compare.
+ */
+static uint8 BENCH_checkPass(void)
+{
+	uint8 salt[DIGEST_SALT_SIZE];
+	uint8 comp[DIGEST_TAG_SIZE];
+	uint8 test[DIGEST_TAG_SIZE];
+	uint8 status;
+
+	status = EEPROM_readBlock(EEPROM_PASS_SALT_ADDRESS, salt, DIGEST_SALT_SIZE);
+	if (EEPROM_readBlock(EEPROM_PASS_DIGEST_ADDRESS, comp, DIGEST_TAG_SIZE) == ERROR)
+	{
+		status = ERROR;
+	}
+	DIGEST_calculate(salt, g_pass, sizeof(g_pass), test);
+	DIGEST_equal(test, comp, DIGEST_TAG_SIZE);
+
+	return status;
+}
+
+/*
+ * Description :
+ * The CPU time of one data frame of the log export, the frame before is sent
+ * by the UART interrupt meanwhile.
+ */
+static uint8 BENCH_exportEncode(void)
+{
+	EXPORT_EncoderType encoder;
+	uint8 frame[EXPORT_FRAME_MAX];
+	uint8 size = 0;
+	uint8 i;
+
+	EXPORT_start(&encoder);
+	for (i = 0; i < EXPORT_BLOCK_RECORDS; i++)
+	{
+		size += EXPORT_encode(&encoder, &g_records[i], &frame[size]);
+	}
+	size += EXPORT_finish(&encoder, &frame[size]);
+
+	return (size != 0) ? BENCH_OK : ERROR;
+}
+
+/*
+ * Description :
+ * One tear-free read of the real-time clock, as done for every audit log record.
+ */
+static uint8 BENCH_clockNow(void)
+{
+	CLOCK_TimeType now;
+
+	CLOCK_now(&now);
+	return BENCH_OK;
+}
+
+/*
+ * Description :
+ * The schedule check after a password match, group 0 has a schedule so the
+ * bit of the slot is read from the EEPROM.
+ */
+static uint8 BENCH_scheduleCheck(void)
+{
+	SCHEDULE_isAllowed(SCHEDULE_GROUP_MAIN);
+	return BENCH_OK;
+}
+
+/*
+ * Description :
+ * Store a known salt and password digest so the reads have real data, and
+ * give group 0 a schedule with the wall clock set.
+ */
+static void BENCH_prepare(void)
+{
+	uint8 salt[DIGEST_SALT_SIZE] = {0};
+	uint8 digest[DIGEST_TAG_SIZE];
+
+	DIGEST_calculate(salt, g_pass, sizeof(g_pass), digest);
+	EEPROM_writeBlock(EEPROM_PASS_SALT_ADDRESS, salt, DIGEST_SALT_SIZE);
+	_delay_ms(10);
+	EEPROM_writeBlock(EEPROM_PASS_DIGEST_ADDRESS, digest, DIGEST_TAG_SIZE);
+	_delay_ms(10);
+	EEPROM_writeByte(EEPROM_PASS_FLAG_ADDRESS, EEPROM_PASS_MAGIC);
+	_delay_ms(10);
+	EEPROM_writeByte(EEPROM_SCHEDULE_ADDRESS + SCHEDULE_GROUP_MAIN, SCHEDULE_RESTRICTED);
+	_delay_ms(10);
+	CLOCK_setWall(0);
+}
+
+int main(void)
+{
+	static const BENCH_CaseType cases[] = {
+		{"EEPROM_readByte", BENCH_eepromReadByte},
+		{"EEPROM_readBlock_16", BENCH_eepromReadBlock},
+		{"UART_sendByte", BENCH_uartSendByte},
+		{"TRACE_emit", BENCH_traceEmit},
+		{"DIGEST_calculate_5", BENCH_digest},
+		{"CONTROL_checkPass", BENCH_checkPass},
+		{"EXPORT_encode_4", BENCH_exportEncode},
+		{"CLOCK_now", BENCH_clockNow},
+		{"SCHEDULE_isAllowed", BENCH_scheduleCheck},
+	};
+	UART_ConfigType uartType = {EIGHT_BIT, DISABLED, ONE_BIT, 9600};
+	TWI_ConfigType twiType = {BENCH_TWI_BITRATE, BENCH_TWI_ADDRESS};
+
+	UART_init(&uartType);
+	TWI_init(&twiType);
+	BENCH_prepare();
+	SCHEDULE_init();
+
+	BENCH_runAll("control", cases, sizeof(cases) / sizeof(cases[0]));
+	BENCH_end();
+
+	return 0;
+}
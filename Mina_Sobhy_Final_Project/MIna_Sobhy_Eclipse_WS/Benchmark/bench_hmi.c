@@ -0,0 +1,87 @@
+/*
+ * bench_hmi.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: benchmark cases of the HMI_ECU drivers, built with the
+ *      			 HMI_ECU sources and flags by run_bench.sh
+ */
+
+#include "bench.h"
+#include "uart.h"
+#include "lcd.h"
+#include "keypad.h"
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+static uint8 BENCH_lcdDisplayString(void)
+{
+	LCD_displayString("Plz enter pass:");
+	return BENCH_OK;
+}
+
+static uint8 BENCH_lcdDisplayStringP(void)
+{
+	LCD_displayString_P(PSTR("Plz enter pass:"));
+	return BENCH_OK;
+}
+
+static uint8 BENCH_lcdDisplayMessage(void)
+{
+	LCD_displayMessage(MSG_ENTER_PASS);
+	return BENCH_OK;
+}
+
+static uint8 BENCH_lcdClearScreen(void)
+{
+	LCD_clearScreen();
+	return BENCH_OK;
+}
+
+static uint8 BENCH_lcdMoveCursor(void)
+{
+	LCD_moveCursor(1,0);
+	return BENCH_OK;
+}
+
+/*
+ * Description :
+ * The keypad columns are not connected in the simulator so every key reads as
+ * pressed and the driver returns the first one ('7'), the figure is the
+ * shortest scan which detects a key.
+ */
+static uint8 BENCH_keypadGetPressedKey(void)
+{
+	return (KEYPAD_getPressedKey() == '7') ? BENCH_OK : 0;
+}
+
+static uint8 BENCH_uartSendByte(void)
+{
+	UART_sendByte('H');
+	return BENCH_OK;
+}
+
+int main(void)
+{
+	static const BENCH_CaseType cases[] = {
+		{"LCD_displayString_15", BENCH_lcdDisplayString},
+		{"LCD_displayString_P_15", BENCH_lcdDisplayStringP},
+		{"LCD_displayMessage_15", BENCH_lcdDisplayMessage},
+		{"LCD_clearScreen", BENCH_lcdClearScreen},
+		{"LCD_moveCursor", BENCH_lcdMoveCursor},
+		{"KEYPAD_getPressedKey", BENCH_keypadGetPressedKey},
+		{"UART_sendByte", BENCH_uartSendByte},
+	};
+	UART_ConfigType uartType = {EIGHT_BIT, DISABLED, ONE_BIT, 9600};
+
+	UART_init(&uartType);
+	LCD_init();
+
+	BENCH_runAll("hmi", cases, sizeof(cases) / sizeof(cases[0]));
+	BENCH_end();
+
+	return 0;
+}
@@ -0,0 +1,111 @@
+/*
+ * bench_simavr.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: simavr board for the benchmark firmware, an ATmega32 with a
+ *      			 24C16 on the TWI bus. The UART output is printed on stdout
+ *      			 and the simulation ends when the firmware sleeps with the
+ *      			 interrupts disabled (BENCH_end).
+ *
+ *      usage: bench_simavr <elf> <frequency> [max_cycles]
+ *      build: see run_bench.sh, it needs libsimavr and examples/parts/i2c_eeprom.c
+ *      			 of the simavr sources
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim_avr.h"
+#include "sim_elf.h"
+#include "avr_uart.h"
+#include "avr_twi.h"
+#include "i2c_eeprom.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define BENCH_EEPROM_ADDRESS	0xA0
+/* the 24C16 takes the block number in the device address, the simavr part
+ * ignores these bits (and R/W) so the 8 blocks share 256 bytes. The bus
+ * transactions and so the cycles are the same.
+ */
+#define BENCH_EEPROM_MASK		0x0F
+#define BENCH_EEPROM_SIZE		256
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+static void BENCH_uartOutput(struct avr_irq_t * a_irq, uint32_t a_value, void * a_param)
+{
+	(void)a_irq;
+	(void)a_param;
+	putchar((int)a_value);
+	if (a_value == '\n')
+	{
+		fflush(stdout);
+	}
+}
+
+int main(int argc, char * argv[])
+{
+	elf_firmware_t firmware;
+	i2c_eeprom_t eeprom;
+	avr_t * avr;
+	uint32_t flags = 0;
+	unsigned long long limit = 0;
+	int state;
+
+	if (argc < 3)
+	{
+		fprintf(stderr, "usage: %s <elf> <frequency> [max_cycles]\n", argv[0]);
+		return 2;
+	}
+	if (argc > 3)
+	{
+		limit = strtoull(argv[3], NULL, 10);
+	}
+
+	memset(&firmware, 0, sizeof(firmware));
+	if (elf_read_firmware(argv[1], &firmware) != 0)
+	{
+		fprintf(stderr, "%s: can't load %s\n", argv[0], argv[1]);
+		return 2;
+	}
+	strcpy(firmware.mmcu, "atmega32");
+	firmware.frequency = strtoul(argv[2], NULL, 10);
+
+	avr = avr_make_mcu_by_name(firmware.mmcu);
+	if (avr == NULL)
+	{
+		fprintf(stderr, "%s: simavr has no %s core\n", argv[0], firmware.mmcu);
+		return 2;
+	}
+	avr_init(avr);
+	avr_load_firmware(avr, &firmware);
+
+	i2c_eeprom_init(avr, &eeprom, BENCH_EEPROM_ADDRESS, BENCH_EEPROM_MASK, NULL, BENCH_EEPROM_SIZE);
+	i2c_eeprom_attach(avr, &eeprom, AVR_IOCTL_TWI_GETIRQ(0));
+
+	/* print the UART bytes as they are, without the simavr line formatting */
+	avr_ioctl(avr, AVR_IOCTL_UART_GET_FLAGS('0'), &flags);
+	flags &= ~AVR_UART_FLAG_STDIO;
+	avr_ioctl(avr, AVR_IOCTL_UART_SET_FLAGS('0'), &flags);
+	avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUTPUT),
+							BENCH_uartOutput, NULL);
+
+	do
+	{
+		state = avr_run(avr);
+		if ((limit != 0) && (avr->cycle > limit))
+		{
+			fprintf(stderr, "%s: %s is still running after %llu cycles\n", argv[0], argv[1], limit);
+			return 1;
+		}
+	} while ((state != cpu_Done) && (state != cpu_Crashed));
+
+	fflush(stdout);
+	return (state == cpu_Crashed) ? 1 : 0;
+}
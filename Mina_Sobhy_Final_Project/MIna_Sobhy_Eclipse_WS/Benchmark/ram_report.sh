@@ -0,0 +1,105 @@
+#!/bin/sh
+#
+# ram_report.sh
+#
+#  Created on: Oct 19, 2026
+#      Author: Mina sobhy
+#      description: static RAM of every module from the linker map file of an
+#      			 ECU, then check the static RAM plus the measured stack
+#      			 against the RAM budget
+#
+#      usage: ram_report.sh <ecu> <map file>
+#      			 ecu is control or hmi, the map file is written by the
+#      			 "-Wl,-Map" option (Debug/Control_ECU.map, Debug/HMI_ECU.map)
+#
+#      The stack is the high-water measured on the target by the painted stack
+#      (stack.c), it is read from stack.csv. The budget is the "ram.total" line
+#      of budget.csv. The script fails when .data + .bss + stack is over budget.
+#      When stack.csv has no measurement of the ECU the static RAM is checked
+#      alone with a warning, the RAM isn't really checked until it is measured.
+#
+
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+
+# RAM of the ATmega32
+DEFAULT_BUDGET=2048
+
+if [ $# -ne 2 ] || [ ! -f "$2" ]; then
+	echo "usage: ram_report.sh <ecu> <map file>" >&2
+	exit 2
+fi
+
+ecu=$1
+map=$2
+
+# "ecu,metric,value" files without the header and the comments
+lookup()
+{
+	awk -F, -v ecu="$ecu" -v metric="$2" '
+		FNR > 1 && !/^#/ && $1 == ecu && $2 == metric { value = $3 }
+		END { print value }' "$1"
+}
+
+stack=$(lookup "$HERE/stack.csv" stack.high_water)
+budget=$(lookup "$HERE/budget.csv" ram.total)
+
+tr -d '\r' < "$map" | awk -v ecu="$ecu" -v stack="$stack" -v budget="${budget:-$DEFAULT_BUDGET}" '
+	# value of a "0x..." number, without the gawk only strtonum
+	function hex(text,    i, value) {
+		text = tolower(substr(text, 3))
+		value = 0
+		for (i = 1; i <= length(text); i++) {
+			value = value * 16 + index("0123456789abcdef", substr(text, i, 1)) - 1
+		}
+		return value
+	}
+
+	# module name from an object path, the map can come from Windows or Linux
+	function module(path) {
+		sub(/.*[\/\\]/, "", path)
+		return path
+	}
+
+	# an input section in RAM: " .bss.name 0x00800064 0x1e ./diag.o", the name
+	# is alone on its line when it is too long and the rest is on the next line
+	function add(name, address, size, path,    kind) {
+		if (address !~ /^0x0*80[0-9a-fA-F][0-9a-fA-F][0-9a-fA-F][0-9a-fA-F]$/) return
+		if (name ~ /^\.bss/ || name == "COMMON") kind = "bss"
+		else if (name ~ /^\.(data|rodata)/) kind = "data"
+		else return
+		size = hex(size)
+		if (size == 0) return
+		path = module(path)
+		ram[path, kind] += size
+		total[kind] += size
+		modules[path] = 1
+	}
+
+	pending != "" && NF == 3 { add(pending, $1, $2, $3) }
+	{ pending = "" }
+	/^ (\.(data|rodata|bss)[^ ]*|COMMON)/ {
+		if (NF == 1) pending = $1
+		else if (NF == 4) add($1, $2, $3, $4)
+	}
+
+	END {
+		printf "%-32s %6s %6s\n", "module", ".data", ".bss"
+		for (path in modules) {
+			printf "%-32s %6d %6d\n", path, ram[path, "data"], ram[path, "bss"] | "sort"
+		}
+		close("sort")
+		static = total["data"] + total["bss"]
+		printf "%-32s %6d %6d\n", "total", total["data"], total["bss"]
+		if (stack == "") {
+			printf "WARN %s: no stack.high_water in stack.csv, static RAM checked alone\n", ecu
+			stack = 0
+		}
+		printf "%s: static %d + stack %d = %d bytes, budget %d\n", ecu, static, stack,
+			static + stack, budget
+		if (static + stack > budget) {
+			printf "FAIL %s: RAM over budget by %d bytes\n", ecu, static + stack - budget
+			exit 1
+		}
+	}'
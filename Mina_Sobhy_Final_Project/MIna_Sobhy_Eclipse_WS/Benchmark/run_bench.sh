@@ -0,0 +1,164 @@
+#!/bin/sh
+#
+# run_bench.sh
+#
+#  Created on: Oct 19, 2026
+#      Author: Mina sobhy
+#      description: build the benchmark firmware of both ECUs with the flags of
+#      			 the Eclipse Debug configuration, run it under simavr and
+#      			 compare the report with baseline.csv and budget.csv
+#
+#      usage: run_bench.sh [-u]
+#      			 -u writes the report as the new baseline
+#
+#      environment:
+#      			 SIMAVR_SRC       simavr source tree, for examples/parts/i2c_eeprom.c
+#      			 SIMAVR_INCLUDE   simavr headers (default /usr/include/simavr)
+#      			 BENCH_TOLERANCE  allowed increase in percent (default 2)
+#      			 BENCH_OUT        output directory (default ./out)
+#
+#      The report (out/bench_report.csv) has one "ecu,metric,value" line for
+#      every case (<case>.cycles, <case>.stack, <case>.status) and for the flash,
+#      RAM and .data size of the application ELFs. data_copy.cycles is the time
+#      __do_copy_data of avr-libc takes to copy .data at the reset, 9 cycles a
+#      byte for its lpm/st/cpi/cpc/brne loop. The script fails when a metric of the
+#      baseline is missing, a metric of the report has no baseline, a metric grew
+#      by more than the tolerance, or a case failed. A new metric is added to the
+#      baseline with -u. Until baseline.csv has a first measurement every metric
+#      is only reported as NEW, the cases must still pass.
+#      budget.csv holds absolute "ecu,metric,max" limits which are checked
+#      even when the baseline is updated, a "provisional" limit is only a
+#      warning until it is confirmed by a measurement. ram_report.sh checks the
+#      static RAM of the application maps plus the stack high-water of stack.csv
+#      against the "ram.total" budget and stops the script when it doesn't fit,
+#      it warns when the stack isn't measured yet.
+#
+
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+WS=$(cd "$HERE/.." && pwd)
+OUT=${BENCH_OUT:-$HERE/out}
+SIMAVR_INCLUDE=${SIMAVR_INCLUDE:-/usr/include/simavr}
+TOLERANCE=${BENCH_TOLERANCE:-2}
+MAX_CYCLES=200000000
+
+# same options as the Eclipse Debug configuration of the two projects
+CFLAGS="-Wall -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega32"
+
+# relative to the workspace, the shared drivers are in drivers/
+CONTROL_DRIVERS="drivers/uart.c Control_ECU/twi.c Control_ECU/external_eeprom.c drivers/gpio.c Control_ECU/digest.c drivers/trace.c Control_ECU/diag.c drivers/stack.c drivers/power.c Control_ECU/audit_log.c Control_ECU/log_export.c Control_ECU/clock.c Control_ECU/schedule.c"
+HMI_DRIVERS="drivers/uart.c HMI_ECU/lcd.c HMI_ECU/keypad.c HMI_ECU/messages.c drivers/gpio.c drivers/trace.c drivers/power.c"
+
+if [ -z "$SIMAVR_SRC" ]; then
+	echo "run_bench.sh: set SIMAVR_SRC to the simavr source tree" >&2
+	exit 2
+fi
+
+mkdir -p "$OUT"
+
+# $1 ECU directory, $2 F_CPU, $3 output ELF, the rest are the sources
+build()
+{
+	dir=$1
+	fcpu=$2
+	elf=$3
+	shift 3
+	avr-gcc $CFLAGS -DF_CPU=$fcpu -I"$WS/$dir" -I"$WS/drivers" -I"$HERE" -Wl,--gc-sections -o "$elf" "$@"
+}
+
+# flash, RAM and .data of an ELF as report lines
+sizes()
+{
+	avr-size -A "$2" | awk -v ecu="$1" '
+		$1 == ".text" { text = $2 }
+		$1 == ".data" { data = $2 }
+		$1 == ".bss"  { bss = $2 }
+		END {
+			printf "%s,flash,%d\n%s,ram,%d\n", ecu, text + data, ecu, data + bss
+			printf "%s,data,%d\n%s,data_copy.cycles,%d\n", ecu, data, ecu, 9 * data
+		}'
+}
+
+# BENCH,<ecu>,<case>,<cycles>,<stack>,<status> lines as report lines
+cases()
+{
+	tr -d '\r' < "$1" | awk -F, '
+		$1 == "BENCH" && NF == 6 {
+			printf "%s,%s.cycles,%s\n%s,%s.stack,%s\n%s,%s.status,%s\n", $2, $3, $4, $2, $3, $5, $2, $3, $6
+		}'
+}
+
+cc -O2 -I"$SIMAVR_INCLUDE" -I"$SIMAVR_SRC/examples/parts" -o "$OUT/bench_simavr" \
+	"$HERE/bench_simavr.c" "$SIMAVR_SRC/examples/parts/i2c_eeprom.c" -lsimavr -lelf
+
+# the application images for the sizes and the RAM budget
+build Control_ECU 8000000UL "$OUT/Control_ECU.elf" -Wl,-Map,"$OUT/Control_ECU.map" "$WS"/Control_ECU/*.c "$WS"/drivers/*.c
+build HMI_ECU 1000000UL "$OUT/HMI_ECU.elf" -Wl,-Map,"$OUT/HMI_ECU.map" "$WS"/HMI_ECU/*.c "$WS"/drivers/*.c
+"$HERE/ram_report.sh" control "$OUT/Control_ECU.map"
+"$HERE/ram_report.sh" hmi "$OUT/HMI_ECU.map"
+
+# the benchmark images
+build Control_ECU 8000000UL "$OUT/bench_control.elf" "$HERE/bench.c" "$HERE/bench_control.c" \
+	$(for f in $CONTROL_DRIVERS; do echo "$WS/$f"; done)
+build HMI_ECU 1000000UL "$OUT/bench_hmi.elf" "$HERE/bench.c" "$HERE/bench_hmi.c" \
+	$(for f in $HMI_DRIVERS; do echo "$WS/$f"; done)
+
+"$OUT/bench_simavr" "$OUT/bench_control.elf" 8000000 $MAX_CYCLES > "$OUT/bench_control.log"
+"$OUT/bench_simavr" "$OUT/bench_hmi.elf" 1000000 $MAX_CYCLES > "$OUT/bench_hmi.log"
+
+REPORT="$OUT/bench_report.csv"
+{
+	echo "ecu,metric,value"
+	cases "$OUT/bench_control.log"
+	sizes control "$OUT/Control_ECU.elf"
+	cases "$OUT/bench_hmi.log"
+	sizes hmi "$OUT/HMI_ECU.elf"
+} > "$REPORT"
+
+cat "$REPORT"
+
+awk -F, '
+	FNR == 1 || /^#/ || NF < 3 { next }
+	FILENAME == ARGV[1] { limit[$1 "," $2] = $3; provisional[$1 "," $2] = ($4 == "provisional"); next }
+	($1 "," $2) in limit && provisional[$1 "," $2] {
+		printf "WARN %s,%s: %s, budget %s is provisional\n", $1, $2, $3, limit[$1 "," $2]; next
+	}
+	($1 "," $2) in limit && $3 > limit[$1 "," $2] {
+		printf "FAIL %s,%s: %s, budget %s\n", $1, $2, $3, limit[$1 "," $2]; failed = 1
+	}
+	END { exit failed }' "$HERE/budget.csv" "$REPORT"
+
+if [ "$1" = "-u" ]; then
+	cp "$REPORT" "$HERE/baseline.csv"
+	echo "run_bench.sh: baseline updated"
+	exit 0
+fi
+
+awk -F, -v tolerance="$TOLERANCE" '
+	FNR == 1 || /^#/ || NF != 3 { next }
+	FILENAME == ARGV[1] { base[$1 "," $2] = $3; measured++; next }
+	{
+		key = $1 "," $2
+		seen[key] = 1
+		if ($2 ~ /\.status$/) {
+			if ($3 != 1) { printf "FAIL %s: status %s\n", key, $3; failed = 1 }
+		} else if (!(key in base) && !measured) {
+			printf "NEW  %s: %s\n", key, $3
+		} else if (!(key in base)) {
+			printf "FAIL %s: %s, no baseline\n", key, $3; failed = 1
+		} else if ($3 > base[key] * (1 + tolerance / 100)) {
+			printf "FAIL %s: %s, baseline %s\n", key, $3, base[key]; failed = 1
+		} else if ($3 != base[key]) {
+			printf "OK   %s: %s, baseline %s\n", key, $3, base[key]
+		}
+	}
+	END {
+		if (!measured) {
+			print "run_bench.sh: baseline.csv has no measurement, record it with -u"
+		}
+		for (key in base) {
+			if (!(key in seen)) { printf "FAIL %s: missing\n", key; failed = 1 }
+		}
+		exit failed
+	}' "$HERE/baseline.csv" "$REPORT"
@@ -0,0 +1,44 @@
+################################################################################
+# Automatically-generated file. Do not edit!
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+C_SRCS += \
+../../drivers/baud.c \
+../../drivers/bus.c \
+../../drivers/gpio.c \
+../../drivers/power.c \
+../../drivers/stack.c \
+../../drivers/timer1.c \
+../../drivers/trace.c \
+../../drivers/uart.c 
+
+OBJS += \
+./drivers/baud.o \
+./drivers/bus.o \
+./drivers/gpio.o \
+./drivers/power.o \
+./drivers/stack.o \
+./drivers/timer1.o \
+./drivers/trace.o \
+./drivers/uart.o 
+
+C_DEPS += \
+./drivers/baud.d \
+./drivers/bus.d \
+./drivers/gpio.d \
+./drivers/power.d \
+./drivers/stack.d \
+./drivers/timer1.d \
+./drivers/trace.d \
+./drivers/uart.d 
+
+
+# Each subdirectory must supply rules for building sources it contributes
+drivers/%.o: ../../drivers/%.c drivers/subdir.mk
+	@echo 'Building file: $<'
+	@echo 'Invoking: AVR Compiler'
+	avr-gcc -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega32 -I".." -I"../../drivers" -DF_CPU=8000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
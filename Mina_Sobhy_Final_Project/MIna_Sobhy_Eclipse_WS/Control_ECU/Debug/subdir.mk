@@ -4,44 +4,71 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../audit_log.c \
 ../buzzer.c \
+../clock.c \
+../config.c \
+../credential.c \
+../cred_store.c \
 ../control_main.c \
 ../dcmotor.c \
+../diag.c \
+../digest.c \
 ../external_eeprom.c \
-../gpio.c \
+../flash.c \
+../lockout.c \
+../log_export.c \
 ../pwm_timer0.c \
-../timer1.c \
-../twi.c \
-../uart.c 
+../provision.c \
+../schedule.c \
+../twi.c 
 
 OBJS += \
+./audit_log.o \
 ./buzzer.o \
+./clock.o \
+./config.o \
+./credential.o \
+./cred_store.o \
 ./control_main.o \
 ./dcmotor.o \
+./diag.o \
+./digest.o \
 ./external_eeprom.o \
-./gpio.o \
+./flash.o \
+./lockout.o \
+./log_export.o \
 ./pwm_timer0.o \
-./timer1.o \
-./twi.o \
-./uart.o 
+./provision.o \
+./schedule.o \
+./twi.o 
 
 C_DEPS += \
+./audit_log.d \
 ./buzzer.d \
+./clock.d \
+./config.d \
+./credential.d \
+./cred_store.d \
 ./control_main.d \
 ./dcmotor.d \
+./diag.d \
+./digest.d \
 ./external_eeprom.d \
-./gpio.d \
+./flash.d \
+./lockout.d \
+./log_export.d \
 ./pwm_timer0.d \
-./timer1.d \
-./twi.d \
-./uart.d 
+./provision.d \
+./schedule.d \
+./twi.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
 %.o: ../%.c subdir.mk
 	@echo 'Building file: $<'
 	@echo 'Invoking: AVR Compiler'
-	avr-gcc -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega32 -DF_CPU=8000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
+	avr-gcc -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega32 -I".." -I"../../drivers" -DF_CPU=8000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
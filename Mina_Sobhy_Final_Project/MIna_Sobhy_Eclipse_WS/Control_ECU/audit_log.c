@@ -0,0 +1,295 @@
+/*
+ * audit_log.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: source file of the access audit log kept in the external EEPROM
+ */
+
+#include "audit_log.h"
+#include "clock.h"
+#include <string.h>
+#include <util/delay.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* most records of one sequential EEPROM read, its size is a byte */
+#define LOG_READ_MAX			(255 / LOG_RECORD_SIZE)
+
+/* the records are copied as they are in the page image */
+typedef char LOG_recordSizeCheck[(sizeof(LOG_RecordType) == LOG_RECORD_SIZE) ? 1 : -1];
+
+/* index record, the lap of the ring when the log entered the page */
+typedef struct
+{
+	uint8	magic	; /* LOG_MAGIC, an erased EEPROM reads 0xFF */
+	uint8	page	; /* first page of the block in use, a multiple of LOG_INDEX_INTERVAL */
+	uint8	lap		; /* lap of the ring */
+	uint8	check	; /* complement of page ^ lap */
+} LOG_IndexType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* RAM image of the page in use, the unused records are erased (0xFF) */
+static uint8 g_page[EEPROM_PAGE_SIZE];
+
+static uint8 g_head = 0;		/* page in use */
+static uint8 g_lap = 0;			/* 0 until the ring is full for the first time */
+static uint8 g_used = 0;		/* records in the page image */
+static uint8 g_dirty = FALSE;	/* the page image has records not written yet */
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static uint16 LOG_pageAddress(uint8 a_page);
+static void LOG_writeIndex(void);
+static void LOG_commit(void);
+static void LOG_nextPage(void);
+static uint8 LOG_usedRecords(void);
+static uint16 LOG_slot(uint16 a_index);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+static uint16 LOG_pageAddress(uint8 a_page)
+{
+	return EEPROM_LOG_ADDRESS + ((uint16)a_page * EEPROM_PAGE_SIZE);
+}
+
+/* Description:
+ * store the page in use and the lap in the index record in one page write
+ */
+static void LOG_writeIndex(void)
+{
+	LOG_IndexType index;
+
+	index.magic = LOG_MAGIC;
+	index.page = g_head;
+	index.lap = g_lap;
+	index.check = (uint8)~(g_head ^ g_lap);
+
+	EEPROM_writeBlock(EEPROM_LOG_INDEX_ADDRESS, (const uint8 *)&index, sizeof(index));
+	_delay_ms(10);
+}
+
+/* Description:
+ * write the whole page image in one page write cycle
+ */
+static void LOG_commit(void)
+{
+	EEPROM_writeBlock(LOG_pageAddress(g_head), g_page, EEPROM_PAGE_SIZE);
+	_delay_ms(10);
+	g_dirty = FALSE;
+}
+
+/* Description:
+ * start the next page with an erased image, the lap 0xFF is skipped as it
+ * is the value of an erased record
+ */
+static void LOG_nextPage(void)
+{
+	memset(g_page, 0xFF, sizeof(g_page));
+	g_used = 0;
+
+	g_head++;
+	if (g_head == LOG_PAGES)
+	{
+		g_head = 0;
+		g_lap = (g_lap == 0xFE) ? 1 : (g_lap + 1);
+	}
+
+	if ((g_head % LOG_INDEX_INTERVAL) == 0)
+	{
+		LOG_writeIndex();
+	}
+}
+
+/* Description:
+ * return the number of records of the page image written in the lap in use,
+ * the records of an older lap are the part of the page not written yet
+ */
+static uint8 LOG_usedRecords(void)
+{
+	const LOG_RecordType * record = (const LOG_RecordType *)g_page;
+	uint8 used = 0;
+
+	while ((used < LOG_RECORDS_PER_PAGE) && (record[used].event != 0xFF)
+		&& (record[used].lap == g_lap))
+	{
+		used++;
+	}
+
+	return used;
+}
+
+void LOG_init(void)
+{
+	LOG_IndexType index;
+	uint8 probe;
+
+	memset(g_page, 0xFF, sizeof(g_page));
+	g_head = 0;
+	g_lap = 0;
+	g_used = 0;
+	g_dirty = FALSE;
+
+	if ((EEPROM_readBlock(EEPROM_LOG_INDEX_ADDRESS, (uint8 *)&index, sizeof(index)) == ERROR)
+		|| (index.magic != LOG_MAGIC) || (index.check != (uint8)~(index.page ^ index.lap))
+		|| (index.page >= LOG_PAGES) || ((index.page % LOG_INDEX_INTERVAL) != 0))
+	{
+		/* a new EEPROM, or an index of another log format, starts an empty log */
+		LOG_writeIndex();
+		return;
+	}
+
+	g_head = index.page;
+	g_lap = index.lap;
+
+	/* the full pages of the block are skipped, the first page which isn't full
+	 * is the page in use. The index is written when the next block is entered,
+	 * so the page in use is one of the LOG_INDEX_INTERVAL + 1 pages after it.
+	 */
+	for (probe = 0; probe <= LOG_INDEX_INTERVAL; probe++)
+	{
+		if (EEPROM_readBlock(LOG_pageAddress(g_head), g_page, EEPROM_PAGE_SIZE) == ERROR)
+		{
+			memset(g_page, 0xFF, sizeof(g_page));
+		}
+
+		g_used = LOG_usedRecords();
+		if (g_used < LOG_RECORDS_PER_PAGE)
+		{
+			break;
+		}
+		LOG_nextPage();
+	}
+
+	/* the rest of the page is erased in the image, it is written over anyway */
+	memset(g_page + ((uint16)g_used * LOG_RECORD_SIZE), 0xFF,
+		(uint16)(LOG_RECORDS_PER_PAGE - g_used) * LOG_RECORD_SIZE);
+}
+
+void LOG_append(LOG_EventType a_event, uint8 a_user, uint8 a_result)
+{
+	LOG_RecordType * record = (LOG_RecordType *)g_page + g_used;
+	uint32 time = CLOCK_wall();
+
+	record->event = (uint8)a_event;
+	record->user = a_user;
+	record->result = a_result;
+	record->lap = g_lap;
+	record->time[0] = (uint8)time;
+	record->time[1] = (uint8)(time >> 8);
+	record->time[2] = (uint8)(time >> 16);
+	record->time[3] = (uint8)(time >> 24);
+
+	g_used++;
+	g_dirty = TRUE;
+
+	if (g_used == LOG_RECORDS_PER_PAGE)
+	{
+		LOG_commit();
+		LOG_nextPage();
+	}
+}
+
+void LOG_flush(void)
+{
+	if (g_dirty)
+	{
+		LOG_commit();
+	}
+}
+
+uint16 LOG_count(void)
+{
+	/* once the ring is full the old records of the page in use are lost */
+	if (g_lap == 0)
+	{
+		return ((uint16)g_head * LOG_RECORDS_PER_PAGE) + g_used;
+	}
+	return ((uint16)(LOG_PAGES - 1) * LOG_RECORDS_PER_PAGE) + g_used;
+}
+
+/* Description:
+ * return the ring slot of the record a_index, the oldest record is the first
+ * one of the log, or of the page after the page in use once the ring is full
+ */
+static uint16 LOG_slot(uint16 a_index)
+{
+	if (g_lap == 0)
+	{
+		return a_index;
+	}
+	return (uint16)(((uint16)(g_head + 1) * LOG_RECORDS_PER_PAGE) + a_index) % LOG_CAPACITY;
+}
+
+uint8 LOG_read(uint16 a_index, LOG_RecordType * a_record)
+{
+	return (LOG_readBlock(a_index, a_record, 1) == 1) ? SUCCESS : ERROR;
+}
+
+uint8 LOG_readBlock(uint16 a_index, LOG_RecordType * a_records, uint8 a_count)
+{
+	uint16 count = LOG_count();
+	uint16 slot;
+	uint16 end;
+	uint8 read = 0;
+	uint8 run;
+
+	if (a_index >= count)
+	{
+		return 0;
+	}
+	if (a_count > count - a_index)
+	{
+		a_count = (uint8)(count - a_index);
+	}
+
+	while (read < a_count)
+	{
+		slot = LOG_slot(a_index + read);
+
+		if ((slot / LOG_RECORDS_PER_PAGE) == g_head)
+		{
+			memcpy(&a_records[read], g_page + ((slot % LOG_RECORDS_PER_PAGE) * LOG_RECORD_SIZE),
+				LOG_RECORD_SIZE);
+			read++;
+			continue;
+		}
+
+		/* one sequential read up to the page in use or the end of the ring */
+		end = (slot < ((uint16)g_head * LOG_RECORDS_PER_PAGE)) ?
+			((uint16)g_head * LOG_RECORDS_PER_PAGE) : LOG_CAPACITY;
+		run = a_count - read;
+		if (run > end - slot)
+		{
+			run = (uint8)(end - slot);
+		}
+		if (run > LOG_READ_MAX)
+		{
+			run = LOG_READ_MAX;
+		}
+
+		if (EEPROM_readBlock(EEPROM_LOG_ADDRESS + (slot * LOG_RECORD_SIZE), (uint8 *)&a_records[read],
+			run * LOG_RECORD_SIZE) == ERROR)
+		{
+			break;
+		}
+		read += run;
+	}
+
+	return read;
+}
+
+uint32 LOG_time(const LOG_RecordType * a_record)
+{
+	return (uint32)a_record->time[0] | ((uint32)a_record->time[1] << 8)
+		| ((uint32)a_record->time[2] << 16) | ((uint32)a_record->time[3] << 24);
+}
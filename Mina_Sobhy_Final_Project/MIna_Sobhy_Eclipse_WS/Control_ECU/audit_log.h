@@ -0,0 +1,134 @@
+/*
+ * audit_log.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: header file of the access audit log kept in the external EEPROM
+ *
+ *      The log is a ring of fixed size records (EEPROM_LOG_ADDRESS), the oldest
+ *      records are overwritten when it is full. The records are added to a RAM
+ *      image of the page in use and the page is written in one page write cycle
+ *      when it is full, so LOG_RECORDS_PER_PAGE events cost one EEPROM write.
+ *      LOG_flush writes a page which isn't full yet, the same page is written
+ *      again with the following records.
+ *
+ *      Every record keeps the lap of the ring it was written in. The index record
+ *      (EEPROM_LOG_INDEX_ADDRESS) is only written when the log enters a new block
+ *      of LOG_INDEX_INTERVAL pages, LOG_init reads it and then at most
+ *      LOG_INDEX_INTERVAL + 1 pages to find the page in use, whatever the size of
+ *      the log.
+ */
+
+#ifndef AUDIT_LOG_H_
+#define AUDIT_LOG_H_
+
+#include "std_types.h"
+#include "eeprom_map.h"
+#include "external_eeprom.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* index record marker, changed whenever the log format changes */
+#define LOG_MAGIC				0xB3
+
+/* pages between two index writes */
+#define LOG_INDEX_INTERVAL		8
+
+/* user of the events which aren't done by a password holder */
+#define LOG_USER_NONE			0xFF
+/* the system has one password, it is user 0 */
+#define LOG_USER_MAIN			0
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef enum
+{
+	LOG_EVENT_BOOT, LOG_EVENT_DOOR_OPEN, LOG_EVENT_PASS_CHANGE, LOG_EVENT_SETTINGS,
+	LOG_EVENT_LOCKOUT, LOG_EVENT_CLOCK, LOG_EVENT_PROVISION
+} LOG_EventType;
+
+typedef enum
+{
+	LOG_RESULT_SUCCESS, LOG_RESULT_WRONG_PASS, LOG_RESULT_INVALID, LOG_RESULT_SCHEDULE
+} LOG_ResultType;
+
+/* one event, an erased record reads 0xFF. The time is kept in bytes so the
+ * record is the same on the host simulation where uint32 is 64 bits.
+ */
+typedef struct
+{
+	uint8	event	; /* LOG_EventType */
+	uint8	user	; /* user ID or LOG_USER_NONE */
+	uint8	result	; /* LOG_ResultType, the lockout level for LOG_EVENT_LOCKOUT */
+	uint8	lap		; /* lap of the ring when the record was written, never 0xFF */
+	uint8	time[4]	; /* wall clock seconds (CLOCK_wall), the low byte first */
+} LOG_RecordType;
+
+#define LOG_RECORD_SIZE			8
+#define LOG_RECORDS_PER_PAGE	(EEPROM_PAGE_SIZE / LOG_RECORD_SIZE)
+#define LOG_PAGES				(EEPROM_LOG_SIZE / EEPROM_PAGE_SIZE)
+#define LOG_CAPACITY			(LOG_PAGES * LOG_RECORDS_PER_PAGE)
+
+#if ((EEPROM_LOG_ADDRESS % EEPROM_PAGE_SIZE) != 0) || ((EEPROM_LOG_SIZE % EEPROM_PAGE_SIZE) != 0)
+#error "audit_log.h: the log must be made of whole EEPROM pages"
+#endif
+
+#if (LOG_PAGES > 255) || ((LOG_PAGES % LOG_INDEX_INTERVAL) != 0)
+#error "audit_log.h: LOG_PAGES must fit in a byte and be a multiple of LOG_INDEX_INTERVAL"
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Find the page in use from the index record, an erased EEPROM starts an
+ * empty log. Must be called after the TWI initialization.
+ */
+void LOG_init(void);
+
+/*
+ * Description :
+ * Add an event, the page is written to the EEPROM when it is full.
+ */
+void LOG_append(LOG_EventType a_event, uint8 a_user, uint8 a_result);
+
+/*
+ * Description :
+ * Write the records which are only in the RAM image of the page in use.
+ */
+void LOG_flush(void);
+
+/*
+ * Description :
+ * Return the number of records in the log, the ones in the RAM included.
+ */
+uint16 LOG_count(void);
+
+/*
+ * Description :
+ * Read the record a_index, 0 is the oldest one. Return ERROR if a_index is
+ * out of range or the EEPROM read failed.
+ */
+uint8 LOG_read(uint16 a_index, LOG_RecordType * a_record);
+
+/*
+ * Description :
+ * Read a_count records from a_index in as few EEPROM reads as the ring allows,
+ * return the number read. It is less than a_count at the end of the log or if
+ * an EEPROM read failed.
+ */
+uint8 LOG_readBlock(uint16 a_index, LOG_RecordType * a_records, uint8 a_count);
+
+/*
+ * Description :
+ * Return the time of a record in seconds since the reset.
+ */
+uint32 LOG_time(const LOG_RecordType * a_record);
+
+#endif /* AUDIT_LOG_H_ */
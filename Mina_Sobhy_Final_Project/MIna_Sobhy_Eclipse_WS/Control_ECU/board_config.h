@@ -0,0 +1,76 @@
+/*
+ * board_config.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: configuration of the CONTROL_ECU board, the clock, the pins
+ *      			 of its devices and the buffer sizes of the shared drivers
+ *      			 (../drivers) which are built once for every board
+ */
+
+#ifndef BOARD_CONFIG_H_
+#define BOARD_CONFIG_H_
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* CPU clock, the build passes the same value with -DF_CPU for <util/delay.h> */
+#define BOARD_F_CPU				8000000UL
+
+#ifndef F_CPU
+#define F_CPU					BOARD_F_CPU
+#elif (F_CPU != BOARD_F_CPU)
+#error "board_config.h: F_CPU of the build isn't the CONTROL_ECU clock"
+#endif
+
+/* the UART driver counts its traffic in the performance counters of diag.c */
+#define BOARD_DIAG				1
+
+/* watch crystal on TOSC1/TOSC2 (PC6/PC7), Timer2 counts it for the real-time
+ * clock (clock.c). The HMI_ECU has none, its PORTC is the LCD data bus.
+ */
+#define BOARD_RTC_CRYSTAL_HZ	32768UL
+
+/* shared drivers buffers */
+#define UART_RX_SIZE			64
+#define TRACE_ENABLE
+#define TRACE_BUFFER_SIZE		64
+
+/* RS-485 multi-drop bus (bus.c): number of HMI_ECU keypads polled, 0 keeps the
+ * point-to-point UART link to one HMI_ECU. Every keypad takes about 70 bytes of
+ * RAM for its bus queues and its session in control_main.c.
+ */
+#ifndef BOARD_BUS_NODES
+#define BOARD_BUS_NODES			0
+#endif
+
+/* storage of the credential table (cred_store.h): BOARD_CRED_EEPROM reads it
+ * from the external EEPROM, BOARD_CRED_FLASH copies it from the EEPROM to a
+ * reserved flash region (flash.h) read with lpm. The flash storage needs the
+ * BOOTSZ fuses of a 2048 words boot section, makefile.targets links the SPM
+ * code at its start.
+ */
+#define BOARD_CRED_EEPROM		0
+#define BOARD_CRED_FLASH		1
+
+#ifndef BOARD_CRED_STORE
+#define BOARD_CRED_STORE		BOARD_CRED_EEPROM
+#endif
+
+/* driver enable of the RS-485 transceiver, DE and /RE tied together */
+#define BUS_DE_PORT				PORTD
+#define BUS_DE_DDR				DDRD
+#define BUS_DE_PIN				PD2
+
+/* DC motor direction pins (dcmotor.c), its speed is the OC0 PWM output */
+#define DCmotor_PORTA			PORTB_ID
+#define DCmotor_PORTB			PORTB_ID
+#define DCmotor_PINA			PIN1_ID
+#define DCmotor_PINB			PIN2_ID
+
+/* alarm buzzer (buzzer.c) */
+#define BUZZER_PORT				PORTA_ID
+#define BUZZER_PIN				PIN0_ID
+
+#endif /* BOARD_CONFIG_H_ */
@@ -11,14 +11,12 @@
 
 #include "std_types.h"
 #include "gpio.h"
+#include "board_config.h"
 
 /*******************************************************************************
  *                                Definitions                                  *
  *******************************************************************************/
-//Define Buzzer port
-#define BUZZER_PORT PORTA_ID
-//Define Buzzer pin
-#define BUZZER_PIN PIN0_ID
+//Define Buzzer port and pin in board_config.h
 
 /*******************************************************************************
  *                      Functions Prototypes                                   *
@@ -0,0 +1,138 @@
+/*
+ * clock.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: source file of the real-time clock of the CONTROL_ECU
+ */
+
+#include "clock.h"
+#include "diag.h"
+#include "common_macros.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* monotonic time, only changed by the Timer2 overflow interrupt */
+static volatile uint32 g_seconds = 0;
+static volatile uint8 g_ticks = 0;
+
+/* changed by the interrupt after every change of the time */
+static volatile uint8 g_sequence = 0;
+
+/* wall clock minus the monotonic seconds, only changed in the main context */
+static uint32 g_wallOffset = 0;
+static uint8 g_wallSet = FALSE;
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+ISR(TIMER2_OVF_vect)
+{
+	/* TCNT2 counted from 0 since the overflow, so it is the delay of this ISR
+	 * to a crystal period
+	 */
+	uint16 latency = (uint16)TCNT2 * CLOCK_COUNT_CYCLES;
+
+	if (latency > g_diag.isr_max_latency)
+	{
+		g_diag.isr_max_latency = latency;
+	}
+
+	g_ticks++;
+	if (g_ticks == CLOCK_TICKS_PER_SECOND)
+	{
+		g_ticks = 0;
+		g_seconds++;
+	}
+
+	/* the main context can't run in the middle of the ISR, so one change after
+	 * the time is enough for a reader to see that it was interrupted
+	 */
+	g_sequence++;
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void CLOCK_init(void)
+{
+	/* the interrupts must be off while the timer clock source is changed */
+	CLEAR_BIT(TIMSK, TOIE2);
+	CLEAR_BIT(TIMSK, OCIE2);
+
+	/* clock Timer2 from the crystal on TOSC1 */
+	SET_BIT(ASSR, AS2);
+
+	/* Normal mode, OC2 disconnected, clock = crystal with no prescaler */
+	TCNT2 = 0;
+	TCCR2 = (1<<CS20);
+
+	/* the registers are written in the crystal clock domain, wait until they are taken */
+	while (ASSR & ((1<<TCN2UB) | (1<<OCR2UB) | (1<<TCR2UB))){}
+
+	/* clear the flags raised while switching, writing one clears them */
+	TIFR = (1<<OCF2) | (1<<TOV2);
+
+	/* Enable Timer2 Overflow Interrupt */
+	SET_BIT(TIMSK, TOIE2);
+}
+
+void CLOCK_now(CLOCK_TimeType * a_time)
+{
+	uint8 sequence;
+
+	do
+	{
+		sequence = g_sequence;
+		a_time->seconds = g_seconds;
+		a_time->ticks = g_ticks;
+	} while (sequence != g_sequence);
+}
+
+uint32 CLOCK_counts(void)
+{
+	uint8 sreg = SREG;
+	uint32 high;
+	uint8 low;
+
+	/* TCNT2 has to be read with the ticks of the same overflow */
+	cli();
+	low = TCNT2;
+	high = (g_seconds * CLOCK_TICKS_PER_SECOND) + g_ticks;
+
+	/* the counter rolled over after the interrupts were disabled */
+	if (BIT_IS_SET(TIFR, TOV2) && (low < 0x80))
+	{
+		high++;
+	}
+	SREG = sreg;
+
+	return (high << 8) | low;
+}
+
+void CLOCK_setWall(uint32 a_seconds)
+{
+	CLOCK_TimeType now;
+
+	CLOCK_now(&now);
+	g_wallOffset = a_seconds - now.seconds;
+	g_wallSet = TRUE;
+}
+
+uint32 CLOCK_wall(void)
+{
+	CLOCK_TimeType now;
+
+	CLOCK_now(&now);
+	return now.seconds + g_wallOffset;
+}
+
+uint8 CLOCK_isSet(void)
+{
+	return g_wallSet;
+}
@@ -0,0 +1,107 @@
+/*
+ * clock.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: header file of the real-time clock of the CONTROL_ECU
+ *
+ *      Timer2 runs in asynchronous mode from the 32.768 kHz watch crystal on
+ *      TOSC1/TOSC2 (board_config.h) and overflows CLOCK_TICKS_PER_SECOND times a
+ *      second. The overflow interrupt keeps the monotonic time in seconds and
+ *      ticks since CLOCK_init, it doesn't depend on the CPU clock so it keeps
+ *      the crystal accuracy (about 20 ppm, 2 seconds a day).
+ *
+ *      The main context reads the time without disabling the interrupts: the ISR
+ *      changes a sequence number with the time and the read is done again if the
+ *      sequence changed while it was read.
+ *
+ *      The wall clock is the monotonic time plus an offset set over the link
+ *      (CLOCK_setWall). Its seconds count from Monday 1 January 2024 00:00 local
+ *      time, so the weekday and the time of day are found without a calendar.
+ *      Until it is set after a reset it is the seconds since the reset.
+ */
+
+#ifndef CLOCK_H_
+#define CLOCK_H_
+
+#include "std_types.h"
+#include "board_config.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Timer2 overflows (256 crystal periods, prescaler 1) in one second */
+#define CLOCK_TICKS_PER_SECOND	(BOARD_RTC_CRYSTAL_HZ / 256UL)
+
+/* CPU cycles of one crystal period, the unit of CLOCK_counts */
+#define CLOCK_COUNT_CYCLES		(F_CPU / BOARD_RTC_CRYSTAL_HZ)
+
+#if ((BOARD_RTC_CRYSTAL_HZ % 256UL) != 0) || (CLOCK_TICKS_PER_SECOND > 255)
+#error "clock.h: the crystal must give a whole number of Timer2 overflows a second"
+#endif
+
+/* Timer2 in asynchronous mode needs a CPU clock at least 4 times the crystal */
+#if (F_CPU < (4UL * BOARD_RTC_CRYSTAL_HZ))
+#error "clock.h: the CPU clock is too slow for the asynchronous Timer2"
+#endif
+
+/* year of the wall clock second 0, it starts on a Monday */
+#define CLOCK_EPOCH_YEAR		2024
+
+#define CLOCK_SECONDS_PER_DAY	86400UL
+#define CLOCK_SECONDS_PER_WEEK	(7UL * CLOCK_SECONDS_PER_DAY)
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef struct
+{
+	uint32	seconds	; /* since CLOCK_init */
+	uint8	ticks	; /* 0 to CLOCK_TICKS_PER_SECOND - 1 */
+} CLOCK_TimeType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Switch Timer2 to the crystal, start it and enable its overflow interrupt.
+ * The crystal needs up to one second to start, the time starts with it.
+ */
+void CLOCK_init(void);
+
+/*
+ * Description :
+ * Read the monotonic time, the two fields are from the same tick.
+ */
+void CLOCK_now(CLOCK_TimeType * a_time);
+
+/*
+ * Description :
+ * Return the time in counts of CLOCK_COUNT_CYCLES cycles (one crystal period),
+ * it rolls over after 36 hours so only differences of it are meaningful.
+ */
+uint32 CLOCK_counts(void);
+
+/*
+ * Description :
+ * Set the wall clock to a_seconds since CLOCK_EPOCH_YEAR.
+ */
+void CLOCK_setWall(uint32 a_seconds);
+
+/*
+ * Description :
+ * Return the wall clock seconds.
+ */
+uint32 CLOCK_wall(void);
+
+/*
+ * Description :
+ * Return TRUE if the wall clock was set since the reset.
+ */
+uint8 CLOCK_isSet(void);
+
+#endif /* CLOCK_H_ */
@@ -0,0 +1,89 @@
+/*
+ * config.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: source file for the policy record stored in the external EEPROM
+ */
+
+#include "config.h"
+#include "eeprom_map.h"
+#include "external_eeprom.h"
+#include <util/delay.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* RAM copy of the policy record */
+static POLICY_ConfigType g_policy =
+{
+	POLICY_VERSION,
+	POLICY_DEFAULT_PASS_MIN,
+	POLICY_DEFAULT_PASS_MAX,
+	POLICY_DEFAULT_ATTEMPTS,
+	POLICY_DEFAULT_LOCKOUT,
+	POLICY_DEFAULT_DOOR_MOVE,
+	POLICY_DEFAULT_DOOR_HOLD
+};
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void CONFIG_init(void)
+{
+	POLICY_ConfigType policy;
+
+	if (EEPROM_readBlock(EEPROM_CONFIG_ADDRESS, (uint8 *)&policy, sizeof(policy)) == SUCCESS)
+	{
+		if (CONFIG_isValid(&policy))
+		{
+			g_policy = policy;
+			return;
+		}
+	}
+
+	/* no valid record, store the default policy so it is loaded in the next start */
+	EEPROM_writeBlock(EEPROM_CONFIG_ADDRESS, (const uint8 *)&g_policy, sizeof(g_policy));
+	_delay_ms(10);
+}
+
+const POLICY_ConfigType * CONFIG_get(void)
+{
+	return &g_policy;
+}
+
+uint8 CONFIG_isValid(const POLICY_ConfigType * a_policy)
+{
+	return (a_policy->version == POLICY_VERSION)
+		&& (a_policy->pass_min >= POLICY_PASS_MIN_SIZE)
+		&& (a_policy->pass_max <= POLICY_PASS_MAX_SIZE)
+		&& (a_policy->pass_min <= a_policy->pass_max)
+		&& (a_policy->max_attempts >= POLICY_ATTEMPTS_MIN)
+		&& (a_policy->max_attempts <= POLICY_ATTEMPTS_MAX)
+		&& (a_policy->lockout_seconds >= POLICY_LOCKOUT_MIN)
+		&& (a_policy->lockout_seconds <= POLICY_LOCKOUT_MAX)
+		&& (a_policy->door_move >= POLICY_DOOR_MIN)
+		&& (a_policy->door_move <= POLICY_DOOR_MAX)
+		&& (a_policy->door_hold >= POLICY_DOOR_MIN)
+		&& (a_policy->door_hold <= POLICY_DOOR_MAX);
+}
+
+uint8 CONFIG_set(const POLICY_ConfigType * a_policy)
+{
+	if (!CONFIG_isValid(a_policy))
+	{
+		return ERROR;
+	}
+
+	g_policy = *a_policy;
+
+	if (EEPROM_writeBlock(EEPROM_CONFIG_ADDRESS, (const uint8 *)&g_policy, sizeof(g_policy)) == ERROR)
+	{
+		return ERROR;
+	}
+	_delay_ms(10);
+
+	return SUCCESS;
+}
@@ -0,0 +1,45 @@
+/*
+ * config.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: header file for the policy record stored in the external EEPROM
+ */
+
+#ifndef CONFIG_H_
+#define CONFIG_H_
+
+#include "std_types.h"
+#include "policy.h"
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Load the policy record from the external EEPROM to the RAM. If there is no
+ * valid record the default policy is stored once in the EEPROM.
+ */
+void CONFIG_init(void);
+
+/*
+ * Description :
+ * Return the policy loaded in the RAM.
+ */
+const POLICY_ConfigType * CONFIG_get(void);
+
+/*
+ * Description :
+ * Check the range of every policy value, return TRUE if the policy can be used.
+ */
+uint8 CONFIG_isValid(const POLICY_ConfigType * a_policy);
+
+/*
+ * Description :
+ * Replace the policy and store it in the external EEPROM in one page write.
+ * Return ERROR if any value is out of range and keep the old policy.
+ */
+uint8 CONFIG_set(const POLICY_ConfigType * a_policy);
+
+#endif /* CONFIG_H_ */
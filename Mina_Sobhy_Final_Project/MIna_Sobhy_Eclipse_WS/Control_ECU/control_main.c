@@ -14,8 +14,24 @@
 #include "twi.h"
 #include "external_eeprom.h"
 #include "buzzer.h"
+#include "lockout.h"
+#include "digest.h"
+#include "config.h"
+#include "eeprom_map.h"
+#include "trace.h"
+#include "diag.h"
+#include "power.h"
+#include "baud.h"
+#include "audit_log.h"
+#include "log_export.h"
+#include "clock.h"
+#include "schedule.h"
+#include "bus.h"
+#include "provision.h"
+#include "credential.h"
 #include <util/delay.h>
 #include <avr/io.h>
+#include <avr/interrupt.h>
 
 
 /*******************************************************************************
@@ -25,6 +41,44 @@
 #define MATCHED			'1'
 #define UNMATCHED 		'0'
 #define COMPARE_ERROR	'2'
+#define LOCKED			'3' /* reply to any option while the system is locked */
+#define OUT_OF_SCHEDULE	'B' /* right password out of the schedule of its group */
+
+/* sent at the start to tell the HMI_ECU if a password has to be created */
+#define PASS_EMPTY		'4'
+#define PASS_STORED		'5'
+
+/* main option to change the policy after entering the password */
+#define SETTINGS		'6'
+
+/* hidden main option ('=') to send the trace buffers of the two ECUs on the UART,
+ * it is accepted while the system is locked
+ */
+#define TRACE_DUMP		'7'
+
+/* hidden main option ('%') to send the performance counters of the CONTROL_ECU,
+ * it is accepted while the system is locked
+ */
+#define DIAGNOSTICS		'8'
+
+/* hidden main option ('#' then '0') to send the audit log compressed (log_export.h),
+ * it is accepted while the system is locked
+ */
+#define LOG_EXPORT		'9'
+
+/* hidden main option ('#' then '1') to set the wall clock after entering the password */
+#define CLOCK_SET		'A'
+
+/* bytes sent by the HMI_ECU for the hidden main options typed after '#', a digit
+ * alone does nothing at the main menu as it may be the start of a password
+ */
+#define LOG_EXPORT_KEY	'L'
+#define CLOCK_SET_KEY	'K'
+
+/* main option ('P') of a host tool on the UART line to write a credential image
+ * (provision.h) after entering the password, the keypad has no 'P' key
+ */
+#define PROVISION		'C'
 
 /* as the CONTROL_ECU is faster than the HMI_ECU. So, we won't need a start bit
  * from the CONTOL_ECU as it will be always ready, but we will need start bit
@@ -34,52 +88,142 @@
 //#define CONTROL_ECU_READY	'C'
 #define HMI_ECU_READY		'H'
 
+/* the HMI_ECU sends every password character as soon as it is typed and then
+ * sends PASS_END when the user presses enter, the password size is between the
+ * policy minimum and maximum sizes
+ */
+#define PASS_END			'#'
+
 #define TWI_ADDRESS		0x01
 #define TWI_BITRATE		0x02
 
+/* the HMI_ECUs are reached on the RS-485 bus when board_config.h sets
+ * BOARD_BUS_NODES, the flows below then talk to the keypad of g_node
+ */
+#if BUS_ENABLED
+#define LINK_sendByte(data)		BUS_sendByte(g_node, (data))
+#define LINK_receiveByte()		BUS_receiveByte(g_node)
+#define LINK_isDataAvailable()	BUS_isDataAvailable(g_node)
+
+/* session states of a keypad on the bus */
+#define SESSION_ABSENT		0 /* the keypad didn't answer yet */
+#define SESSION_OPTION		1 /* waiting for a main option */
+#define SESSION_PASS		2 /* receiving the password of the main option of the flow */
+#define SESSION_DOOR		3 /* right password, waiting for the door */
+#define SESSION_NEW_PASS	4 /* receiving a new password */
+#define SESSION_CONFIRM		5 /* receiving the confirmation of the new password */
+#define SESSION_SETTINGS	6 /* receiving the new policy */
+#define SESSION_CLOCK		7 /* receiving the new weekday, hour and minute */
+
+/* bytes of the new weekday, hour and minute received by SESSION_CLOCK */
+#define SESSION_CLOCK_SIZE	3
+
+/* door phases timed by the real-time clock */
+#define DOOR_IDLE		0
+#define DOOR_OPENING	1
+#define DOOR_HOLDING	2
+#define DOOR_CLOSING	3
+#else
+#define LINK_sendByte(data)		UART_sendByte(data)
+#define LINK_receiveByte()		UART_receiveByte()
+#define LINK_isDataAvailable()	UART_isDataAvailable()
+#endif
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+#if BUS_ENABLED
+/* the flows of every keypad run here without blocking the others, the replies
+ * are sent one by one when the keypad asks for them with HMI_ECU_READY
+ */
+typedef struct
+{
+	uint8	state						;
+	uint8	flow						; /* main option of the flow, 0 for the first password */
+	uint8	replies[sizeof(POLICY_ConfigType) + 1];
+	uint8	count						; /* replies queued */
+	uint8	index						; /* replies sent */
+	uint8	pass[POLICY_PASS_MAX_SIZE]	; /* password, or the new policy or time */
+	uint8	passSize					;
+	uint8	testSize					; /* characters of the confirmation */
+	uint8	differs						; /* the confirmation differs from the new password */
+	uint8	user						; /* audit log user of the right password */
+} CONTROL_SessionType;
+
+/* the new policy and time are received in the password buffer, the replies hold
+ * the policy and the password state or the state and the wall clock
+ */
+typedef char CONTROL_sessionSizeCheck[((sizeof(POLICY_ConfigType) <= POLICY_PASS_MAX_SIZE) &&
+	(SESSION_CLOCK_SIZE <= POLICY_PASS_MAX_SIZE) && (sizeof(POLICY_ConfigType) >= sizeof(uint32))) ? 1 : -1];
+#endif
+
 /*******************************************************************************
  *                                Global Variables                             *
  *******************************************************************************/
 
-uint8 sec1 = 0; /* store seconds passed when opening the door */
-uint8 sec2 = 0; /* store seconds passed when the error happened */
+volatile uint8 sec1 = 0; /* store seconds passed when opening the door */
+
+/* sum of the arrival times of the password characters, it depends on the user
+ * typing speed so it is used as a random seed for the password salt
+ */
+uint16 g_entropy = 0;
+
+/* user of the last right password, the main password or a user of the
+ * credential table (credential.h)
+ */
+CRED_UserType g_user = { LOG_USER_MAIN , SCHEDULE_GROUP_MAIN };
+
+#if BUS_ENABLED
+/* keypad of the flow being run */
+uint8 g_node = 1;
+
+CONTROL_SessionType g_sessions[BOARD_BUS_NODES];
+
+/* the door is shared by all the keypads, its start time is from the RTC */
+uint8 g_doorPhase = DOOR_IDLE;
+CLOCK_TimeType g_doorStart;
+#endif
 
 /*******************************************************************************
  *                                Timers CallBack Functions                    *
  *******************************************************************************/
 
+/* Description:
+ * return the seconds needed to unlock the door, keep it open and lock it again
+ */
+uint8 CONTROL_doorCycle(void)
+{
+	const POLICY_ConfigType * policy = CONFIG_get();
+
+	return (2 * policy->door_move) + policy->door_hold;
+}
+
 /* Description:
  * rotate the motor to open close the door or stop it
  */
 void CONTROL_TIMER1_count1(void)
 {
+	const POLICY_ConfigType * policy = CONFIG_get();
+
 	/* increment sec1 when timer is fired and ISR is called  */
 	sec1++;
 
 	/* rotate the motor or stop it according to the time passed */
-	switch (sec1)
+	if (sec1 == policy->door_move)
 	{
-	case 15:
 		DcMotor_Rotate(STOP,0);
-		break;
-	case 18:
+	}
+	else if (sec1 == (policy->door_move + policy->door_hold))
+	{
 		DcMotor_Rotate(ACW,100);
-		break;
-	case 33:
+	}
+	else if (sec1 == CONTROL_doorCycle())
+	{
 		DcMotor_Rotate(STOP,0);
 		Timer1_deInit();
-		break;
 	}
 }
-/* Description:
- * count seconds for the error function
- */
-void CONTROL_TIMER1_count2(void)
-{
-	/* increment sec2 when timer is fired and ISR is called  */
-	sec2++;
-}
-
 /*******************************************************************************
  *                                Functions definitions                        *
  *******************************************************************************/
@@ -89,10 +233,10 @@ void CONTROL_TIMER1_count2(void)
 void CONTROL_sendState (uint8 a_status)
 {
 	/* Wait until HMI_ECU is ready to receive the string */
-	while(UART_receiveByte() != HMI_ECU_READY){}
+	while(LINK_receiveByte() != HMI_ECU_READY){}
 
 	/* Send the required string to HMI_ECU through UART */
-	UART_sendByte(a_status);
+	LINK_sendByte(a_status);
 }
 
 /* Description:
@@ -111,17 +255,43 @@ uint8 CONTROL_receiveState(void)
 	//UART_sendByte(CONTROL_ECU_READY);
 
 	/* Receive String from HMI_ECU through UART */
-	status = UART_receiveByte();
+	status = LINK_receiveByte();
 
 	return status;
 }
 
 /* Description:
- * function to receive a password from the HMI ECU
+ * function to receive one password character from the HMI ECU
  */
-void CONTROL_receivePass(uint8 * a_pass)
+uint8 CONTROL_receivePassChar(void)
 {
-	uint8 i;
+	/* sleep until the character is received, the interrupts are disabled for
+	 * the last check as in UART_receiveByte
+	 */
+	cli();
+	while (!LINK_isDataAvailable())
+	{
+		POWER_sleep(POWER_WAKE_UART);
+		cli();
+	}
+	sei();
+
+	/* add the arrival time of every character to the random seed */
+	g_entropy += (uint16)DIAG_now();
+
+	/* Receive the character from HMI_ECU through UART */
+	return LINK_receiveByte();
+}
+
+/* Description:
+ * function to receive a password from the HMI ECU until PASS_END, it returns the
+ * number of characters and only the first POLICY_PASS_MAX_SIZE characters are
+ * stored, the rest of the buffer is cleared
+ */
+uint8 CONTROL_receivePass(uint8 * a_pass)
+{
+	uint8 i = 0;
+	uint8 data;
 
 	/* as the CONTROL_ECU is faster than the HMI_ECU. So, we won't need a start bit
 	 * from the CONTOL_ECU as it will be always ready, but we will need start bit
@@ -131,113 +301,242 @@ void CONTROL_receivePass(uint8 * a_pass)
 	/* Send CONTROL_ECU_READY byte to HMI_ECU to ask it to send the string */
 	//UART_sendByte(CONTROL_ECU_READY);
 
-	for(i=0; i<5; i++)
+	data = CONTROL_receivePassChar();
+	while (data != PASS_END)
+	{
+		if (i < POLICY_PASS_MAX_SIZE)
+		{
+			a_pass[i] = data;
+		}
+		if (i < 0xFF)
+		{
+			i++;
+		}
+		data = CONTROL_receivePassChar();
+	}
+
+	for (data = i; data < POLICY_PASS_MAX_SIZE; data++)
 	{
-		/* Receive String from HMI_ECU through UART */
-		a_pass[i] = UART_receiveByte();
+		a_pass[data] = 0;
 	}
-}
 
+	return i;
+}
 
 /* Description:
- * function to compare two passwords and return the state
+ * function to receive a password from the HMI ECU and calculate its digest while
+ * the characters are typed. The digest of the characters received so far is
+ * finalized while the link is idle, so when the user presses enter the digest
+ * is ready and only the compare is left before the reply. If a_userDigest isn't
+ * NULL_PTR and the credential table has users, the digest keyed by the salt of
+ * the table is calculated too.
  */
-uint8 CONTROL_compPass(uint8 * a_pass , uint8 * a_test)
+void CONTROL_receiveDigest(const uint8 * a_salt, uint8 * a_digest, uint8 * a_userDigest)
 {
-	uint8 i;
-	uint8 status;
+	DIGEST_StateType state;
+	DIGEST_StateType userState;
+	uint8 users = (a_userDigest != NULL_PTR) && (CRED_count() != 0);
+	uint8 ready = FALSE;
+	uint8 data;
+
+	DIGEST_init(&state, a_salt);
+	if (users)
+	{
+		DIGEST_init(&userState, CRED_salt());
+	}
 
-	for(i=0; i<5; i++)
+	data = CONTROL_receivePassChar();
+	while (data != PASS_END)
 	{
-		/* if any character was unmatched then return the status with unmatched state*/
-		if (a_pass[i] != a_test[i])
+		DIGEST_update(&state, data);
+		if (users)
 		{
-			status = UNMATCHED;
-			break;
+			DIGEST_update(&userState, data);
+		}
+
+		/* the next character is at least a key press away when the HMI ECU
+		 * streams them, a password sent at once is finalized at the end only
+		 */
+		ready = !LINK_isDataAvailable();
+		if (ready)
+		{
+			DIGEST_peek(&state, a_digest);
+			if (users)
+			{
+				DIGEST_peek(&userState, a_userDigest);
+			}
+		}
+		data = CONTROL_receivePassChar();
+	}
+
+	if (ready)
+	{
+		DIGEST_clear(&state);
+		if (users)
+		{
+			DIGEST_clear(&userState);
 		}
-		/* if the 5 characters were matched return matched in the status */
-		if ( i == 4 )
+	}
+	else
+	{
+		DIGEST_final(&state, a_digest);
+		if (users)
 		{
-			status = MATCHED;
+			DIGEST_final(&userState, a_userDigest);
 		}
 	}
+}
+
+/* Description:
+ * function to compare two passwords and return the state, the comparison takes
+ * the same time wherever the first unmatched character is
+ */
+uint8 CONTROL_compPass(uint8 * a_pass , uint8 * a_test)
+{
+	uint8 status = UNMATCHED;
+
+	if (DIGEST_equal(a_pass, a_test, POLICY_PASS_MAX_SIZE))
+	{
+		status = MATCHED;
+	}
 
 	return status;
 }
 
 /* Description:
- * function to check an input pass send by HMI ECU with the stored pass in the EEPROM
+ * function to decide the state of an entered password from its digest a_test and
+ * the stored digest a_comp, the attempt is counted by the lockout manager and added
+ * to the audit log as a_event if it is wrong. If a_userDigest isn't NULL_PTR, a pass
+ * which isn't the main one is looked up by its digest in the credential table and
+ * g_user gets the user found. A right password opens the door only in the schedule
+ * of its group (schedule.h).
  */
-uint8 CONTROL_checkPass(void)
+uint8 CONTROL_passStatus(LOG_EventType a_event, const uint8 * a_test, const uint8 * a_comp,
+	const uint8 * a_userDigest)
 {
-	uint8 status,i;
-	uint8 comp[5]; /* store pass from the EEPROM */
-	uint8 pass[5]; /* store pass from HMI ECU */
+	uint8 status = UNMATCHED;
 
+	DIAG_COUNT(unlock_attempts);
+	g_user.id = LOG_USER_MAIN;
+	g_user.group = SCHEDULE_GROUP_MAIN;
 
-	for (i=0; i<5 ; i++)
+	/* compare the digest of the received pass with the digest stored in EEPROM */
+	if (DIGEST_equal(a_test, a_comp, DIGEST_TAG_SIZE))
+	{
+		status = MATCHED;
+	}
+	/* one bucket of the credential table is read for any other pass */
+	else if ((a_userDigest != NULL_PTR) && (CRED_count() != 0) && CRED_find(a_userDigest, &g_user))
 	{
-		/* read password from the external EEPROM */
-		EEPROM_readByte(0x0311+i, &comp[i]);
-		_delay_ms(10);
+		status = MATCHED;
 	}
 
-	for (i=0 ; i<3 ; i++)
+	/* check if the password is matched */
+	if (status == MATCHED)
 	{
-		/* receive pass from HMI ECU */
-		CONTROL_receivePass(pass);
-		/* compare the received pass with the pass stored in EEPROM */
-		status = CONTROL_compPass(pass ,comp);
+		LOCKOUT_registerSuccess();
 
-		/* check if the password is matched */
-		if (status == MATCHED)
-		{
-			CONTROL_sendState(status);
-			break;
-		}
-		/* check if the password wasn't matched for 3 times */
-		else if ( i ==2 )
+		/* the schedule is one bit lookup after the credential match */
+		if ((a_event == LOG_EVENT_DOOR_OPEN) && !SCHEDULE_isAllowed(g_user.group))
 		{
-			status = COMPARE_ERROR;
-			CONTROL_sendState(status);
-			break;
-		}
-		/* send the state if unmatched */
-		else
-		{
-			CONTROL_sendState(status);
+			status = OUT_OF_SCHEDULE;
+			LOG_append(a_event, CRED_LOG_USER(g_user.id), LOG_RESULT_SCHEDULE);
 		}
 	}
+	/* check if the wrong passwords reached the maximum attempts */
+	else if (LOCKOUT_registerFailure())
+	{
+		status = COMPARE_ERROR;
+
+		/* the lockout is written at once, it must survive a power cycle */
+		LOG_append(a_event, LOG_USER_MAIN, LOG_RESULT_WRONG_PASS);
+		LOG_append(LOG_EVENT_LOCKOUT, LOG_USER_MAIN, LOCKOUT_level());
+		LOG_flush();
+	}
+	else
+	{
+		LOG_append(a_event, LOG_USER_MAIN, LOG_RESULT_WRONG_PASS);
+	}
+
+	return status;
+}
+
+/* Description:
+ * function to check an input pass send by HMI ECU with the stored pass in the EEPROM,
+ * every wrong password and the lockout are added to the audit log as a_event. A right
+ * password opens the door only in the schedule of its group (schedule.h).
+ */
+uint8 CONTROL_checkPass(LOG_EventType a_event)
+{
+	uint8 status = UNMATCHED;
+	uint8 salt[DIGEST_SALT_SIZE]; /* store the salt from the EEPROM */
+	uint8 comp[DIGEST_TAG_SIZE]; /* store the pass digest from the EEPROM */
+	uint8 test[DIGEST_TAG_SIZE]; /* store the digest of the pass from HMI ECU */
+	uint8 userDigest[DIGEST_TAG_SIZE]; /* digest of the pass keyed by the salt of the users */
+	uint8 * user = (a_event == LOG_EVENT_DOOR_OPEN) ? userDigest : NULL_PTR; /* only the door is for the users */
+
+	TRACE(TRACE_STATE, TRACE_STATE_CONTROL_CHECK_PASS);
+
+	/* read the salt and the password digest from the external EEPROM */
+	EEPROM_readBlock(EEPROM_PASS_SALT_ADDRESS, salt, DIGEST_SALT_SIZE);
+	EEPROM_readBlock(EEPROM_PASS_DIGEST_ADDRESS, comp, DIGEST_TAG_SIZE);
+
+	/* the failed attempts are kept by the lockout manager so a power cycle
+	 * between two wrong passwords doesn't give the user more attempts
+	 */
+	while (status == UNMATCHED)
+	{
+		/* receive pass from HMI ECU and calculate its digest */
+		CONTROL_receiveDigest(salt, test, user);
+		status = CONTROL_passStatus(a_event, test, comp, user);
+
+		CONTROL_sendState(status);
+	}
 
 	return status;
 }
 
 /* Description:
- * function to handle Error by turning the buzzer on for 60 second
+ * function to generate a new salt from the old one and the user typing time
  */
-void CONTROL_error(void)
+void CONTROL_newSalt(uint8 * a_salt)
 {
-	/* turn on the buzzer */
-	Buzzer_on();
+	uint8 seed[3];
+
+	/* read the old salt from the external EEPROM */
+	EEPROM_readBlock(EEPROM_PASS_SALT_ADDRESS, a_salt, DIGEST_SALT_SIZE);
+
+	seed[0] = (uint8)g_entropy;
+	seed[1] = (uint8)(g_entropy >> 8);
 
-	/* set the timer callback function */
-	Timer1_setCallBack(CONTROL_TIMER1_count2);
-	/* Timer1 Configuration */
-	Timer1_ConfigType timerType = { 0 , 31250 , PRESCALER_256, COMPARE_MODE};
-	/* Timer1 initialization */
-	Timer1_init(&timerType);
+	/* every half of the new salt is a digest of the seed keyed by the old salt */
+	seed[2] = 0;
+	DIGEST_calculate(a_salt, seed, 3, a_salt);
+	seed[2] = 1;
+	DIGEST_calculate(a_salt, seed, 3, a_salt + DIGEST_TAG_SIZE);
+}
 
-	/* wait for 60 second */
-	while (sec2 != 60){}
+/* Description:
+ * function to store the salt and the digest of a new password of a_size characters
+ * in the EEPROM
+ */
+void CONTROL_savePass(const uint8 * a_pass, uint8 a_size)
+{
+	uint8 salt[DIGEST_SALT_SIZE];
+	uint8 digest[DIGEST_TAG_SIZE];
 
-	/* clear the sec1 variable */
-	sec2 = 0;
+	/* only the salt and the digest of the password are stored in the external EEPROM */
+	CONTROL_newSalt(salt);
+	DIGEST_calculate(salt, a_pass, a_size, digest);
 
-	/* turn off the buzzer */
-	Buzzer_off();
+	EEPROM_writeBlock(EEPROM_PASS_SALT_ADDRESS, salt, DIGEST_SALT_SIZE);
+	_delay_ms(10);
+	EEPROM_writeBlock(EEPROM_PASS_DIGEST_ADDRESS, digest, DIGEST_TAG_SIZE);
+	_delay_ms(10);
 
-	/* De-initialize the timer */
-	Timer1_deInit();
+	/* mark the password as stored so it isn't requested again after a power cycle */
+	EEPROM_writeByte(EEPROM_PASS_FLAG_ADDRESS, EEPROM_PASS_MAGIC);
+	_delay_ms(10);
 }
 
 /* Description:
@@ -247,45 +546,46 @@ void CONTROL_error(void)
  */
 void CONTROL_storePass()
 {
-	uint8 i;
-	uint8 pass[5];
-	uint8 test[5];
+	const POLICY_ConfigType * policy = CONFIG_get();
+	uint8 pass[POLICY_PASS_MAX_SIZE];
+	uint8 test[POLICY_PASS_MAX_SIZE];
+	uint8 passSize;
+	uint8 testSize;
 	uint8 status = UNMATCHED;
 
+	TRACE(TRACE_STATE, TRACE_STATE_CONTROL_STORE_PASS);
+
 	/* loop until the state of two passwords is matched */
 	while (status == UNMATCHED)
 	{
 		/* receive the first password */
-		CONTROL_receivePass(pass);
+		passSize = CONTROL_receivePass(pass);
 		/* receive the confirmation password */
-		CONTROL_receivePass(test);
+		testSize = CONTROL_receivePass(test);
 
 		/* compare the two passwords and get the status*/
 		status = CONTROL_compPass(pass ,test);
+		if ((passSize != testSize) || (passSize < policy->pass_min) || (passSize > policy->pass_max))
+		{
+			status = UNMATCHED;
+		}
 		/* send the status to HMI ECU */
 		CONTROL_sendState(status);
 	}
 
-	for (i = 0 ; i<5 ; i++)
-	{
-		/* Write password in the external EEPROM */
-		EEPROM_writeByte(0x0311+i, pass[i]);
-		_delay_ms(10);
-	}
+	CONTROL_savePass(pass, passSize);
 }
 
 /* Description:
- * function to get the user choice either open door or change password
+ * function to return the reply to the main option key a_option, the remaining
+ * lockout seconds are stored in a_remaining
  */
-uint8 CONTROL_mainOptions(void)
+uint8 CONTROL_optionFlag(uint8 a_option, uint16 * a_remaining)
 {
-	uint8 option;
 	uint8 flag = '0';
+	uint16 remaining;
 
-	/* receive the key pressed from the HMI ECU */
-	option = CONTROL_receiveState();
-
-	switch (option)
+	switch (a_option)
 	{
 	case '+':
 		flag = '1';
@@ -293,11 +593,76 @@ uint8 CONTROL_mainOptions(void)
 	case '-':
 		flag= '2';
 		break;
+	case '*':
+		flag = SETTINGS;
+		break;
+#if !BUS_ENABLED
+	/* the dumps are sent on the UART lines, they have no place on the bus */
+	case '=':
+		flag = TRACE_DUMP;
+		break;
+	case '%':
+		flag = DIAGNOSTICS;
+		break;
+	case LOG_EXPORT_KEY:
+		flag = LOG_EXPORT;
+		break;
+	case 'P':
+		flag = PROVISION;
+		break;
+#endif
+	case CLOCK_SET_KEY:
+		flag = CLOCK_SET;
+		break;
+	}
+
+	/* no option is accepted while the system is locked, except the trace dump,
+	 * the diagnostics and the log export which don't change anything
+	 */
+	remaining = LOCKOUT_remaining();
+	if ((remaining != 0) && (flag != TRACE_DUMP) && (flag != DIAGNOSTICS) && (flag != LOG_EXPORT))
+	{
+		flag = LOCKED;
+	}
+	*a_remaining = remaining;
+
+	return flag;
+}
+
+/* Description:
+ * function to get the user choice either open door or change password
+ */
+uint8 CONTROL_mainOptions(void)
+{
+	uint8 option;
+	uint8 flag;
+	uint16 remaining;
+
+	TRACE(TRACE_STATE, TRACE_STATE_CONTROL_MAIN_OPTIONS);
+
+	/* receive the key pressed from the HMI ECU and get the reply to it */
+	option = CONTROL_receiveState();
+#if !BUS_ENABLED
+	/* the HMI_ECU was reset or lost the link, it asks for the baud rate
+	 * negotiation instead of sending an option
+	 */
+	if (option == BAUD_READY)
+	{
+		return BAUD_READY;
 	}
+#endif
+	flag = CONTROL_optionFlag(option, &remaining);
 
 	/* send the option to the HMI ECU */
 	CONTROL_sendState(flag);
 
+	/* send the remaining lockout seconds to be displayed by the HMI ECU */
+	if (flag == LOCKED)
+	{
+		CONTROL_sendState((uint8)(remaining >> 8));
+		CONTROL_sendState((uint8)remaining);
+	}
+
 	return flag;
 }
 
@@ -310,13 +675,17 @@ void CONTROL_openDoor(void)
 {
 	uint8 status;
 
+	TRACE(TRACE_STATE, TRACE_STATE_CONTROL_OPEN_DOOR);
+
 	/* check the entered passwords state */
-	status = CONTROL_checkPass();
+	status = CONTROL_checkPass(LOG_EVENT_DOOR_OPEN);
 
 	switch (status)
 	{
 	/* check if the password is matched to go to open the door */
 	case MATCHED:
+		LOG_append(LOG_EVENT_DOOR_OPEN, CRED_LOG_USER(g_user.id), LOG_RESULT_SUCCESS);
+
 		/* rotate teh motor to open the door */
 		DcMotor_Rotate(CW,100);
 
@@ -327,19 +696,31 @@ void CONTROL_openDoor(void)
 		/* Timer1 initialization */
 		Timer1_init(&timerType);
 
-		/* wait until the door is opened and entered and then closed to get out from the loop */
-		while (sec1 != 33){}
+		/* wait until the door is opened and entered and then closed to get out from the loop,
+		 * the CPU sleeps between the Timer1 interrupts which are disabled for the last check
+		 */
+		cli();
+		while (sec1 != CONTROL_doorCycle())
+		{
+			POWER_sleep(POWER_WAKE_TIMER1);
+			cli();
+		}
+		sei();
 
 		/* clear the sec1 variable */
 		sec1 = 0;
+		DIAG_COUNT(door_cycles);
 
 		break;
 
 	/* if the password is unmatched for 3 times then the status variable will have value of
-	 * COMPARE ERROR and then go to the error function
+	 * COMPARE ERROR and the lockout manager already started the alarm in the background
 	 */
 	case COMPARE_ERROR:
-		CONTROL_error();
+		break;
+
+	/* the password is right but not at this time, the door stays locked */
+	case OUT_OF_SCHEDULE:
 		break;
 	}
 
@@ -353,67 +734,896 @@ void CONTROL_changePass(void)
 {
 	uint8 status;
 
+	TRACE(TRACE_STATE, TRACE_STATE_CONTROL_CHANGE_PASS);
+
 	/* check the entered passwords state */
-	status = CONTROL_checkPass();
+	status = CONTROL_checkPass(LOG_EVENT_PASS_CHANGE);
 
 	switch (status)
 	{
 	/* check if the password is matched to go to change the password */
 	case MATCHED:
 		CONTROL_storePass();
+		LOG_append(LOG_EVENT_PASS_CHANGE, LOG_USER_MAIN, LOG_RESULT_SUCCESS);
 		break;
 
 	/* if the password is unmatched for 3 times then the status variable will have value of
-	 * COMPARE ERROR and then go to the error function
+	 * COMPARE ERROR and the lockout manager already started the alarm in the background
 	 */
 	case COMPARE_ERROR:
-		CONTROL_error();
 		break;
 	}
 
 }
 
-
-int main (void)
+/* Description:
+ * function to send the policy to the HMI ECU, it is sent at the start and after every
+ * change so the two ECUs always use the same policy
+ */
+void CONTROL_sendPolicy(void)
 {
-	/* enable interrupt for the timer function*/
-	SREG |= (1<<7) ;
+	const uint8 * policy = (const uint8 *)CONFIG_get();
+	uint8 i;
 
-	/* UART Configuration */
-	UART_ConfigType uartType = {EIGHT_BIT, DISABLED, ONE_BIT, 9600};
-	/* UART initialization */
-	UART_init(&uartType);
+	for (i = 0; i < sizeof(POLICY_ConfigType); i++)
+	{
+		CONTROL_sendState(policy[i]);
+	}
+}
 
-	/* TWI Configuration */
-	TWI_ConfigType twiType = {TWI_BITRATE, TWI_ADDRESS};
-	/* TWI initialization */
-	TWI_init(&twiType);
+/* Description:
+ * function to use the new policy a_policy, it is kept without any change if any
+ * value is out of range
+ */
+void CONTROL_setPolicy(const POLICY_ConfigType * a_policy)
+{
+	LOG_append(LOG_EVENT_SETTINGS, LOG_USER_MAIN,
+		(CONFIG_set(a_policy) == SUCCESS) ? LOG_RESULT_SUCCESS : LOG_RESULT_INVALID);
+}
 
-	/* initializing DcMotor */
-	DcMotor_init();
+/* Description:
+ * check the password from the HMI ECU to decide either change the policy
+ * or go to error if the password was incorrect for the maximum attempts
+ */
+void CONTROL_settings(void)
+{
+	POLICY_ConfigType policy;
+	uint8 * data = (uint8 *)&policy;
+	uint8 i;
 
-	/* initializing buzzer */
-	Buzzer_init();
+	TRACE(TRACE_STATE, TRACE_STATE_CONTROL_SETTINGS);
 
-	/* compare passwords and store it in the EEPROM at the start */
-	CONTROL_storePass();
-	for (;;)
+	/* check the entered passwords state */
+	if (CONTROL_checkPass(LOG_EVENT_SETTINGS) == MATCHED)
 	{
-		switch (CONTROL_mainOptions())
+		/* receive the new policy from the HMI ECU */
+		for (i = 0; i < sizeof(POLICY_ConfigType); i++)
 		{
-		/* if the user choose '+' then go to open door function */
-		case '1':
-			CONTROL_openDoor();
-			break;
+			data[i] = CONTROL_receiveState();
+		}
 
-		/* if the user choose '-' then go to change password function */
-		case '2':
-			CONTROL_changePass();
+		CONTROL_setPolicy(&policy);
+
+		/* send back the policy in use */
+		CONTROL_sendPolicy();
+	}
+}
+
+/* Description:
+ * function to send the wall clock seconds to the HMI ECU, the low byte first
+ */
+void CONTROL_sendWall(void)
+{
+	uint32 wall = CLOCK_wall();
+	uint8 i;
+
+	for (i = 0; i < 4; i++)
+	{
+		CONTROL_sendState((uint8)wall);
+		wall >>= 8;
+	}
+}
+
+/* Description:
+ * function to set the wall clock to the weekday a_day (1 for Monday), the hour and
+ * the minute of the current week, it is kept without any change if any value is
+ * out of range
+ */
+void CONTROL_setClock(uint8 a_day, uint8 a_hour, uint8 a_minute)
+{
+	uint32 wall;
+
+	if ((a_day >= 1) && (a_day <= 7) && (a_hour < 24) && (a_minute < 60))
+	{
+		/* the new time is in the current week of the wall clock */
+		wall = CLOCK_wall();
+		wall -= wall % CLOCK_SECONDS_PER_WEEK;
+		wall += ((a_day - 1) * CLOCK_SECONDS_PER_DAY) + (a_hour * 3600UL) + (a_minute * 60UL);
+		CLOCK_setWall(wall);
+		LOG_append(LOG_EVENT_CLOCK, LOG_USER_MAIN, LOG_RESULT_SUCCESS);
+	}
+	else
+	{
+		LOG_append(LOG_EVENT_CLOCK, LOG_USER_MAIN, LOG_RESULT_INVALID);
+	}
+}
+
+/* Description:
+ * check the password from the HMI ECU to decide either set the wall clock
+ * or go to error if the password was incorrect for the maximum attempts
+ */
+void CONTROL_clock(void)
+{
+	uint8 day;
+	uint8 hour;
+	uint8 minute;
+
+	TRACE(TRACE_STATE, TRACE_STATE_CONTROL_CLOCK);
+
+	/* check the entered passwords state */
+	if (CONTROL_checkPass(LOG_EVENT_CLOCK) == MATCHED)
+	{
+		/* the HMI ECU shows the current weekday and time to be edited */
+		CONTROL_sendWall();
+
+		/* receive the weekday (1 for Monday), the hour and the minute */
+		day = CONTROL_receiveState();
+		hour = CONTROL_receiveState();
+		minute = CONTROL_receiveState();
+
+		CONTROL_setClock(day, hour, minute);
+
+		/* send back the wall clock in use */
+		CONTROL_sendWall();
+	}
+}
+
+/* Description:
+ * function to send the trace buffer of the CONTROL_ECU then receive the one of the
+ * HMI_ECU, the two dumps can be read by a serial monitor on the UART lines
+ */
+void CONTROL_traceDump(void)
+{
+	TRACE(TRACE_STATE, TRACE_STATE_CONTROL_TRACE_DUMP);
+
+	/* Wait until HMI_ECU is ready to receive the dump */
+	while(UART_receiveByte() != HMI_ECU_READY){}
+
+	TRACE_dump();
+	TRACE_skip();
+}
+
+/* Description:
+ * function to send the performance counters to the HMI_ECU in one frame
+ */
+void CONTROL_diagnostics(void)
+{
+	TRACE(TRACE_STATE, TRACE_STATE_CONTROL_DIAGNOSTICS);
+
+	/* Wait until HMI_ECU is ready to receive the frame */
+	while(UART_receiveByte() != HMI_ECU_READY){}
+
+	DIAG_send();
+}
+
+/* Description:
+ * function to send the audit log to the HMI_ECU, the frames can be read by a
+ * serial monitor on the UART lines and decoded by Host_Sim/tools/log_decode
+ */
+void CONTROL_logExport(void)
+{
+	TRACE(TRACE_STATE, TRACE_STATE_CONTROL_LOG_EXPORT);
+
+	/* Wait until HMI_ECU is ready to receive the log */
+	while(UART_receiveByte() != HMI_ECU_READY){}
+
+	EXPORT_send();
+}
+
+/* Description:
+ * check the password from the host tool on the UART line, then receive the
+ * credential image and load the schedules and the users it holds
+ */
+void CONTROL_provision(void)
+{
+	TRACE(TRACE_STATE, TRACE_STATE_CONTROL_PROVISION);
+
+	/* check the entered passwords state */
+	if (CONTROL_checkPass(LOG_EVENT_PROVISION) == MATCHED)
+	{
+		LOG_append(LOG_EVENT_PROVISION, LOG_USER_MAIN,
+			(PROVISION_receive() == SUCCESS) ? LOG_RESULT_SUCCESS : LOG_RESULT_INVALID);
+
+		SCHEDULE_init();
+		CRED_init();
+	}
+}
+
+#if !BUS_ENABLED
+/* Description:
+ * function to tell the HMI ECU if a password is stored, a new one is stored if not
+ */
+void CONTROL_sendPassState(void)
+{
+	uint8 passFlag;
+
+	EEPROM_readByte(EEPROM_PASS_FLAG_ADDRESS, &passFlag);
+	if (passFlag == EEPROM_PASS_MAGIC)
+	{
+		CONTROL_sendState(PASS_STORED);
+	}
+	else
+	{
+		CONTROL_sendState(PASS_EMPTY);
+		CONTROL_storePass();
+	}
+}
+
+/* Description:
+ * function to negotiate the baud rate again after the reset of the HMI ECU or a lost
+ * link, then send the policy and the password state the HMI ECU waits for as at the start
+ */
+void CONTROL_relink(void)
+{
+	if (BAUD_negotiateMaster() != BAUD_NO_SLAVE)
+	{
+		CONTROL_sendPolicy();
+		CONTROL_sendPassState();
+	}
+}
+#endif
+
+#if BUS_ENABLED
+/* Description:
+ * queue a reply for the keypad of a_session, it is sent when the keypad asks for it
+ */
+void CONTROL_queueReply(CONTROL_SessionType * a_session, uint8 a_reply)
+{
+	a_session->replies[a_session->count] = a_reply;
+	a_session->count++;
+}
+
+/* Description:
+ * start the door cycle of the right password of a_user, CONTROL_doorService stops
+ * and turns back the motor
+ */
+void CONTROL_doorStart(uint8 a_user)
+{
+	LOG_append(LOG_EVENT_DOOR_OPEN, a_user, LOG_RESULT_SUCCESS);
+
+	/* rotate the motor to open the door */
+	DcMotor_Rotate(CW,100);
+
+	CLOCK_now(&g_doorStart);
+	g_doorPhase = DOOR_OPENING;
+}
+
+/* Description:
+ * rotate the motor to open close the door or stop it from the time passed since
+ * CONTROL_doorStart, Timer1 isn't used as a keypad can start the lockout while
+ * the door opened by another one is moving
+ */
+void CONTROL_doorService(void)
+{
+	const POLICY_ConfigType * policy = CONFIG_get();
+	CLOCK_TimeType now;
+	uint32 seconds;
+
+	if (g_doorPhase == DOOR_IDLE)
+	{
+		return;
+	}
+
+	CLOCK_now(&now);
+	seconds = now.seconds - g_doorStart.seconds;
+	if (now.ticks < g_doorStart.ticks)
+	{
+		seconds--;
+	}
+
+	if ((g_doorPhase == DOOR_OPENING) && (seconds >= policy->door_move))
+	{
+		DcMotor_Rotate(STOP,0);
+		g_doorPhase = DOOR_HOLDING;
+	}
+	if ((g_doorPhase == DOOR_HOLDING) && (seconds >= (uint32)(policy->door_move + policy->door_hold)))
+	{
+		DcMotor_Rotate(ACW,100);
+		g_doorPhase = DOOR_CLOSING;
+	}
+	if ((g_doorPhase == DOOR_CLOSING) && (seconds >= CONTROL_doorCycle()))
+	{
+		DcMotor_Rotate(STOP,0);
+		g_doorPhase = DOOR_IDLE;
+		DIAG_COUNT(door_cycles);
+	}
+}
+
+/* Description:
+ * queue the policy in use for the keypad of a_session
+ */
+void CONTROL_queuePolicy(CONTROL_SessionType * a_session)
+{
+	const uint8 * policy = (const uint8 *)CONFIG_get();
+	uint8 i;
+
+	for (i = 0; i < sizeof(POLICY_ConfigType); i++)
+	{
+		CONTROL_queueReply(a_session, policy[i]);
+	}
+}
+
+/* Description:
+ * queue the wall clock seconds for the keypad of a_session, the low byte first
+ */
+void CONTROL_queueWall(CONTROL_SessionType * a_session)
+{
+	uint32 wall = CLOCK_wall();
+	uint8 i;
+
+	for (i = 0; i < 4; i++)
+	{
+		CONTROL_queueReply(a_session, (uint8)wall);
+		wall >>= 8;
+	}
+}
+
+/* Description:
+ * clear the password buffer of a_session, the password isn't kept in RAM after it
+ * is used
+ */
+void CONTROL_sessionClear(CONTROL_SessionType * a_session)
+{
+	uint8 i;
+
+	for (i = 0; i < POLICY_PASS_MAX_SIZE; i++)
+	{
+		a_session->pass[i] = 0;
+	}
+	a_session->passSize = 0;
+	a_session->testSize = 0;
+	a_session->differs = FALSE;
+}
+
+/* Description:
+ * check the password buffered by the session of a keypad and queue its state. A
+ * right password waits for the door, or goes on with the flow of the main option
+ */
+void CONTROL_sessionPass(CONTROL_SessionType * a_session)
+{
+	uint8 salt[DIGEST_SALT_SIZE];
+	uint8 comp[DIGEST_TAG_SIZE];
+	uint8 test[DIGEST_TAG_SIZE];
+	uint8 userDigest[DIGEST_TAG_SIZE];
+	uint8 size = (a_session->passSize < POLICY_PASS_MAX_SIZE) ? a_session->passSize : POLICY_PASS_MAX_SIZE;
+	uint8 oversize = (a_session->passSize > POLICY_PASS_MAX_SIZE);
+	uint8 door = (a_session->flow == '1'); /* only the door is for the users */
+	LOG_EventType event;
+	uint8 status;
+
+	switch (a_session->flow)
+	{
+	case '2':
+		event = LOG_EVENT_PASS_CHANGE;
+		break;
+	case SETTINGS:
+		event = LOG_EVENT_SETTINGS;
+		break;
+	case CLOCK_SET:
+		event = LOG_EVENT_CLOCK;
+		break;
+	default:
+		event = LOG_EVENT_DOOR_OPEN;
+		break;
+	}
+
+	EEPROM_readBlock(EEPROM_PASS_SALT_ADDRESS, salt, DIGEST_SALT_SIZE);
+	EEPROM_readBlock(EEPROM_PASS_DIGEST_ADDRESS, comp, DIGEST_TAG_SIZE);
+
+	DIGEST_calculate(salt, a_session->pass, size, test);
+	if (door)
+	{
+		DIGEST_calculate(CRED_salt(), a_session->pass, size, userDigest);
+	}
+
+	/* a password longer than the buffer isn't the stored one nor a user, its digest
+	 * is made wrong and the users aren't looked up so the attempt is still counted,
+	 * the digests are of its first POLICY_PASS_MAX_SIZE characters only
+	 */
+	if (oversize)
+	{
+		test[0] = (uint8)~comp[0];
+	}
+
+	CONTROL_sessionClear(a_session);
+
+	status = CONTROL_passStatus(event, test, comp, (door && !oversize) ? userDigest : NULL_PTR);
+	if ((status == MATCHED) && door)
+	{
+		a_session->user = CRED_LOG_USER(g_user.id);
+		a_session->state = SESSION_DOOR;
+		return;
+	}
+
+	/* a wrong password is typed again, the other states end the flow */
+	CONTROL_queueReply(a_session, status);
+	if (status == MATCHED)
+	{
+		switch (a_session->flow)
+		{
+		case '2':
+			a_session->state = SESSION_NEW_PASS;
+			break;
+		case SETTINGS:
+			a_session->state = SESSION_SETTINGS;
+			break;
+		default:
+			/* the keypad shows the current time to be edited */
+			CONTROL_queueWall(a_session);
+			a_session->state = SESSION_CLOCK;
+			break;
+		}
+	}
+	else if (status != UNMATCHED)
+	{
+		a_session->state = SESSION_OPTION;
+	}
+}
+
+/* Description:
+ * check the new password and its confirmation buffered by the session of a keypad
+ * and queue their state, the password is stored if they match or they are typed again
+ */
+void CONTROL_sessionNewPass(CONTROL_SessionType * a_session)
+{
+	const POLICY_ConfigType * policy = CONFIG_get();
+	uint8 status = UNMATCHED;
+
+	if (!a_session->differs && (a_session->passSize == a_session->testSize) &&
+		(a_session->passSize >= policy->pass_min) && (a_session->passSize <= policy->pass_max))
+	{
+		CONTROL_savePass(a_session->pass, a_session->passSize);
+
+		/* the first password of the system isn't a change, if two keypads create
+		 * it at the same time the last one stored is kept
+		 */
+		if (a_session->flow == '2')
+		{
+			LOG_append(LOG_EVENT_PASS_CHANGE, LOG_USER_MAIN, LOG_RESULT_SUCCESS);
+		}
+		status = MATCHED;
+	}
+
+	CONTROL_sessionClear(a_session);
+	CONTROL_queueReply(a_session, status);
+	a_session->state = (status == MATCHED) ? SESSION_OPTION : SESSION_NEW_PASS;
+}
+
+/* Description:
+ * take a password character a_data in the session of a keypad, the characters of a
+ * confirmation are compared with the new password as they come
+ */
+void CONTROL_sessionChar(CONTROL_SessionType * a_session, uint8 a_data)
+{
+	/* add the arrival time of every character to the random seed */
+	g_entropy += (uint16)DIAG_now();
+
+	if (a_session->state == SESSION_CONFIRM)
+	{
+		if ((a_session->testSize < POLICY_PASS_MAX_SIZE) && (a_session->pass[a_session->testSize] != a_data))
+		{
+			a_session->differs = TRUE;
+		}
+		if (a_session->testSize < 0xFF)
+		{
+			a_session->testSize++;
+		}
+		return;
+	}
+
+	if (a_session->passSize < POLICY_PASS_MAX_SIZE)
+	{
+		a_session->pass[a_session->passSize] = a_data;
+	}
+	if (a_session->passSize < 0xFF)
+	{
+		a_session->passSize++;
+	}
+}
+
+/* Description:
+ * take a byte a_data of the new policy or time in the session of a keypad, they
+ * are used and the values in use are queued when the last byte is received
+ */
+void CONTROL_sessionValue(CONTROL_SessionType * a_session, uint8 a_data)
+{
+	POLICY_ConfigType policy;
+	uint8 * data = (uint8 *)&policy;
+	uint8 i;
+
+	a_session->pass[a_session->passSize] = a_data;
+	a_session->passSize++;
+
+	if (a_session->state == SESSION_SETTINGS)
+	{
+		if (a_session->passSize < sizeof(POLICY_ConfigType))
+		{
+			return;
+		}
+		for (i = 0; i < sizeof(POLICY_ConfigType); i++)
+		{
+			data[i] = a_session->pass[i];
+		}
+		CONTROL_setPolicy(&policy);
+
+		/* send back the policy in use */
+		CONTROL_queuePolicy(a_session);
+	}
+	else
+	{
+		if (a_session->passSize < SESSION_CLOCK_SIZE)
+		{
+			return;
+		}
+		CONTROL_setClock(a_session->pass[0], a_session->pass[1], a_session->pass[2]);
+
+		/* send back the wall clock in use */
+		CONTROL_queueWall(a_session);
+	}
+
+	CONTROL_sessionClear(a_session);
+	a_session->state = SESSION_OPTION;
+}
+
+/* Description:
+ * start the flow of the main option key a_option in the session of a keypad
+ */
+void CONTROL_sessionOption(CONTROL_SessionType * a_session, uint8 a_option)
+{
+	uint8 flag;
+	uint16 remaining;
+
+	flag = CONTROL_optionFlag(a_option, &remaining);
+
+	switch (flag)
+	{
+	/* the flows start with the password */
+	case '1':
+	case '2':
+	case SETTINGS:
+	case CLOCK_SET:
+		a_session->flow = flag;
+		a_session->state = SESSION_PASS;
+		CONTROL_queueReply(a_session, flag);
+		break;
+
+	/* send the remaining lockout seconds to be displayed by the HMI ECU */
+	case LOCKED:
+		CONTROL_queueReply(a_session, flag);
+		CONTROL_queueReply(a_session, (uint8)(remaining >> 8));
+		CONTROL_queueReply(a_session, (uint8)remaining);
+		break;
+
+	default:
+		CONTROL_queueReply(a_session, flag);
+		break;
+	}
+}
+
+/* Description:
+ * run the session of the keypad on a_node for what it sent. Every flow of every
+ * keypad goes on at the same time, a session only takes the bytes which are
+ * already received so a keypad stopping in the middle of a flow doesn't stop the
+ * others. It starts again from the main options when the keypad restarts.
+ */
+void CONTROL_session(uint8 a_node)
+{
+	CONTROL_SessionType * session = &g_sessions[a_node - 1];
+	uint8 passFlag;
+	uint8 data;
+
+	g_node = a_node;
+
+	/* a keypad which started gets the policy and the password state, the first
+	 * password is created before anything else
+	 */
+	if (BUS_isNew(a_node))
+	{
+		session->state = SESSION_OPTION;
+		session->flow = 0;
+		session->count = 0;
+		session->index = 0;
+		CONTROL_sessionClear(session);
+
+		CONTROL_queuePolicy(session);
+		EEPROM_readByte(EEPROM_PASS_FLAG_ADDRESS, &passFlag);
+		if (passFlag == EEPROM_PASS_MAGIC)
+		{
+			CONTROL_queueReply(session, PASS_STORED);
+		}
+		else
+		{
+			CONTROL_queueReply(session, PASS_EMPTY);
+			session->state = SESSION_NEW_PASS;
+		}
+		return;
+	}
+
+	if (session->state == SESSION_ABSENT)
+	{
+		return;
+	}
+
+	/* the replies are sent one by one as the keypad asks for them */
+	if (session->index != session->count)
+	{
+		if (BUS_isDataAvailable(a_node) && (BUS_receiveByte(a_node) == HMI_ECU_READY))
+		{
+			BUS_sendByte(a_node, session->replies[session->index]);
+			session->index++;
+		}
+		return;
+	}
+	session->count = 0;
+	session->index = 0;
+
+	/* the keypads take the door in turn */
+	if (session->state == SESSION_DOOR)
+	{
+		if (g_doorPhase == DOOR_IDLE)
+		{
+			CONTROL_doorStart(session->user);
+			CONTROL_queueReply(session, MATCHED);
+			session->state = SESSION_OPTION;
+		}
+		return;
+	}
+
+	if (!BUS_isDataAvailable(a_node))
+	{
+		return;
+	}
+	data = BUS_receiveByte(a_node);
+
+	switch (session->state)
+	{
+	case SESSION_OPTION:
+		CONTROL_sessionOption(session, data);
+		break;
+
+	case SESSION_PASS:
+	case SESSION_NEW_PASS:
+	case SESSION_CONFIRM:
+		if (data != PASS_END)
+		{
+			CONTROL_sessionChar(session, data);
+		}
+		else if (session->state == SESSION_PASS)
+		{
+			CONTROL_sessionPass(session);
+		}
+		else if (session->state == SESSION_NEW_PASS)
+		{
+			session->state = SESSION_CONFIRM;
+		}
+		else
+		{
+			CONTROL_sessionNewPass(session);
+		}
+		break;
+
+	case SESSION_SETTINGS:
+	case SESSION_CLOCK:
+		CONTROL_sessionValue(session, data);
+		break;
+	}
+}
+#endif
+
+int main (void)
+{
+#if BUS_ENABLED
+	uint8 node;
+#else
+	/* FALSE if no HMI ECU answered the negotiation, it asks for it later */
+	uint8 linked;
+#endif
+	/* TRUE if the last main loop pass had nothing to do */
+	uint8 idle = TRUE;
+
+	/* enable interrupt for the timer function*/
+	SREG |= (1<<7) ;
+
+	/* switch off the unused peripherals */
+	POWER_init();
+
+	/* start the real-time clock, it is the time base of the performance counters */
+	CLOCK_init();
+	DIAG_init();
+
+#if BUS_ENABLED
+	/* poll the keypads on the bus, every one is started when it first answers */
+	BUS_init();
+#else
+	/* UART Configuration */
+	UART_ConfigType uartType = {EIGHT_BIT, DISABLED, ONE_BIT, 9600};
+	/* UART initialization */
+	UART_init(&uartType);
+
+	/* step up to the fastest baud rate which works with the HMI ECU */
+	linked = (BAUD_negotiateMaster() != BAUD_NO_SLAVE);
+#endif
+
+	/* TWI Configuration */
+	TWI_ConfigType twiType = {TWI_BITRATE, TWI_ADDRESS};
+	/* TWI initialization */
+	TWI_init(&twiType);
+
+	/* initializing DcMotor */
+	DcMotor_init();
+
+	/* initializing buzzer */
+	Buzzer_init();
+
+	/* load the policy and send it to the HMI ECU */
+	CONFIG_init();
+#if !BUS_ENABLED
+	if (linked)
+	{
+		CONTROL_sendPolicy();
+	}
+#endif
+
+	/* load the failed attempts and continue the lockout if it was interrupted by a power cycle */
+	LOCKOUT_init();
+
+	/* load which user groups have an access schedule */
+	SCHEDULE_init();
+
+	/* load the header of the credential table of the users */
+	CRED_init();
+
+	/* find the end of the audit log and record the start */
+	LOG_init();
+	LOG_append(LOG_EVENT_BOOT, LOG_USER_NONE, LOG_RESULT_SUCCESS);
+
+#if BUS_ENABLED
+	for (;;)
+	{
+		/* account the time of the last pass as idle or busy */
+		DIAG_mainLoop(idle);
+
+		/* store the lockout record if the lockout ended in the timer ISR */
+		LOCKOUT_service();
+		CONTROL_doorService();
+
+		/* serve every keypad for what it sent since the last pass */
+		idle = TRUE;
+		for (node = 1; node <= BOARD_BUS_NODES; node++)
+		{
+			if (BUS_isDataAvailable(node))
+			{
+				idle = FALSE;
+			}
+			CONTROL_session(node);
+		}
+
+		/* the interrupts are disabled for the last check, a byte or a lockout end
+		 * coming after it wakes the CPU
+		 */
+		cli();
+		for (node = 1; idle && (node <= BOARD_BUS_NODES); node++)
+		{
+			idle = !BUS_isDataAvailable(node);
+		}
+		if (idle && !LOCKOUT_isServicePending())
+		{
+			/* sleep until a bus interrupt or a timer interrupt (lockout, clock, door) */
+			POWER_sleep(POWER_WAKE_UART | POWER_WAKE_TIMER1 | POWER_WAKE_TIMER2);
+		}
+		else
+		{
+			sei();
+		}
+	}
+#else
+	/* compare passwords and store it in the EEPROM at the start if there is no stored password */
+	if (linked)
+	{
+		CONTROL_sendPassState();
+	}
+
+	for (;;)
+	{
+		/* account the time of the last pass as idle or busy */
+		DIAG_mainLoop(idle);
+
+		/* store the lockout record if the lockout ended in the timer ISR */
+		LOCKOUT_service();
+
+		/* don't block on the UART so the lockout is handled while the HMI ECU is idle,
+		 * the interrupts are disabled for the check as in UART_receiveByte
+		 */
+		cli();
+		idle = !UART_isDataAvailable();
+		if (idle)
+		{
+			if (!LOCKOUT_isServicePending())
+			{
+				/* sleep until a byte from the HMI ECU or a timer interrupt (lockout, clock) */
+				POWER_sleep(POWER_WAKE_UART | POWER_WAKE_TIMER1 | POWER_WAKE_TIMER2);
+			}
+			else
+			{
+				sei();
+			}
+			continue;
+		}
+		sei();
+
+		/* the bytes come with errors when the HMI ECU runs at another rate, they
+		 * are dropped without a reply until the rate is back at the default one
+		 */
+		switch (BAUD_checkLink())
+		{
+		case BAUD_LINK_ERROR:
+			continue;
+		case BAUD_LINK_LOST:
+			CONTROL_relink();
+			continue;
+		}
+
+		switch (CONTROL_mainOptions())
+		{
+		/* if the user choose '+' then go to open door function */
+		case '1':
+			CONTROL_openDoor();
+			break;
+
+		/* if the user choose '-' then go to change password function */
+		case '2':
+			CONTROL_changePass();
+			break;
+
+		/* if the user choose '*' then go to change policy function */
+		case SETTINGS:
+			CONTROL_settings();
+			break;
+
+		/* if the user choose '=' then send the trace buffers */
+		case TRACE_DUMP:
+			CONTROL_traceDump();
+			break;
+
+		/* if the user choose '%' then send the performance counters */
+		case DIAGNOSTICS:
+			CONTROL_diagnostics();
+			break;
+
+		/* if the user choose '#' then '0' then send the audit log */
+		case LOG_EXPORT:
+			CONTROL_logExport();
+			break;
+
+		/* if the host tool sends 'P' then write the credential image */
+		case PROVISION:
+			CONTROL_provision();
+			break;
+
+		/* if the user choose '#' then '1' then set the wall clock */
+		case CLOCK_SET:
+			CONTROL_clock();
+			break;
+
+		/* if the HMI ECU starts the baud rate negotiation */
+		case BAUD_READY:
+			CONTROL_relink();
 			break;
 
 		/* else, ask the user to enter the option he want again by
 		 * repeating the loop */
 		}
 	}
+#endif
 
 }
@@ -0,0 +1,113 @@
+/*
+ * cred_store.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: source file of the storage of the credential table read by
+ *      			 credential.c, in the external EEPROM or in the flash
+ */
+
+#include "cred_store.h"
+#include "external_eeprom.h"
+
+#if (BOARD_CRED_STORE == BOARD_CRED_FLASH)
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static uint8 CSTORE_pageChunk(uint16 a_offset, uint8 * a_chunk);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/* Description:
+ * read the EEPROM_PAGE_SIZE bytes of the flash region from a_offset as they
+ * must be, the bytes after the credential area are erased
+ */
+static uint8 CSTORE_pageChunk(uint16 a_offset, uint8 * a_chunk)
+{
+	uint8 i;
+
+	if (a_offset >= EEPROM_CRED_SIZE)
+	{
+		for (i = 0; i < EEPROM_PAGE_SIZE; i++)
+		{
+			a_chunk[i] = 0xFF;
+		}
+		return SUCCESS;
+	}
+	return EEPROM_readBlock(EEPROM_CRED_ADDRESS + a_offset, a_chunk, EEPROM_PAGE_SIZE);
+}
+
+/* every flash page is compared with the EEPROM, then erased and read again from
+ * the EEPROM in the page buffer if it differs. A failed EEPROM read leaves it
+ * erased, the table is then found wrong by its CRC until the next CSTORE_init.
+ */
+uint8 CSTORE_init(void)
+{
+	uint8 chunk[EEPROM_PAGE_SIZE];
+	uint8 stored[EEPROM_PAGE_SIZE];
+	uint8 written = 0;
+	uint16 page;
+	uint16 offset;
+	uint8 same;
+	uint8 i;
+
+	for (page = 0; page < FLASH_DATA_SIZE; page += FLASH_PAGE_SIZE)
+	{
+		same = TRUE;
+		for (offset = page; same && (offset < (page + FLASH_PAGE_SIZE)); offset += EEPROM_PAGE_SIZE)
+		{
+			if (CSTORE_pageChunk(offset, chunk) == ERROR)
+			{
+				return written;
+			}
+			FLASH_read(offset, stored, EEPROM_PAGE_SIZE);
+			for (i = 0; i < EEPROM_PAGE_SIZE; i++)
+			{
+				same = same && (chunk[i] == stored[i]);
+			}
+		}
+		if (same)
+		{
+			continue;
+		}
+
+		FLASH_erasePage(page);
+		for (offset = page; offset < (page + FLASH_PAGE_SIZE); offset += EEPROM_PAGE_SIZE)
+		{
+			if (CSTORE_pageChunk(offset, chunk) == ERROR)
+			{
+				FLASH_dropPage();
+				return written;
+			}
+			FLASH_fillPage(offset, chunk, EEPROM_PAGE_SIZE);
+		}
+		FLASH_writePage(page);
+		written++;
+	}
+
+	return written;
+}
+
+uint8 CSTORE_read(uint16 a_offset, uint8 * a_data, uint8 a_size)
+{
+	FLASH_read(a_offset, a_data, a_size);
+	return SUCCESS;
+}
+
+#else
+
+uint8 CSTORE_init(void)
+{
+	return 0;
+}
+
+uint8 CSTORE_read(uint16 a_offset, uint8 * a_data, uint8 a_size)
+{
+	return EEPROM_readBlock(EEPROM_CRED_ADDRESS + a_offset, a_data, a_size);
+}
+
+#endif /* BOARD_CRED_STORE */
@@ -0,0 +1,55 @@
+/*
+ * cred_store.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: header file of the storage of the credential table read by
+ *      			 credential.c, in the external EEPROM or in the flash
+ *
+ *      BOARD_CRED_STORE (board_config.h) selects the storage at build time:
+ *      1. BOARD_CRED_EEPROM: the credential area of the EEPROM is read on the TWI,
+ *         about 270us for a record at 400 kHz.
+ *      2. BOARD_CRED_FLASH: the credential area is copied in the data region of
+ *         the flash (flash.h) and read with lpm, a record in a few us. The EEPROM
+ *         stays the master copy written by the provisioning (provision.h), the
+ *         copy is made by CSTORE_init at boot and after the provisioning: only
+ *         the flash pages which differ from the EEPROM are written, so the flash
+ *         is written once per new table. The interrupts are disabled for about
+ *         4.5ms by every erase and write of a page (flash.h), no UART session is
+ *         running then.
+ */
+
+#ifndef CRED_STORE_H_
+#define CRED_STORE_H_
+
+#include "std_types.h"
+#include "board_config.h"
+#include "eeprom_map.h"
+
+#if (BOARD_CRED_STORE == BOARD_CRED_FLASH)
+#include "flash.h"
+
+#if (EEPROM_CRED_SIZE > FLASH_DATA_SIZE)
+#error "cred_store.h: the credential area doesn't fit in the data region of the flash"
+#endif
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Make the storage hold the credential area of the EEPROM, nothing to do for
+ * the EEPROM. Return the number of flash pages written.
+ */
+uint8 CSTORE_init(void);
+
+/*
+ * Description :
+ * Read a_size bytes of the credential area from a_offset. Return SUCCESS or
+ * ERROR if the EEPROM failed.
+ */
+uint8 CSTORE_read(uint16 a_offset, uint8 * a_data, uint8 a_size);
+
+#endif /* CRED_STORE_H_ */
@@ -0,0 +1,138 @@
+/*
+ * credential.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: source file of the credential table of the users kept in the
+ *      			 external EEPROM or in the flash
+ */
+
+#include "credential.h"
+#include "cred_store.h"
+#include <util/crc16.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* RAM copy of the header, the salt and the displacements, the records stay in the storage */
+static uint16 g_count = 0;
+static uint16 g_buckets = 0;
+static uint8 g_salt[DIGEST_SALT_SIZE];
+static uint16 g_displacements[CRED_BUCKETS_MAX];
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void CRED_init(void)
+{
+	uint8 page[EEPROM_PAGE_SIZE];
+	uint16 crc = 0xFFFF;
+	uint16 stored;
+	uint16 count;
+	uint16 buckets;
+	uint16 offset;
+	uint16 end;
+	uint8 size;
+	uint8 i;
+
+	g_count = 0;
+	CSTORE_init();
+
+	if ((CSTORE_read(0, page, EEPROM_PAGE_SIZE) == ERROR)
+		|| (page[CRED_HEADER_VERSION] != CRED_VERSION))
+	{
+		return;
+	}
+
+	count = page[CRED_HEADER_COUNT] | ((uint16)page[CRED_HEADER_COUNT + 1] << 8);
+	buckets = page[CRED_HEADER_BUCKETS] | ((uint16)page[CRED_HEADER_BUCKETS + 1] << 8);
+	stored = page[CRED_HEADER_CRC] | ((uint16)page[CRED_HEADER_CRC + 1] << 8);
+
+	/* the displacements must fit in the RAM and the records in the area */
+	if ((buckets > CRED_BUCKETS_MAX) || ((buckets == 0) != (count == 0))
+		|| (count > ((EEPROM_CRED_SIZE - CRED_TABLE_OFFSET(buckets)) / CRED_RECORD_SIZE)))
+	{
+		return;
+	}
+
+	for (i = 0; i < CRED_HEADER_CRC; i++)
+	{
+		crc = _crc_ccitt_update(crc, page[i]);
+	}
+
+	/* the salt, the displacements and the records are read a page at a time */
+	end = CRED_TABLE_OFFSET(buckets) + (count * CRED_RECORD_SIZE);
+	for (offset = CRED_SALT_OFFSET; offset < end; offset += size)
+	{
+		size = ((end - offset) < EEPROM_PAGE_SIZE) ? (uint8)(end - offset) : EEPROM_PAGE_SIZE;
+		if (CSTORE_read(offset, page, size) == ERROR)
+		{
+			return;
+		}
+		for (i = 0; i < size; i++)
+		{
+			crc = _crc_ccitt_update(crc, page[i]);
+
+			if ((offset + i) < (CRED_SALT_OFFSET + DIGEST_SALT_SIZE))
+			{
+				g_salt[offset + i - CRED_SALT_OFFSET] = page[i];
+			}
+			else if (((offset + i) >= CRED_DISPLACEMENT_OFFSET)
+				&& ((offset + i) < (CRED_DISPLACEMENT_OFFSET + (buckets * 2))))
+			{
+				/* low byte first */
+				if (((offset + i) & 1) == 0)
+				{
+					g_displacements[(offset + i - CRED_DISPLACEMENT_OFFSET) / 2] = page[i];
+				}
+				else
+				{
+					g_displacements[(offset + i - CRED_DISPLACEMENT_OFFSET) / 2] |= (uint16)page[i] << 8;
+				}
+			}
+		}
+	}
+
+	if (crc == stored)
+	{
+		g_buckets = buckets;
+		g_count = count;
+	}
+}
+
+uint16 CRED_count(void)
+{
+	return g_count;
+}
+
+const uint8 * CRED_salt(void)
+{
+	return g_salt;
+}
+
+uint8 CRED_find(const uint8 * a_digest, CRED_UserType * a_user)
+{
+	uint8 record[CRED_RECORD_SIZE];
+	uint16 slot;
+
+	if (g_count == 0)
+	{
+		return FALSE;
+	}
+
+	/* the only record the PIN can be, a PIN of nobody gets the record of a user
+	 * so its tag is checked
+	 */
+	slot = CRED_SLOT(a_digest, g_displacements[CRED_BUCKET(a_digest, g_buckets)], g_count);
+	if ((CSTORE_read(CRED_TABLE_OFFSET(g_buckets) + (slot * CRED_RECORD_SIZE), record, CRED_RECORD_SIZE) == ERROR)
+		|| !DIGEST_equal(record, a_digest, CRED_TAG_SIZE))
+	{
+		return FALSE;
+	}
+
+	a_user->group = record[CRED_RECORD_GROUP];
+	a_user->id = record[CRED_RECORD_USER] | ((uint16)record[CRED_RECORD_USER + 1] << 8);
+	return TRUE;
+}
@@ -0,0 +1,137 @@
+/*
+ * credential.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: header file of the credential table of the users kept in the
+ *      			 external EEPROM or in the flash
+ *
+ *      The table is built on the host by Host_Sim/tools/credential_compile and
+ *      written by the provisioning (provision.h). The users open the door with
+ *      their PIN, the main password stays the only one for the other options.
+ *      The credential area (EEPROM_CRED_ADDRESS) holds:
+ *      1. the header page: CRED_VERSION, the number of users and of buckets
+ *         (low byte first) and at CRED_HEADER_CRC the CRC-CCITT of the header
+ *         bytes before it and of every byte after the header page up to the end
+ *         of the table, low byte first.
+ *      2. the salt page: the DIGEST_SALT_SIZE bytes of the salt of the table.
+ *      3. the displacements: one of 2 bytes for every bucket, low byte first,
+ *         padded to a whole page. They are kept in RAM by CRED_init.
+ *      4. the records: the first CRED_TAG_SIZE bytes of the digest of the PIN
+ *         keyed by the salt, the group of the user and its ID (low byte first).
+ *      The records are placed by a minimal perfect hash of the digest built by
+ *      the compiler (CHD): the digest gives its bucket (CRED_BUCKET) and the
+ *      displacement of the bucket gives the record (CRED_SLOT), every user has
+ *      its own record and no record is empty. A PIN is looked up with exactly one
+ *      read of a record whatever the number of users, the tag of the record is
+ *      checked as any other PIN also gives a record.
+ *
+ *      The area is read through cred_store.h, from the EEPROM or from its copy in
+ *      the flash (BOARD_CRED_STORE).
+ *
+ *      An erased area, another version, more buckets than CRED_BUCKETS_MAX or a
+ *      wrong CRC leaves the table empty.
+ */
+
+#ifndef CREDENTIAL_H_
+#define CREDENTIAL_H_
+
+#include "std_types.h"
+#include "eeprom_map.h"
+#include "external_eeprom.h"
+#include "digest.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* first byte of the header, changed whenever the layout changes */
+#define CRED_VERSION			3
+
+/* bytes of the header page */
+#define CRED_HEADER_VERSION		0
+#define CRED_HEADER_COUNT		2
+#define CRED_HEADER_BUCKETS		4
+#define CRED_HEADER_CRC			(EEPROM_PAGE_SIZE - 2)
+
+#define CRED_SALT_OFFSET		EEPROM_PAGE_SIZE
+#define CRED_DISPLACEMENT_OFFSET	(2 * EEPROM_PAGE_SIZE)
+
+#define CRED_TAG_SIZE			5
+#define CRED_RECORD_GROUP		CRED_TAG_SIZE
+#define CRED_RECORD_USER		(CRED_TAG_SIZE + 1)
+#define CRED_RECORD_SIZE		8
+
+/* users per bucket the compiler starts from, less if the hash isn't found */
+#define CRED_BUCKET_KEYS		4
+
+/* displacements kept in RAM, 2 bytes each */
+#ifndef CRED_BUCKETS_MAX
+#define CRED_BUCKETS_MAX		32
+#endif
+
+/* bytes of the displacements and offset of the records for a_buckets buckets */
+#define CRED_DISPLACEMENT_SIZE(buckets)	((((buckets) * 2UL) + EEPROM_PAGE_SIZE - 1UL) & ~(EEPROM_PAGE_SIZE - 1UL))
+#define CRED_TABLE_OFFSET(buckets)		(CRED_DISPLACEMENT_OFFSET + CRED_DISPLACEMENT_SIZE(buckets))
+
+/* the minimal perfect hash of a digest of DIGEST_TAG_SIZE bytes, its 16-bit
+ * values are reduced to a range by a multiplication instead of a division
+ */
+#define CRED_HASH(digest, byte)			(((uint16)(digest)[byte] << 8) | (digest)[(byte) + 1])
+#define CRED_BUCKET(digest, buckets)	((uint16)(((uint32)CRED_HASH(digest, 6) * (buckets)) >> 16))
+#define CRED_SLOT(digest, displacement, count) \
+	((uint16)(((uint32)(uint16)(CRED_HASH(digest, 0) + ((uint32)(displacement) * (CRED_HASH(digest, 2) | 1U))) \
+		* (count)) >> 16))
+
+/* the audit log keeps 8-bit user IDs, the users after LOG_USER_NONE - 1 are logged as LOG_USER_NONE */
+#define CRED_LOG_USER(user)		(((user) < 0xFF) ? (uint8)(user) : (uint8)0xFF)
+
+#if ((EEPROM_CRED_ADDRESS % EEPROM_PAGE_SIZE) != 0) || (EEPROM_CRED_SIZE < CRED_TABLE_OFFSET(1)) \
+	|| ((EEPROM_CRED_ADDRESS + EEPROM_CRED_SIZE) > (EEPROM_IMAGE_ADDRESS + EEPROM_IMAGE_SIZE))
+#error "credential.h: the credential area must be whole pages of the image area"
+#endif
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/* a user found by its PIN */
+typedef struct
+{
+	uint16	id		;
+	uint8	group	;
+} CRED_UserType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Update the storage of the table (CSTORE_init), load the header and the
+ * displacements of the table and check its CRC, the table is empty if it is
+ * wrong. It is called again after the provisioning.
+ */
+void CRED_init(void);
+
+/*
+ * Description :
+ * Return the number of users of the table.
+ */
+uint16 CRED_count(void);
+
+/*
+ * Description :
+ * Return the salt of the digests of the table, DIGEST_SALT_SIZE bytes.
+ */
+const uint8 * CRED_salt(void);
+
+/*
+ * Description :
+ * Find the user of a_digest (the DIGEST_TAG_SIZE bytes of the digest of its
+ * PIN keyed by CRED_salt) with one read of the storage. Return TRUE with the
+ * user in a_user.
+ */
+uint8 CRED_find(const uint8 * a_digest, CRED_UserType * a_user);
+
+#endif /* CREDENTIAL_H_ */
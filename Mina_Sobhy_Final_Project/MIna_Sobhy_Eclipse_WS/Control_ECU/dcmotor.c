@@ -50,6 +50,11 @@ void DcMotor_Rotate(DcMotor_State a_state, uint8 a_speed)
 	{
 		/* incorrect speed so do nothing */
 	}
+	else if (a_speed == 0)
+	{
+		/* stop Timer0 while the motor is off to save power */
+		PWM_Timer0_Stop();
+	}
 	else
 	{
 		/* convert the speed form percentage to bits according to the register size(256)
@@ -10,18 +10,13 @@
 #define DCMOTOR_H_
 
 #include "std_types.h"
+#include "board_config.h"
 
 /*******************************************************************************
  *                                Definitions                                  *
  *******************************************************************************/
 
-//Define ports
-#define DCmotor_PORTA PORTB_ID
-#define DCmotor_PORTB PORTB_ID
-
-//Define pins
-#define DCmotor_PINA PIN1_ID
-#define DCmotor_PINB PIN2_ID
+//Define ports and pins in board_config.h
 
 /*******************************************************************************
  *                         Types Declaration                                   *
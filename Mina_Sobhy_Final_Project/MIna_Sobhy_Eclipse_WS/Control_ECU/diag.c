@@ -0,0 +1,124 @@
+/*
+ * diag.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: source file of the performance counters of the CONTROL_ECU
+ */
+
+#include "diag.h"
+#include "uart.h"
+#include "stack.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+DIAG_CountersType g_diag = {.version = DIAG_VERSION};
+
+/* main loop time accounting since the last frame, in DIAG_now counts */
+static uint32 g_loopLast = 0;
+static uint32 g_loopIdle = 0;
+static uint32 g_loopTotal = 0;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static uint32 DIAG_add(uint32 a_total, uint32 a_value);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void DIAG_init(void)
+{
+	g_loopLast = DIAG_now();
+}
+
+uint32 DIAG_now(void)
+{
+	return CLOCK_counts();
+}
+
+/* Description:
+ * return a_total + a_value, or 0xFFFFFFFF if the sum doesn't fit
+ */
+static uint32 DIAG_add(uint32 a_total, uint32 a_value)
+{
+	if (a_total > (0xFFFFFFFFUL - a_value))
+	{
+		return 0xFFFFFFFFUL;
+	}
+	return a_total + a_value;
+}
+
+void DIAG_eepromAccess(uint8 a_write, uint32 a_start, uint8 a_ok)
+{
+	uint32 cycles = (DIAG_now() - a_start) * DIAG_TICK_CYCLES;
+
+	if (a_write)
+	{
+		DIAG_COUNT(eeprom_writes);
+		g_diag.eeprom_write_cycles = DIAG_add(g_diag.eeprom_write_cycles, cycles);
+	}
+	else
+	{
+		DIAG_COUNT(eeprom_reads);
+		g_diag.eeprom_read_cycles = DIAG_add(g_diag.eeprom_read_cycles, cycles);
+	}
+
+	if (!a_ok)
+	{
+		DIAG_COUNT(twi_errors);
+	}
+}
+
+void DIAG_mainLoop(uint8 a_idle)
+{
+	uint32 now = DIAG_now();
+	uint32 elapsed = now - g_loopLast;
+
+	g_loopLast = now;
+	g_loopTotal += elapsed;
+	if (a_idle)
+	{
+		g_loopIdle += elapsed;
+	}
+
+	if (g_loopTotal >= DIAG_IDLE_WINDOW_LIMIT)
+	{
+		g_loopTotal >>= 1;
+		g_loopIdle >>= 1;
+	}
+}
+
+void DIAG_send(void)
+{
+	const uint8 * frame;
+	DIAG_CountersType counters;
+	uint8 sreg;
+	uint8 i;
+
+	/* the idle time is never more than the total, so the result is at most 100 */
+	g_diag.idle_percent = (uint8)(g_loopIdle / ((g_loopTotal / 100) + 1));
+	g_diag.stack_high_water = STACK_highWater();
+
+	/* take a copy as isr_max_latency and uart_errors are changed by the ISRs */
+	sreg = SREG;
+	cli();
+	counters = g_diag;
+	SREG = sreg;
+	frame = (const uint8 *)&counters;
+
+	UART_sendByte(sizeof(DIAG_CountersType));
+	for (i = 0; i < sizeof(DIAG_CountersType); i++)
+	{
+		UART_sendByte(frame[i]);
+	}
+
+	g_loopIdle = 0;
+	g_loopTotal = 0;
+}
@@ -0,0 +1,117 @@
+/*
+ * diag.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: header file of the performance counters of the CONTROL_ECU,
+ *      			 they are sent to the HMI_ECU in one frame by the hidden
+ *      			 diagnostics option ('%') and can be read on the UART lines
+ *
+ *      The real-time clock (clock.h) is the time base of the cycle counters, its
+ *      Timer2 overflow interrupt also measures how late an interrupt can be served.
+ *      All the counters saturate at their maximum value instead of rolling over.
+ */
+
+#ifndef DIAG_H_
+#define DIAG_H_
+
+#include "std_types.h"
+#include "clock.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* changed whenever the counters record layout changes */
+#define DIAG_VERSION			2
+
+/* CPU cycles of one time base count, a crystal period (244.14 cycles at 8 MHz) */
+#define DIAG_TICK_CYCLES		CLOCK_COUNT_CYCLES
+
+/* idle time is accounted since the last diagnostics frame, the two sums are
+ * halved when the total reaches this limit so the percentage stays right
+ */
+#define DIAG_IDLE_WINDOW_LIMIT	0x80000000UL
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/* sent as it is on the UART, so it is packed even without -fpack-struct */
+typedef struct __attribute__((packed))
+{
+	uint8	version				; /* DIAG_VERSION */
+	uint16	uart_rx_bytes		; /* bytes received by UART_receiveByte */
+	uint16	uart_tx_bytes		; /* bytes sent by UART_sendByte and UART_sendBlock */
+	uint16	uart_errors			; /* bytes with a frame, overrun or parity error or lost in a full Rx buffer */
+	uint16	eeprom_reads		; /* EEPROM_readByte and EEPROM_readBlock calls */
+	uint16	eeprom_writes		; /* EEPROM_writeByte and EEPROM_writeBlock calls */
+	uint32	eeprom_read_cycles	; /* CPU cycles spent in the EEPROM reads */
+	uint32	eeprom_write_cycles	; /* CPU cycles spent in the EEPROM writes */
+	uint16	twi_errors			; /* EEPROM accesses stopped by an unexpected TWI_getStatus */
+	uint16	unlock_attempts		; /* passwords checked by CONTROL_checkPass */
+	uint16	door_cycles			; /* completed door unlock, hold and lock cycles */
+	uint16	isr_max_latency		; /* CPU cycles, worst delay of the Timer2 overflow interrupt to DIAG_TICK_CYCLES */
+	uint8	idle_percent		; /* main loop time spent waiting since the last frame */
+	uint16	stack_high_water	; /* bytes, deepest stack since the reset (STACK_highWater) */
+} DIAG_CountersType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+extern DIAG_CountersType g_diag;
+
+/*
+ * Description :
+ * Add one to a uint16 counter of g_diag, it stays at 0xFFFF when reached.
+ * Only used in the main context and for uart_errors in the UART receive
+ * interrupt, the Timer2 ISR only changes isr_max_latency.
+ */
+#define DIAG_COUNT(counter) \
+	do { if (g_diag.counter != 0xFFFF) { g_diag.counter++; } } while (0)
+
+/*
+ * Description :
+ * Add a_value to a uint16 counter of g_diag, it stays at 0xFFFF when reached.
+ * Same contexts as DIAG_COUNT.
+ */
+#define DIAG_ADD(counter, value) \
+	do { uint16 diagRoom = 0xFFFF - g_diag.counter; \
+		g_diag.counter = (diagRoom > (uint16)(value)) ? \
+			(uint16)(g_diag.counter + (uint16)(value)) : 0xFFFF; } while (0)
+
+/*
+ * Description :
+ * Start the idle time accounting, the clock must be started (CLOCK_init).
+ */
+void DIAG_init(void);
+
+/*
+ * Description :
+ * Return the time in counts of DIAG_TICK_CYCLES cycles.
+ */
+uint32 DIAG_now(void);
+
+/*
+ * Description :
+ * Count an EEPROM access started at a_start (DIAG_now) and its TWI error.
+ * a_write is TRUE for a write and a_ok is FALSE if the access returned ERROR.
+ */
+void DIAG_eepromAccess(uint8 a_write, uint32 a_start, uint8 a_ok);
+
+/*
+ * Description :
+ * Called once every pass of the main loop, a_idle is TRUE if the previous
+ * pass found nothing to do.
+ */
+void DIAG_mainLoop(uint8 a_idle);
+
+/*
+ * Description :
+ * Send the counters on the UART: the frame size then the DIAG_CountersType bytes.
+ * The idle accounting restarts after every frame.
+ */
+void DIAG_send(void);
+
+#endif /* DIAG_H_ */
@@ -0,0 +1,196 @@
+/*
+ * digest.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: source file for the password digest
+ */
+
+#include "digest.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define ROTL(x,b)	(uint64)(((x) << (b)) | ((x) >> (64 - (b))))
+
+/* the host simulation charges the cycles of the rounds to its virtual clock
+ * (Host_Sim/CMakeLists.txt), nothing is done on the target
+ */
+#ifndef DIGEST_SIM_CYCLES
+#define DIGEST_SIM_CYCLES(cycles)
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static uint64 DIGEST_load(const uint8 * a_data);
+static void DIGEST_rounds(DIGEST_StateType * a_state, uint8 a_rounds);
+static void DIGEST_compress(DIGEST_StateType * a_state);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/* Description:
+ * read 8 bytes as a little endian 64-bit word
+ */
+static uint64 DIGEST_load(const uint8 * a_data)
+{
+	uint64 word = 0;
+	uint8 i;
+
+	for (i = 8; i > 0; i--)
+	{
+		word = (word << 8) | a_data[i - 1];
+	}
+
+	return word;
+}
+
+/* Description:
+ * SipRound repeated the required number of times
+ */
+static void DIGEST_rounds(DIGEST_StateType * a_state, uint8 a_rounds)
+{
+	/* work on local copies so the compiler can keep them in registers */
+	uint64 v0 = a_state->v[0];
+	uint64 v1 = a_state->v[1];
+	uint64 v2 = a_state->v[2];
+	uint64 v3 = a_state->v[3];
+
+	DIGEST_SIM_CYCLES((uint32)a_rounds * DIGEST_ROUND_CYCLES);
+
+	while (a_rounds--)
+	{
+		v0 += v1;
+		v1 = ROTL(v1, 13);
+		v1 ^= v0;
+		v0 = ROTL(v0, 32);
+		v2 += v3;
+		v3 = ROTL(v3, 16);
+		v3 ^= v2;
+		v0 += v3;
+		v3 = ROTL(v3, 21);
+		v3 ^= v0;
+		v2 += v1;
+		v1 = ROTL(v1, 17);
+		v1 ^= v2;
+		v2 = ROTL(v2, 32);
+	}
+
+	a_state->v[0] = v0;
+	a_state->v[1] = v1;
+	a_state->v[2] = v2;
+	a_state->v[3] = v3;
+}
+
+/* Description:
+ * compress the full block in the state with 2 rounds
+ */
+static void DIGEST_compress(DIGEST_StateType * a_state)
+{
+	uint64 m = DIGEST_load(a_state->block);
+
+	a_state->v[3] ^= m;
+	DIGEST_rounds(a_state, 2);
+	a_state->v[0] ^= m;
+}
+
+void DIGEST_init(DIGEST_StateType * a_state, const uint8 * a_salt)
+{
+	uint64 k0 = DIGEST_load(a_salt);
+	uint64 k1 = DIGEST_load(a_salt + 8);
+
+	a_state->v[0] = k0 ^ 0x736f6d6570736575ULL;
+	a_state->v[1] = k1 ^ 0x646f72616e646f6dULL;
+	a_state->v[2] = k0 ^ 0x6c7967656e657261ULL;
+	a_state->v[3] = k1 ^ 0x7465646279746573ULL;
+	a_state->length = 0;
+}
+
+void DIGEST_update(DIGEST_StateType * a_state, uint8 a_data)
+{
+	a_state->block[a_state->length % DIGEST_BLOCK_SIZE] = a_data;
+	a_state->length++;
+
+	if ((a_state->length % DIGEST_BLOCK_SIZE) == 0)
+	{
+		DIGEST_compress(a_state);
+	}
+}
+
+void DIGEST_final(DIGEST_StateType * a_state, uint8 * a_tag)
+{
+	uint64 m;
+	uint8 i;
+
+	/* the last block is the rest of the message padded with zeros and the length
+	 * in its last byte
+	 */
+	for (i = a_state->length % DIGEST_BLOCK_SIZE; i < (DIGEST_BLOCK_SIZE - 1); i++)
+	{
+		a_state->block[i] = 0;
+	}
+	a_state->block[DIGEST_BLOCK_SIZE - 1] = a_state->length;
+	DIGEST_compress(a_state);
+
+	/* finalization */
+	a_state->v[2] ^= 0xFF;
+	DIGEST_rounds(a_state, 4);
+	m = a_state->v[0] ^ a_state->v[1] ^ a_state->v[2] ^ a_state->v[3];
+
+	for (i = 0; i < DIGEST_TAG_SIZE; i++)
+	{
+		a_tag[i] = (uint8)m;
+		m >>= 8;
+	}
+
+	/* don't leave the password in the state */
+	DIGEST_clear(a_state);
+}
+
+void DIGEST_peek(const DIGEST_StateType * a_state, uint8 * a_tag)
+{
+	DIGEST_StateType state = *a_state;
+
+	DIGEST_final(&state, a_tag);
+}
+
+void DIGEST_clear(DIGEST_StateType * a_state)
+{
+	uint8 i;
+
+	for (i = 0; i < DIGEST_BLOCK_SIZE; i++)
+	{
+		a_state->block[i] = 0;
+	}
+}
+
+void DIGEST_calculate(const uint8 * a_salt, const uint8 * a_data, uint8 a_size, uint8 * a_tag)
+{
+	DIGEST_StateType state;
+	uint8 i;
+
+	DIGEST_init(&state, a_salt);
+	for (i = 0; i < a_size; i++)
+	{
+		DIGEST_update(&state, a_data[i]);
+	}
+	DIGEST_final(&state, a_tag);
+}
+
+uint8 DIGEST_equal(const uint8 * a_first, const uint8 * a_second, uint8 a_size)
+{
+	uint8 difference = 0;
+	uint8 i;
+
+	/* accumulate the differences without any early exit */
+	for (i = 0; i < a_size; i++)
+	{
+		difference |= a_first[i] ^ a_second[i];
+	}
+
+	return (difference == 0);
+}
@@ -0,0 +1,92 @@
+/*
+ * digest.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: header file for the password digest (SipHash-2-4 keyed by a
+ *      			 random salt) and the constant time comparison
+ */
+
+#ifndef DIGEST_H_
+#define DIGEST_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define DIGEST_SALT_SIZE	16	/* SipHash key size */
+#define DIGEST_TAG_SIZE		8	/* SipHash output size */
+
+/* standard SipHash-2-4: every full 8-byte block of the message is compressed by
+ * DIGEST_update as soon as it is received (2 rounds), the last partial block
+ * and the length by DIGEST_final with the finalization (2 + 4 rounds). The time
+ * depends on the message length only, never on its bytes.
+ */
+#define DIGEST_BLOCK_SIZE	8
+
+/* AVR cycles of one SipRound from the cycle model of Host_Sim/tools/digest_model.cpp,
+ * the host simulation adds them to its virtual clock for every round
+ */
+#define DIGEST_ROUND_CYCLES	1200
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+typedef struct
+{
+	uint64	v[4]	; /* SipHash internal state */
+	uint8	block[DIGEST_BLOCK_SIZE]; /* message block being filled */
+	uint8	length	; /* number of message bytes received, modulo 256 as SipHash */
+} DIGEST_StateType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Start a new digest keyed by the 16-byte salt.
+ */
+void DIGEST_init(DIGEST_StateType * a_state, const uint8 * a_salt);
+
+/*
+ * Description :
+ * Add one byte to the message, the block is compressed when it is full.
+ */
+void DIGEST_update(DIGEST_StateType * a_state, uint8 a_data);
+
+/*
+ * Description :
+ * Finish the digest and write the 8-byte tag.
+ */
+void DIGEST_final(DIGEST_StateType * a_state, uint8 * a_tag);
+
+/*
+ * Description :
+ * Write the tag of the bytes added so far without ending the digest, more bytes
+ * can be added after. It takes the time of DIGEST_final.
+ */
+void DIGEST_peek(const DIGEST_StateType * a_state, uint8 * a_tag);
+
+/*
+ * Description :
+ * Forget the message bytes kept in the state, for a digest ended by DIGEST_peek.
+ */
+void DIGEST_clear(DIGEST_StateType * a_state);
+
+/*
+ * Description :
+ * Calculate the digest of a whole message in one call.
+ */
+void DIGEST_calculate(const uint8 * a_salt, const uint8 * a_data, uint8 a_size, uint8 * a_tag);
+
+/*
+ * Description :
+ * Compare two buffers in a constant time, all the bytes are always compared so
+ * the time doesn't tell where the first difference is. Return TRUE if equal.
+ */
+uint8 DIGEST_equal(const uint8 * a_first, const uint8 * a_second, uint8 a_size);
+
+#endif /* DIGEST_H_ */
@@ -0,0 +1,62 @@
+/*
+ * eeprom_map.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: layout of the data stored in the external EEPROM
+ */
+
+#ifndef EEPROM_MAP_H_
+#define EEPROM_MAP_H_
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* image written in one session by the provisioning over the UART (provision.h),
+ * it is built on the host and holds the access schedules and the credentials
+ */
+#define EEPROM_IMAGE_ADDRESS		0x0000
+#define EEPROM_IMAGE_SIZE			0x0310
+
+/* access schedules, the group flags page then the week bitmaps (schedule.h),
+ * written by Host_Sim/tools/schedule_compile
+ */
+#define EEPROM_SCHEDULE_ADDRESS		0x0000
+#define EEPROM_SCHEDULE_SIZE		0x0160
+
+/* credential table of the users (credential.h), written by
+ * Host_Sim/tools/credential_compile
+ */
+#define EEPROM_CRED_ADDRESS			0x0160
+#define EEPROM_CRED_SIZE			0x01B0
+
+/* byte holding EEPROM_PASS_MAGIC once a password has been stored, a new
+ * (erased) EEPROM reads 0xFF so the system asks for a password at the start.
+ * The magic is changed whenever the stored password format changes.
+ */
+#define EEPROM_PASS_FLAG_ADDRESS	0x0310
+#define EEPROM_PASS_MAGIC			0xA8
+
+/* random salt and digest of the password, the password itself is never stored */
+#define EEPROM_PASS_SALT_ADDRESS	0x0340
+#define EEPROM_PASS_DIGEST_ADDRESS	0x0350
+
+/* lockout record (failed attempts, backoff level and remaining seconds),
+ * it is page aligned to be written in one page write cycle
+ */
+#define EEPROM_LOCKOUT_ADDRESS		0x0320
+
+/* policy record (password size, attempts, lockout and door timing) */
+#define EEPROM_CONFIG_ADDRESS		0x0360
+
+/* audit log index (first page of the last block of the ring and its lap), it is
+ * page aligned and only written when the log enters a new block of pages
+ */
+#define EEPROM_LOG_INDEX_ADDRESS	0x0370
+
+/* audit log ring of fixed size records, a whole number of pages */
+#define EEPROM_LOG_ADDRESS			0x0400
+#define EEPROM_LOG_SIZE				0x0400
+
+#endif /* EEPROM_MAP_H_ */
@@ -11,8 +11,85 @@
  *******************************************************************************/
 #include "external_eeprom.h"
 #include "twi.h"
+#include "diag.h"
 
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static uint8 EEPROM_writeByteBus(uint16 u16addr, uint8 u8data);
+static uint8 EEPROM_readByteBus(uint16 u16addr, uint8 *u8data);
+static uint8 EEPROM_writeBlockBus(uint16 u16addr, const uint8 *u8data, uint8 u8size);
+static uint8 EEPROM_readBlockBus(uint16 u16addr, uint8 *u8data, uint8 u8size);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/* the public functions count the access, its time and its TWI error in the
+ * diagnostics counters around the TWI transfer, the TWI is switched off after
+ * every transfer to save power
+ */
 uint8 EEPROM_writeByte(uint16 u16addr, uint8 u8data)
+{
+	uint32 start = DIAG_now();
+	uint8 status = EEPROM_writeByteBus(u16addr, u8data);
+
+	TWI_disable();
+	DIAG_eepromAccess(TRUE, start, (status == SUCCESS));
+	return status;
+}
+
+uint8 EEPROM_readByte(uint16 u16addr, uint8 *u8data)
+{
+	uint32 start = DIAG_now();
+	uint8 status = EEPROM_readByteBus(u16addr, u8data);
+
+	TWI_disable();
+	DIAG_eepromAccess(FALSE, start, (status == SUCCESS));
+	return status;
+}
+
+uint8 EEPROM_writeBlock(uint16 u16addr, const uint8 *u8data, uint8 u8size)
+{
+	uint32 start = DIAG_now();
+	uint8 status = EEPROM_writeBlockBus(u16addr, u8data, u8size);
+
+	TWI_disable();
+	DIAG_eepromAccess(TRUE, start, (status == SUCCESS));
+	return status;
+}
+
+uint8 EEPROM_readBlock(uint16 u16addr, uint8 *u8data, uint8 u8size)
+{
+	uint32 start = DIAG_now();
+	uint8 status = EEPROM_readBlockBus(u16addr, u8data, u8size);
+
+	TWI_disable();
+	DIAG_eepromAccess(FALSE, start, (status == SUCCESS));
+	return status;
+}
+
+uint8 EEPROM_isReady(void)
+{
+	uint8 ready = FALSE;
+
+	/* Send the Start Bit then the device address with R/W=0 (write) */
+	TWI_start();
+	if (TWI_getStatus() == TWI_START)
+	{
+		TWI_writeByte(0xA0);
+		ready = (TWI_getStatus() == TWI_MT_SLA_W_ACK);
+	}
+
+	/* Send the Stop Bit, nothing is written without the memory location address */
+	TWI_stop();
+	TWI_disable();
+
+	return ready;
+}
+
+static uint8 EEPROM_writeByteBus(uint16 u16addr, uint8 u8data)
 {
 	/* Send the Start Bit */
     TWI_start();
@@ -41,7 +118,7 @@ uint8 EEPROM_writeByte(uint16 u16addr, uint8 u8data)
     return SUCCESS;
 }
 
-uint8 EEPROM_readByte(uint16 u16addr, uint8 *u8data)
+static uint8 EEPROM_readByteBus(uint16 u16addr, uint8 *u8data)
 {
 	/* Send the Start Bit */
     TWI_start();
@@ -80,3 +157,94 @@ uint8 EEPROM_readByte(uint16 u16addr, uint8 *u8data)
 
     return SUCCESS;
 }
+
+static uint8 EEPROM_writeBlockBus(uint16 u16addr, const uint8 *u8data, uint8 u8size)
+{
+	uint8 i;
+
+	/* the memory wraps inside the page, so a block must fit in one page */
+	if (((u16addr % EEPROM_PAGE_SIZE) + u8size) > EEPROM_PAGE_SIZE)
+		return ERROR;
+
+	/* Send the Start Bit */
+    TWI_start();
+    if (TWI_getStatus() != TWI_START)
+        return ERROR;
+
+    /* Send the device address, we need to get A8 A9 A10 address bits from the
+     * memory location address and R/W=0 (write) */
+    TWI_writeByte((uint8)(0xA0 | ((u16addr & 0x0700)>>7)));
+    if (TWI_getStatus() != TWI_MT_SLA_W_ACK)
+        return ERROR;
+
+    /* Send the required memory location address */
+    TWI_writeByte((uint8)(u16addr));
+    if (TWI_getStatus() != TWI_MT_DATA_ACK)
+        return ERROR;
+
+    /* write the whole block in one page write cycle */
+    for (i = 0; i < u8size; i++)
+    {
+        TWI_writeByte(u8data[i]);
+        if (TWI_getStatus() != TWI_MT_DATA_ACK)
+            return ERROR;
+    }
+
+    /* Send the Stop Bit */
+    TWI_stop();
+
+    return SUCCESS;
+}
+
+static uint8 EEPROM_readBlockBus(uint16 u16addr, uint8 *u8data, uint8 u8size)
+{
+	uint8 i;
+
+	if (u8size == 0)
+		return SUCCESS;
+
+	/* Send the Start Bit */
+    TWI_start();
+    if (TWI_getStatus() != TWI_START)
+        return ERROR;
+
+    /* Send the device address, we need to get A8 A9 A10 address bits from the
+     * memory location address and R/W=0 (write) */
+    TWI_writeByte((uint8)((0xA0) | ((u16addr & 0x0700)>>7)));
+    if (TWI_getStatus() != TWI_MT_SLA_W_ACK)
+        return ERROR;
+
+    /* Send the required memory location address */
+    TWI_writeByte((uint8)(u16addr));
+    if (TWI_getStatus() != TWI_MT_DATA_ACK)
+        return ERROR;
+
+    /* Send the Repeated Start Bit */
+    TWI_start();
+    if (TWI_getStatus() != TWI_REP_START)
+        return ERROR;
+
+    /* Send the device address, we need to get A8 A9 A10 address bits from the
+     * memory location address and R/W=1 (Read) */
+    TWI_writeByte((uint8)((0xA0) | ((u16addr & 0x0700)>>7) | 1));
+    if (TWI_getStatus() != TWI_MT_SLA_R_ACK)
+        return ERROR;
+
+    /* sequential read: ACK every byte except the last one */
+    for (i = 0; i < (uint8)(u8size - 1); i++)
+    {
+        u8data[i] = TWI_readByteWithACK();
+        if (TWI_getStatus() != TWI_MR_DATA_ACK)
+            return ERROR;
+    }
+
+    /* Read the last Byte from Memory without send ACK */
+    u8data[i] = TWI_readByteWithNACK();
+    if (TWI_getStatus() != TWI_MR_DATA_NACK)
+        return ERROR;
+
+    /* Send the Stop Bit */
+    TWI_stop();
+
+    return SUCCESS;
+}
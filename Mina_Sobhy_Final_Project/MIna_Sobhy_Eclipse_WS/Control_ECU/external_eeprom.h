@@ -22,11 +22,23 @@
 #define ERROR 0
 #define SUCCESS 1
 
+/* 24C16 write page size, a block write must not cross a page boundary */
+#define EEPROM_PAGE_SIZE 16
+
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
 
 uint8 EEPROM_writeByte(uint16 u16addr,uint8 u8data);
 uint8 EEPROM_readByte(uint16 u16addr,uint8 *u8data);
+uint8 EEPROM_writeBlock(uint16 u16addr,const uint8 *u8data,uint8 u8size);
+uint8 EEPROM_readBlock(uint16 u16addr,uint8 *u8data,uint8 u8size);
+
+/*
+ * Description :
+ * Return TRUE if the memory acknowledges its address, it doesn't during the
+ * write cycle of a page (ACK polling). It isn't counted as an access.
+ */
+uint8 EEPROM_isReady(void);
  
 #endif /* EXTERNAL_EEPROM_H_ */
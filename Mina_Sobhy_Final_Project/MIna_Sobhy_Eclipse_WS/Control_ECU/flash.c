@@ -0,0 +1,106 @@
+/*
+ * flash.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: source file of the data region of the flash written by the
+ *      			 self-programming (SPM) of the ATmega32
+ */
+
+#include "board_config.h"
+
+#if (BOARD_CRED_STORE == BOARD_CRED_FLASH)
+
+#include "flash.h"
+#include "clock.h"
+#include <avr/io.h>
+#include <avr/boot.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+#if (FLASH_SPM_US >= (1000000UL / CLOCK_TICKS_PER_SECOND))
+#error "flash.c: an erase or a write of a page would lose Timer2 overflows of the clock"
+#endif
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* the region, its address is the one of the .flashdata section */
+static const uint8 g_data[FLASH_DATA_SIZE] __attribute__((section(".flashdata"), used, aligned(2))) =
+	{ [0 ... (FLASH_DATA_SIZE - 1)] = 0xFF };
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void FLASH_read(uint16 a_offset, uint8 * a_data, uint8 a_size)
+{
+	uint8 i;
+
+	for (i = 0; i < a_size; i++)
+	{
+		a_data[i] = pgm_read_byte(&g_data[a_offset + i]);
+	}
+}
+
+/* the SPM functions stay in the boot section, -flto mustn't inline them in the
+ * application
+ */
+BOOTLOADER_SECTION __attribute__((noinline)) void FLASH_erasePage(uint16 a_offset)
+{
+	uint8 sreg = SREG;
+	uint16 page = (uint16)&g_data[a_offset & ~(FLASH_PAGE_SIZE - 1)];
+
+	/* the erase and the write are made with the interrupts enabled between
+	 * them, so the Timer2 overflow is taken before the next one
+	 */
+	cli();
+	boot_page_erase(page);
+	boot_spm_busy_wait();
+
+	/* the buffer is empty before the fill, the RWWSRE command doesn't lose anything */
+	boot_rww_enable();
+	SREG = sreg;
+}
+
+BOOTLOADER_SECTION __attribute__((noinline)) void FLASH_fillPage(uint16 a_offset, const uint8 * a_data, uint8 a_size)
+{
+	uint8 sreg = SREG;
+	uint8 i;
+
+	/* an interrupt between the write of SPMCR and the spm makes the spm fail */
+	cli();
+	for (i = 0; i < a_size; i += 2)
+	{
+		boot_page_fill((uint16)&g_data[a_offset + i], a_data[i] | ((uint16)a_data[i + 1] << 8));
+	}
+	SREG = sreg;
+}
+
+BOOTLOADER_SECTION __attribute__((noinline)) void FLASH_writePage(uint16 a_offset)
+{
+	uint8 sreg = SREG;
+	uint16 page = (uint16)&g_data[a_offset & ~(FLASH_PAGE_SIZE - 1)];
+
+	cli();
+	boot_page_write(page);
+	boot_spm_busy_wait();
+
+	/* the RWW section is read again by the application and its interrupts */
+	boot_rww_enable();
+	SREG = sreg;
+}
+
+BOOTLOADER_SECTION __attribute__((noinline)) void FLASH_dropPage(void)
+{
+	uint8 sreg = SREG;
+
+	/* the RWWSRE command also empties the buffer */
+	cli();
+	boot_spm_busy_wait();
+	boot_rww_enable();
+	SREG = sreg;
+}
+
+#endif /* BOARD_CRED_STORE */
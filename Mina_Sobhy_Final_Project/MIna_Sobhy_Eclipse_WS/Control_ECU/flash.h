@@ -0,0 +1,91 @@
+/*
+ * flash.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: header file of the data region of the flash written by the
+ *      			 self-programming (SPM) of the ATmega32
+ *
+ *      The region is FLASH_DATA_SIZE bytes of the RWW section just under the boot
+ *      section, erased (0xFF) in the image and placed by the linker at
+ *      FLASH_DATA_ADDRESS (makefile.targets). It is read with lpm like any
+ *      constant of the flash. A page is erased by FLASH_erasePage, then the
+ *      temporary page buffer of the SPM is filled (FLASH_fillPage) and written
+ *      in it by FLASH_writePage, from the boot section: the SPM doesn't run
+ *      from the RWW section. The interrupts are disabled while the RWW section
+ *      is busy as their vectors and handlers are in it, about 4.5ms for the
+ *      erase and again for the write. Each is shorter than the 7.8ms between
+ *      two Timer2 overflows (clock.h), so the overflow waits in TOV2 and the
+ *      real-time clock doesn't lose a tick.
+ *
+ *      The driver is built only with BOARD_CRED_STORE == BOARD_CRED_FLASH, it
+ *      needs the BOOTSZ fuses of a boot section of 2048 words at FLASH_BOOT_ADDRESS.
+ */
+
+#ifndef FLASH_H_
+#define FLASH_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* SPM page of the ATmega32, 64 words */
+#define FLASH_PAGE_SIZE			128
+
+/* BOOTSZ1:0 = 00, also the --section-start of .bootloader and .flashdata in
+ * makefile.targets
+ */
+#define FLASH_BOOT_ADDRESS		0x7000
+#define FLASH_DATA_SIZE			0x0200
+#define FLASH_DATA_ADDRESS		(FLASH_BOOT_ADDRESS - FLASH_DATA_SIZE)
+
+#define FLASH_DATA_PAGES		(FLASH_DATA_SIZE / FLASH_PAGE_SIZE)
+
+/* longest erase or write of a page by the SPM (tWD_FLASH of the ATmega32) */
+#define FLASH_SPM_US			4500UL
+
+#if defined(SPM_PAGESIZE) && (SPM_PAGESIZE != FLASH_PAGE_SIZE)
+#error "flash.h: FLASH_PAGE_SIZE isn't the SPM page of the MCU"
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Read a_size bytes of the data region from a_offset with lpm.
+ */
+void FLASH_read(uint16 a_offset, uint8 * a_data, uint8 a_size);
+
+/*
+ * Description :
+ * Erase the page of the data region of a_offset, before its temporary page
+ * buffer is filled.
+ */
+void FLASH_erasePage(uint16 a_offset);
+
+/*
+ * Description :
+ * Put a_size bytes (an even number) in the temporary page buffer at a_offset
+ * of the data region (even), every byte of the page is put once before it is
+ * written.
+ */
+void FLASH_fillPage(uint16 a_offset, const uint8 * a_data, uint8 a_size);
+
+/*
+ * Description :
+ * Write the temporary page buffer in the page of the data region of a_offset,
+ * erased by FLASH_erasePage, the buffer is empty after.
+ */
+void FLASH_writePage(uint16 a_offset);
+
+/*
+ * Description :
+ * Empty the temporary page buffer without writing it.
+ */
+void FLASH_dropPage(void);
+
+#endif /* FLASH_H_ */
@@ -0,0 +1,224 @@
+/*
+ * lockout.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: source file for the lockout manager
+ */
+
+#include "lockout.h"
+#include "eeprom_map.h"
+#include "config.h"
+#include "external_eeprom.h"
+#include "timer1.h"
+#include "buzzer.h"
+#include <util/delay.h>
+#include <avr/io.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* RAM copy of the record stored in the EEPROM */
+static volatile LOCKOUT_RecordType g_record = {0, 0, 0};
+
+/* set by the timer ISR when the lockout ends to store the record later */
+static volatile uint8 g_commitPending = FALSE;
+
+/* lockout seconds counted since the record was stored */
+static volatile uint8 g_uncommitted = 0;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void LOCKOUT_TIMER1_tick(void);
+static void LOCKOUT_start(void);
+static void LOCKOUT_commit(void);
+
+/*******************************************************************************
+ *                                Timers CallBack Functions                    *
+ *******************************************************************************/
+
+/* Description:
+ * count down the lockout seconds, store them periodically and stop the alarm
+ * when the lockout ends
+ */
+static void LOCKOUT_TIMER1_tick(void)
+{
+	if (g_record.remaining > 0)
+	{
+		g_record.remaining--;
+	}
+
+	if (g_record.remaining == 0)
+	{
+		Buzzer_off();
+		Timer1_deInit();
+		g_commitPending = TRUE;
+	}
+	else if (++g_uncommitted >= LOCKOUT_COMMIT_SECONDS)
+	{
+		g_commitPending = TRUE;
+	}
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/* Description:
+ * write the whole record in one EEPROM page write
+ */
+static void LOCKOUT_commit(void)
+{
+	LOCKOUT_RecordType record;
+	uint8 sreg;
+
+	/* take a copy of the record as the remaining seconds are changed by the ISR */
+	sreg = SREG;
+	SREG &= ~(1<<7);
+	record = g_record;
+	g_uncommitted = 0;
+	SREG = sreg;
+
+	EEPROM_writeBlock(EEPROM_LOCKOUT_ADDRESS, (const uint8 *)&record, sizeof(record));
+	_delay_ms(10);
+}
+
+/* Description:
+ * turn on the alarm and count the lockout seconds in the background
+ */
+static void LOCKOUT_start(void)
+{
+	/* turn on the buzzer */
+	Buzzer_on();
+
+	/* set the timer callback function */
+	Timer1_setCallBack(LOCKOUT_TIMER1_tick);
+	/* Timer1 Configuration, compare match every 1 second */
+	Timer1_ConfigType timerType = { 0 , 31250 , PRESCALER_256, COMPARE_MODE};
+	/* Timer1 initialization */
+	Timer1_init(&timerType);
+}
+
+void LOCKOUT_init(void)
+{
+	LOCKOUT_RecordType record;
+
+	if (EEPROM_readBlock(EEPROM_LOCKOUT_ADDRESS, (uint8 *)&record, sizeof(record)) == ERROR)
+	{
+		return;
+	}
+
+	/* an erased EEPROM reads 0xFF, treat it as a clean record */
+	if (record.attempts == 0xFF)
+	{
+		return;
+	}
+
+	if (record.attempts > POLICY_ATTEMPTS_MAX)
+	{
+		record.attempts = POLICY_ATTEMPTS_MAX;
+	}
+	if (record.level > LOCKOUT_MAX_LEVEL)
+	{
+		record.level = LOCKOUT_MAX_LEVEL;
+	}
+	if (record.remaining > LOCKOUT_MAX_SECONDS)
+	{
+		record.remaining = (uint16)LOCKOUT_MAX_SECONDS;
+	}
+
+	g_record = record;
+
+	/* the system was powered off while locked so continue the lockout */
+	if (g_record.remaining > 0)
+	{
+		LOCKOUT_start();
+	}
+}
+
+uint8 LOCKOUT_isActive(void)
+{
+	return (LOCKOUT_remaining() != 0);
+}
+
+uint16 LOCKOUT_remaining(void)
+{
+	uint16 remaining;
+	uint8 sreg;
+
+	/* the 16-bit read must not be interrupted by the timer ISR */
+	sreg = SREG;
+	SREG &= ~(1<<7);
+	remaining = g_record.remaining;
+	SREG = sreg;
+
+	return remaining;
+}
+
+uint8 LOCKOUT_level(void)
+{
+	return g_record.level;
+}
+
+uint8 LOCKOUT_registerFailure(void)
+{
+	uint8 locked = FALSE;
+	uint32 seconds;
+
+	g_record.attempts++;
+
+	if (g_record.attempts >= CONFIG_get()->max_attempts)
+	{
+		/* exponential backoff, every lockout is double the previous one */
+		seconds = (uint32)CONFIG_get()->lockout_seconds << g_record.level;
+		if (seconds > LOCKOUT_MAX_SECONDS)
+		{
+			seconds = LOCKOUT_MAX_SECONDS;
+		}
+		g_record.remaining = (uint16)seconds;
+		g_record.attempts = 0;
+		if (g_record.level < LOCKOUT_MAX_LEVEL)
+		{
+			g_record.level++;
+		}
+		locked = TRUE;
+	}
+
+	/* store the new record before the lockout starts so a power cycle can't skip it */
+	LOCKOUT_commit();
+
+	if (locked)
+	{
+		LOCKOUT_start();
+	}
+
+	return locked;
+}
+
+void LOCKOUT_registerSuccess(void)
+{
+	/* don't waste an EEPROM write cycle if there is nothing to clear */
+	if ((g_record.attempts != 0) || (g_record.level != 0))
+	{
+		g_record.attempts = 0;
+		g_record.level = 0;
+		LOCKOUT_commit();
+	}
+}
+
+void LOCKOUT_service(void)
+{
+	if (g_commitPending)
+	{
+		g_commitPending = FALSE;
+		LOCKOUT_commit();
+	}
+}
+
+uint8 LOCKOUT_isServicePending(void)
+{
+	return g_commitPending;
+}
@@ -0,0 +1,113 @@
+/*
+ * lockout.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: header file for the lockout manager which counts the failed
+ *      			 password attempts and runs the alarm in the background
+ */
+
+#ifndef LOCKOUT_H_
+#define LOCKOUT_H_
+
+#include "std_types.h"
+#include "policy.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* the number of wrong passwords and the duration of the first lockout are taken
+ * from the policy, every following lockout doubles the duration until the level
+ * reaches LOCKOUT_MAX_LEVEL (60s, 120s, 240s, 480s, 960s with the default policy)
+ */
+#define LOCKOUT_MAX_LEVEL		4
+
+/* longest lockout in seconds, the durations are computed on 32 bits and
+ * clamped to it as the shift overflows the 16-bit int of the AVR
+ */
+#define LOCKOUT_MAX_SECONDS		((uint32)POLICY_LOCKOUT_MAX << LOCKOUT_MAX_LEVEL)
+
+#if ((POLICY_LOCKOUT_MAX << LOCKOUT_MAX_LEVEL) > 0xFFFF)
+#error "lockout.h: the longest lockout doesn't fit in the remaining seconds of the record"
+#endif
+
+/* the remaining seconds are stored every LOCKOUT_COMMIT_SECONDS of a lockout, so a
+ * power cycle adds less than that to it (960 EEPROM write cycles for the longest one)
+ */
+#define LOCKOUT_COMMIT_SECONDS	60
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/* record stored in the external EEPROM, it is written as one block so every
+ * event and every LOCKOUT_COMMIT_SECONDS of a lockout cost one EEPROM write cycle only
+ */
+typedef struct
+{
+	uint8	attempts	; /* failed attempts since the last correct password */
+	uint8	level		; /* number of lockouts since the last correct password */
+	uint16	remaining	; /* seconds left in the current lockout, 0 if not locked */
+} LOCKOUT_RecordType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Load the lockout record from the EEPROM and resume the lockout if the
+ * system was powered off while locked. A power cycle restarts the remaining
+ * time of the last stored record, so it can never shorten a lockout and makes
+ * it longer by less than LOCKOUT_COMMIT_SECONDS.
+ */
+void LOCKOUT_init(void);
+
+/*
+ * Description :
+ * Return TRUE while the system is locked.
+ */
+uint8 LOCKOUT_isActive(void);
+
+/*
+ * Description :
+ * Return the seconds left in the current lockout.
+ */
+uint16 LOCKOUT_remaining(void);
+
+/*
+ * Description :
+ * Return the number of lockouts since the last correct password.
+ */
+uint8 LOCKOUT_level(void);
+
+/*
+ * Description :
+ * Count a wrong password and start the lockout when the attempts reach
+ * the policy maximum attempts. Return TRUE if the lockout has been started.
+ */
+uint8 LOCKOUT_registerFailure(void);
+
+/*
+ * Description :
+ * Clear the attempts and the backoff level after a correct password.
+ */
+void LOCKOUT_registerSuccess(void);
+
+/*
+ * Description :
+ * Must be called from the main loop, it stores the record in the EEPROM
+ * every LOCKOUT_COMMIT_SECONDS of a lockout and when it ends as the EEPROM
+ * can't be accessed from the timer ISR.
+ */
+void LOCKOUT_service(void);
+
+/*
+ * Description :
+ * Return TRUE when LOCKOUT_service has a record to store, the main loop checks
+ * it with the interrupts disabled before it sleeps.
+ */
+uint8 LOCKOUT_isServicePending(void);
+
+#endif /* LOCKOUT_H_ */
@@ -0,0 +1,224 @@
+/*
+ * log_export.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: source file of the compressed export of the audit log on the UART
+ */
+
+#include "log_export.h"
+#include "uart.h"
+#include <util/crc16.h>
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static uint8 EXPORT_varint(uint8 * a_out, uint32 a_value);
+static uint8 EXPORT_delta(uint8 * a_out, sint32 a_delta);
+static void EXPORT_sendFrame(uint8 * a_frame, uint8 a_size);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/* Description:
+ * write a_value 7 bits per byte from the low ones, return the number of bytes
+ */
+static uint8 EXPORT_varint(uint8 * a_out, uint32 a_value)
+{
+	uint8 size = 0;
+
+	while (a_value >= 0x80)
+	{
+		a_out[size] = (uint8)a_value | 0x80;
+		a_value >>= 7;
+		size++;
+	}
+	a_out[size] = (uint8)a_value;
+
+	return size + 1;
+}
+
+/* Description:
+ * write a time delta as a zigzag varint, the small negative deltas stay short
+ */
+static uint8 EXPORT_delta(uint8 * a_out, sint32 a_delta)
+{
+	return EXPORT_varint(a_out, ((uint32)a_delta << 1) ^ (uint32)(a_delta >> 31));
+}
+
+/* Description:
+ * send a frame after the frame before is out of the buffer it reuses, a_frame
+ * holds the length byte then a_size bytes
+ */
+static void EXPORT_sendFrame(uint8 * a_frame, uint8 a_size)
+{
+	a_frame[0] = a_size;
+	while (!UART_isSendDone()){}
+	UART_sendBlock(a_frame, a_size + 1);
+}
+
+void EXPORT_start(EXPORT_EncoderType * a_encoder)
+{
+	a_encoder->event = 0xFF;
+	a_encoder->user = LOG_USER_MAIN;
+	a_encoder->result = 0;
+	a_encoder->run = 0;
+	a_encoder->time = 0;
+	a_encoder->delta = 0;
+}
+
+uint8 EXPORT_encode(EXPORT_EncoderType * a_encoder, const LOG_RecordType * a_record, uint8 * a_out)
+{
+	uint32 time = LOG_time(a_record);
+	sint32 delta = (sint32)(time - a_encoder->time);
+	uint8 same = (a_record->event == a_encoder->event) && (a_record->user == a_encoder->user)
+		&& (a_record->result == a_encoder->result);
+	uint8 size;
+	uint8 token;
+
+	a_encoder->time = time;
+
+	/* the run is written when it ends or when it is full */
+	if (same && (delta == a_encoder->delta))
+	{
+		a_encoder->run++;
+		return (a_encoder->run == EXPORT_RUN_MAX) ? EXPORT_finish(a_encoder, a_out) : 0;
+	}
+
+	size = EXPORT_finish(a_encoder, a_out);
+	a_encoder->delta = delta;
+
+	if (same)
+	{
+		if ((delta >= 0) && (delta < EXPORT_DELTA_ESCAPE))
+		{
+			a_out[size] = EXPORT_TOKEN_REPEAT | (uint8)delta;
+			return size + 1;
+		}
+		a_out[size++] = EXPORT_TOKEN_REPEAT | EXPORT_DELTA_ESCAPE;
+		return size + EXPORT_delta(&a_out[size], delta);
+	}
+
+	token = (a_record->event < EXPORT_ESCAPE) ? a_record->event : EXPORT_ESCAPE;
+	token <<= 3;
+	token |= (a_record->result < EXPORT_ESCAPE) ? a_record->result : EXPORT_ESCAPE;
+	token <<= 1;
+	if (a_record->user != a_encoder->user)
+	{
+		token |= EXPORT_USER_CHANGED;
+	}
+	a_out[size++] = token;
+
+	if (a_record->event >= EXPORT_ESCAPE)
+	{
+		a_out[size++] = a_record->event;
+	}
+	if (a_record->result >= EXPORT_ESCAPE)
+	{
+		a_out[size++] = a_record->result;
+	}
+	if (token & EXPORT_USER_CHANGED)
+	{
+		size += EXPORT_varint(&a_out[size], a_record->user);
+	}
+
+	a_encoder->event = a_record->event;
+	a_encoder->user = a_record->user;
+	a_encoder->result = a_record->result;
+
+	return size + EXPORT_delta(&a_out[size], delta);
+}
+
+uint8 EXPORT_finish(EXPORT_EncoderType * a_encoder, uint8 * a_out)
+{
+	if (a_encoder->run == 0)
+	{
+		return 0;
+	}
+
+	a_out[0] = EXPORT_TOKEN_RUN | (a_encoder->run - 1);
+	a_encoder->run = 0;
+	return 1;
+}
+
+void EXPORT_send(void)
+{
+	/* the interrupt sends one buffer while the other one is filled, each buffer
+	 * has the length byte of the frame first
+	 */
+	uint8 frames[2][1 + EXPORT_FRAME_MAX];
+	LOG_RecordType records[EXPORT_BLOCK_RECORDS];
+	EXPORT_EncoderType encoder;
+	uint16 count = LOG_count();
+	uint16 index = 0;
+	uint16 crc = 0xFFFF;
+	uint8 * frame;
+	uint8 buffer = 1;
+	uint8 read;
+	uint8 size;
+	uint8 i;
+
+	frames[0][1] = EXPORT_VERSION;
+	frames[0][2] = (uint8)count;
+	frames[0][3] = (uint8)(count >> 8);
+	EXPORT_sendFrame(frames[0], EXPORT_HEADER_SIZE);
+
+	EXPORT_start(&encoder);
+	while (index < count)
+	{
+		frame = frames[buffer];
+
+		/* a failed read ends the export, the decoder finds less records than the header */
+		read = LOG_readBlock(index, records, EXPORT_BLOCK_RECORDS);
+		if (read == 0)
+		{
+			break;
+		}
+		index += read;
+
+		size = 0;
+		for (i = 0; i < read; i++)
+		{
+			size += EXPORT_encode(&encoder, &records[i], &frame[1 + size]);
+		}
+		if (index == count)
+		{
+			size += EXPORT_finish(&encoder, &frame[1 + size]);
+		}
+
+		/* the records of a run are only written when it ends, an empty frame would end the export */
+		if (size == 0)
+		{
+			continue;
+		}
+
+		for (i = 0; i < size; i++)
+		{
+			crc = _crc_ccitt_update(crc, frame[1 + i]);
+		}
+		EXPORT_sendFrame(frame, size);
+		buffer ^= 1;
+	}
+
+	/* a run still open after a failed read */
+	frame = frames[buffer];
+	size = EXPORT_finish(&encoder, &frame[1]);
+	if (size != 0)
+	{
+		crc = _crc_ccitt_update(crc, frame[1]);
+		EXPORT_sendFrame(frame, size);
+		buffer ^= 1;
+	}
+
+	/* the empty frame and the CRC after it */
+	frame = frames[buffer];
+	frame[1] = (uint8)crc;
+	frame[2] = (uint8)(crc >> 8);
+	EXPORT_sendFrame(frame, 0);
+	UART_sendBlock(&frame[1], 2);
+
+	/* the buffers are on the stack, they must be out before the return */
+	while (!UART_isSendDone()){}
+}
@@ -0,0 +1,111 @@
+/*
+ * log_export.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: header file of the compressed export of the audit log on the UART
+ *
+ *      The export is a sequence of frames, every frame is its length byte then
+ *      its bytes as read by UART_receiveFrame:
+ *      1. the header frame: EXPORT_VERSION then the number of records, low byte first.
+ *      2. the data frames of the encoded records, never empty.
+ *      3. an empty frame, then the CRC-CCITT of the encoded bytes, low byte first.
+ *
+ *      The records are encoded from the oldest one as a stream of tokens, the
+ *      frames only cut it, a token can go on in the next frame:
+ *      - 0EEERRRU: the event (EEE) and the result (RRR), followed by the event byte
+ *        if EEE is EXPORT_ESCAPE, the result byte if RRR is EXPORT_ESCAPE, the user
+ *        ID as a varint if U is 1 (else the user of the record before) and the
+ *        time delta as a zigzag varint.
+ *      - 10DDDDDD: the event, the user and the result of the record before with a
+ *        time delta of DDDDDD seconds, or a zigzag varint after it if DDDDDD is
+ *        EXPORT_DELTA_ESCAPE.
+ *      - 11NNNNNN: NNNNNN + 1 records which are the same as the record before,
+ *        time delta included.
+ *      A varint is 7 bits per byte from the low ones, bit 7 is set when another
+ *      byte follows. The time delta is the time of the record minus the time of
+ *      the record before (0 before the first one), it is negative after a reset.
+ */
+
+#ifndef LOG_EXPORT_H_
+#define LOG_EXPORT_H_
+
+#include "std_types.h"
+#include "audit_log.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* first byte of the header frame, changed whenever the encoding changes */
+#define EXPORT_VERSION			1
+#define EXPORT_HEADER_SIZE		3
+
+#define EXPORT_TOKEN_REPEAT		0x80
+#define EXPORT_TOKEN_RUN		0xC0
+#define EXPORT_ESCAPE			7		/* EEE or RRR of a value which doesn't fit in 3 bits */
+#define EXPORT_DELTA_ESCAPE		0x3F	/* DDDDDD of a delta which doesn't fit in 6 bits */
+#define EXPORT_USER_CHANGED		0x01
+#define EXPORT_RUN_MAX			64
+
+/* records read from the EEPROM for one data frame */
+#define EXPORT_BLOCK_RECORDS	4
+
+/* most bytes of one record: the run ended by it, the token, the escaped event and
+ * result, the user and the time delta (5 bytes for 32 bits)
+ */
+#define EXPORT_RECORD_MAX		11
+#define EXPORT_FRAME_MAX		(EXPORT_BLOCK_RECORDS * EXPORT_RECORD_MAX)
+
+/* the HMI_ECU takes a data frame in place in its 64 byte Rx buffer */
+#if (EXPORT_FRAME_MAX > 62)
+#error "log_export.h: a data frame must fit in the Rx buffer of the HMI_ECU"
+#endif
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/* the record before, as seen by the encoder and the decoder */
+typedef struct
+{
+	uint8	event	; /* 0xFF before the first record */
+	uint8	user	;
+	uint8	result	;
+	uint8	run		; /* records of the run not encoded yet */
+	uint32	time	;
+	sint32	delta	;
+} EXPORT_EncoderType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Start the encoding from the first record of the log.
+ */
+void EXPORT_start(EXPORT_EncoderType * a_encoder);
+
+/*
+ * Description :
+ * Encode a record in a_out, return the number of bytes written (at most
+ * EXPORT_RECORD_MAX). A record in a run writes nothing until the run ends.
+ */
+uint8 EXPORT_encode(EXPORT_EncoderType * a_encoder, const LOG_RecordType * a_record, uint8 * a_out);
+
+/*
+ * Description :
+ * Write the run which isn't ended yet after the last record, return the number
+ * of bytes written (0 or 1).
+ */
+uint8 EXPORT_finish(EXPORT_EncoderType * a_encoder, uint8 * a_out);
+
+/*
+ * Description :
+ * Send the whole log on the UART. The EEPROM reads and the encoding of a frame
+ * are done while the frame before is sent by the UART interrupt.
+ */
+void EXPORT_send(void);
+
+#endif /* LOG_EXPORT_H_ */
@@ -0,0 +1,223 @@
+/*
+ * provision.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: source file of the provisioning of a pre-built image of the
+ *      			 external EEPROM over the UART
+ */
+
+#include "provision.h"
+#include <util/crc16.h>
+#include <util/delay.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* step of the main loop of the session when it has nothing to do */
+#define PROVISION_POLL_US		100
+#define PROVISION_TIMEOUT_POLLS	((PROVISION_TIMEOUT_MS * 1000UL) / PROVISION_POLL_US)
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/* the pages from written to expected are queued, page n in pages[n % PROVISION_QUEUE_PAGES] */
+typedef struct
+{
+	uint8	count		; /* pages of the image */
+	uint8	written		; /* pages written to the EEPROM */
+	uint8	expected	; /* next page to receive */
+	uint8	step		; /* bytes of the chunk received */
+	uint8	number		; /* page number of the chunk */
+	uint8	crcLow		; /* first byte of the CRC of the chunk */
+	uint16	crc			;
+	uint8	reply[2]	; /* sent by the UART interrupt */
+	uint8	pages[PROVISION_QUEUE_PAGES][EEPROM_PAGE_SIZE];
+} PROVISION_SessionType;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void PROVISION_reply(PROVISION_SessionType * a_session, uint8 a_type, uint8 a_value);
+static uint8 PROVISION_parse(PROVISION_SessionType * a_session, uint8 a_data);
+static void PROVISION_resync(PROVISION_SessionType * a_session);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/* Description:
+ * send a reply and its value from the UART interrupt, the reply before is out
+ * long before as the host sends a whole chunk between two replies
+ */
+static void PROVISION_reply(PROVISION_SessionType * a_session, uint8 a_type, uint8 a_value)
+{
+	while (!UART_isSendDone()){}
+
+	a_session->reply[0] = a_type;
+	a_session->reply[1] = a_value;
+	UART_sendBlock(a_session->reply, 2);
+}
+
+/* Description:
+ * take one byte of a chunk, the page is stored in the free slot of the queue
+ * which follows the queued pages. A right chunk of the expected page is queued
+ * and acknowledged. Return FALSE if the chunk is wrong.
+ */
+static uint8 PROVISION_parse(PROVISION_SessionType * a_session, uint8 a_data)
+{
+	uint8 step = a_session->step;
+
+	a_session->step++;
+
+	if (step == 0)
+	{
+		a_session->crc = 0xFFFF;
+		return (a_data == PROVISION_FRAME_LENGTH);
+	}
+
+	if (step <= (1 + EEPROM_PAGE_SIZE))
+	{
+		a_session->crc = _crc_ccitt_update(a_session->crc, a_data);
+		if (step == 1)
+		{
+			a_session->number = a_data;
+		}
+		else
+		{
+			a_session->pages[a_session->expected & (PROVISION_QUEUE_PAGES - 1)][step - 2] = a_data;
+		}
+		return TRUE;
+	}
+
+	if (step == (2 + EEPROM_PAGE_SIZE))
+	{
+		a_session->crcLow = a_data;
+		return TRUE;
+	}
+
+	/* last byte of the chunk */
+	a_session->step = 0;
+	if (a_session->crc != (a_session->crcLow | ((uint16)a_data << 8)))
+	{
+		return FALSE;
+	}
+
+	/* a chunk sent again after a NACK which was already queued is dropped */
+	if (a_session->number == a_session->expected)
+	{
+		PROVISION_reply(a_session, PROVISION_ACK, a_session->expected);
+		a_session->expected++;
+	}
+
+	return TRUE;
+}
+
+/* Description:
+ * drop the bytes of the host until the line is quiet and ask for the expected
+ * page again, the chunks of the window after a wrong one are all dropped
+ */
+static void PROVISION_resync(PROVISION_SessionType * a_session)
+{
+	uint8 data;
+
+	while (UART_receiveByteTimeout(&data, PROVISION_QUIET_MS)){}
+
+	a_session->step = 0;
+	PROVISION_reply(a_session, PROVISION_NACK, a_session->expected);
+}
+
+uint8 PROVISION_receive(void)
+{
+	PROVISION_SessionType session;
+	uint32 silent = 0; /* polls with nothing to do in a row */
+	uint8 retries = 0;
+	uint8 status = SUCCESS;
+	uint8 data;
+
+	session.written = 0;
+	session.expected = 0;
+	session.step = 0;
+
+	if (!UART_receiveByteTimeout(&session.count, PROVISION_TIMEOUT_MS)
+		|| (session.count == 0) || (session.count > PROVISION_PAGES))
+	{
+		PROVISION_reply(&session, PROVISION_FAILED, 0);
+		while (!UART_isSendDone()){}
+		return ERROR;
+	}
+	PROVISION_reply(&session, PROVISION_WINDOW, PROVISION_WINDOW_CHUNKS);
+
+	while (session.written != session.count)
+	{
+		/* the oldest queued page is written as soon as the EEPROM ends the write
+		 * cycle of the page before
+		 */
+		if ((session.written != session.expected) && EEPROM_isReady())
+		{
+			if (EEPROM_writeBlock(EEPROM_IMAGE_ADDRESS + ((uint16)session.written * EEPROM_PAGE_SIZE),
+				session.pages[session.written & (PROVISION_QUEUE_PAGES - 1)], EEPROM_PAGE_SIZE) != SUCCESS)
+			{
+				status = ERROR;
+				break;
+			}
+			session.written++;
+			silent = 0;
+			continue;
+		}
+
+		/* the chunks stay in the Rx buffer while the queue is full */
+		if ((session.expected != session.count)
+			&& ((uint8)(session.expected - session.written) != PROVISION_QUEUE_PAGES)
+			&& UART_receiveByteTimeout(&data, 0))
+		{
+			silent = 0;
+			retries = 0;
+			if (!PROVISION_parse(&session, data))
+			{
+				PROVISION_resync(&session);
+			}
+			continue;
+		}
+
+		/* nothing to do, the EEPROM is in a write cycle or the host waits for an
+		 * acknowledgement which was lost on the line
+		 */
+		silent++;
+		if (silent == PROVISION_TIMEOUT_POLLS)
+		{
+			silent = 0;
+			retries++;
+
+			/* a write cycle which doesn't end or a host which stopped */
+			if ((session.written != session.expected) || (retries > PROVISION_RETRIES))
+			{
+				status = ERROR;
+				break;
+			}
+			session.step = 0;
+			PROVISION_reply(&session, PROVISION_NACK, session.expected);
+		}
+		_delay_us(PROVISION_POLL_US);
+	}
+
+	/* the last page is written when its write cycle ends */
+	for (silent = 0; (status == SUCCESS) && !EEPROM_isReady(); silent++)
+	{
+		if (silent == PROVISION_TIMEOUT_POLLS)
+		{
+			status = ERROR;
+		}
+		_delay_us(PROVISION_POLL_US);
+	}
+
+	PROVISION_reply(&session, (status == SUCCESS) ? PROVISION_DONE : PROVISION_FAILED, session.written);
+
+	/* the reply is in the session on the stack, it must be out before the return */
+	while (!UART_isSendDone()){}
+
+	return status;
+}
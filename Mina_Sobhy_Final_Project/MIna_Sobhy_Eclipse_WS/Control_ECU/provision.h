@@ -0,0 +1,101 @@
+/*
+ * provision.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: header file of the provisioning of a pre-built image of the
+ *      			 external EEPROM over the UART
+ *
+ *      A host tool takes the place of the HMI_ECU on the UART line and writes the
+ *      image area (EEPROM_IMAGE_ADDRESS) in one session, after the hidden main
+ *      option 'P' and the password. Every chunk is one EEPROM page, so it is
+ *      written by one page write:
+ *      1. the host sends the number of pages of the image, the CONTROL_ECU replies
+ *         PROVISION_WINDOW and the window: the most chunks the host may send
+ *         before they are acknowledged. A wrong number is answered PROVISION_FAILED.
+ *      2. every chunk is a frame: its length byte (PROVISION_FRAME_LENGTH), the page
+ *         number in the image, the EEPROM_PAGE_SIZE bytes of the page and the
+ *         CRC-CCITT of the page number and the bytes, low byte first. The chunks
+ *         are sent in the order of the pages.
+ *      3. a chunk is acknowledged with PROVISION_ACK and its page number as soon as
+ *         its CRC is right and it is queued in RAM, not when it is written. The
+ *         queued pages are written one after the other while the next chunks are
+ *         received, the end of every write cycle is found by ACK polling, so the
+ *         host never waits for the EEPROM unless the queue is full.
+ *      4. a chunk with a wrong length or CRC is dropped with the bytes after it
+ *         until the line is quiet, then PROVISION_NACK and the page expected are
+ *         sent and the host sends again from that page. A chunk of another page
+ *         is dropped. The NACK is sent again if nothing comes in PROVISION_TIMEOUT_MS.
+ *      5. once every page is written the CONTROL_ECU sends PROVISION_DONE, or
+ *         PROVISION_FAILED if the EEPROM write failed or the host stopped.
+ *
+ *      The replies are sent at once, without waiting for HMI_ECU_READY. The chunks
+ *      of the window fit in the Rx buffer of the UART driver, none is lost while
+ *      the CPU is busy with a page write on the TWI.
+ */
+
+#ifndef PROVISION_H_
+#define PROVISION_H_
+
+#include "std_types.h"
+#include "eeprom_map.h"
+#include "external_eeprom.h"
+#include "uart.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* replies of the CONTROL_ECU */
+#define PROVISION_WINDOW		'W'	/* then the window in chunks */
+#define PROVISION_ACK			'K'	/* then the page number of the chunk queued */
+#define PROVISION_NACK			'N'	/* then the page number expected */
+#define PROVISION_DONE			'D'
+#define PROVISION_FAILED		'F'
+
+#define PROVISION_PAGES			(EEPROM_IMAGE_SIZE / EEPROM_PAGE_SIZE)
+
+/* length byte of a chunk: the page number, the page and the CRC */
+#define PROVISION_FRAME_LENGTH	(1 + EEPROM_PAGE_SIZE + 2)
+#define PROVISION_FRAME_SIZE	(1 + PROVISION_FRAME_LENGTH)
+
+/* chunks in flight which fit in the Rx buffer with its free slot */
+#define PROVISION_WINDOW_CHUNKS	((UART_RX_SIZE - 1) / PROVISION_FRAME_SIZE)
+
+/* pages received and not written yet, a power of 2 */
+#define PROVISION_QUEUE_PAGES	4
+
+/* wait for the next byte of the host, then the NACK is sent again at most
+ * PROVISION_RETRIES times
+ */
+#define PROVISION_TIMEOUT_MS	500
+#define PROVISION_RETRIES		4
+
+/* time without any byte which ends the bytes dropped after a wrong chunk */
+#define PROVISION_QUIET_MS		10
+
+#if ((EEPROM_IMAGE_ADDRESS % EEPROM_PAGE_SIZE) != 0) || ((EEPROM_IMAGE_SIZE % EEPROM_PAGE_SIZE) != 0) \
+	|| (PROVISION_PAGES > 255)
+#error "provision.h: the image must be made of at most 255 whole EEPROM pages"
+#endif
+
+#if (PROVISION_WINDOW_CHUNKS == 0)
+#error "provision.h: a chunk doesn't fit in the Rx buffer of the UART driver"
+#endif
+
+#if (PROVISION_QUEUE_PAGES & (PROVISION_QUEUE_PAGES - 1))
+#error "provision.h: PROVISION_QUEUE_PAGES must be a power of 2"
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Receive an image from the host and write it to the image area, from the
+ * number of pages to the last reply. Return SUCCESS if the whole image is written.
+ */
+uint8 PROVISION_receive(void);
+
+#endif /* PROVISION_H_ */
@@ -41,3 +41,15 @@ void PWM_Timer0_Start(uint8 a_dutyCycle )
 	 */
 	TCCR0 = (1<<WGM00) | (1<<WGM01) | (1<<COM01) | (1<<CS01);
 }
+
+/* Description :
+ * Stop the Timer0 clock and disconnect OC0.
+ */
+void PWM_Timer0_Stop(void)
+{
+	TCCR0 = 0; // No clock source, OC0 disconnected
+
+	TCNT0 = 0;
+
+	PORTB = PORTB & ~(1<<PB3); // keep OC0 low
+}
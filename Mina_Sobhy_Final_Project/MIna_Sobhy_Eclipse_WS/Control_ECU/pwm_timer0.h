@@ -25,4 +25,10 @@
 
 void PWM_Timer0_Start(uint8 a_dutyCycle);
 
+/* Description :
+ * Stop the Timer0 clock and disconnect OC0, the pin goes back to its PORTB value (low)
+ * so the motor stops and the timer doesn't draw current while the motor is off.
+ */
+void PWM_Timer0_Stop(void);
+
 #endif /* PWM_TIMER0_H_ */
@@ -0,0 +1,66 @@
+/*
+ * schedule.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: source file of the access schedules kept in the external EEPROM
+ */
+
+#include "schedule.h"
+#include "clock.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* RAM copy of the group flags, the bitmaps stay in the EEPROM */
+static uint8 g_flags[SCHEDULE_GROUPS];
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void SCHEDULE_init(void)
+{
+	uint8 group;
+
+	/* a failed read restricts every group, they are refused until the next start */
+	if (EEPROM_readBlock(EEPROM_SCHEDULE_ADDRESS, g_flags, SCHEDULE_GROUPS) == ERROR)
+	{
+		for (group = 0; group < SCHEDULE_GROUPS; group++)
+		{
+			g_flags[group] = SCHEDULE_RESTRICTED;
+		}
+	}
+}
+
+uint16 SCHEDULE_slot(uint32 a_wall)
+{
+	return (uint16)((a_wall % CLOCK_SECONDS_PER_WEEK) / SCHEDULE_SLOT_SECONDS);
+}
+
+uint8 SCHEDULE_isAllowed(uint8 a_group)
+{
+	uint16 slot;
+	uint8 data;
+
+	if ((a_group < SCHEDULE_GROUPS) && (g_flags[a_group] == SCHEDULE_UNRESTRICTED))
+	{
+		return TRUE;
+	}
+
+	/* the slot of a clock which isn't set means nothing */
+	if ((a_group >= SCHEDULE_GROUPS) || !CLOCK_isSet())
+	{
+		return FALSE;
+	}
+
+	slot = SCHEDULE_slot(CLOCK_wall());
+	if (EEPROM_readByte(EEPROM_SCHEDULE_BITMAPS_ADDRESS + (a_group * SCHEDULE_BITMAP_SIZE) + (slot >> 3),
+		&data) == ERROR)
+	{
+		return FALSE;
+	}
+
+	return (data >> (slot & 7)) & 1;
+}
@@ -0,0 +1,77 @@
+/*
+ * schedule.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: header file of the access schedules kept in the external EEPROM
+ *
+ *      Every group of users has a week bitmap of SCHEDULE_SLOTS slots of
+ *      SCHEDULE_SLOT_SECONDS from Monday 00:00, a set bit allows the group in
+ *      the slot. Bit n of the week is bit (n % 8) of byte (n / 8). The bitmaps
+ *      are compiled from rules such as "mon-fri 08:00-18:00" by the host tool
+ *      Host_Sim/tools/schedule_compile, so checking a credential is one bit
+ *      lookup whatever the rules are.
+ *
+ *      The schedule area (EEPROM_SCHEDULE_ADDRESS) starts with one flag byte for
+ *      every group: 0xFF, as in an erased EEPROM, for a group without schedule
+ *      which is allowed at any time, any other value restricts the group to its
+ *      bitmap. The bitmaps follow from EEPROM_SCHEDULE_BITMAPS_ADDRESS.
+ */
+
+#ifndef SCHEDULE_H_
+#define SCHEDULE_H_
+
+#include "std_types.h"
+#include "eeprom_map.h"
+#include "external_eeprom.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SCHEDULE_GROUPS			4
+
+/* group of the main password (LOG_USER_MAIN) */
+#define SCHEDULE_GROUP_MAIN		0
+
+#define SCHEDULE_SLOT_SECONDS	900UL	/* 15 minutes */
+#define SCHEDULE_SLOTS_PER_DAY	96
+#define SCHEDULE_SLOTS			(7 * SCHEDULE_SLOTS_PER_DAY)
+#define SCHEDULE_BITMAP_SIZE	(SCHEDULE_SLOTS / 8)
+
+/* flag of a group without schedule, the value of an erased EEPROM */
+#define SCHEDULE_UNRESTRICTED	0xFF
+/* flag written by the compiler for a group with a schedule */
+#define SCHEDULE_RESTRICTED		0x00
+
+#define EEPROM_SCHEDULE_BITMAPS_ADDRESS	(EEPROM_SCHEDULE_ADDRESS + EEPROM_PAGE_SIZE)
+#define SCHEDULE_AREA_SIZE		(EEPROM_PAGE_SIZE + (SCHEDULE_GROUPS * SCHEDULE_BITMAP_SIZE))
+
+#if (SCHEDULE_GROUPS > EEPROM_PAGE_SIZE) || (SCHEDULE_AREA_SIZE > EEPROM_SCHEDULE_SIZE)
+#error "schedule.h: the schedules don't fit in their EEPROM area"
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Load the flags of the groups from the external EEPROM to the RAM.
+ */
+void SCHEDULE_init(void);
+
+/*
+ * Description :
+ * Return the slot of the week of a_wall (CLOCK_wall seconds).
+ */
+uint16 SCHEDULE_slot(uint32 a_wall);
+
+/*
+ * Description :
+ * Return TRUE if a_group may be let in now. A restricted group is refused
+ * while the wall clock isn't set and when its EEPROM bit can't be read.
+ */
+uint8 SCHEDULE_isAllowed(uint8 a_group);
+
+#endif /* SCHEDULE_H_ */
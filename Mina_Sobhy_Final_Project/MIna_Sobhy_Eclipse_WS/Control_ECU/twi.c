@@ -98,3 +98,15 @@ uint8 TWI_getStatus(void)
     status = TWSR & 0xF8;
     return status;
 }
+
+void TWI_disable(void)
+{
+    /* Wait until the stop bit is sent (TWSTO is cleared by the hardware) */
+    while(BIT_IS_SET(TWCR,TWSTO));
+
+    /*
+	 * Switch off the TWI Module TWEN=0 to save power between two transfers,
+	 * the bit rate is kept and TWI_start enables the module again
+	 */
+    TWCR = 0;
+}
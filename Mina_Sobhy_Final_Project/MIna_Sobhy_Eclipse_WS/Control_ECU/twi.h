@@ -54,6 +54,7 @@ void TWI_writeByte(uint8 data);
 uint8 TWI_readByteWithACK(void);
 uint8 TWI_readByteWithNACK(void);
 uint8 TWI_getStatus(void);
+void TWI_disable(void);
 
 
 #endif /* TWI_H_ */
@@ -4,35 +4,29 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
-../gpio.c \
 ../hmi_main.c \
 ../keypad.c \
 ../lcd.c \
-../timer1.c \
-../uart.c 
+../messages.c 
 
 OBJS += \
-./gpio.o \
 ./hmi_main.o \
 ./keypad.o \
 ./lcd.o \
-./timer1.o \
-./uart.o 
+./messages.o 
 
 C_DEPS += \
-./gpio.d \
 ./hmi_main.d \
 ./keypad.d \
 ./lcd.d \
-./timer1.d \
-./uart.d 
+./messages.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
 %.o: ../%.c subdir.mk
 	@echo 'Building file: $<'
 	@echo 'Invoking: AVR Compiler'
-	avr-gcc -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega32 -DF_CPU=1000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
+	avr-gcc -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega32 -I".." -I"../../drivers" -DF_CPU=1000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
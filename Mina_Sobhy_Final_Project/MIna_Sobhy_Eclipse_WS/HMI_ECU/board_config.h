@@ -0,0 +1,65 @@
+/*
+ * board_config.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: configuration of the HMI_ECU board, the clock, the pins of
+ *      			 its devices and the buffer sizes of the shared drivers
+ *      			 (../drivers) which are built once for every board
+ */
+
+#ifndef BOARD_CONFIG_H_
+#define BOARD_CONFIG_H_
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* CPU clock, the build passes the same value with -DF_CPU for <util/delay.h> */
+#define BOARD_F_CPU				1000000UL
+
+#ifndef F_CPU
+#define F_CPU					BOARD_F_CPU
+#elif (F_CPU != BOARD_F_CPU)
+#error "board_config.h: F_CPU of the build isn't the HMI_ECU clock"
+#endif
+
+/* no performance counters on this board */
+#define BOARD_DIAG				0
+
+/* shared drivers buffers */
+#define UART_RX_SIZE			64
+#define TRACE_ENABLE
+#define TRACE_BUFFER_SIZE		64
+
+/* RS-485 multi-drop bus (bus.c): node address of this keypad from 1, 0 keeps
+ * the point-to-point UART link to the CONTROL_ECU
+ */
+#ifndef BOARD_BUS_ADDRESS
+#define BOARD_BUS_ADDRESS		0
+#endif
+
+/* driver enable of the RS-485 transceiver, DE and /RE tied together */
+#define BUS_DE_PORT				PORTD
+#define BUS_DE_DDR				DDRD
+#define BUS_DE_PIN				PD5
+
+/* LCD control pins (lcd.c) */
+#define LCD_RS_PORT_ID			PORTD_ID
+#define LCD_RS_PIN_ID			PIN2_ID
+#define LCD_RW_PORT_ID			PORTD_ID
+#define LCD_RW_PIN_ID			PIN3_ID
+#define LCD_E_PORT_ID			PORTD_ID
+#define LCD_E_PIN_ID			PIN4_ID
+
+/* LCD data bus, 4 or 8 bits, in 4 bits mode LCD_LAST_PORT_PINS uses the pins 4 to 7 */
+#define LCD_DATA_BITS_MODE		8
+#define LCD_DATA_PORT_ID		PORTC_ID
+
+/* keypad rows on the first pins of their port and columns after them (keypad.c) */
+#define KEYPAD_ROW_PORT_ID		PORTA_ID
+#define KEYPAD_FIRST_ROW_PIN_ID	PIN0_ID
+#define KEYPAD_COL_PORT_ID		PORTA_ID
+#define KEYPAD_FIRST_COL_PIN_ID	PIN4_ID
+
+#endif /* BOARD_CONFIG_H_ */
@@ -11,8 +11,17 @@
 #include "timer1.h"
 #include "uart.h"
 #include "lcd.h"
+#include "policy.h"
+#include "trace.h"
+#include "stack.h"
+#include "power.h"
+#include "baud.h"
+#include "bus.h"
+#include "messages.h"
 #include <util/delay.h>
 #include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
 
 /*******************************************************************************
  *                                Definitions                                  *
@@ -20,7 +29,52 @@
 #define MATCHED 		'1'
 #define UNMATCHED		'0'
 #define COMPARE_ERROR	'2'
+#define LOCKED			'3' /* reply to any option while the system is locked */
+#define OUT_OF_SCHEDULE	'B' /* right password out of the access schedule */
 
+/* sent at the start by the CONTROL_ECU to tell if a password has to be created */
+#define PASS_EMPTY		'4'
+#define PASS_STORED		'5'
+
+/* main option to change the policy after entering the password */
+#define SETTINGS		'6'
+
+/* reply to the hidden main option ('=') which sends the trace buffers of the two ECUs */
+#define TRACE_DUMP		'7'
+
+/* reply to the hidden main option ('%') which sends the performance counters of the
+ * CONTROL_ECU
+ */
+#define DIAGNOSTICS		'8'
+
+/* reply to the hidden main option ('#' then '0') which sends the audit log of the
+ * CONTROL_ECU
+ */
+#define LOG_EXPORT		'9'
+
+/* reply to the hidden main option ('#' then '1') which sets the wall clock of the
+ * CONTROL_ECU
+ */
+#define CLOCK_SET		'A'
+
+/* the '#' key of the keypad has three roles:
+ * - ENTER_KEY ends a password or a number, PASS_END is then sent after a password.
+ * - HIDDEN_KEY at the main menu starts a hidden option: '0' after it sends
+ *   LOG_EXPORT_KEY, '1' sends CLOCK_SET_KEY, so a digit alone does nothing at the
+ *   main menu as it may be the start of a password.
+ * - any other key after HIDDEN_KEY sends LANGUAGE_OPTION, which selects the next
+ *   language of the LCD messages, then the key is taken as the next main option
+ *   key ('#' then '+' opens the door in the next language).
+ */
+#define HASH_KEY			'#'
+#define ENTER_KEY			HASH_KEY
+#define HIDDEN_KEY			HASH_KEY
+#define LOG_EXPORT_KEY		'L'
+#define CLOCK_SET_KEY		'K'
+
+/* the wall clock counts the seconds from a Monday at 00:00 */
+#define SECONDS_PER_DAY		86400UL
+#define SECONDS_PER_WEEK	(7UL * SECONDS_PER_DAY)
 
 /* as the CONTROL_ECU is faster than the HMI_ECU. So, we won't need a start bit
  * from the CONTOL_ECU as it will be always ready, but we will need start bit
@@ -30,15 +84,63 @@
 //#define CONTROL_ECU_READY	'C'
 #define HMI_ECU_READY		'H'  /* start bit send by the HMI_ECU when ready */
 
+/* sent after the last password character when the user presses ENTER_KEY */
+#define PASS_END			'#'
+
+/* main option byte of the next language, the CONTROL_ECU has no option for it and
+ * replies with no option
+ */
+#define LANGUAGE_OPTION		'#'
+#define NO_OPTION			'0'
+
+/* no key held by HMI_sendState for the next main menu */
+#define NO_KEY				0
+
+/* returned by HMI_sendState instead of a key when the baud rate is negotiated again */
+#define HMI_LINK_LOST		0xFF
+
+/* if HMI_STREAM_PASS is 1 every password character is sent to the CONTROL_ECU as
+ * soon as it is typed, so the CONTROL_ECU calculates the password digest while the user
+ * is typing and only the PASS_END byte is left when enter is pressed.
+ * To send the whole password after enter is pressed define HMI_STREAM_PASS as 0
+ */
+#ifndef HMI_STREAM_PASS
+#define HMI_STREAM_PASS		1
+#endif
+
+/* the CONTROL_ECU is reached on the RS-485 bus when board_config.h gives this
+ * keypad a node address, else on the point-to-point UART link
+ */
+#if BUS_ENABLED
+#define LINK_sendByte(data)		BUS_sendByte(BUS_MASTER, (data))
+#define LINK_receiveByte()		BUS_receiveByte(BUS_MASTER)
+#else
+#define LINK_sendByte(data)		UART_sendByte(data)
+#define LINK_receiveByte()		UART_receiveByte()
+#endif
+
 /*******************************************************************************
  *                                Global Variables                             *
  *******************************************************************************/
-uint8 sec1 = 0; /* store seconds passed when opening the door */
-uint8 sec2 = 0; /* store seconds passed when the error happened */
+volatile uint8 sec1 = 0; /* store seconds passed when opening the door */
+
+/* policy received from the CONTROL_ECU at the start and after every change */
+POLICY_ConfigType g_policy;
+
+/* key typed after HIDDEN_KEY which switched the language, taken by the next main menu */
+static uint8 g_heldKey = NO_KEY;
 
 /*******************************************************************************
  *                                Timers CallBack Functions                    *
  *******************************************************************************/
+/* Description:
+ * return the seconds needed to unlock the door, keep it open and lock it again
+ */
+uint8 HMI_doorCycle(void)
+{
+	return (2 * g_policy.door_move) + g_policy.door_hold;
+}
+
 /* Description:
  * print on the LCD the door state
  */
@@ -48,31 +150,23 @@ void HMI_TIMER1_count1(void)
 	sec1++;
 
 	/* print on the screen the current state according to the time passed */
-	switch (sec1)
+	if (sec1 == g_policy.door_move)
 	{
-	case 15:
 		LCD_clearScreen();
-		LCD_displayString("Entering");
-		break;
-	case 18:
+		LCD_displayMessage(MSG_ENTERING);
+	}
+	else if (sec1 == (g_policy.door_move + g_policy.door_hold))
+	{
 		LCD_clearScreen();
-		LCD_displayString("Door is Locking");
-		break;
-	case 33:
+		LCD_displayMessage(MSG_DOOR_LOCKING);
+	}
+	else if (sec1 == HMI_doorCycle())
+	{
 		LCD_clearScreen();
 		Timer1_deInit();
-		break;
 	}
 
 }
-/* Description:
- * count seconds for the error function
- */
-void HMI_TIMER1_count2(void)
-{
-	/* increment sec2 when timer is fired and ISR is called  */
-	sec2++;
-}
 
 
 /*******************************************************************************
@@ -83,22 +177,12 @@ void HMI_TIMER1_count2(void)
  */
 void HMI_sendPass (void)
 {
+	uint8 size = 0;
+	uint8 key;
+#if !HMI_STREAM_PASS
 	uint8 i;
-	uint8 input[6];
-
-	/* get the 5 characters of the password from the user */
-	for (i=0; i<5; i++)
-	{
-		input[i] = KEYPAD_getPressedKey();
-		LCD_displayString("*");
-		_delay_ms(500);
-	}
-
-	/* loop until the user press enter button */
-	while ( input[5] != '#')
-	{
-		input[5] = KEYPAD_getPressedKey();
-	}
+	uint8 input[POLICY_PASS_MAX_SIZE];
+#endif
 
 	/* as the CONTROL_ECU is faster than the HMI_ECU. So, we won't need a start bit
 	 * from the CONTOL_ECU as it will be always ready, but we will need start bit
@@ -108,24 +192,89 @@ void HMI_sendPass (void)
 	/* Wait until Control_ECU is ready to receive the string */
 	//while(UART_receiveByte() != CONTROL_ECU_READY){}
 
-	for (i=0; i<5; i++)
+	/* get the password characters from the user until the enter button is pressed,
+	 * enter is ignored before the policy minimum size is typed and the characters
+	 * after the policy maximum size are ignored
+	 */
+	for (;;)
+	{
+		key = KEYPAD_getPressedKey();
+
+		if (key == ENTER_KEY)
+		{
+			if (size >= g_policy.pass_min)
+			{
+				break;
+			}
+		}
+		else if (size < g_policy.pass_max)
+		{
+			LCD_displayCharacter('*');
+
+#if HMI_STREAM_PASS
+			/* Send the character to CONTROL_ECU through UART as soon as it is typed */
+			LINK_sendByte(key);
+#else
+			input[size] = key;
+#endif
+			size++;
+		}
+		_delay_ms(500);
+	}
+
+#if !HMI_STREAM_PASS
+	for (i=0; i<size; i++)
 	{
 		/* Send the required string to CONTROL_ECU through UART */
-		UART_sendByte(input[i]);
+		LINK_sendByte(input[i]);
 	}
+#endif
 
+	/* tell the CONTROL_ECU that the password is complete */
+	LINK_sendByte(PASS_END);
 }
 
 /* Description:
- * function to send a byte to the control ECU
+ * function to send a pressed key to the control ECU, the key is returned or
+ * HMI_LINK_LOST if the baud rate must be negotiated again instead
  */
-void HMI_sendState (void)
+uint8 HMI_sendState (void)
 {
 	uint8 input ;
 
 
-	input = KEYPAD_getPressedKey();
-	_delay_ms(500);
+	if (g_heldKey != NO_KEY)
+	{
+		input = g_heldKey;
+		g_heldKey = NO_KEY;
+	}
+	else
+	{
+		input = KEYPAD_getPressedKey();
+		_delay_ms(500);
+	}
+
+	/* the key after HIDDEN_KEY picks the hidden option, any other key is held for
+	 * the main menu shown again in the next language
+	 */
+	if (input == HIDDEN_KEY)
+	{
+		input = KEYPAD_getPressedKey();
+		_delay_ms(500);
+		switch (input)
+		{
+		case '0':
+			input = LOG_EXPORT_KEY;
+			break;
+		case '1':
+			input = CLOCK_SET_KEY;
+			break;
+		default:
+			g_heldKey = input;
+			input = LANGUAGE_OPTION;
+			break;
+		}
+	}
 
 	/* as the CONTROL_ECU is faster than the HMI_ECU. So, we won't need a start bit
 	 * from the CONTOL_ECU as it will be always ready, but we will need start bit
@@ -135,8 +284,21 @@ void HMI_sendState (void)
 	/* Wait until Control_ECU is ready to receive the string */
 	/* while(UART_receiveByte() != CONTROL_ECU_READY){} */
 
+#if !BUS_ENABLED
+	/* the control ECU sends nothing while a key is waited for, the bytes come
+	 * with errors when it was reset or runs at another rate
+	 */
+	if (BAUD_checkLink() == BAUD_LINK_LOST)
+	{
+		return HMI_LINK_LOST;
+	}
+	UART_flush();
+#endif
+
 	/* Send the required string to CONTROL_ECU through UART */
-	UART_sendByte(input);
+	LINK_sendByte(input);
+
+	return input;
 }
 
 /* Description:
@@ -147,38 +309,54 @@ uint8 HMI_receiveState(void)
 	uint8 status;
 
 	/* Send HMI_ECU_READY byte to CONTROL_ECU to ask it to send the string */
-	UART_sendByte(HMI_ECU_READY);
+	LINK_sendByte(HMI_ECU_READY);
 
 	/* Receive String from CONTROL_ECU through UART */
-	status = UART_receiveByte();
+	status = LINK_receiveByte();
 
 	return status;
 }
 
 /* Description:
- * function to print Error on the LCD and stop every thing else for 60 second
+ * function to print Error on the LCD, the CONTROL_ECU counts the lockout time in the
+ * background so the screen stays until any key is pressed
  */
 void HMI_error(void)
 {
+	TRACE(TRACE_STATE, TRACE_STATE_HMI_ERROR);
+
 	/* print error on the screen */
 	LCD_clearScreen();
-	LCD_displayString("     ERROR     ");
+	LCD_displayMessage(MSG_ERROR);
+	LCD_moveCursor(1,0);
+	LCD_displayMessage(MSG_SYSTEM_LOCKED);
+
+	/* wait for any key to go back to the main options */
+	KEYPAD_getPressedKey();
+	_delay_ms(500);
+}
+
+/* Description:
+ * function to print the remaining lockout time received from the control ECU
+ */
+void HMI_locked(void)
+{
+	uint16 remaining;
 
-	/* set the timer callback function */
-	Timer1_setCallBack(HMI_TIMER1_count2);
-	/* Timer1 Configuration */
-	Timer1_ConfigType timerType = { 0 , 15625 , PRESCALER_64, COMPARE_MODE};
-	/* Timer1 initialization */
-	Timer1_init(&timerType);
+	TRACE(TRACE_STATE, TRACE_STATE_HMI_LOCKED);
 
-	/* wait for 60 second */
-	while (sec2 !=60){}
+	/* receive the remaining seconds, the high byte first */
+	remaining = (uint16)HMI_receiveState() << 8;
+	remaining |= HMI_receiveState();
 
-	/* clear the sec1 variable */
-	sec2 = 0;
+	LCD_clearScreen();
+	LCD_displayMessage(MSG_SYSTEM_LOCKED);
+	LCD_moveCursor(1,0);
+	LCD_displayMessage(MSG_RETRY_IN);
+	LCD_intgerToString(remaining);
+	LCD_displayCharacter('s');
 
-	/* De-initialize the timer */
-	Timer1_deInit();
+	_delay_ms(2000);
 }
 
 /* Description:
@@ -189,12 +367,14 @@ void HMI_createPass(void)
 	/* variable to store the two password state */
 	uint8 status = UNMATCHED;
 
+	TRACE(TRACE_STATE, TRACE_STATE_HMI_CREATE_PASS);
+
 	/* loop until the state of two passwords is matched */
 	while (status == UNMATCHED)
 	{
 		/* displaying the first title to the user */
 		LCD_clearScreen();
-		LCD_displayString("Plz enter pass:");
+		LCD_displayMessage(MSG_ENTER_PASS);
 		LCD_moveCursor(1,0);
 
 		/* receive the first password from the user and send it to the control ECU */
@@ -202,9 +382,9 @@ void HMI_createPass(void)
 
 		/* displaying the first title to the user */
 		LCD_clearScreen();
-		LCD_displayString("Plz re-enter the");
+		LCD_displayMessage(MSG_REENTER_PASS);
 		LCD_moveCursor(1,0);
-		LCD_displayString("same pass: ");
+		LCD_displayMessage(MSG_SAME_PASS);
 
 		/* receive the confirm password from the user and send it to the control ECU */
 		HMI_sendPass();
@@ -214,6 +394,36 @@ void HMI_createPass(void)
 	}
 }
 
+/* Description:
+ * function to receive the policy from the control ECU
+ */
+void HMI_receivePolicy(void)
+{
+	uint8 * data = (uint8 *)&g_policy;
+	uint8 i;
+
+	for (i = 0; i < sizeof(POLICY_ConfigType); i++)
+	{
+		data[i] = HMI_receiveState();
+	}
+}
+
+/* Description:
+ * function to receive the policy and create a password if the control ECU has no
+ * stored password, the control ECU sends them after the baud rate negotiation
+ */
+void HMI_startSession(void)
+{
+	/* receive the policy in use from the control ECU */
+	HMI_receivePolicy();
+
+	/* create a password at the start if the control ECU has no stored password */
+	if (HMI_receiveState() == PASS_EMPTY)
+	{
+		HMI_createPass();
+	}
+}
+
 /* Description:
  * function to get the user choice either open door or change password
  */
@@ -221,19 +431,37 @@ uint8 HMI_mainOptions(void)
 {
 	/* variable to store the chosin option */
 	uint8 option;
+	uint8 key;
+
+	TRACE(TRACE_STATE, TRACE_STATE_HMI_MAIN_OPTIONS);
 
 	/* print the options on the screen */
 	LCD_clearScreen();
-	LCD_displayString("+ : Open Door");
+	LCD_displayMessage(MSG_OPEN_DOOR);
 	LCD_moveCursor(1,0);
-	LCD_displayString("- : Change Pass");
+	LCD_displayMessage(MSG_OTHER_OPTIONS);
 
 	/*send the chosen option to the control ECU */
-	HMI_sendState();
+	key = HMI_sendState();
+#if !BUS_ENABLED
+	/* the control ECU was reset or lost the link, negotiate and start again */
+	if (key == HMI_LINK_LOST)
+	{
+		BAUD_negotiateSlave();
+		HMI_startSession();
+		return NO_OPTION;
+	}
+#endif
 
 	/* receive the control ECU choice */
 	option = HMI_receiveState();
 
+	/* the options are displayed again in the next language */
+	if ((key == LANGUAGE_OPTION) && (option == NO_OPTION))
+	{
+		MSG_nextLanguage();
+	}
+
 	return option;
 }
 
@@ -249,11 +477,13 @@ void HMI_openDoor(void)
 	 */
 	uint8 correct= UNMATCHED;
 
+	TRACE(TRACE_STATE, TRACE_STATE_HMI_OPEN_DOOR);
+
 	/* still in the loop until the password is matched or the password was incorrect for 3 times */
 	while (correct == UNMATCHED)
 	{
 		LCD_clearScreen();
-		LCD_displayString("Plz enter pass:");
+		LCD_displayMessage(MSG_ENTER_PASS);
 		LCD_moveCursor(1,0);
 
 		/* receive the password from the user and send it to the CONTROL_ECU to check its state */
@@ -267,7 +497,7 @@ void HMI_openDoor(void)
 	/* check if the password is matched to start opening the door*/
 	case MATCHED:
 		LCD_clearScreen();
-		LCD_displayString("Door isUnlocking");
+		LCD_displayMessage(MSG_DOOR_UNLOCKING);
 
 		/* store the call back function */
 		Timer1_setCallBack(HMI_TIMER1_count1);
@@ -276,8 +506,16 @@ void HMI_openDoor(void)
 		/* Timer1 initialization */
 		Timer1_init(&timerType);
 
-		/* wait until the door is opened and entered and then closed to get out from the loop */
-		while (sec1 != 33){}
+		/* wait until the door is opened and entered and then closed to get out from the loop,
+		 * the CPU sleeps between the Timer1 interrupts which are disabled for the last check
+		 */
+		cli();
+		while (sec1 != HMI_doorCycle())
+		{
+			POWER_sleep(POWER_WAKE_TIMER1);
+			cli();
+		}
+		sei();
 
 		/* clear the sec1 variable */
 		sec1 = 0;
@@ -290,6 +528,13 @@ void HMI_openDoor(void)
 	case COMPARE_ERROR:
 		HMI_error();
 		break;
+
+	/* the password is right but the door can't be opened at this time */
+	case OUT_OF_SCHEDULE:
+		LCD_clearScreen();
+		LCD_displayMessage(MSG_NOT_ALLOWED);
+		_delay_ms(2000);
+		break;
 	}
 }
 
@@ -304,11 +549,13 @@ void HMI_changePass(void)
 	 */
 	uint8 correct = UNMATCHED;
 
+	TRACE(TRACE_STATE, TRACE_STATE_HMI_CHANGE_PASS);
+
 	/* still in the loop until the password is matched or the password was incorrect for 3 times */
 	while (correct == UNMATCHED)
 	{
 		LCD_clearScreen();
-		LCD_displayString("Plz enter pass:");
+		LCD_displayMessage(MSG_ENTER_PASS);
 		LCD_moveCursor(1,0);
 
 		/* receive the password from the user and send it to the CONTROL_ECU to check its state */
@@ -333,7 +580,283 @@ void HMI_changePass(void)
 	}
 }
 
+/* Description:
+ * function to display a policy value and let the user type a new one up to a_max,
+ * enter without typing any number keeps the current value
+ */
+uint16 HMI_readNumber(MSG_IdType a_title, uint16 a_value, uint16 a_max)
+{
+	uint16 value = a_value;
+	uint8 digits = 0;
+	uint8 key;
+
+	LCD_clearScreen();
+	LCD_displayMessage(a_title);
+	LCD_moveCursor(1,0);
+	LCD_intgerToString(value);
+
+	key = KEYPAD_getPressedKey();
+	_delay_ms(500);
+	while (key != ENTER_KEY)
+	{
+		/* clear the current value with the first typed digit */
+		if ((key >= '0') && (key <= '9') && (digits == 0))
+		{
+			value = 0;
+			LCD_moveCursor(1,0);
+			LCD_displayString_P(PSTR("    "));
+			LCD_moveCursor(1,0);
+		}
 
+		/* the digits which make the value bigger than the maximum are ignored */
+		if ((key >= '0') && (key <= '9') && (((value * 10) + (key - '0')) <= a_max))
+		{
+			value = (value * 10) + (key - '0');
+			LCD_displayCharacter(key);
+			digits++;
+		}
+
+		key = KEYPAD_getPressedKey();
+		_delay_ms(500);
+	}
+
+	return value;
+}
+
+/* Description:
+ * Receive the password from the user and send it to the CONTROL_ECU to edit the policy,
+ * the CONTROL_ECU checks the new values and sends back the policy in use
+ */
+void HMI_settings(void)
+{
+	POLICY_ConfigType policy;
+	uint8 * data = (uint8 *)&policy;
+	uint8 correct = UNMATCHED;
+	uint8 i;
+
+	TRACE(TRACE_STATE, TRACE_STATE_HMI_SETTINGS);
+
+	/* still in the loop until the password is matched or the password was incorrect for the maximum attempts */
+	while (correct == UNMATCHED)
+	{
+		LCD_clearScreen();
+		LCD_displayMessage(MSG_ENTER_PASS);
+		LCD_moveCursor(1,0);
+
+		/* receive the password from the user and send it to the CONTROL_ECU to check its state */
+		HMI_sendPass();
+		/* store the new password state */
+		correct = HMI_receiveState();
+	}
+
+	if (correct == COMPARE_ERROR)
+	{
+		HMI_error();
+		return;
+	}
+
+	/* let the user edit every policy value */
+	policy = g_policy;
+	policy.pass_min = HMI_readNumber(MSG_MIN_PASS_SIZE, policy.pass_min, POLICY_PASS_MAX_SIZE);
+	policy.pass_max = HMI_readNumber(MSG_MAX_PASS_SIZE, policy.pass_max, POLICY_PASS_MAX_SIZE);
+	policy.max_attempts = HMI_readNumber(MSG_MAX_ATTEMPTS, policy.max_attempts, POLICY_ATTEMPTS_MAX);
+	policy.lockout_seconds = HMI_readNumber(MSG_LOCKOUT_SECONDS, policy.lockout_seconds, POLICY_LOCKOUT_MAX);
+	policy.door_move = HMI_readNumber(MSG_DOOR_MOVE, policy.door_move, POLICY_DOOR_MAX);
+	policy.door_hold = HMI_readNumber(MSG_DOOR_HOLD, policy.door_hold, POLICY_DOOR_MAX);
+
+	/* send the new policy to the CONTROL_ECU */
+	for (i = 0; i < sizeof(POLICY_ConfigType); i++)
+	{
+		LINK_sendByte(data[i]);
+	}
+
+	/* receive the policy in use, it is the old one if any new value was out of range */
+	HMI_receivePolicy();
+
+	LCD_clearScreen();
+	if ((policy.pass_min == g_policy.pass_min) && (policy.pass_max == g_policy.pass_max)
+		&& (policy.max_attempts == g_policy.max_attempts)
+		&& (policy.lockout_seconds == g_policy.lockout_seconds)
+		&& (policy.door_move == g_policy.door_move) && (policy.door_hold == g_policy.door_hold))
+	{
+		LCD_displayMessage(MSG_SETTINGS_SAVED);
+	}
+	else
+	{
+		LCD_displayMessage(MSG_INVALID_SETTINGS);
+	}
+	_delay_ms(2000);
+}
+
+/* Description:
+ * function to receive the wall clock seconds from the control ECU and split them in
+ * the weekday (1 for Monday), the hour and the minute
+ */
+void HMI_receiveClock(uint8 * a_day, uint8 * a_hour, uint8 * a_minute)
+{
+	uint32 seconds = 0;
+	uint8 i;
+
+	/* the low byte first */
+	for (i = 0; i < 32; i += 8)
+	{
+		seconds |= (uint32)HMI_receiveState() << i;
+	}
+
+	seconds %= SECONDS_PER_WEEK;
+	*a_day = (uint8)(seconds / SECONDS_PER_DAY) + 1;
+	seconds %= SECONDS_PER_DAY;
+	*a_hour = (uint8)(seconds / 3600);
+	*a_minute = (uint8)((seconds % 3600) / 60);
+}
+
+/* Description:
+ * Receive the password from the user and send it to the CONTROL_ECU to set its wall
+ * clock, the CONTROL_ECU checks the new time and sends back the clock in use
+ */
+void HMI_clock(void)
+{
+	uint8 correct = UNMATCHED;
+	uint8 day;
+	uint8 hour;
+	uint8 minute;
+	uint8 newDay;
+	uint8 newHour;
+	uint8 newMinute;
+
+	TRACE(TRACE_STATE, TRACE_STATE_HMI_CLOCK);
+
+	/* still in the loop until the password is matched or the password was incorrect for the maximum attempts */
+	while (correct == UNMATCHED)
+	{
+		LCD_clearScreen();
+		LCD_displayMessage(MSG_ENTER_PASS);
+		LCD_moveCursor(1,0);
+
+		/* receive the password from the user and send it to the CONTROL_ECU to check its state */
+		HMI_sendPass();
+		/* store the new password state */
+		correct = HMI_receiveState();
+	}
+
+	if (correct == COMPARE_ERROR)
+	{
+		HMI_error();
+		return;
+	}
+
+	/* let the user edit the current time */
+	HMI_receiveClock(&day, &hour, &minute);
+	newDay = HMI_readNumber(MSG_CLOCK_DAY, day, 7);
+	newHour = HMI_readNumber(MSG_CLOCK_HOUR, hour, 23);
+	newMinute = HMI_readNumber(MSG_CLOCK_MINUTE, minute, 59);
+
+	/* send the new time to the CONTROL_ECU */
+	LINK_sendByte(newDay);
+	LINK_sendByte(newHour);
+	LINK_sendByte(newMinute);
+
+	/* receive the clock in use, it is the old one if the new time was out of range */
+	HMI_receiveClock(&day, &hour, &minute);
+
+	LCD_clearScreen();
+	if ((day == newDay) && (hour == newHour) && (minute == newMinute))
+	{
+		LCD_displayMessage(MSG_CLOCK_SAVED);
+	}
+	else
+	{
+		LCD_displayMessage(MSG_INVALID_SETTINGS);
+	}
+	_delay_ms(2000);
+}
+
+/* Description:
+ * function to receive the trace buffer of the CONTROL_ECU then send the one of the
+ * HMI_ECU, the two dumps can be read by a serial monitor on the UART lines
+ */
+void HMI_traceDump(void)
+{
+	TRACE(TRACE_STATE, TRACE_STATE_HMI_TRACE_DUMP);
+
+	/* tell the CONTROL_ECU that the HMI_ECU is ready to receive the dump */
+	UART_sendByte(HMI_ECU_READY);
+	TRACE_skip();
+	TRACE_dump();
+
+	LCD_clearScreen();
+	LCD_displayMessage(MSG_TRACE_SENT);
+	_delay_ms(1000);
+}
+
+/* Description:
+ * function to receive the audit log frames of the CONTROL_ECU, they can be read by
+ * a serial monitor on the UART lines. The frames are taken in place from the Rx
+ * buffer without looking at their bytes, so the HMI_ECU keeps up with the stream.
+ */
+void HMI_logExport(void)
+{
+	UART_MessageType frame;
+	uint16 records = 0;
+
+	TRACE(TRACE_STATE, TRACE_STATE_HMI_LOG_EXPORT);
+
+	/* tell the CONTROL_ECU that the HMI_ECU is ready to receive the log */
+	UART_sendByte(HMI_ECU_READY);
+
+	/* the header frame holds the version and the number of records */
+	UART_receiveFrame(&frame, UART_MESSAGE_MAX);
+	if (frame.length == 3)
+	{
+		records = frame.data[1] | ((uint16)frame.data[2] << 8);
+	}
+	UART_releaseMessage(&frame);
+
+	/* the data frames end with an empty frame and the CRC */
+	do
+	{
+		UART_receiveFrame(&frame, UART_MESSAGE_MAX);
+		UART_releaseMessage(&frame);
+	} while (frame.size > 1);
+	UART_receiveByte();
+	UART_receiveByte();
+
+	LCD_clearScreen();
+	LCD_displayMessage(MSG_LOG_SENT);
+	LCD_moveCursor(1,0);
+	LCD_intgerToString(records);
+	_delay_ms(2000);
+}
+
+/* Description:
+ * function to receive the performance counters frame of the CONTROL_ECU, the frame
+ * can be read by a serial monitor on the UART lines
+ */
+void HMI_diagnostics(void)
+{
+	uint8 size;
+
+	TRACE(TRACE_STATE, TRACE_STATE_HMI_DIAGNOSTICS);
+
+	/* tell the CONTROL_ECU that the HMI_ECU is ready to receive the frame */
+	UART_sendByte(HMI_ECU_READY);
+
+	/* the frame starts with its size, so the HMI_ECU doesn't depend on its layout */
+	size = UART_receiveByte();
+	while (size != 0)
+	{
+		UART_receiveByte();
+		size--;
+	}
+
+	/* the HMI_ECU has no diagnostics frame, its own stack high-water is displayed */
+	LCD_clearScreen();
+	LCD_displayMessage(MSG_DIAG_SENT);
+	LCD_moveCursor(1,0);
+	LCD_displayMessage(MSG_STACK);
+	LCD_intgerToString(STACK_highWater());
+	_delay_ms(2000);
+}
 
 int main (void)
 {
@@ -343,6 +866,17 @@ int main (void)
 	/* enable interrupt for the timer function*/
 	SREG |= (1<<7) ;
 
+	/* switch off the unused peripherals and start the keypad scan tick */
+	POWER_init();
+	POWER_startTick();
+
+#if BUS_ENABLED
+	/* the CONTROL_ECU polls this keypad on the bus at a fixed rate */
+	BUS_init();
+
+	/* initializing LCD */
+	LCD_init();
+#else
 	/* UART Configuration */
 	UART_ConfigType uartType = {EIGHT_BIT, DISABLED, ONE_BIT, 9600};
 	/* UART initialization */
@@ -351,8 +885,12 @@ int main (void)
 	/* initializing LCD */
 	LCD_init();
 
-	/* create a password at the start */
-	HMI_createPass();
+	/* step up to the fastest baud rate which works with the control ECU */
+	BAUD_negotiateSlave();
+#endif
+
+	/* receive the policy and create a password if there is no stored one */
+	HMI_startSession();
 
 	for (;;)
 	{
@@ -371,6 +909,36 @@ int main (void)
 			HMI_changePass();
 			break;
 
+			/* if the user choose '*' then go to change policy function */
+		case SETTINGS:
+			HMI_settings();
+			break;
+
+			/* if the user choose '=' then send the trace buffers */
+		case TRACE_DUMP:
+			HMI_traceDump();
+			break;
+
+			/* if the user choose '%' then send the performance counters */
+		case DIAGNOSTICS:
+			HMI_diagnostics();
+			break;
+
+			/* if the user choose '#' then '0' then send the audit log */
+		case LOG_EXPORT:
+			HMI_logExport();
+			break;
+
+			/* if the user choose '#' then '1' then set the wall clock */
+		case CLOCK_SET:
+			HMI_clock();
+			break;
+
+			/* if the system is locked then display the remaining time */
+		case LOCKED:
+			HMI_locked();
+			break;
+
 			/* else, ask the user to enter the option he want again by
 			 * repeating the loop */
 		}
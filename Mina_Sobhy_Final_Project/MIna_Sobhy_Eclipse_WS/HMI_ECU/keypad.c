@@ -11,6 +11,7 @@
  *******************************************************************************/
 #include "keypad.h"
 #include "gpio.h"
+#include "power.h"
 #include <util/delay.h>
 
 /*******************************************************************************
@@ -88,6 +89,9 @@ uint8 KEYPAD_getPressedKey(void)
 			}
 			GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+row,PIN_INPUT);
 		}
+
+		/* no key is pressed, sleep until the next scan tick */
+		POWER_sleep(POWER_WAKE_TIMER2);
 	}	
 }
 
@@ -14,6 +14,7 @@
 #define KEYPAD_H_
 
 #include "std_types.h"
+#include "board_config.h"
 
 /*******************************************************************************
  *                                Definitions                                  *
@@ -23,12 +24,7 @@
 #define KEYPAD_NUM_COLS                   4
 #define KEYPAD_NUM_ROWS                   4
 
-/* Keypad Port Configurations */
-#define KEYPAD_ROW_PORT_ID                PORTA_ID
-#define KEYPAD_FIRST_ROW_PIN_ID           PIN0_ID
-
-#define KEYPAD_COL_PORT_ID                PORTA_ID
-#define KEYPAD_FIRST_COL_PIN_ID           PIN4_ID
+/* Keypad Port Configurations are in board_config.h */
 
 /* Keypad button logic configurations */
 #define KEYPAD_BUTTON_PRESSED            LOGIC_LOW
@@ -8,6 +8,7 @@
 
 #include <stdlib.h> /* For itoa function */
 #include <util/delay.h> /* For the delay functions */
+#include <avr/pgmspace.h> /* For the strings in the flash */
 #include "common_macros.h" /* To use the macros like SET_BIT */
 #include "lcd.h"
 #include "gpio.h"
@@ -171,6 +172,31 @@ void LCD_displayString(const char *STR_PTR)
 	*********************************************************/
 }
 
+/*
+ * Description :
+ * Display the required string stored in the flash (PROGMEM or PSTR) on the screen
+ */
+void LCD_displayString_P(const char *STR_PTR)
+{
+	uint8 character = pgm_read_byte(STR_PTR); /* read by lpm from the program memory */
+
+	while(character != '\0')
+	{
+		LCD_displayCharacter(character);
+		STR_PTR++;
+		character = pgm_read_byte(STR_PTR);
+	}
+}
+
+/*
+ * Description :
+ * Display the required message in the language selected by MSG_setLanguage
+ */
+void LCD_displayMessage(MSG_IdType a_id)
+{
+	LCD_displayString_P(MSG_get(a_id));
+}
+
 /*
  * Description :
  * Move the cursor to a specified row and column index on the screen
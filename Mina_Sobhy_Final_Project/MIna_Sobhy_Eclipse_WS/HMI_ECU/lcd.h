@@ -10,14 +10,14 @@
 #define LCD_H_
 
 #include "std_types.h"
+#include "board_config.h"
+#include "messages.h"
 
 /*******************************************************************************
  *                                Definitions                                  *
  *******************************************************************************/
 
-/* LCD Data bits mode configuration, its value should be 4 or 8*/
-#define LCD_DATA_BITS_MODE 8
-
+/* LCD Data bits mode configuration is in board_config.h, its value should be 4 or 8*/
 #if((LCD_DATA_BITS_MODE != 4) && (LCD_DATA_BITS_MODE != 8))
 
 #error "Number of Data bits should be equal to 4 or 8"
@@ -38,17 +38,7 @@
 
 #endif
 
-/* LCD HW Ports and Pins Ids */
-#define LCD_RS_PORT_ID                 PORTD_ID
-#define LCD_RS_PIN_ID                  PIN2_ID
-
-#define LCD_RW_PORT_ID                 PORTD_ID
-#define LCD_RW_PIN_ID                  PIN3_ID
-
-#define LCD_E_PORT_ID                  PORTD_ID
-#define LCD_E_PIN_ID                   PIN4_ID
-
-#define LCD_DATA_PORT_ID               PORTC_ID
+/* LCD HW Ports and Pins Ids are in board_config.h */
 
 /* LCD Commands */
 #define LCD_CLEAR_COMMAND              0x01
@@ -89,6 +79,18 @@ void LCD_displayCharacter(uint8 a_data);
  */
 void LCD_displayString(const char *STR_PTR);
 
+/*
+ * Description :
+ * Display the required string stored in the flash (PROGMEM or PSTR) on the screen
+ */
+void LCD_displayString_P(const char *STR_PTR);
+
+/*
+ * Description :
+ * Display the required message in the language selected by MSG_setLanguage
+ */
+void LCD_displayMessage(MSG_IdType a_id);
+
 /*
  * Description :
  * Move the cursor to a specified row and column index on the screen
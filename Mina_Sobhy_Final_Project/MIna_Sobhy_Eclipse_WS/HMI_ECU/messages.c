@@ -0,0 +1,198 @@
+/*
+ * messages.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: string tables of the LCD messages of the HMI_ECU in the flash
+ *
+ *      A message is at most 16 characters, the width of the LCD. The strings are
+ *      ASCII only as the HD44780 character ROM has no other accented letters than
+ *      its own codes, so the German umlauts are written as "ae", "oe" and "ue".
+ */
+
+#include "messages.h"
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* older avr-libc versions have no pgm_read_ptr, the flash pointers are 16 bits */
+#ifndef pgm_read_ptr
+#define pgm_read_ptr(address)	((const void *)pgm_read_word(address))
+#endif
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static const char g_enEnterPass[] PROGMEM		= "Plz enter pass:";
+static const char g_enReenterPass[] PROGMEM		= "Plz re-enter the";
+static const char g_enSamePass[] PROGMEM		= "same pass: ";
+static const char g_enDoorUnlocking[] PROGMEM	= "Door isUnlocking";
+static const char g_enEntering[] PROGMEM		= "Entering";
+static const char g_enDoorLocking[] PROGMEM		= "Door is Locking";
+static const char g_enError[] PROGMEM			= "     ERROR     ";
+static const char g_enSystemLocked[] PROGMEM	= "System Locked";
+static const char g_enRetryIn[] PROGMEM			= "Retry in ";
+static const char g_enOpenDoor[] PROGMEM		= "+ : Open Door";
+static const char g_enOtherOptions[] PROGMEM	= "- :Pass  *:Setup";
+static const char g_enMinPassSize[] PROGMEM		= "Min pass size:";
+static const char g_enMaxPassSize[] PROGMEM		= "Max pass size:";
+static const char g_enMaxAttempts[] PROGMEM		= "Max attempts:";
+static const char g_enLockoutSeconds[] PROGMEM	= "Lockout seconds:";
+static const char g_enDoorMove[] PROGMEM		= "Door move secs:";
+static const char g_enDoorHold[] PROGMEM		= "Door hold secs:";
+static const char g_enSettingsSaved[] PROGMEM	= "Settings saved";
+static const char g_enInvalidSettings[] PROGMEM	= "Invalid settings";
+static const char g_enTraceSent[] PROGMEM		= "Trace sent";
+static const char g_enDiagSent[] PROGMEM		= "Diag sent";
+static const char g_enStack[] PROGMEM			= "Stack: ";
+static const char g_enLogSent[] PROGMEM			= "Log sent";
+static const char g_enClockDay[] PROGMEM		= "Day (1=Monday):";
+static const char g_enClockHour[] PROGMEM		= "Hour:";
+static const char g_enClockMinute[] PROGMEM		= "Minute:";
+static const char g_enClockSaved[] PROGMEM		= "Clock set";
+static const char g_enNotAllowed[] PROGMEM		= "Not allowed now";
+
+static const char g_deEnterPass[] PROGMEM		= "Passwort:";
+static const char g_deReenterPass[] PROGMEM		= "Passwort noch";
+static const char g_deSamePass[] PROGMEM		= "einmal: ";
+static const char g_deDoorUnlocking[] PROGMEM	= "Tuer oeffnet";
+static const char g_deEntering[] PROGMEM		= "Eintreten";
+static const char g_deDoorLocking[] PROGMEM		= "Tuer schliesst";
+static const char g_deError[] PROGMEM			= "     FEHLER     ";
+static const char g_deSystemLocked[] PROGMEM	= "System gesperrt";
+static const char g_deRetryIn[] PROGMEM			= "Erneut in ";
+static const char g_deOpenDoor[] PROGMEM		= "+ : Tuer oeffnen";
+static const char g_deOtherOptions[] PROGMEM	= "- :Pass *:Einst.";
+static const char g_deMinPassSize[] PROGMEM		= "Min. Passlaenge:";
+static const char g_deMaxPassSize[] PROGMEM		= "Max. Passlaenge:";
+static const char g_deMaxAttempts[] PROGMEM		= "Max. Versuche:";
+static const char g_deLockoutSeconds[] PROGMEM	= "Sperrzeit Sek.:";
+static const char g_deDoorMove[] PROGMEM		= "Tuer Lauf Sek.:";
+static const char g_deDoorHold[] PROGMEM		= "Tuer offen Sek.:";
+static const char g_deSettingsSaved[] PROGMEM	= "Gespeichert";
+static const char g_deInvalidSettings[] PROGMEM	= "Ungueltig";
+static const char g_deTraceSent[] PROGMEM		= "Trace gesendet";
+static const char g_deDiagSent[] PROGMEM		= "Diag gesendet";
+static const char g_deStack[] PROGMEM			= "Stack: ";
+static const char g_deLogSent[] PROGMEM			= "Log gesendet";
+static const char g_deClockDay[] PROGMEM		= "Tag (1=Montag):";
+static const char g_deClockHour[] PROGMEM		= "Stunde:";
+static const char g_deClockMinute[] PROGMEM		= "Minute:";
+static const char g_deClockSaved[] PROGMEM		= "Uhr gestellt";
+static const char g_deNotAllowed[] PROGMEM		= "Jetzt gesperrt";
+
+/* flash addresses of the strings, indexed by the language then by the message ID */
+static const char * const g_messages[MSG_LANGUAGES][MSG_COUNT] PROGMEM = {
+	[MSG_ENGLISH] = {
+		[MSG_ENTER_PASS]		= g_enEnterPass,
+		[MSG_REENTER_PASS]		= g_enReenterPass,
+		[MSG_SAME_PASS]			= g_enSamePass,
+		[MSG_DOOR_UNLOCKING]	= g_enDoorUnlocking,
+		[MSG_ENTERING]			= g_enEntering,
+		[MSG_DOOR_LOCKING]		= g_enDoorLocking,
+		[MSG_ERROR]				= g_enError,
+		[MSG_SYSTEM_LOCKED]		= g_enSystemLocked,
+		[MSG_RETRY_IN]			= g_enRetryIn,
+		[MSG_OPEN_DOOR]			= g_enOpenDoor,
+		[MSG_OTHER_OPTIONS]		= g_enOtherOptions,
+		[MSG_MIN_PASS_SIZE]		= g_enMinPassSize,
+		[MSG_MAX_PASS_SIZE]		= g_enMaxPassSize,
+		[MSG_MAX_ATTEMPTS]		= g_enMaxAttempts,
+		[MSG_LOCKOUT_SECONDS]	= g_enLockoutSeconds,
+		[MSG_DOOR_MOVE]			= g_enDoorMove,
+		[MSG_DOOR_HOLD]			= g_enDoorHold,
+		[MSG_SETTINGS_SAVED]	= g_enSettingsSaved,
+		[MSG_INVALID_SETTINGS]	= g_enInvalidSettings,
+		[MSG_TRACE_SENT]		= g_enTraceSent,
+		[MSG_DIAG_SENT]			= g_enDiagSent,
+		[MSG_STACK]				= g_enStack,
+		[MSG_LOG_SENT]			= g_enLogSent,
+		[MSG_CLOCK_DAY]			= g_enClockDay,
+		[MSG_CLOCK_HOUR]		= g_enClockHour,
+		[MSG_CLOCK_MINUTE]		= g_enClockMinute,
+		[MSG_CLOCK_SAVED]		= g_enClockSaved,
+		[MSG_NOT_ALLOWED]		= g_enNotAllowed,
+	},
+	[MSG_GERMAN] = {
+		[MSG_ENTER_PASS]		= g_deEnterPass,
+		[MSG_REENTER_PASS]		= g_deReenterPass,
+		[MSG_SAME_PASS]			= g_deSamePass,
+		[MSG_DOOR_UNLOCKING]	= g_deDoorUnlocking,
+		[MSG_ENTERING]			= g_deEntering,
+		[MSG_DOOR_LOCKING]		= g_deDoorLocking,
+		[MSG_ERROR]				= g_deError,
+		[MSG_SYSTEM_LOCKED]		= g_deSystemLocked,
+		[MSG_RETRY_IN]			= g_deRetryIn,
+		[MSG_OPEN_DOOR]			= g_deOpenDoor,
+		[MSG_OTHER_OPTIONS]		= g_deOtherOptions,
+		[MSG_MIN_PASS_SIZE]		= g_deMinPassSize,
+		[MSG_MAX_PASS_SIZE]		= g_deMaxPassSize,
+		[MSG_MAX_ATTEMPTS]		= g_deMaxAttempts,
+		[MSG_LOCKOUT_SECONDS]	= g_deLockoutSeconds,
+		[MSG_DOOR_MOVE]			= g_deDoorMove,
+		[MSG_DOOR_HOLD]			= g_deDoorHold,
+		[MSG_SETTINGS_SAVED]	= g_deSettingsSaved,
+		[MSG_INVALID_SETTINGS]	= g_deInvalidSettings,
+		[MSG_TRACE_SENT]		= g_deTraceSent,
+		[MSG_DIAG_SENT]			= g_deDiagSent,
+		[MSG_STACK]				= g_deStack,
+		[MSG_LOG_SENT]			= g_deLogSent,
+		[MSG_CLOCK_DAY]			= g_deClockDay,
+		[MSG_CLOCK_HOUR]		= g_deClockHour,
+		[MSG_CLOCK_MINUTE]		= g_deClockMinute,
+		[MSG_CLOCK_SAVED]		= g_deClockSaved,
+		[MSG_NOT_ALLOWED]		= g_deNotAllowed,
+	},
+};
+
+static MSG_LanguageType g_language = MSG_ENGLISH;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Select the language of the following MSG_get calls, English after the reset.
+ */
+void MSG_setLanguage(MSG_LanguageType a_language)
+{
+	if (a_language < MSG_LANGUAGES)
+	{
+		g_language = a_language;
+	}
+}
+
+/*
+ * Description :
+ * Return the language in use.
+ */
+MSG_LanguageType MSG_getLanguage(void)
+{
+	return g_language;
+}
+
+/*
+ * Description :
+ * Select the next language, after the last one comes the first again.
+ */
+void MSG_nextLanguage(void)
+{
+	g_language = (g_language + 1 < MSG_LANGUAGES) ? (g_language + 1) : MSG_ENGLISH;
+}
+
+/*
+ * Description :
+ * Return the flash address of the message a_id in the language in use.
+ */
+const char * MSG_get(MSG_IdType a_id)
+{
+	if (a_id >= MSG_COUNT)
+	{
+		a_id = MSG_ERROR;
+	}
+	return (const char *)pgm_read_ptr(&g_messages[g_language][a_id]);
+}
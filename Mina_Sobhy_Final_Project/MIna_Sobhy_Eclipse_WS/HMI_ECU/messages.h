@@ -0,0 +1,89 @@
+/*
+ * messages.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: header file of the LCD messages of the HMI_ECU, every message
+ *      			 has an ID and one string per language kept in the flash
+ *
+ *      The strings and the tables of their addresses are PROGMEM, so they are not
+ *      copied to the SRAM at the reset. MSG_get returns a flash address which is
+ *      read by LCD_displayString_P, never by the normal string functions.
+ */
+
+#ifndef MESSAGES_H_
+#define MESSAGES_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef enum
+{
+	MSG_ENTER_PASS,
+	MSG_REENTER_PASS,
+	MSG_SAME_PASS,
+	MSG_DOOR_UNLOCKING,
+	MSG_ENTERING,
+	MSG_DOOR_LOCKING,
+	MSG_ERROR,
+	MSG_SYSTEM_LOCKED,
+	MSG_RETRY_IN,
+	MSG_OPEN_DOOR,
+	MSG_OTHER_OPTIONS,
+	MSG_MIN_PASS_SIZE,
+	MSG_MAX_PASS_SIZE,
+	MSG_MAX_ATTEMPTS,
+	MSG_LOCKOUT_SECONDS,
+	MSG_DOOR_MOVE,
+	MSG_DOOR_HOLD,
+	MSG_SETTINGS_SAVED,
+	MSG_INVALID_SETTINGS,
+	MSG_TRACE_SENT,
+	MSG_DIAG_SENT,
+	MSG_STACK,
+	MSG_LOG_SENT,
+	MSG_CLOCK_DAY,
+	MSG_CLOCK_HOUR,
+	MSG_CLOCK_MINUTE,
+	MSG_CLOCK_SAVED,
+	MSG_NOT_ALLOWED,
+	MSG_COUNT
+} MSG_IdType;
+
+typedef enum
+{
+	MSG_ENGLISH, MSG_GERMAN, MSG_LANGUAGES
+} MSG_LanguageType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Select the language of the following MSG_get calls, English after the reset.
+ */
+void MSG_setLanguage(MSG_LanguageType a_language);
+
+/*
+ * Description :
+ * Return the language in use.
+ */
+MSG_LanguageType MSG_getLanguage(void);
+
+/*
+ * Description :
+ * Select the next language, after the last one comes the first again.
+ */
+void MSG_nextLanguage(void);
+
+/*
+ * Description :
+ * Return the flash address of the message a_id in the language in use.
+ */
+const char * MSG_get(MSG_IdType a_id);
+
+#endif /* MESSAGES_H_ */
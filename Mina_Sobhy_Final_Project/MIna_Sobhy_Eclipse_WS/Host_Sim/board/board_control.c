@@ -0,0 +1,79 @@
+/*
+ * board_control.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: model of the Control_ECU board, the buzzer and the door motor
+ *      			 are reported in the simulation log
+ */
+
+#include "gpio.h"
+#include "buzzer.h"
+#include "dcmotor.h"
+#include "sim.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+const char SIM_nodeName[] = "control";
+
+static unsigned char g_buzzer = 0;
+static unsigned char g_motor = 0;	/* motor pins, bit 0 is pin A and bit 1 is pin B */
+static unsigned char g_reported = 0;
+static unsigned char g_duty = 0;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void SIM_boardPinWrite(unsigned char a_port, unsigned char a_pin, unsigned char a_value)
+{
+	if ((a_port == BUZZER_PORT) && (a_pin == BUZZER_PIN))
+	{
+		if (a_value != g_buzzer)
+		{
+			g_buzzer = a_value;
+			SIM_log("buzzer %s", a_value ? "on" : "off");
+		}
+		return;
+	}
+
+	if ((a_port == DCmotor_PORTA) && (a_pin == DCmotor_PINA))
+	{
+		g_motor = (g_motor & ~1) | (a_value ? 1 : 0);
+	}
+	else if ((a_port == DCmotor_PORTB) && (a_pin == DCmotor_PINB))
+	{
+		g_motor = (g_motor & ~2) | (a_value ? 2 : 0);
+	}
+}
+
+int SIM_boardPinRead(unsigned char a_port, unsigned char a_pin, unsigned char * a_value)
+{
+	(void)a_port;
+	(void)a_pin;
+	(void)a_value;
+	return 0;
+}
+
+/*
+ * Description :
+ * The motor driver sets the pins then the speed, so the motor is reported here
+ * once both are stable.
+ */
+void SIM_boardPwm(unsigned char a_duty)
+{
+	static const char * const directions[] = {"stopped", "unlocking (CW)", "locking (ACW)", "braked"};
+
+	if ((a_duty != g_duty) || (g_motor != g_reported))
+	{
+		g_duty = a_duty;
+		g_reported = g_motor;
+		SIM_log("door motor %s, %u%% speed", directions[g_motor], (g_duty * 100U + 127U) / 255U);
+	}
+}
+
+void SIM_boardIdle(void)
+{
+}
@@ -0,0 +1,193 @@
+/*
+ * board_hmi.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: model of the HMI_ECU board, a 16x2 HD44780 LCD in 8-bit mode
+ *      			 printed in the simulation log and a 4x4 keypad pressed by the
+ *      			 characters read from the standard input
+ *
+ *      			 The keys are the keypad characters (0-9 % * - # = +), white
+ *      			 space is ignored and 'w' waits one second before the next key.
+ *      			 The ECU is powered off at the end of the input.
+ */
+
+#include "gpio.h"
+#include "lcd.h"
+#include "keypad.h"
+#include "power.h"
+#include "sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SIM_LCD_COLUMNS		16
+#define SIM_LCD_LINE2		0x40
+#define SIM_KEY_NONE		0xFF
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+const char SIM_nodeName[] = "hmi";
+
+/* keypad characters at every row and column, the inverse of the keypad driver map */
+static const char g_keyMap[KEYPAD_NUM_ROWS][KEYPAD_NUM_COLS + 1] = {"789%", "456*", "123-", "#0=+"};
+
+static char g_ddram[0x80];
+static unsigned char g_cursor = 0;
+static unsigned char g_dirty = 0;
+static unsigned char g_enable = 0;
+
+static unsigned char g_keyRow = SIM_KEY_NONE;
+static unsigned char g_keyCol = SIM_KEY_NONE;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Execute the instruction or write the data on the bus at the falling edge of E.
+ */
+static void SIM_lcdLatch(void)
+{
+	unsigned char data = SIM_gpioPort(LCD_DATA_PORT_ID);
+
+	if (SIM_gpioPort(LCD_RS_PORT_ID) & (1 << LCD_RS_PIN_ID))
+	{
+		g_ddram[g_cursor] = (char)data;
+		g_cursor = (g_cursor + 1) & 0x7F;
+		g_dirty = 1;
+	}
+	else if (data & LCD_SET_CURSOR_LOCATION)
+	{
+		g_cursor = data & 0x7F;
+	}
+	else if (data == LCD_CLEAR_COMMAND)
+	{
+		memset(g_ddram, ' ', sizeof(g_ddram));
+		g_cursor = 0;
+		g_dirty = 1;
+	}
+	else if (data == LCD_GO_TO_HOME)
+	{
+		g_cursor = 0;
+	}
+}
+
+void SIM_boardPinWrite(unsigned char a_port, unsigned char a_pin, unsigned char a_value)
+{
+	if ((a_port == LCD_E_PORT_ID) && (a_pin == LCD_E_PIN_ID))
+	{
+		if (g_enable && !a_value)
+		{
+			SIM_lcdLatch();
+		}
+		g_enable = a_value;
+	}
+}
+
+/*
+ * Description :
+ * Wait for the next key of the input, the screen is printed first as the user
+ * reads it before pressing.
+ */
+static void SIM_keyNext(void)
+{
+	const char * position;
+	unsigned char row;
+	int key;
+
+	SIM_boardIdle();
+
+	/* the firmware sleeps between the keypad scan ticks until the key is pressed */
+	SIM_powerSleep(POWER_IDLE);
+	for (;;)
+	{
+		key = getchar();
+		if (key == EOF)
+		{
+			SIM_log("no more keys, power off");
+			exit(0);
+		}
+		if (key == 'w')
+		{
+			SIM_delay(1000000ULL);
+			continue;
+		}
+
+		for (row = 0; row < KEYPAD_NUM_ROWS; row++)
+		{
+			position = (key != '\0') ? strchr(g_keyMap[row], key) : NULL;
+			if (position != NULL)
+			{
+				g_keyRow = row;
+				g_keyCol = (unsigned char)(position - g_keyMap[row]);
+				SIM_log("key %c", key);
+				SIM_powerWake();
+				return;
+			}
+		}
+	}
+}
+
+/*
+ * Description :
+ * A pressed key connects its row and column, the column reads low while the
+ * keypad driver drives the row low. The key is released once it is detected.
+ */
+int SIM_boardPinRead(unsigned char a_port, unsigned char a_pin, unsigned char * a_value)
+{
+	unsigned char row;
+
+	if ((a_port != KEYPAD_COL_PORT_ID) || (a_pin < KEYPAD_FIRST_COL_PIN_ID)
+		|| (a_pin >= KEYPAD_FIRST_COL_PIN_ID + KEYPAD_NUM_COLS))
+	{
+		return 0;
+	}
+
+	if (g_keyRow == SIM_KEY_NONE)
+	{
+		SIM_keyNext();
+	}
+
+	*a_value = KEYPAD_BUTTON_RELEASED;
+	if (a_pin == KEYPAD_FIRST_COL_PIN_ID + g_keyCol)
+	{
+		row = KEYPAD_FIRST_ROW_PIN_ID + g_keyRow;
+		if ((SIM_gpioDdr(KEYPAD_ROW_PORT_ID) & (1 << row))
+			&& ((SIM_gpioPort(KEYPAD_ROW_PORT_ID) & (1 << row)) == 0))
+		{
+			*a_value = KEYPAD_BUTTON_PRESSED;
+			g_keyRow = SIM_KEY_NONE;
+		}
+	}
+
+	return 1;
+}
+
+void SIM_boardPwm(unsigned char a_duty)
+{
+	(void)a_duty;
+}
+
+/*
+ * Description :
+ * Print the screen when it changed since it was printed last.
+ */
+void SIM_boardIdle(void)
+{
+	SIM_irqLock();
+	if (g_dirty)
+	{
+		g_dirty = 0;
+		SIM_log("LCD |%.*s|", SIM_LCD_COLUMNS, &g_ddram[0]);
+		SIM_log("    |%.*s|", SIM_LCD_COLUMNS, &g_ddram[SIM_LCD_LINE2]);
+	}
+	SIM_irqUnlock();
+}
@@ -0,0 +1,62 @@
+/*
+ * clock_sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host implementation of the real-time clock, the time is the
+ *      			 simulation time (SIM_now) which starts with the ECU, there
+ *      			 is no Timer2 interrupt to read around
+ */
+
+#include "clock.h"
+#include "sim.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static uint32 g_wallOffset = 0;
+static uint8 g_wallSet = FALSE;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void CLOCK_init(void)
+{
+}
+
+void CLOCK_now(CLOCK_TimeType * a_time)
+{
+	unsigned long long now = SIM_now();
+
+	a_time->seconds = (uint32)(now / 1000000ULL);
+	a_time->ticks = (uint8)(((now % 1000000ULL) * CLOCK_TICKS_PER_SECOND) / 1000000ULL);
+}
+
+uint32 CLOCK_counts(void)
+{
+	return (uint32)((SIM_now() * BOARD_RTC_CRYSTAL_HZ) / 1000000ULL);
+}
+
+void CLOCK_setWall(uint32 a_seconds)
+{
+	CLOCK_TimeType now;
+
+	CLOCK_now(&now);
+	g_wallOffset = a_seconds - now.seconds;
+	g_wallSet = TRUE;
+}
+
+uint32 CLOCK_wall(void)
+{
+	CLOCK_TimeType now;
+
+	CLOCK_now(&now);
+	return now.seconds + g_wallOffset;
+}
+
+uint8 CLOCK_isSet(void)
+{
+	return g_wallSet;
+}
@@ -0,0 +1,29 @@
+/*
+ * delay_sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host implementation of the avr-libc busy wait delays
+ */
+
+#include <util/delay.h>
+#include "sim.h"
+
+/*******************************************************************************
+ *                          Functions Definitions                              *
+ *******************************************************************************/
+
+void _delay_ms(double a_ms)
+{
+	/* the long delays are the points where the firmware waits for the user */
+	if (a_ms >= 100)
+	{
+		SIM_boardIdle();
+	}
+	SIM_delay((unsigned long long)(a_ms * 1000));
+}
+
+void _delay_us(double a_us)
+{
+	SIM_delay((unsigned long long)a_us);
+}
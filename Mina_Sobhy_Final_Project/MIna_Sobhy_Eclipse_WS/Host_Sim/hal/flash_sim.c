@@ -0,0 +1,103 @@
+/*
+ * flash_sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host implementation of the data region of the flash. The
+ *      			 temporary page buffer takes every word once like the SPM
+ *      			 one, the erase and the write of a page take their time and
+ *      			 a write only clears bits as the SPM does
+ */
+
+#include "flash.h"
+#include "sim.h"
+#include <string.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* the region and the buffer are kept inverted so that the zeroed memory is erased */
+static uint8 g_region[FLASH_DATA_SIZE];
+static uint8 g_buffer[FLASH_PAGE_SIZE];
+static uint8 g_filled[FLASH_PAGE_SIZE / 2];
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void FLASH_read(uint16 a_offset, uint8 * a_data, uint8 a_size)
+{
+	uint8 i;
+
+	for (i = 0; i < a_size; i++)
+	{
+		a_data[i] = ((uint16)(a_offset + i) < FLASH_DATA_SIZE) ? (uint8)~g_region[a_offset + i] : 0xFF;
+	}
+}
+
+void FLASH_erasePage(uint16 a_offset)
+{
+	uint16 page = a_offset & ~(FLASH_PAGE_SIZE - 1);
+
+	if (page >= FLASH_DATA_SIZE)
+	{
+		SIM_log("flash: page %u out of the data region", page);
+		return;
+	}
+
+	SIM_delay(FLASH_SPM_US);
+	memset(&g_region[page], 0, FLASH_PAGE_SIZE);
+}
+
+void FLASH_fillPage(uint16 a_offset, const uint8 * a_data, uint8 a_size)
+{
+	uint16 word;
+	uint8 i;
+
+	if ((a_offset & 1) || (a_size & 1))
+	{
+		SIM_log("flash: page buffer filled at an odd offset %u or size %u", a_offset, a_size);
+		return;
+	}
+
+	for (i = 0; i < a_size; i += 2)
+	{
+		word = (a_offset + i) & (FLASH_PAGE_SIZE - 1);
+		if (g_filled[word / 2])
+		{
+			SIM_log("flash: word %u of the page buffer filled twice", word);
+		}
+		g_filled[word / 2] = TRUE;
+		g_buffer[word] = ~a_data[i];
+		g_buffer[word + 1] = ~a_data[i + 1];
+	}
+}
+
+void FLASH_writePage(uint16 a_offset)
+{
+	uint16 page = a_offset & ~(FLASH_PAGE_SIZE - 1);
+	uint8 i;
+
+	if (page >= FLASH_DATA_SIZE)
+	{
+		SIM_log("flash: page %u out of the data region", page);
+		return;
+	}
+
+	/* the words not filled are written erased, the bits of a page which wasn't
+	 * erased stay cleared
+	 */
+	SIM_delay(FLASH_SPM_US);
+	for (i = 0; i < FLASH_PAGE_SIZE; i++)
+	{
+		g_region[page + i] |= g_buffer[i];
+	}
+	FLASH_dropPage();
+}
+
+void FLASH_dropPage(void)
+{
+	memset(g_buffer, 0, sizeof(g_buffer));
+	memset(g_filled, FALSE, sizeof(g_filled));
+}
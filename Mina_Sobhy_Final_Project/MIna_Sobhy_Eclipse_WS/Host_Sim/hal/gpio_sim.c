@@ -0,0 +1,146 @@
+/*
+ * gpio_sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host implementation of the GPIO driver, the pins are kept in
+ *      			 RAM and the board model of the ECU is told about every change
+ */
+
+#include "gpio.h"
+#include "sim.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static uint8 g_port[NUM_OF_PORTS];
+static uint8 g_ddr[NUM_OF_PORTS];
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+unsigned char SIM_gpioPort(unsigned char a_port)
+{
+	return (a_port < NUM_OF_PORTS) ? g_port[a_port] : 0;
+}
+
+unsigned char SIM_gpioDdr(unsigned char a_port)
+{
+	return (a_port < NUM_OF_PORTS) ? g_ddr[a_port] : 0;
+}
+
+void GPIO_setupPinDirection(uint8 port_num, uint8 pin_num, GPIO_PinDirectionType direction)
+{
+	if ((pin_num >= NUM_OF_PINS_PER_PORT) || (port_num >= NUM_OF_PORTS))
+	{
+		return;
+	}
+
+	SIM_irqLock();
+	if (direction == PIN_OUTPUT)
+	{
+		g_ddr[port_num] |= (1 << pin_num);
+	}
+	else
+	{
+		g_ddr[port_num] &= ~(1 << pin_num);
+	}
+	SIM_irqUnlock();
+}
+
+void GPIO_writePin(uint8 port_num, uint8 pin_num, uint8 value)
+{
+	if ((pin_num >= NUM_OF_PINS_PER_PORT) || (port_num >= NUM_OF_PORTS))
+	{
+		return;
+	}
+
+	SIM_irqLock();
+	if (value == LOGIC_HIGH)
+	{
+		g_port[port_num] |= (1 << pin_num);
+	}
+	else
+	{
+		g_port[port_num] &= ~(1 << pin_num);
+	}
+	SIM_boardPinWrite(port_num, pin_num, value);
+	SIM_irqUnlock();
+}
+
+uint8 GPIO_readPin(uint8 port_num, uint8 pin_num)
+{
+	uint8 value;
+
+	if ((pin_num >= NUM_OF_PINS_PER_PORT) || (port_num >= NUM_OF_PORTS))
+	{
+		return LOGIC_LOW;
+	}
+
+	/* a pin which isn't driven by the board model reads its output value,
+	 * or high for an input as every input has a pull up resistor
+	 */
+	if (!SIM_boardPinRead(port_num, pin_num, &value))
+	{
+		if (g_ddr[port_num] & (1 << pin_num))
+		{
+			value = (g_port[port_num] >> pin_num) & 1;
+		}
+		else
+		{
+			value = LOGIC_HIGH;
+		}
+	}
+
+	return value;
+}
+
+void GPIO_setupPortDirection(uint8 port_num, uint8 direction)
+{
+	if (port_num >= NUM_OF_PORTS)
+	{
+		return;
+	}
+
+	SIM_irqLock();
+	g_ddr[port_num] = direction;
+	SIM_irqUnlock();
+}
+
+void GPIO_writePort(uint8 port_num, uint8 value)
+{
+	uint8 pin;
+
+	if (port_num >= NUM_OF_PORTS)
+	{
+		return;
+	}
+
+	SIM_irqLock();
+	g_port[port_num] = value;
+	for (pin = 0; pin < NUM_OF_PINS_PER_PORT; pin++)
+	{
+		SIM_boardPinWrite(port_num, pin, (value >> pin) & 1);
+	}
+	SIM_irqUnlock();
+}
+
+uint8 GPIO_readPort(uint8 port_num)
+{
+	uint8 value = 0;
+	uint8 pin;
+
+	if (port_num >= NUM_OF_PORTS)
+	{
+		return 0;
+	}
+
+	for (pin = 0; pin < NUM_OF_PINS_PER_PORT; pin++)
+	{
+		value |= (GPIO_readPin(port_num, pin) << pin);
+	}
+
+	return value;
+}
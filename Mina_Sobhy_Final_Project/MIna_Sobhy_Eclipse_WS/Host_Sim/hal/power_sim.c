@@ -0,0 +1,168 @@
+/*
+ * power_sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host implementation of the power manager and model of the
+ *      			 supply current of the ATmega32
+ *
+ *      The simulation time spent active and in every sleep mode is summed and
+ *      printed with the estimated current when the ECU is powered off. The
+ *      currents are typical values read from the ATmega32 characteristics at
+ *      5 V, 25 C, for the microcontroller only (no LCD, motor or buzzer).
+ */
+
+#include "power.h"
+#include "sim.h"
+#include <avr/interrupt.h>
+#include <stdlib.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* index of the active CPU after the POWER_ModeType values */
+#define POWER_SIM_ACTIVE		3
+#define POWER_SIM_STATES		4
+
+#define POWER_SIM_MHZ			((double)F_CPU / 1000000.0)
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static const char * const g_stateName[POWER_SIM_STATES] = {
+	"idle", "power save", "power down", "active"
+};
+
+static unsigned long long g_stateTime[POWER_SIM_STATES];
+static unsigned long long g_stateSince = 0;
+static unsigned char g_state = POWER_SIM_ACTIVE;
+static unsigned char g_tick = FALSE;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static double POWER_current(unsigned char a_state);
+static void POWER_account(void);
+static void POWER_report(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Supply current in mA, the active and idle currents grow with the clock.
+ */
+static double POWER_current(unsigned char a_state)
+{
+	switch (a_state)
+	{
+	case POWER_IDLE:
+		return 0.10 + (0.55 * POWER_SIM_MHZ);
+	case POWER_SAVE:
+		return 0.009;
+	case POWER_DOWN:
+		return 0.001;
+	default:
+		return 0.25 + (1.35 * POWER_SIM_MHZ);
+	}
+}
+
+/*
+ * Description :
+ * Add the time since the last change to the current state.
+ */
+static void POWER_account(void)
+{
+	unsigned long long now = SIM_now();
+
+	g_stateTime[g_state] += now - g_stateSince;
+	g_stateSince = now;
+}
+
+/*
+ * Description :
+ * Print the time and the charge of every state when the ECU is powered off.
+ */
+static void POWER_report(void)
+{
+	double seconds;
+	double total = 0;
+	double charge = 0;
+	unsigned char state;
+
+	POWER_account();
+	for (state = 0; state < POWER_SIM_STATES; state++)
+	{
+		seconds = (double)g_stateTime[state] / 1000000.0;
+		total += seconds;
+		charge += seconds * POWER_current(state);
+		if (g_stateTime[state] != 0)
+		{
+			SIM_log("power: %-10s %9.3f s at %7.3f mA", g_stateName[state], seconds,
+				POWER_current(state));
+		}
+	}
+
+	if (total > 0)
+	{
+		SIM_log("power: average %.3f mA, %.6f mAh in %.3f s", charge / total,
+			charge / 3600.0, total);
+	}
+}
+
+void SIM_powerSleep(unsigned char a_mode)
+{
+	POWER_account();
+	g_state = a_mode;
+}
+
+void SIM_powerWake(void)
+{
+	POWER_account();
+	g_state = POWER_SIM_ACTIVE;
+}
+
+void POWER_init(void)
+{
+	g_stateSince = SIM_now();
+	atexit(POWER_report);
+}
+
+void POWER_startTick(void)
+{
+	g_tick = TRUE;
+}
+
+POWER_ModeType POWER_selectMode(uint8 a_wake)
+{
+	/* Timer2 has no 32 kHz crystal on the boards, so power save is never used */
+	if (a_wake & (POWER_WAKE_UART | POWER_WAKE_TIMER1 | POWER_WAKE_TIMER2))
+	{
+		return POWER_IDLE;
+	}
+	return POWER_DOWN;
+}
+
+void POWER_sleep(uint8 a_wake)
+{
+	/* the callers check their condition with the interrupts disabled, the sleep
+	 * enables them as the sei before sleep_cpu on the target
+	 */
+	sei();
+	SIM_powerSleep(POWER_selectMode(a_wake));
+
+	if (a_wake & (POWER_WAKE_UART | POWER_WAKE_TIMER1))
+	{
+		SIM_waitInterrupt((a_wake & POWER_WAKE_UART) ? 1 : 0);
+	}
+	else if ((a_wake & POWER_WAKE_TIMER2) && g_tick)
+	{
+		SIM_delay(POWER_TICK_MS * 1000ULL);
+	}
+
+	SIM_powerWake();
+}
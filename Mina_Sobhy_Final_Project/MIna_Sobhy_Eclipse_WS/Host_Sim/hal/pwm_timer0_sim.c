@@ -0,0 +1,24 @@
+/*
+ * pwm_timer0_sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host implementation of the Timer0 PWM driver
+ */
+
+#include "pwm_timer0.h"
+#include "sim.h"
+
+/*******************************************************************************
+ *                          Functions Definitions                              *
+ *******************************************************************************/
+
+void PWM_Timer0_Start(uint8 a_dutyCycle)
+{
+	SIM_boardPwm(a_dutyCycle);
+}
+
+void PWM_Timer0_Stop(void)
+{
+	SIM_boardPwm(0);
+}
@@ -0,0 +1,25 @@
+/*
+ * stack_sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host implementation of the stack high-water measurement, the
+ *      			 host stack has nothing in common with the 2 KB of the ATmega32
+ *      			 so nothing is measured
+ */
+
+#include "stack.h"
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+uint16 STACK_highWater(void)
+{
+	return 0;
+}
+
+uint16 STACK_free(void)
+{
+	return 0;
+}
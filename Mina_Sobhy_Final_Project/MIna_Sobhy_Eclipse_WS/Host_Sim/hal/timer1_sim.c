@@ -0,0 +1,73 @@
+/*
+ * timer1_sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host implementation of the Timer1 driver, the compare match or
+ *      			 overflow interrupt is raised by the simulation timer thread
+ */
+
+#include "timer1.h"
+#include "trace.h"
+#include "sim.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static void (*g_callBackPtr)(void) = NULL_PTR;
+static Timer1_Mode g_mode = NORMAL_MODE;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Called by the simulation timer thread as the Timer1 ISR.
+ */
+static void Timer1_isr(void)
+{
+	TRACE((g_mode == COMPARE_MODE) ? TRACE_TIMER1_COMPA : TRACE_TIMER1_OVF, 0);
+
+	if (g_callBackPtr != NULL_PTR)
+	{
+		(*g_callBackPtr)();
+	}
+}
+
+void Timer1_init(const Timer1_ConfigType * Config_Ptr)
+{
+	static const uint16 prescalers[] = {0, 1, 8, 64, 256, 1024};
+	unsigned long long counts;
+
+	if ((Config_Ptr->prescaler == NOCLOCK) || (Config_Ptr->prescaler > PRESCALER_1024))
+	{
+		SIM_timerStop();
+		return;
+	}
+
+	g_mode = Config_Ptr->mode;
+
+	/* number of timer counts between two interrupts */
+	if (Config_Ptr->mode == COMPARE_MODE)
+	{
+		counts = (unsigned long long)Config_Ptr->compare_value - Config_Ptr->initial_value + 1;
+	}
+	else
+	{
+		counts = 65536ULL - Config_Ptr->initial_value;
+	}
+
+	SIM_timerStart((counts * prescalers[Config_Ptr->prescaler] * 1000000ULL) / F_CPU, Timer1_isr);
+}
+
+void Timer1_deInit(void)
+{
+	SIM_timerStop();
+}
+
+void Timer1_setCallBack(void(*a_ptr)(void))
+{
+	g_callBackPtr = a_ptr;
+}
@@ -0,0 +1,233 @@
+/*
+ * twi_sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host implementation of the TWI driver with a 24C16 EEPROM on
+ *      			 the bus. The EEPROM answers with the same status codes as the
+ *      			 real bus, wraps the page writes, NACKs its address during the
+ *      			 write cycle and keeps its content in the SIM_EEPROM file
+ */
+
+#include "twi.h"
+#include "sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SIM_EEPROM_SIZE			2048
+#define SIM_EEPROM_PAGE_SIZE	16
+#define SIM_EEPROM_WRITE_US		5000	/* tWR of the 24C16 */
+
+/* status codes which the application doesn't define */
+#define TWI_MT_SLA_W_NACK		0x20
+#define TWI_MR_SLA_R_NACK		0x48
+#define TWI_NO_INFO				0xF8
+
+typedef enum
+{
+	SIM_TWI_IDLE, SIM_TWI_ADDRESS, SIM_TWI_WORD_ADDRESS, SIM_TWI_WRITE, SIM_TWI_READ, SIM_TWI_IGNORE
+} SIM_TwiStateType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static uint8 g_memory[SIM_EEPROM_SIZE];
+static uint8 g_page[SIM_EEPROM_PAGE_SIZE];
+static uint8 g_pageWritten[SIM_EEPROM_PAGE_SIZE];
+static uint16 g_pointer = 0;
+static uint8 g_status = TWI_NO_INFO;
+static SIM_TwiStateType g_state = SIM_TWI_IDLE;
+static unsigned long long g_busyUntil = 0;
+static const char * g_file = NULL;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Load the EEPROM content, a new device is erased (0xFF).
+ */
+static void SIM_eepromLoad(void)
+{
+	FILE * file;
+
+	memset(g_memory, 0xFF, sizeof(g_memory));
+	g_file = getenv(SIM_ENV_EEPROM);
+	if (g_file == NULL)
+	{
+		return;
+	}
+
+	file = fopen(g_file, "rb");
+	if (file != NULL)
+	{
+		if (fread(g_memory, 1, sizeof(g_memory), file) != sizeof(g_memory))
+		{
+			SIM_log("EEPROM file %s is short, the rest is erased", g_file);
+		}
+		fclose(file);
+	}
+}
+
+static void SIM_eepromSave(void)
+{
+	FILE * file;
+
+	if (g_file == NULL)
+	{
+		return;
+	}
+
+	file = fopen(g_file, "wb");
+	if (file != NULL)
+	{
+		fwrite(g_memory, 1, sizeof(g_memory), file);
+		fclose(file);
+	}
+}
+
+/*
+ * Description :
+ * Program the bytes latched in the page buffer, the device is busy for tWR after.
+ */
+static void SIM_eepromCommit(void)
+{
+	uint16 page = g_pointer & ~(SIM_EEPROM_PAGE_SIZE - 1);
+	uint8 i;
+	uint8 count = 0;
+
+	for (i = 0; i < SIM_EEPROM_PAGE_SIZE; i++)
+	{
+		if (g_pageWritten[i])
+		{
+			g_memory[page + i] = g_page[i];
+			count++;
+		}
+	}
+
+	if (count != 0)
+	{
+		g_busyUntil = SIM_now() + SIM_EEPROM_WRITE_US;
+		SIM_eepromSave();
+	}
+}
+
+void TWI_init(const TWI_ConfigType * Config_Ptr)
+{
+	(void)Config_Ptr;
+	SIM_eepromLoad();
+	g_state = SIM_TWI_IDLE;
+}
+
+void TWI_start(void)
+{
+	g_status = (g_state == SIM_TWI_IDLE) ? TWI_START : TWI_REP_START;
+	g_state = SIM_TWI_ADDRESS;
+}
+
+void TWI_stop(void)
+{
+	if (g_state == SIM_TWI_WRITE)
+	{
+		SIM_eepromCommit();
+	}
+	g_state = SIM_TWI_IDLE;
+	g_status = TWI_NO_INFO;
+}
+
+void TWI_writeByte(uint8 data)
+{
+	switch (g_state)
+	{
+	case SIM_TWI_ADDRESS:
+		/* the device answers only to its address and not while it programs a page */
+		if (((data & 0xF0) != 0xA0) || (SIM_now() < g_busyUntil))
+		{
+			g_status = (data & 1) ? TWI_MR_SLA_R_NACK : TWI_MT_SLA_W_NACK;
+			g_state = SIM_TWI_IGNORE;
+		}
+		else if (data & 1)
+		{
+			g_status = TWI_MT_SLA_R_ACK;
+			g_state = SIM_TWI_READ;
+		}
+		else
+		{
+			/* the block number is sent in the device address */
+			g_pointer = (uint16)(data & 0x0E) << 7;
+			g_status = TWI_MT_SLA_W_ACK;
+			g_state = SIM_TWI_WORD_ADDRESS;
+		}
+		break;
+
+	case SIM_TWI_WORD_ADDRESS:
+		g_pointer |= data;
+		memset(g_pageWritten, 0, sizeof(g_pageWritten));
+		g_status = TWI_MT_DATA_ACK;
+		g_state = SIM_TWI_WRITE;
+		break;
+
+	case SIM_TWI_WRITE:
+		/* the address counter rolls over inside the page */
+		g_page[g_pointer & (SIM_EEPROM_PAGE_SIZE - 1)] = data;
+		g_pageWritten[g_pointer & (SIM_EEPROM_PAGE_SIZE - 1)] = TRUE;
+		g_pointer = (g_pointer & ~(SIM_EEPROM_PAGE_SIZE - 1)) | ((g_pointer + 1) & (SIM_EEPROM_PAGE_SIZE - 1));
+		g_status = TWI_MT_DATA_ACK;
+		break;
+
+	default:
+		g_status = TWI_NO_INFO;
+		break;
+	}
+}
+
+/*
+ * Description :
+ * Sequential read, the address counter rolls over the whole memory.
+ */
+static uint8 TWI_readByte(uint8 a_status)
+{
+	uint8 data = 0xFF;
+
+	if (g_state == SIM_TWI_READ)
+	{
+		data = g_memory[g_pointer];
+		g_pointer = (g_pointer + 1) & (SIM_EEPROM_SIZE - 1);
+		g_status = a_status;
+	}
+	else
+	{
+		g_status = TWI_NO_INFO;
+	}
+
+	return data;
+}
+
+uint8 TWI_readByteWithACK(void)
+{
+	return TWI_readByte(TWI_MR_DATA_ACK);
+}
+
+uint8 TWI_readByteWithNACK(void)
+{
+	return TWI_readByte(TWI_MR_DATA_NACK);
+}
+
+uint8 TWI_getStatus(void)
+{
+	return g_status;
+}
+
+void TWI_disable(void)
+{
+	/* a transfer without its stop bit is dropped, the memory doesn't write it */
+	g_state = SIM_TWI_IDLE;
+	g_status = TWI_NO_INFO;
+}
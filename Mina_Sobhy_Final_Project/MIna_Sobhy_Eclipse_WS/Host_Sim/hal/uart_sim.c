@@ -0,0 +1,275 @@
+/*
+ * uart_sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host implementation of the UART driver, the bytes go through
+ *      			 the socket created by the door_sim launcher
+ */
+
+#include "uart.h"
+#include "trace.h"
+#include "power.h"
+#include "sim.h"
+
+/* only the CONTROL_ECU keeps the performance counters */
+#if BOARD_DIAG
+#include "diag.h"
+#else
+#define DIAG_COUNT(counter)
+#define DIAG_ADD(counter, value)
+#endif
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+#define UART_BAUD_ENTRY(baud)	{(baud), UART_UBRR(baud)},
+
+const UART_BaudType g_uartBaudTable[UART_BAUD_COUNT] = {
+	UART_BAUD_TABLE(UART_BAUD_ENTRY)
+};
+
+/* same Rx ring buffer as the firmware, it is filled from the simulation link
+ * when the driver waits for bytes instead of the receive interrupt
+ */
+static uint8 g_rxBuffer[2 * UART_RX_SIZE];
+static uint8 g_rxHead = 0;
+static uint8 g_rxTail = 0;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static uint8 UART_buffered(void);
+static void UART_waitData(uint8 a_count);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/* Description:
+ * number of bytes in the Rx buffer
+ */
+static uint8 UART_buffered(void)
+{
+	return (uint8)(g_rxHead - g_rxTail) & (UART_RX_SIZE - 1);
+}
+
+/* Description:
+ * receive from the simulation until the Rx buffer holds at least a_count bytes
+ */
+static void UART_waitData(uint8 a_count)
+{
+	uint8 data;
+
+	while (UART_buffered() < a_count)
+	{
+		/* the firmware sleeps in idle until the byte is received */
+		SIM_powerSleep(POWER_IDLE);
+		data = SIM_uartReceive();
+		SIM_powerWake();
+
+		g_rxBuffer[g_rxHead] = data;
+		g_rxBuffer[g_rxHead + UART_RX_SIZE] = data;
+		g_rxHead = (g_rxHead + 1) & (UART_RX_SIZE - 1);
+	}
+}
+
+void UART_init(const UART_ConfigType * Config_Ptr)
+{
+	g_rxHead = 0;
+	g_rxTail = 0;
+	if (!UART_setBaudRate(Config_Ptr->baud_rate))
+	{
+		UART_setBaudRate(UART_BAUD_DEFAULT);
+	}
+}
+
+uint8 UART_setBaudRate(UART_BaudRate a_baud)
+{
+	uint8 i;
+
+	/* the link has no bit timing, both ECUs only have to agree on the byte time */
+	for (i = 0; i < UART_BAUD_COUNT; i++)
+	{
+		if (g_uartBaudTable[i].baud_rate == a_baud)
+		{
+			SIM_uartInit((unsigned long)a_baud);
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+void UART_sendByte(const uint8 data)
+{
+	TRACE(TRACE_UART_TX, data);
+	DIAG_COUNT(uart_tx_bytes);
+	SIM_uartSend(data);
+}
+
+void UART_sendBlock(const uint8 * a_data, uint8 a_size)
+{
+	uint8 i;
+
+	/* the link sends the bytes at once, so the block is done when this returns */
+	DIAG_ADD(uart_tx_bytes, a_size);
+	for (i = 0; i < a_size; i++)
+	{
+		SIM_uartSend(a_data[i]);
+	}
+}
+
+uint8 UART_isSendDone(void)
+{
+	return TRUE;
+}
+
+uint8 UART_receiveByte(void)
+{
+	uint8 data;
+
+	UART_waitData(1);
+	data = g_rxBuffer[g_rxTail];
+	g_rxTail = (g_rxTail + 1) & (UART_RX_SIZE - 1);
+
+	TRACE(TRACE_UART_RX, data);
+	DIAG_COUNT(uart_rx_bytes);
+	return data;
+}
+
+uint8 UART_receiveMessage(UART_MessageType * a_message, uint8 a_delimiter, uint8 a_max)
+{
+	const uint8 * data = &g_rxBuffer[g_rxTail];
+	uint8 length = 0;
+
+	if (a_max > UART_MESSAGE_MAX)
+	{
+		a_max = UART_MESSAGE_MAX;
+	}
+	a_message->data = data;
+
+	for (;;)
+	{
+		UART_waitData(length + 1);
+		if (data[length] == a_delimiter)
+		{
+			a_message->length = length;
+			a_message->size = length + 1;
+			return TRUE;
+		}
+		if (length == a_max)
+		{
+			a_message->length = length;
+			a_message->size = length;
+			return FALSE;
+		}
+		length++;
+	}
+}
+
+uint8 UART_receiveFrame(UART_MessageType * a_message, uint8 a_max)
+{
+	const uint8 * data = &g_rxBuffer[g_rxTail];
+	uint8 length;
+
+	if (a_max > UART_MESSAGE_MAX)
+	{
+		a_max = UART_MESSAGE_MAX;
+	}
+	a_message->data = data + 1;
+
+	UART_waitData(1);
+	length = data[0];
+	if (length > a_max)
+	{
+		a_message->length = 0;
+		a_message->size = 1;
+		return FALSE;
+	}
+
+	UART_waitData(length + 1);
+	a_message->length = length;
+	a_message->size = length + 1;
+	return TRUE;
+}
+
+void UART_releaseMessage(const UART_MessageType * a_message)
+{
+	g_rxTail = (g_rxTail + a_message->size) & (UART_RX_SIZE - 1);
+}
+
+uint8 UART_isDataAvailable(void)
+{
+	/* a poll only, the firmware sleeps after a poll which finds nothing and
+	 * POWER_sleep is where the simulation waits for the next byte
+	 */
+	return ((UART_buffered() != 0) || SIM_uartWait(0)) ? TRUE : FALSE;
+}
+
+uint8 UART_receiveByteTimeout(uint8 * a_data, uint16 a_timeout_ms)
+{
+	uint8 available = TRUE;
+
+	if (UART_buffered() == 0)
+	{
+		SIM_powerSleep(POWER_IDLE);
+		available = SIM_uartWait(a_timeout_ms * 1000ULL) ? TRUE : FALSE;
+		SIM_powerWake();
+	}
+
+	if (!available)
+	{
+		return FALSE;
+	}
+	*a_data = UART_receiveByte();
+	return TRUE;
+}
+
+void UART_flush(void)
+{
+	g_rxTail = g_rxHead;
+	while (SIM_uartWait(0))
+	{
+		(void)SIM_uartReceive();
+	}
+}
+
+uint8 UART_takeErrors(void)
+{
+	return SIM_uartTakeErrors();
+}
+
+void UART_sendString(const uint8 *Str)
+{
+	uint8 i = 0;
+
+	while (Str[i] != '\0')
+	{
+		UART_sendByte(Str[i]);
+		i++;
+	}
+}
+
+uint8 UART_receiveString(uint8 *Str, uint8 a_size)
+{
+	UART_MessageType message;
+	uint8 complete;
+	uint8 i;
+
+	if (a_size == 0)
+	{
+		return FALSE;
+	}
+
+	complete = UART_receiveMessage(&message, '#', a_size - 1);
+	for (i = 0; i < message.length; i++)
+	{
+		Str[i] = message.data[i];
+	}
+	Str[i] = '\0';
+
+	UART_releaseMessage(&message);
+	return complete;
+}
@@ -0,0 +1,20 @@
+/*
+ * interrupt.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host replacement of <avr/interrupt.h>, the interrupts are
+ *      			 raised by the simulated peripherals in Host_Sim/hal
+ */
+
+#ifndef HOST_AVR_INTERRUPT_H_
+#define HOST_AVR_INTERRUPT_H_
+
+#include <avr/io.h>
+
+#define ISR(vector)		void vector(void); void vector(void)
+
+#define sei()			(SREG |= (1<<SREG_I))
+#define cli()			(SREG &= (unsigned char)~(1<<SREG_I))
+
+#endif /* HOST_AVR_INTERRUPT_H_ */
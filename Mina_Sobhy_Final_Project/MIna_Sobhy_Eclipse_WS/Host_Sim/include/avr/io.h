@@ -0,0 +1,135 @@
+/*
+ * io.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host replacement of <avr/io.h>, the ATmega32 registers are plain
+ *      			 variables so the application code compiles unchanged. Only SREG
+ *      			 has a meaning (global interrupt enable), the peripherals are
+ *      			 simulated behind the driver functions in Host_Sim/hal
+ */
+
+#ifndef HOST_AVR_IO_H_
+#define HOST_AVR_IO_H_
+
+/* list of the simulated registers, expanded once as declarations here and once
+ * as definitions in Host_Sim/sim/io_sim.c
+ */
+#define SIM_REGISTERS(R8, R16) \
+	R8(SREG) \
+	R8(PORTA) R8(DDRA) R8(PINA) \
+	R8(PORTB) R8(DDRB) R8(PINB) \
+	R8(PORTC) R8(DDRC) R8(PINC) \
+	R8(PORTD) R8(DDRD) R8(PIND) \
+	R8(UCSRA) R8(UCSRB) R8(UCSRC) R8(UBRRH) R8(UBRRL) R8(UDR) \
+	R8(TCCR0) R8(TCNT0) R8(OCR0) \
+	R8(TCCR1A) R8(TCCR1B) R16(TCNT1) R16(OCR1A) R16(OCR1B) \
+	R8(TCCR2) R8(TCNT2) R8(OCR2) R8(ASSR) \
+	R8(TIMSK) R8(TIFR) \
+	R8(TWBR) R8(TWSR) R8(TWAR) R8(TWCR) R8(TWDR) \
+	R8(MCUCR) R8(MCUCSR) R8(GICR) R8(GIFR) \
+	R8(ADCSRA) R8(ACSR) R8(SPCR) R8(SFIOR) R8(WDTCR)
+
+#define SIM_DECLARE_REG8(name)		extern volatile unsigned char name;
+#define SIM_DECLARE_REG16(name)		extern volatile unsigned short name;
+
+SIM_REGISTERS(SIM_DECLARE_REG8, SIM_DECLARE_REG16)
+
+/* SREG */
+#define SREG_I		7
+
+/* UCSRA, UCSRB, UCSRC */
+#define RXC			7
+#define TXC			6
+#define UDRE		5
+#define FE			4
+#define DOR			3
+#define PE			2
+#define U2X			1
+#define MPCM		0
+#define RXCIE		7
+#define TXCIE		6
+#define UDRIE		5
+#define RXEN		4
+#define TXEN		3
+#define UCSZ2		2
+#define RXB8		1
+#define TXB8		0
+#define URSEL		7
+#define UMSEL		6
+#define UPM1		5
+#define UPM0		4
+#define USBS		3
+#define UCSZ1		2
+#define UCSZ0		1
+#define UCPOL		0
+
+/* TIMSK, TIFR */
+#define OCIE2		7
+#define TOIE2		6
+#define TICIE1		5
+#define OCIE1A		4
+#define OCIE1B		3
+#define TOIE1		2
+#define OCIE0		1
+#define TOIE0		0
+#define OCF2		7
+#define TOV2		6
+#define OCF1A		4
+#define TOV1		2
+
+/* TCCR0, TCCR1A, TCCR1B, TCCR2, ASSR */
+#define FOC0		7
+#define WGM00		6
+#define COM01		5
+#define COM00		4
+#define WGM01		3
+#define CS02		2
+#define CS01		1
+#define CS00		0
+#define FOC1A		3
+#define FOC1B		2
+#define WGM12		3
+#define CS12		2
+#define CS11		1
+#define CS10		0
+#define WGM21		3
+#define CS22		2
+#define CS21		1
+#define CS20		0
+#define AS2			3
+#define TCN2UB		2
+#define OCR2UB		1
+#define TCR2UB		0
+
+/* TWCR */
+#define TWINT		7
+#define TWEA		6
+#define TWSTA		5
+#define TWSTO		4
+#define TWWC		3
+#define TWEN		2
+#define TWIE		0
+
+/* MCUCR, GICR */
+#define SE			7
+#define SM2			6
+#define SM1			5
+#define SM0			4
+#define INT1		7
+#define INT0		6
+#define INT2		5
+
+/* port pins */
+#define PB0			0
+#define PB1			1
+#define PB2			2
+#define PB3			3
+#define PD0			0
+#define PD1			1
+#define PD2			2
+
+#define RAMSTART	0x60
+#define RAMEND		0x85F
+
+#endif /* HOST_AVR_IO_H_ */
@@ -0,0 +1,23 @@
+/*
+ * pgmspace.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host replacement of <avr/pgmspace.h>, the host has one address
+ *      			 space so the flash data is normal read only data
+ */
+
+#ifndef HOST_AVR_PGMSPACE_H_
+#define HOST_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+
+#define PROGMEM
+
+#define PSTR(s)					(s)
+
+#define pgm_read_byte(address)	(*(const uint8_t *)(address))
+#define pgm_read_word(address)	(*(const uint16_t *)(address))
+#define pgm_read_ptr(address)	(*(const void * const *)(address))
+
+#endif /* HOST_AVR_PGMSPACE_H_ */
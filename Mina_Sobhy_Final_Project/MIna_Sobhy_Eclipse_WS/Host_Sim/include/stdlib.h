@@ -0,0 +1,16 @@
+/*
+ * stdlib.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host <stdlib.h> plus the avr-libc itoa used by the LCD driver
+ */
+
+#ifndef HOST_STDLIB_H_
+#define HOST_STDLIB_H_
+
+#include_next <stdlib.h>
+
+char * itoa(int a_value, char * a_string, int a_radix);
+
+#endif /* HOST_STDLIB_H_ */
@@ -0,0 +1,39 @@
+/*
+ * crc16.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host replacement of <util/crc16.h>, the C equivalent of the
+ *      			 avr-libc assembler code of the CRCs in use
+ */
+
+#ifndef HOST_UTIL_CRC16_H_
+#define HOST_UTIL_CRC16_H_
+
+#include <stdint.h>
+
+/* CRC-CCITT, polynomial x^16 + x^12 + x^5 + 1 (0x8408 reflected) */
+static inline uint16_t _crc_ccitt_update(uint16_t a_crc, uint8_t a_data)
+{
+	a_data ^= (uint8_t)a_crc;
+	a_data ^= (uint8_t)(a_data << 4);
+
+	return (uint16_t)((((uint16_t)a_data << 8) | (a_crc >> 8)) ^ (uint8_t)(a_data >> 4) ^
+		((uint16_t)a_data << 3));
+}
+
+/* CRC-8-CCITT, polynomial x^8 + x^2 + x + 1 (0x07), not reflected */
+static inline uint8_t _crc8_ccitt_update(uint8_t a_crc, uint8_t a_data)
+{
+	uint8_t i;
+
+	a_data ^= a_crc;
+	for (i = 0; i < 8; i++)
+	{
+		a_data = (a_data & 0x80) ? (uint8_t)((a_data << 1) ^ 0x07) : (uint8_t)(a_data << 1);
+	}
+
+	return a_data;
+}
+
+#endif /* HOST_UTIL_CRC16_H_ */
@@ -0,0 +1,16 @@
+/*
+ * delay.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host replacement of <util/delay.h>, the delays are taken from
+ *      			 the simulation clock
+ */
+
+#ifndef HOST_UTIL_DELAY_H_
+#define HOST_UTIL_DELAY_H_
+
+void _delay_ms(double a_ms);
+void _delay_us(double a_us);
+
+#endif /* HOST_UTIL_DELAY_H_ */
@@ -0,0 +1,14 @@
+/*
+ * io_sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: storage of the ATmega32 registers declared in the host <avr/io.h>
+ */
+
+#include <avr/io.h>
+
+#define SIM_DEFINE_REG8(name)		volatile unsigned char name;
+#define SIM_DEFINE_REG16(name)		volatile unsigned short name;
+
+SIM_REGISTERS(SIM_DEFINE_REG8, SIM_DEFINE_REG16)
@@ -0,0 +1,82 @@
+/*
+ * sim.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: interface between the simulated drivers (Host_Sim/hal), the
+ *      			 board models (Host_Sim/board) and the simulation core
+ */
+
+#ifndef SIM_H_
+#define SIM_H_
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* environment variables set by the door_sim launcher */
+#define SIM_ENV_UART_FD		"SIM_UART_FD"	/* socket connected to the other ECU */
+#define SIM_ENV_EEPROM		"SIM_EEPROM"	/* file keeping the external EEPROM */
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/* simulation time in microseconds since the ECU started, it is the wall clock
+ * time unless door_sim runs the ECUs with a virtual clock (sim_clock.h)
+ */
+unsigned long long SIM_now(void);
+
+/* wait the required simulation time */
+void SIM_delay(unsigned long long a_us);
+
+/* CPU time of firmware code which the host runs at once (digest.c), it moves
+ * the virtual clock by a_cycles of F_CPU and is ignored on the wall clock
+ */
+void SIM_cycles(unsigned long a_cycles);
+
+/* print a message prefixed by the ECU name and the simulation time */
+void SIM_log(const char * a_format, ...);
+
+/* the interrupt lock serializes the timer "ISR" thread with the drivers */
+void SIM_irqLock(void);
+void SIM_irqUnlock(void);
+
+/* sleep of the CPU until the next timer interrupt, or until a received byte
+ * if a_wakeRx
+ */
+void SIM_waitInterrupt(unsigned char a_wakeRx);
+
+/* periodic timer interrupt, a_tick is called with the interrupt lock taken */
+void SIM_timerStart(unsigned long long a_period_us, void (*a_tick)(void));
+void SIM_timerStop(void);
+
+/* UART link to the other ECU */
+void SIM_uartInit(unsigned long a_baud);
+void SIM_uartSend(unsigned char a_data);
+unsigned char SIM_uartReceive(void);
+/* wait up to a_us for a received byte, return 1 if one is waiting */
+int SIM_uartWait(unsigned long long a_us);
+/* bytes received with a frame error since the last call, in the virtual clock
+ * mode a byte sent at another rate than the one of the receiver has one
+ */
+unsigned char SIM_uartTakeErrors(void);
+
+/* GPIO state kept by the simulated GPIO driver */
+unsigned char SIM_gpioPort(unsigned char a_port);
+unsigned char SIM_gpioDdr(unsigned char a_port);
+
+/* power model (Host_Sim/hal/power_sim.c), the CPU sleeps in a_mode (POWER_ModeType)
+ * until SIM_powerWake, the time spent in every mode gives the estimated current
+ */
+void SIM_powerSleep(unsigned char a_mode);
+void SIM_powerWake(void);
+
+/* board models, implemented once for every ECU in Host_Sim/board */
+extern const char SIM_nodeName[];
+void SIM_boardPinWrite(unsigned char a_port, unsigned char a_pin, unsigned char a_value);
+int SIM_boardPinRead(unsigned char a_port, unsigned char a_pin, unsigned char * a_value);
+void SIM_boardPwm(unsigned char a_duty);
+void SIM_boardIdle(void);
+
+#endif /* SIM_H_ */
@@ -0,0 +1,56 @@
+/*
+ * sim_clock.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: messages between the ECUs and the door_sim scheduler in the
+ *      			 virtual clock mode
+ *
+ *      In the virtual clock mode only one ECU runs at a time and the simulation
+ *      time doesn't move while it runs. An ECU which has to wait (delay, UART
+ *      receive, idle polling) sends SIM_CLOCK_WAIT and sleeps until the scheduler
+ *      answers SIM_CLOCK_RESUME with the new time. The scheduler moves the time to
+ *      the earliest event of the two ECUs, so the events keep their order while
+ *      the waiting takes no wall time. The UART bytes go through the scheduler
+ *      which delivers them to the other ECU (SIM_CLOCK_RX) after the time needed
+ *      to transmit them. The timer interrupts fire only at these waits, so a
+ *      firmware loop waiting for an interrupt must sleep in it (POWER_sleep), a
+ *      busy loop never sees the time move.
+ */
+
+#ifndef SIM_CLOCK_H_
+#define SIM_CLOCK_H_
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* environment variable set by the door_sim launcher in the virtual clock mode,
+ * it replaces SIM_UART_FD
+ */
+#define SIM_ENV_CLOCK_FD	"SIM_CLOCK_FD"
+
+#define SIM_CLOCK_FOREVER	(~0ULL)
+
+/* ECU to scheduler */
+#define SIM_CLOCK_SEND		'S'	/* data sent on the UART, time is the byte duration */
+#define SIM_CLOCK_WAIT		'W'	/* wait until time or a received byte if wake_rx */
+
+/* scheduler to ECU */
+#define SIM_CLOCK_RX		'R'	/* data received on the UART, time is the byte duration of the sender */
+#define SIM_CLOCK_RESUME	'C'	/* continue at time */
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef struct
+{
+	unsigned long long time;
+	unsigned char type;
+	unsigned char data;
+	unsigned char wake_rx;
+	unsigned char reserved[5];
+} SIM_ClockMessageType;
+
+#endif /* SIM_CLOCK_H_ */
@@ -0,0 +1,488 @@
+/*
+ * sim_core.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: simulation clock, interrupt lock, timer thread and UART link
+ *      			 shared by the two simulated ECUs
+ */
+
+#define _GNU_SOURCE
+#include "sim.h"
+#include "sim_clock.h"
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static struct timespec g_start;
+static pthread_mutex_t g_irqMutex;
+static int g_uartFd = -1;
+static unsigned long long g_uartByteTime = 1042;	/* 10 bits at 9600 baud */
+
+/* virtual clock mode */
+static int g_clockFd = -1;
+static pthread_mutex_t g_clockMutex;
+static volatile unsigned long long g_virtualNow = 0;
+static unsigned char g_rxQueue[256];
+static volatile unsigned char g_rxHead = 0;
+static volatile unsigned char g_rxTail = 0;
+static unsigned char g_rxErrors = 0;
+/* cycles of SIM_cycles not yet a whole microsecond */
+static unsigned long long g_cycles = 0;
+
+static pthread_t g_timerThread;
+static int g_timerThreadStarted = 0;
+static volatile int g_timerEnabled = 0;
+static volatile unsigned long long g_timerPeriod = 0;
+static volatile unsigned long long g_timerNext = 0;
+static void (* volatile g_timerTick)(void) = NULL;
+
+/* ATmega32 status register, only the I bit is used */
+extern volatile unsigned char SREG;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void SIM_clockWait(unsigned long long a_until, unsigned char a_wakeRx);
+static void SIM_clockFireTimer(void);
+static void SIM_uartClosed(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+__attribute__((constructor))
+static void SIM_init(void)
+{
+	pthread_mutexattr_t attr;
+	const char * fd = getenv(SIM_ENV_UART_FD);
+	const char * clockFd = getenv(SIM_ENV_CLOCK_FD);
+
+	clock_gettime(CLOCK_MONOTONIC, &g_start);
+
+	/* the timer callbacks may call the drivers which take the lock again */
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&g_irqMutex, &attr);
+	pthread_mutex_init(&g_clockMutex, &attr);
+
+	if (fd != NULL)
+	{
+		g_uartFd = atoi(fd);
+	}
+
+	setvbuf(stdout, NULL, _IOLBF, 0);
+
+	/* with the virtual clock the ECU doesn't start before the scheduler allows it */
+	if (clockFd != NULL)
+	{
+		g_clockFd = atoi(clockFd);
+		SIM_clockWait(0, 0);
+	}
+}
+
+unsigned long long SIM_now(void)
+{
+	struct timespec now;
+
+	if (g_clockFd >= 0)
+	{
+		return g_virtualNow;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((unsigned long long)(now.tv_sec - g_start.tv_sec) * 1000000ULL)
+		+ (unsigned long long)((now.tv_nsec - g_start.tv_nsec) / 1000);
+}
+
+/*
+ * Description :
+ * Sleep on the wall clock.
+ */
+static void SIM_sleep(unsigned long long a_us)
+{
+	struct timespec ts;
+
+	ts.tv_sec = (time_t)(a_us / 1000000ULL);
+	ts.tv_nsec = (long)((a_us % 1000000ULL) * 1000);
+	while (nanosleep(&ts, &ts) != 0 && errno == EINTR)
+	{
+	}
+}
+
+/*
+ * Description :
+ * Virtual clock mode, block until the scheduler moves the time to a_until or
+ * delivers a UART byte if a_wakeRx. The received bytes are queued meanwhile.
+ */
+static void SIM_clockWait(unsigned long long a_until, unsigned char a_wakeRx)
+{
+	SIM_ClockMessageType message;
+
+	memset(&message, 0, sizeof(message));
+	message.type = SIM_CLOCK_WAIT;
+	message.time = a_until;
+	message.wake_rx = a_wakeRx;
+	if (write(g_clockFd, &message, sizeof(message)) != sizeof(message))
+	{
+		SIM_uartClosed();
+	}
+
+	for (;;)
+	{
+		if (read(g_clockFd, &message, sizeof(message)) != sizeof(message))
+		{
+			SIM_uartClosed();
+		}
+
+		if (message.type == SIM_CLOCK_RX)
+		{
+			/* a byte sent at another rate is received with a frame error, the
+			 * receiver samples the idle line after a faster byte and the start
+			 * bit of a slower one
+			 */
+			if (message.time != g_uartByteTime)
+			{
+				message.data = (message.time < g_uartByteTime) ? 0xFF : 0x00;
+				if (g_rxErrors != 0xFF)
+				{
+					g_rxErrors++;
+				}
+			}
+			g_rxQueue[g_rxTail++] = message.data;
+		}
+		else if (message.type == SIM_CLOCK_RESUME)
+		{
+			g_virtualNow = message.time;
+			return;
+		}
+	}
+}
+
+/*
+ * Description :
+ * Virtual clock mode, time of the next timer interrupt.
+ */
+static unsigned long long SIM_clockNextEvent(void)
+{
+	return g_timerEnabled ? g_timerNext : SIM_CLOCK_FOREVER;
+}
+
+void SIM_delay(unsigned long long a_us)
+{
+	unsigned long long until;
+	unsigned long long next;
+
+	if (g_clockFd < 0)
+	{
+		SIM_sleep(a_us);
+		return;
+	}
+
+	pthread_mutex_lock(&g_clockMutex);
+	until = g_virtualNow + a_us;
+	while (g_virtualNow < until)
+	{
+		next = SIM_clockNextEvent();
+		SIM_clockWait((next < until) ? next : until, 0);
+		SIM_clockFireTimer();
+	}
+	pthread_mutex_unlock(&g_clockMutex);
+}
+
+void SIM_cycles(unsigned long a_cycles)
+{
+	unsigned long long us;
+
+	if (g_clockFd < 0)
+	{
+		return;
+	}
+
+	g_cycles += a_cycles;
+	us = (g_cycles * 1000000ULL) / F_CPU;
+	g_cycles -= (us * F_CPU) / 1000000ULL;
+	if (us != 0)
+	{
+		SIM_delay(us);
+	}
+}
+
+void SIM_log(const char * a_format, ...)
+{
+	unsigned long long now = SIM_now();
+	va_list args;
+
+	flockfile(stdout);
+	printf("[%-7s %6llu.%03llu] ", SIM_nodeName, now / 1000000ULL, (now / 1000ULL) % 1000ULL);
+	va_start(args, a_format);
+	vprintf(a_format, args);
+	va_end(args);
+	printf("\n");
+	funlockfile(stdout);
+}
+
+void SIM_irqLock(void)
+{
+	pthread_mutex_lock(&g_irqMutex);
+}
+
+void SIM_irqUnlock(void)
+{
+	pthread_mutex_unlock(&g_irqMutex);
+}
+
+/*
+ * Description :
+ * Timer interrupt thread, it calls the tick callback every period while the timer
+ * is enabled and the global interrupt is enabled in SREG.
+ */
+static void * SIM_timerThread(void * a_arg)
+{
+	unsigned long long now;
+
+	(void)a_arg;
+	for (;;)
+	{
+		now = SIM_now();
+		if (!g_timerEnabled || now < g_timerNext)
+		{
+			SIM_sleep(g_timerEnabled ? (g_timerNext - now) : 1000);
+			continue;
+		}
+
+		SIM_irqLock();
+		if (g_timerEnabled && (SREG & 0x80) && g_timerTick != NULL)
+		{
+			g_timerNext += g_timerPeriod;
+			g_timerTick();
+			/* the ISR may have changed the outputs while the main loop spins */
+			SIM_boardIdle();
+		}
+		SIM_irqUnlock();
+	}
+
+	return NULL;
+}
+
+/*
+ * Description :
+ * Virtual clock mode, call the timer interrupts due at the current time.
+ */
+static void SIM_clockFireTimer(void)
+{
+	SIM_irqLock();
+	while (g_timerEnabled && (g_virtualNow >= g_timerNext))
+	{
+		g_timerNext += g_timerPeriod;
+		if ((SREG & 0x80) && g_timerTick != NULL)
+		{
+			g_timerTick();
+			SIM_boardIdle();
+		}
+	}
+	SIM_irqUnlock();
+}
+
+void SIM_waitInterrupt(unsigned char a_wakeRx)
+{
+	struct pollfd pfd;
+
+	if (g_clockFd >= 0)
+	{
+		pthread_mutex_lock(&g_clockMutex);
+		if (!a_wakeRx || (g_rxHead == g_rxTail))
+		{
+			SIM_clockWait(SIM_clockNextEvent(), a_wakeRx);
+			SIM_clockFireTimer();
+		}
+		pthread_mutex_unlock(&g_clockMutex);
+		return;
+	}
+
+	/* the timer thread runs on its own, so the wall clock wait is only short */
+	if (a_wakeRx && (g_uartFd >= 0))
+	{
+		pfd.fd = g_uartFd;
+		pfd.events = POLLIN;
+		poll(&pfd, 1, 1);
+	}
+	else
+	{
+		SIM_sleep(1000);
+	}
+}
+
+void SIM_timerStart(unsigned long long a_period_us, void (*a_tick)(void))
+{
+	SIM_irqLock();
+	g_timerTick = a_tick;
+	g_timerPeriod = a_period_us;
+	g_timerNext = SIM_now() + a_period_us;
+	g_timerEnabled = 1;
+	SIM_irqUnlock();
+
+	/* the virtual clock fires the timer at the wait points of the firmware
+	 * (SIM_delay, SIM_waitInterrupt and the UART), not on a thread
+	 */
+	if (!g_timerThreadStarted && (g_clockFd < 0))
+	{
+		g_timerThreadStarted = 1;
+		pthread_create(&g_timerThread, NULL, SIM_timerThread, NULL);
+	}
+}
+
+void SIM_timerStop(void)
+{
+	SIM_irqLock();
+	g_timerEnabled = 0;
+	SIM_irqUnlock();
+}
+
+/*
+ * Description :
+ * The ECU is powered off when the other ECU closes the link.
+ */
+static void SIM_uartClosed(void)
+{
+	SIM_log("link closed, power off");
+	exit(0);
+}
+
+void SIM_uartInit(unsigned long a_baud)
+{
+	/* start bit, 8 data bits and stop bit */
+	if (a_baud != 0)
+	{
+		g_uartByteTime = (10ULL * 1000000ULL + a_baud - 1) / a_baud;
+	}
+	SIM_log("UART %lu baud", a_baud);
+}
+
+void SIM_uartSend(unsigned char a_data)
+{
+	SIM_ClockMessageType message;
+
+	if (g_clockFd >= 0)
+	{
+		memset(&message, 0, sizeof(message));
+		message.type = SIM_CLOCK_SEND;
+		message.data = a_data;
+		message.time = g_uartByteTime;
+		pthread_mutex_lock(&g_clockMutex);
+		if (write(g_clockFd, &message, sizeof(message)) != sizeof(message))
+		{
+			SIM_uartClosed();
+		}
+		pthread_mutex_unlock(&g_clockMutex);
+		return;
+	}
+
+	if (g_uartFd < 0)
+	{
+		return;
+	}
+	while (write(g_uartFd, &a_data, 1) != 1)
+	{
+		if (errno != EINTR)
+		{
+			SIM_uartClosed();
+		}
+	}
+}
+
+unsigned char SIM_uartReceive(void)
+{
+	unsigned char data;
+	ssize_t size;
+
+	SIM_boardIdle();
+
+	if (g_clockFd >= 0)
+	{
+		pthread_mutex_lock(&g_clockMutex);
+		while (g_rxHead == g_rxTail)
+		{
+			SIM_clockWait(SIM_clockNextEvent(), 1);
+			SIM_clockFireTimer();
+		}
+		data = g_rxQueue[g_rxHead++];
+		pthread_mutex_unlock(&g_clockMutex);
+		return data;
+	}
+
+	if (g_uartFd < 0)
+	{
+		SIM_uartClosed();
+	}
+
+	do
+	{
+		size = read(g_uartFd, &data, 1);
+	} while (size < 0 && errno == EINTR);
+
+	if (size != 1)
+	{
+		SIM_uartClosed();
+	}
+
+	return data;
+}
+
+int SIM_uartWait(unsigned long long a_us)
+{
+	struct pollfd pfd;
+	unsigned long long until;
+	unsigned long long next;
+	int available;
+
+	if (g_clockFd >= 0)
+	{
+		pthread_mutex_lock(&g_clockMutex);
+		until = g_virtualNow + a_us;
+		while ((g_rxHead == g_rxTail) && (g_virtualNow < until))
+		{
+			next = SIM_clockNextEvent();
+			SIM_clockWait((next < until) ? next : until, 1);
+			SIM_clockFireTimer();
+		}
+		available = (g_rxHead != g_rxTail);
+		pthread_mutex_unlock(&g_clockMutex);
+		return available;
+	}
+
+	if (g_uartFd < 0)
+	{
+		return 0;
+	}
+
+	pfd.fd = g_uartFd;
+	pfd.events = POLLIN;
+	return (poll(&pfd, 1, (int)((a_us + 999) / 1000)) > 0) ? 1 : 0;
+}
+
+unsigned char SIM_uartTakeErrors(void)
+{
+	unsigned char errors = g_rxErrors;
+
+	g_rxErrors = 0;
+	return errors;
+}
+
+char * itoa(int a_value, char * a_string, int a_radix)
+{
+	(void)a_radix;
+	sprintf(a_string, "%d", a_value);
+	return a_string;
+}
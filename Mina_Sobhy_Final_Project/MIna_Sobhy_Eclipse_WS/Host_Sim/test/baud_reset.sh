@@ -0,0 +1,27 @@
+#!/bin/sh
+#
+# baud_reset.sh
+#
+#  Created on: Oct 19, 2026
+#      Author: Mina sobhy
+#      description: a reset of the CONTROL_ECU alone (door_sim -r) leaves the
+#      			 HMI_ECU at the negotiated baud rate, the two ECUs must fall
+#      			 back to the default rate and negotiate again
+#
+
+. "$(dirname "$0")/sim_test.sh"
+
+# reset during the negotiation at the start, then store the password and open the door
+run "12345#12345#w+12345#w" -r 0.015
+expect "control reset" "the CONTROL_ECU wasn't reset"
+expect "door motor unlocking" "the ECUs didn't link again after a reset during the negotiation"
+
+# reset while the main menu waits for a key, the first key makes the HMI_ECU
+# negotiate again and the door opens with the second one
+run "wwww++12345#w" -r 2
+expect "control reset" "the CONTROL_ECU wasn't reset"
+[ "$(grep -c "^\[control\] UART 125000 baud" "$OUT")" -eq 2 ] ||
+	fail "the baud rate wasn't negotiated again after the reset"
+expect "door motor unlocking" "the door didn't open after the reset"
+
+exit 0
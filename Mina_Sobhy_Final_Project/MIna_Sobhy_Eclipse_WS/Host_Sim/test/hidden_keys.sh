@@ -0,0 +1,34 @@
+#!/bin/sh
+#
+# hidden_keys.sh
+#
+#  Created on: Oct 19, 2026
+#      Author: Mina sobhy
+#      description: the hidden main options are typed after '#', a digit alone
+#      			 at the main menu may be the start of a password and does
+#      			 nothing, any other key after '#' switches the language and
+#      			 is taken as a main option key
+#
+
+. "$(dirname "$0")/sim_test.sh"
+
+run "12345#12345#"
+expect "Open Door" "the password wasn't stored"
+
+# power cycle, the digits of the log export and the clock set alone
+run "0w1w"
+reject "Log sent" "'0' alone sent the audit log"
+reject "Plz enter pass" "'1' alone started the clock set"
+
+# power cycle, the same options after '#'
+run "#0w#1w"
+expect "Log sent" "'#' then '0' didn't send the audit log"
+expect "Plz enter pass" "'#' then '1' didn't start the clock set"
+
+# power cycle, another key after '#' switches the language and is still taken,
+# '+' opens the door in German
+run "#+12345#"
+expect "Tuer oeffnen" "'#' then '+' didn't switch the language"
+expect "door motor unlocking" "'+' after '#' was dropped"
+
+exit 0
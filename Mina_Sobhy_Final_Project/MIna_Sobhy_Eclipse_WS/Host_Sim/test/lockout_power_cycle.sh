@@ -0,0 +1,39 @@
+#!/bin/sh
+#
+# lockout_power_cycle.sh
+#
+#  Created on: Oct 19, 2026
+#      Author: Mina sobhy
+#      description: a power cycle of the two ECUs during a lockout doesn't end
+#      			 it, the CONTROL_ECU resumes it from the EEPROM at boot with
+#      			 the remaining seconds stored every LOCKOUT_COMMIT_SECONDS
+#
+
+. "$(dirname "$0")/sim_test.sh"
+
+# store the password then enter a wrong one until the lockout of the default policy
+run "12345#12345#+11111#11111#11111#"
+expect "System Locked" "three wrong passwords didn't lock the system"
+
+# power cycle, the door mustn't open with the right password
+run "+w12345#"
+expect "^\[control\] buzzer on" "the lockout wasn't resumed at boot"
+expect "Retry in 60s" "the HMI_ECU wasn't told the lockout is in force"
+reject "unlocking" "the door opened during the lockout"
+
+# power cycle again after the lockout, the right password opens the door
+run "$(printf 'w%.0s' $(seq 65))+12345#"
+expect "door motor unlocking" "the door didn't open after the lockout ended"
+
+# two lockouts in a row, the second one is 120s and the power is cut after 70s
+# of it, a key dismisses the error screen of the first one
+run "+11111#11111#11111#$(printf 'w%.0s' $(seq 70))++11111#11111#11111#$(printf 'w%.0s' $(seq 70))"
+expect "^\[control\] buzzer on" "the wrong passwords didn't lock the system"
+
+# power cycle, the lockout resumes from the remaining seconds stored after 60s
+# of it, not from its whole duration
+run "+w"
+expect "Retry in 60s" "the remaining seconds of the lockout weren't stored"
+reject "Retry in 120s" "the lockout restarted its whole duration"
+
+exit 0
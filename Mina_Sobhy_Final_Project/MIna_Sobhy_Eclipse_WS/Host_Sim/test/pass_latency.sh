@@ -0,0 +1,58 @@
+#!/bin/sh
+#
+# pass_latency.sh
+#
+#  Created on: Oct 19, 2026
+#      Author: Mina sobhy
+#      description: time from the enter key to the result of a password check,
+#      			 with the characters streamed as they are typed (hmi_ecu)
+#      			 and sent after enter (hmi_ecu_batch)
+#
+#      The CONTROL_ECU has a credential table so it calculates both digests of
+#      the password, their rounds take their AVR cycles on the virtual clock. The
+#      times come from the UART bytes printed by door_sim -l:
+#      1. enter to reply: from PASS_END received by the CONTROL_ECU to its reply,
+#         it must stay under one byte time at 9600 baud (1042 us) when streamed
+#      2. press to result: from PASS_END sent by the HMI_ECU, when enter is
+#         pressed, to the reply received by the HMI_ECU
+#
+
+. "$(dirname "$0")/sim_test.sh"
+
+BYTE_TIME_US=1042
+
+# one user in group 0, which has no schedule and is always allowed
+cat > "$WORK/users.csv" <<CSV
+salt,00112233445566778899aabbccddeeff
+user,300,44444,0
+CSV
+
+# $1 HMI_ECU executable, prints the two times in microseconds
+latency()
+{
+	rm -f "$EEPROM"
+	"$BIN/credential_compile" -e "$WORK/users.csv" "$EEPROM" > /dev/null || fail "credential_compile failed"
+	printf '12345#12345#+44444#w' > "$WORK/keys"
+	"$BIN/door_sim" -v -l -H "$1" -e "$EEPROM" -k "$WORK/keys" > "$RAW" 2>&1 || fail "door_sim failed"
+	cp "$RAW" "$OUT"
+	expect "door motor unlocking" "$1: the user's password didn't open the door"
+
+	awk '
+		function us(stamp) { split(stamp, part, "."); return part[1] * 1000000 + part[2] }
+		$1 == "[link" { time = us(substr($2, 1, length($2) - 1)) }
+		$1 == "[link" && $3 == "hmi" && $4 == "sends" && $5 == "0x23" { press = time; reply = 0; result = 0 }
+		$1 == "[link" && $3 == "control" && $4 == "receives" && $5 == "0x23" { enter = time }
+		$1 == "[link" && $3 == "control" && $4 == "sends" && press && !reply { reply = time }
+		$1 == "[link" && $3 == "hmi" && $4 == "receives" && reply && !result { result = time }
+		END { if (result) print reply - enter, result - press }' "$RAW"
+}
+
+set -- $(latency hmi_ecu) $(latency hmi_ecu_batch)
+[ $# -eq 4 ] || fail "the times weren't found in the link bytes"
+
+echo "streamed:   enter to reply $1 us, press to result $2 us"
+echo "after enter: enter to reply $3 us, press to result $4 us"
+
+[ "$1" -le $BYTE_TIME_US ] || fail "the streamed password is answered $1 us after enter, over one byte time"
+
+exit 0
@@ -0,0 +1,32 @@
+#!/bin/sh
+#
+# pass_lengths.sh
+#
+#  Created on: Oct 19, 2026
+#      Author: Mina sobhy
+#      description: every password size of the policy is stored and checked,
+#      			 the digest of a password of each size opens the door and the
+#      			 one of a wrong password of the same size doesn't
+#
+
+. "$(dirname "$0")/sim_test.sh"
+
+# store the password then widen the sizes to the whole range of policy.h
+run "12345#12345#*12345#4#12#####"
+expect "Settings saved" "the sizes 4 to 12 weren't accepted"
+
+pass=12345
+for size in 4 5 6 7 8 9 10 11 12; do
+	new=$(echo 314159265358 | cut -c1-$size)
+	wrong=$(echo 271828182845 | cut -c1-$size)
+
+	run "-$pass#$new#$new#+$wrong#"
+	reject "unlocking" "a wrong password of $size digits opened the door"
+
+	run "+$new#"
+	expect "|\*\{$size\} *|$" "the HMI_ECU didn't take the $size digits"
+	expect "door motor unlocking" "the password of $size digits didn't open the door"
+	pass=$new
+done
+
+exit 0
@@ -0,0 +1,27 @@
+#!/bin/sh
+#
+# session_pass.sh
+#
+#  Created on: Oct 19, 2026
+#      Author: Mina sobhy
+#      description: the keypad sessions of the RS-485 bus (session_test) open
+#      			 the door with the PIN of a user only, not with a longer
+#      			 entry which starts with it
+#
+
+. "$(dirname "$0")/sim_test.sh"
+
+# a user with a PIN of POLICY_PASS_MAX_SIZE characters and a short one
+printf 'user,1,314159265358,0\nuser,2,2718,0\n' > "$WORK/users.csv"
+"$BIN/credential_compile" -e "$WORK/users.csv" "$EEPROM" > "$RAW" 2>&1 ||
+	fail "the credential table wasn't compiled"
+
+"$BIN/session_test" "$EEPROM" 314159265358 3141592653589 31415926535897 2718 27182 > "$OUT" 2>&1 ||
+	fail "session_test failed"
+expect "^314159265358: door$" "the longest user PIN didn't open the door"
+expect "^3141592653589: refused$" "the longest user PIN and one more character opened the door"
+expect "^31415926535897: refused$" "the longest user PIN and two more characters opened the door"
+expect "^2718: door$" "the short user PIN didn't open the door"
+expect "^27182: refused$" "the short user PIN and one more character opened the door"
+
+exit 0
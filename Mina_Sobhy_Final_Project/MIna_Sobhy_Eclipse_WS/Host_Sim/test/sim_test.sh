@@ -0,0 +1,62 @@
+#!/bin/sh
+#
+# sim_test.sh
+#
+#  Created on: Oct 19, 2026
+#      Author: Mina sobhy
+#      description: functions of the scenario tests of the host simulation,
+#      			 sourced by every test with the build directory as $1
+#
+#      A scenario runs door_sim on the virtual clock with the keys given as a
+#      string (door_sim -k, 'w' waits one second) and an EEPROM file kept
+#      between the runs of the test, so a second run is a power cycle of the
+#      two ECUs. The output has the time stamps removed so it can be matched
+#      with grep.
+#
+
+BIN=${1:?usage: $0 build_dir}
+WORK=$(mktemp -d "${TMPDIR:-/tmp}/sim_test.XXXXXX")
+trap 'rm -rf "$WORK"' EXIT
+EEPROM="$WORK/eeprom.bin"
+OUT="$WORK/out.txt"
+RAW="$WORK/raw.txt"
+
+# $1 keys, the next arguments are more options of door_sim, the output of the
+# run is in $OUT
+run()
+{
+	printf '%s' "$1" > "$WORK/keys"
+	shift
+	if ! "$BIN/door_sim" -v -e "$EEPROM" -k "$WORK/keys" "$@" > "$RAW" 2>&1; then
+		cat "$RAW"
+		fail "door_sim failed"
+	fi
+	sed 's/^\[\([a-z_]*\) *[0-9.]*\]/[\1]/' "$RAW" > "$OUT"
+}
+
+# the time stamp of the first line of the last run matching $1, in seconds
+stamp()
+{
+	grep -m 1 -- "$1" "$RAW" | sed 's/^\[[a-z_]* *\([0-9.]*\)\].*/\1/'
+}
+
+# $1 pattern which must be in the output of the last run, $2 what it checks
+expect()
+{
+	grep -q -- "$1" "$OUT" || fail "$2"
+}
+
+# $1 pattern which mustn't be in the output of the last run, $2 what it checks
+reject()
+{
+	if grep -q -- "$1" "$OUT"; then
+		fail "$2"
+	fi
+}
+
+fail()
+{
+	cat "$OUT" 2>/dev/null
+	echo "FAIL $(basename "$0"): $1" >&2
+	exit 1
+}
@@ -0,0 +1,737 @@
+/*
+ * bus_bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host model of the RS-485 bus, bus.c as it is on the CONTROL_ECU
+ *      			 side with its USART interrupts called by the model, and the
+ *      			 HMI_ECU keypads modelled on the same protocol
+ *
+ *      usage: bus_bench_N [seconds]
+ *
+ *      One executable is built for every number of keypads N (BOARD_BUS_NODES)
+ *      by Host_Sim/CMakeLists.txt. The model runs the transmitter of the master
+ *      byte by byte at BUS_BAUD: UDRE and TXC are called as the buffer and the
+ *      shift register empty, the driver enable pin is read from PORTD after every
+ *      interrupt and a byte only reaches the wires if it was sent with it high.
+ *      The keypads answer BENCH_TURNAROUND_US after the end of their poll, a byte
+ *      sent while another driver is on the wires is counted as a collision.
+ *
+ *      Every keypad presses a key every BENCH_PRESS_MIN_MS to BENCH_PRESS_MAX_MS,
+ *      the keys of a keypad are numbered. The main loop of the master takes them
+ *      from bus.c, checks their order and sends every key back to its keypad,
+ *      which checks it as well. The run is made with all the keypads answering,
+ *      with half of them missing and with bytes damaged on the wires.
+ *
+ *      Printed: poll cycle time (average and longest), keypress latency from the
+ *      press to the main loop of the master, round trip back to the keypad, and
+ *      the counters of bus.c. The run fails on a key lost or out of order, or
+ *      on a collision without damaged bytes. The flows of the keypad sessions
+ *      of control_main.c above bus.c are run by session_bench.
+ */
+
+#include "bus.h"
+#include "diag.h"
+#include "trace.h"
+#include "power.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/crc16.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define BENCH_SECONDS			10.0
+#define BENCH_NEVER				1e18
+
+/* one byte of 11 bits on the wires: start, 9 data bits and stop */
+#define BENCH_BYTE_US			(11000000.0 / BUS_BAUD)
+
+/* receive interrupt of the HMI_ECU at 1 MHz, the two bits of BUS_TURNAROUND_US
+ * and the frame built in the interrupt
+ */
+#define BENCH_TURNAROUND_US		100.0
+
+#define BENCH_PRESS_MIN_MS		50.0
+#define BENCH_PRESS_MAX_MS		250.0
+
+/* damaged bytes of the noisy run, one bit of the 9 is flipped */
+#define BENCH_ERROR_RATE		0.001
+
+/* driver enable pin of the master, the same as bus.c */
+#define BENCH_DE				(BUS_DE_PORT & (1<<BUS_DE_PIN))
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/* a keypad, with the link of bus.c on the node side */
+typedef struct
+{
+	int				present		;
+	/* link */
+	int				sequence	;
+	int				expected	;
+	int				reset		;
+	int				resetAck	;
+	unsigned int	inflight	;
+	unsigned char	queue[BUS_QUEUE_SIZE];
+	unsigned int	head		; /* free running, the queue holds head - tail bytes */
+	unsigned int	tail		;
+	/* receiver */
+	int				rxActive	;
+	unsigned char	rxFrame[BUS_FRAME_DATA + 1];
+	unsigned int	rxIndex		;
+	unsigned char	rxCrc		;
+	/* answer */
+	unsigned char	frame[BUS_FRAME_DATA + 3];
+	unsigned int	frameSize	;
+	unsigned int	frameIndex	;
+	double			answerAt	; /* end of the turnaround, BENCH_NEVER if none */
+	double			byteEnd		; /* end of the byte on the wires, BENCH_NEVER if none */
+	double			driveStart	;
+	double			driveEnd	;
+	int				driving		;
+	/* keys */
+	unsigned char	nextKey		;
+	unsigned char	nextEcho	;
+	double			pressDue	; /* time the next key is pressed */
+	double			pressAt		; /* time the keypad tries to queue it */
+	double			pressTime[256];
+} BENCH_NodeType;
+
+/* the USART of the master */
+typedef struct
+{
+	unsigned char	buffer		;
+	int				bufferBit8	;
+	int				bufferFull	;
+	unsigned char	shift		;
+	int				shiftBit8	;
+	int				shiftDriven	;
+	double			shiftStart	;
+	double			shiftEnd	; /* BENCH_NEVER while the shift register is empty */
+	int				de			;
+	double			deSince		;
+	double			deFall		;
+} BENCH_MasterType;
+
+typedef struct
+{
+	unsigned long	presses		;
+	unsigned long	keys		;
+	unsigned long	echoes		;
+	unsigned long	disorders	;
+	unsigned long	collisions	;
+	unsigned long	blocked		; /* keys waiting for room in the queue of the keypad */
+	double			latencySum	;
+	double			latencyMax	;
+	double			echoMax		;
+	double			cycleMax	;
+	double			cycleAt		;
+	uint32			cycles		;
+} BENCH_ResultType;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/* the USART interrupts of bus.c, plain functions on the host */
+void USART_RXC_vect(void);
+void USART_UDRE_vect(void);
+void USART_TXC_vect(void);
+
+static void BENCH_step(void);
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* the performance counters and the trace buffer used by bus.c */
+DIAG_CountersType g_diag = {.version = DIAG_VERSION};
+TRACE_RecordType g_traceBuffer[TRACE_BUFFER_SIZE];
+volatile uint8 g_traceHead = 0;
+volatile uint8 g_traceCount = 0;
+volatile uint8 g_tracePaused = 0;
+
+static BENCH_NodeType g_nodes[BOARD_BUS_NODES];
+static BENCH_MasterType g_master;
+static BENCH_ResultType g_result;
+static double g_now = 0.0;
+static double g_errorRate = 0.0;
+static unsigned long g_random = 0x2545F491UL;
+
+/* next key expected by the main loop of the master from every keypad */
+static unsigned char g_expect[BOARD_BUS_NODES];
+static int g_synced[BOARD_BUS_NODES];
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/* Description:
+ * the CPU of the master sleeps until the next event of the model
+ */
+void POWER_sleep(uint8 a_wake)
+{
+	(void)a_wake;
+	BENCH_step();
+}
+
+static unsigned long BENCH_random(void)
+{
+	g_random ^= g_random << 13;
+	g_random ^= g_random >> 17;
+	g_random ^= g_random << 5;
+	return g_random & 0xFFFFFFFFUL;
+}
+
+static double BENCH_pressDelay(void)
+{
+	return 1000.0 * (BENCH_PRESS_MIN_MS + ((BENCH_PRESS_MAX_MS - BENCH_PRESS_MIN_MS) *
+		(double)(BENCH_random() % 10000UL) / 10000.0));
+}
+
+/* Description:
+ * damage one bit of the 9 of a byte on the wires at the error rate
+ */
+static void BENCH_noise(unsigned char * a_byte, int * a_bit8)
+{
+	unsigned long bit;
+
+	if ((g_errorRate == 0.0) || ((double)(BENCH_random() % 1000000UL) >= (g_errorRate * 1000000.0)))
+	{
+		return;
+	}
+	bit = BENCH_random() % 9;
+	if (bit == 8)
+	{
+		*a_bit8 = !*a_bit8;
+	}
+	else
+	{
+		*a_byte ^= (unsigned char)(1 << bit);
+	}
+}
+
+/* Description:
+ * follow the driver enable pin after an interrupt of the master
+ */
+static void BENCH_masterDe(void)
+{
+	int de = BENCH_DE ? 1 : 0;
+
+	if (de && !g_master.de)
+	{
+		g_master.deSince = g_now;
+	}
+	else if (!de && g_master.de)
+	{
+		g_master.deFall = g_now;
+	}
+	g_master.de = de;
+}
+
+/* Description:
+ * take the data register empty interrupts and load the shift register
+ */
+static void BENCH_masterKick(void)
+{
+	for (;;)
+	{
+		if (!g_master.bufferFull && (UCSRB & (1<<UDRIE)) && (SREG & (1<<SREG_I)))
+		{
+			/* every call of the interrupt writes UDR once */
+			USART_UDRE_vect();
+			BENCH_masterDe();
+			g_master.buffer = UDR;
+			g_master.bufferBit8 = (UCSRB & (1<<TXB8)) ? 1 : 0;
+			g_master.bufferFull = 1;
+		}
+		if (g_master.bufferFull && (g_master.shiftEnd == BENCH_NEVER))
+		{
+			g_master.shift = g_master.buffer;
+			g_master.shiftBit8 = g_master.bufferBit8;
+			g_master.shiftDriven = g_master.de;
+			g_master.shiftStart = g_now;
+			g_master.shiftEnd = g_now + BENCH_BYTE_US;
+			g_master.bufferFull = 0;
+			continue;
+		}
+		break;
+	}
+}
+
+/* Description:
+ * take the acknowledgement and the data of a frame on a keypad, the data is
+ * the keys sent back by the master
+ */
+static void BENCH_nodeTake(BENCH_NodeType * a_node)
+{
+	unsigned char control = a_node->rxFrame[0];
+	unsigned int length = control & BUS_CONTROL_LENGTH;
+	unsigned char key;
+	unsigned int i;
+
+	if (control & BUS_CONTROL_RESET)
+	{
+		if (!a_node->resetAck)
+		{
+			a_node->sequence = 0;
+			a_node->expected = 0;
+			a_node->resetAck = 1;
+			a_node->inflight = 0;
+		}
+	}
+	else
+	{
+		a_node->resetAck = 0;
+	}
+	if (control & BUS_CONTROL_RESET_ACK)
+	{
+		a_node->reset = 0;
+	}
+
+	if ((a_node->inflight != 0) && (!(control & BUS_CONTROL_ACK) != !a_node->sequence))
+	{
+		a_node->tail += a_node->inflight;
+		a_node->inflight = 0;
+		a_node->sequence = !a_node->sequence;
+	}
+
+	if ((length != 0) && (!(control & BUS_CONTROL_SEQUENCE) == !a_node->expected))
+	{
+		for (i = 0; i < length; i++)
+		{
+			key = a_node->rxFrame[1 + i];
+			if (key != a_node->nextEcho)
+			{
+				g_result.disorders++;
+			}
+			else if ((g_now - a_node->pressTime[key]) > g_result.echoMax)
+			{
+				g_result.echoMax = g_now - a_node->pressTime[key];
+			}
+			a_node->nextEcho = key + 1;
+			g_result.echoes++;
+		}
+		a_node->expected = !a_node->expected;
+	}
+}
+
+/* Description:
+ * build the answer of a keypad, it starts after the turnaround
+ */
+static void BENCH_nodeAnswer(BENCH_NodeType * a_node)
+{
+	unsigned char control;
+	unsigned char crc = 0;
+	unsigned int i;
+
+	if (a_node->inflight == 0)
+	{
+		a_node->inflight = a_node->head - a_node->tail;
+		if (a_node->inflight > BUS_FRAME_DATA)
+		{
+			a_node->inflight = BUS_FRAME_DATA;
+		}
+	}
+
+	control = (unsigned char)a_node->inflight;
+	control |= a_node->sequence ? BUS_CONTROL_SEQUENCE : 0;
+	control |= a_node->expected ? BUS_CONTROL_ACK : 0;
+	control |= a_node->reset ? BUS_CONTROL_RESET : 0;
+	control |= a_node->resetAck ? BUS_CONTROL_RESET_ACK : 0;
+
+	a_node->frame[0] = BUS_MASTER;
+	a_node->frame[1] = control;
+	for (i = 0; i < a_node->inflight; i++)
+	{
+		a_node->frame[2 + i] = a_node->queue[(a_node->tail + i) % BUS_QUEUE_SIZE];
+	}
+	a_node->frameSize = 2 + a_node->inflight;
+	for (i = 0; i < a_node->frameSize; i++)
+	{
+		crc = _crc8_ccitt_update(crc, a_node->frame[i]);
+	}
+	a_node->frame[a_node->frameSize] = crc;
+	a_node->frameSize++;
+	a_node->frameIndex = 0;
+	a_node->answerAt = g_now + BENCH_TURNAROUND_US;
+}
+
+/* Description:
+ * a byte of the master reaches the receiver of a keypad
+ */
+static void BENCH_nodeReceive(BENCH_NodeType * a_node, unsigned char a_address, unsigned char a_byte,
+	int a_bit8, int a_damaged)
+{
+	if (a_damaged)
+	{
+		a_node->rxActive = 0;
+		return;
+	}
+
+	/* the node only listens to its own frames (MPCM) */
+	if (a_bit8)
+	{
+		a_node->rxActive = (a_byte == a_address);
+		a_node->rxIndex = 0;
+		a_node->rxCrc = _crc8_ccitt_update(0, a_byte);
+		return;
+	}
+	if (!a_node->rxActive)
+	{
+		return;
+	}
+
+	if ((a_node->rxIndex == 0) || (a_node->rxIndex <= (unsigned int)(a_node->rxFrame[0] & BUS_CONTROL_LENGTH)))
+	{
+		if ((a_node->rxIndex == 0) && ((a_byte & BUS_CONTROL_LENGTH) > BUS_FRAME_DATA))
+		{
+			a_node->rxActive = 0;
+			return;
+		}
+		a_node->rxFrame[a_node->rxIndex++] = a_byte;
+		a_node->rxCrc = _crc8_ccitt_update(a_node->rxCrc, a_byte);
+		return;
+	}
+
+	a_node->rxActive = 0;
+	if (a_byte == a_node->rxCrc)
+	{
+		BENCH_nodeTake(a_node);
+		BENCH_nodeAnswer(a_node);
+	}
+}
+
+/* Description:
+ * the byte in the shift register of the master is out
+ */
+static void BENCH_masterShifted(void)
+{
+	unsigned char byte = g_master.shift;
+	int bit8 = g_master.shiftBit8;
+	int damaged = 0;
+	unsigned int i;
+
+	g_master.shiftEnd = BENCH_NEVER;
+
+	/* a byte reaches the wires if the driver was enabled for all of it */
+	if (g_master.shiftDriven && g_master.de)
+	{
+		for (i = 0; i < BOARD_BUS_NODES; i++)
+		{
+			if ((g_nodes[i].driving && (g_nodes[i].driveStart < g_now)) ||
+				(g_nodes[i].driveEnd > g_master.shiftStart))
+			{
+				g_result.collisions++;
+				damaged = 1;
+			}
+		}
+		BENCH_noise(&byte, &bit8);
+		for (i = 0; i < BOARD_BUS_NODES; i++)
+		{
+			if (g_nodes[i].present)
+			{
+				BENCH_nodeReceive(&g_nodes[i], (unsigned char)(i + 1), byte, bit8, damaged);
+			}
+		}
+	}
+
+	/* the transmit complete interrupt comes if no byte waits in the buffer */
+	if (!g_master.bufferFull && (UCSRB & (1<<TXCIE)))
+	{
+		USART_TXC_vect();
+		BENCH_masterDe();
+	}
+	BENCH_masterKick();
+}
+
+/* Description:
+ * a byte of a keypad is out, the master receives it if its driver is disabled
+ */
+static void BENCH_nodeShifted(BENCH_NodeType * a_node)
+{
+	unsigned char byte = a_node->frame[a_node->frameIndex];
+	int bit8 = (a_node->frameIndex == 0);
+	double start = g_now - BENCH_BYTE_US;
+	int damaged = 0;
+
+	if ((g_master.de && (g_master.deSince < g_now)) || (g_master.deFall > start))
+	{
+		g_result.collisions++;
+		damaged = 1;
+	}
+
+	if (!g_master.de)
+	{
+		BENCH_noise(&byte, &bit8);
+		UCSRA = damaged ? (1<<FE) : 0;
+		UCSRB = bit8 ? (UCSRB | (1<<RXB8)) : (UCSRB & ~(1<<RXB8));
+		UDR = byte;
+		USART_RXC_vect();
+		UCSRA = 0;
+		BENCH_masterDe();
+		BENCH_masterKick();
+	}
+
+	a_node->frameIndex++;
+	if (a_node->frameIndex < a_node->frameSize)
+	{
+		a_node->byteEnd = g_now + BENCH_BYTE_US;
+	}
+	else
+	{
+		a_node->byteEnd = BENCH_NEVER;
+		a_node->driving = 0;
+		a_node->driveEnd = g_now;
+	}
+}
+
+/* Description:
+ * a key is pressed on a keypad, it waits if the queue of the keypad is full
+ */
+static void BENCH_nodePress(BENCH_NodeType * a_node)
+{
+	if ((a_node->head - a_node->tail) == BUS_QUEUE_SIZE)
+	{
+		g_result.blocked++;
+		a_node->pressAt = g_now + BENCH_BYTE_US;
+		return;
+	}
+
+	a_node->pressTime[a_node->nextKey] = a_node->pressDue;
+	a_node->queue[a_node->head % BUS_QUEUE_SIZE] = a_node->nextKey;
+	a_node->head++;
+	a_node->nextKey++;
+	g_result.presses++;
+	a_node->pressDue += BENCH_pressDelay();
+	a_node->pressAt = a_node->pressDue;
+}
+
+/* Description:
+ * run the next event of the model
+ */
+static void BENCH_step(void)
+{
+	BENCH_NodeType * node;
+	double next = g_master.shiftEnd;
+	BUS_StatsType stats;
+	unsigned int i;
+
+	for (i = 0; i < BOARD_BUS_NODES; i++)
+	{
+		node = &g_nodes[i];
+		if (node->present)
+		{
+			next = (node->answerAt < next) ? node->answerAt : next;
+			next = (node->byteEnd < next) ? node->byteEnd : next;
+			next = (node->pressAt < next) ? node->pressAt : next;
+		}
+	}
+	g_now = next;
+
+	if (g_master.shiftEnd == next)
+	{
+		BENCH_masterShifted();
+	}
+	else
+	{
+		for (i = 0; i < BOARD_BUS_NODES; i++)
+		{
+			node = &g_nodes[i];
+			if (!node->present)
+			{
+				continue;
+			}
+			if (node->answerAt == next)
+			{
+				node->answerAt = BENCH_NEVER;
+				node->driving = 1;
+				node->driveStart = g_now;
+				node->byteEnd = g_now + BENCH_BYTE_US;
+				break;
+			}
+			if (node->byteEnd == next)
+			{
+				BENCH_nodeShifted(node);
+				break;
+			}
+			if (node->pressAt == next)
+			{
+				BENCH_nodePress(node);
+				break;
+			}
+		}
+	}
+
+	/* the first cycle starts after BUS_init */
+	BUS_getStats(&stats);
+	if (stats.cycles != g_result.cycles)
+	{
+		if ((g_result.cycles != 0) && ((g_now - g_result.cycleAt) > g_result.cycleMax))
+		{
+			g_result.cycleMax = g_now - g_result.cycleAt;
+		}
+		g_result.cycles = stats.cycles;
+		g_result.cycleAt = g_now;
+	}
+}
+
+/* Description:
+ * main loop of the master: take the keys in order and send them back
+ */
+static void BENCH_application(void)
+{
+	unsigned char key;
+	double latency;
+	uint8 node;
+
+	for (node = 1; node <= BOARD_BUS_NODES; node++)
+	{
+		if (BUS_isNew(node))
+		{
+			g_synced[node - 1] = 0;
+		}
+		while (BUS_isDataAvailable(node))
+		{
+			key = BUS_receiveByte(node);
+			if (g_synced[node - 1] && (key != g_expect[node - 1]))
+			{
+				g_result.disorders++;
+			}
+			g_expect[node - 1] = key + 1;
+			g_synced[node - 1] = 1;
+
+			latency = g_now - g_nodes[node - 1].pressTime[key];
+			g_result.latencySum += latency;
+			if (latency > g_result.latencyMax)
+			{
+				g_result.latencyMax = latency;
+			}
+			g_result.keys++;
+
+			BUS_sendByte(node, key);
+		}
+	}
+}
+
+/* Description:
+ * run the bus for a_seconds with a_present keypads answering, return 0 if no key
+ * was lost or out of order
+ */
+static int BENCH_run(double a_seconds, unsigned int a_present, double a_errorRate)
+{
+	BUS_StatsType stats;
+	unsigned long pending = 0;
+	unsigned int i;
+
+	g_errorRate = a_errorRate;
+	g_master.shiftEnd = BENCH_NEVER;
+	for (i = 0; i < BOARD_BUS_NODES; i++)
+	{
+		g_nodes[i].present = (i < a_present);
+		g_nodes[i].reset = 1;
+		g_nodes[i].answerAt = BENCH_NEVER;
+		g_nodes[i].byteEnd = BENCH_NEVER;
+		g_nodes[i].pressDue = BENCH_pressDelay();
+		g_nodes[i].pressAt = g_nodes[i].pressDue;
+	}
+
+	sei();
+	BUS_init();
+	BENCH_masterDe();
+	BENCH_masterKick();
+
+	while (g_now < (a_seconds * 1000000.0))
+	{
+		BENCH_application();
+		BENCH_step();
+	}
+
+	BUS_getStats(&stats);
+	for (i = 0; i < a_present; i++)
+	{
+		pending += g_nodes[i].head - g_nodes[i].tail;
+	}
+
+	printf("%2u nodes, %2u answering, byte errors %.0e: cycle %6.2f ms avg %6.2f ms max, "
+		"key %6.2f ms avg %6.2f ms max, echo %6.2f ms max, %lu keys, %u timeouts, %u errors, "
+		"%u retries, %lu collisions\n",
+		BOARD_BUS_NODES, a_present, a_errorRate,
+		(g_now / 1000.0) / (double)((stats.cycles != 0) ? stats.cycles : 1), g_result.cycleMax / 1000.0,
+		(g_result.latencySum / 1000.0) / (double)((g_result.keys != 0) ? g_result.keys : 1),
+		g_result.latencyMax / 1000.0, g_result.echoMax / 1000.0, g_result.keys,
+		stats.timeouts, stats.errors, stats.retries, g_result.collisions);
+
+	if (g_result.disorders != 0)
+	{
+		fprintf(stderr, "bus_bench: %lu keys lost or out of order\n", g_result.disorders);
+		return 1;
+	}
+	/* the keys not acknowledged yet are still in the queues of the keypads */
+	if ((g_result.keys == 0) || ((g_result.presses - g_result.keys) > pending))
+	{
+		fprintf(stderr, "bus_bench: %lu of %lu keys not received\n", g_result.presses - g_result.keys,
+			g_result.presses);
+		return 1;
+	}
+	if ((a_errorRate == 0.0) && ((g_result.collisions != 0) || (stats.errors != 0)))
+	{
+		fprintf(stderr, "bus_bench: collisions on a clean bus\n");
+		return 1;
+	}
+
+	return 0;
+}
+
+/* Description:
+ * run a_present keypads in a new process, bus.c starts from its reset state
+ */
+static int BENCH_fork(double a_seconds, unsigned int a_present, double a_errorRate)
+{
+	int status;
+	pid_t pid;
+
+	fflush(stdout);
+	pid = fork();
+	if (pid == 0)
+	{
+		exit(BENCH_run(a_seconds, a_present, a_errorRate));
+	}
+	if ((pid < 0) || (waitpid(pid, &status, 0) != pid) || !WIFEXITED(status))
+	{
+		fprintf(stderr, "bus_bench: the run didn't end\n");
+		return 1;
+	}
+
+	return WEXITSTATUS(status);
+}
+
+int main(int argc, char * argv[])
+{
+	double seconds = (argc > 1) ? atof(argv[1]) : BENCH_SECONDS;
+	int failed = 0;
+
+	if (seconds <= 0.0)
+	{
+		fprintf(stderr, "usage: %s [seconds]\n", argv[0]);
+		return 2;
+	}
+
+	failed |= BENCH_fork(seconds, BOARD_BUS_NODES, 0.0);
+	if (BOARD_BUS_NODES > 1)
+	{
+		failed |= BENCH_fork(seconds, BOARD_BUS_NODES / 2, 0.0);
+	}
+	failed |= BENCH_fork(seconds, BOARD_BUS_NODES, BENCH_ERROR_RATE);
+
+	return failed;
+}
@@ -0,0 +1,261 @@
+/*
+ * clock_bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host model of the real-time clock of the CONTROL_ECU, built
+ *      			 from clock.c as it is with the Timer2 overflow ISR called by
+ *      			 the model
+ *
+ *      usage: clock_bench [days [read_seconds]]
+ *
+ *      Drift: the ISR is called at every overflow of a crystal of 32.768 kHz plus
+ *      an error in ppm for the given days of true time. Every ISR must move
+ *      CLOCK_now by one tick and CLOCK_counts by 256, the clock must then be
+ *      behind or ahead of the true time by the crystal error only, the counting
+ *      adds nothing. The wall clock set at the start must have moved with it.
+ *
+ *      Reads: a host interval timer calls the ISR as a signal every
+ *      CLOCK_BENCH_ISR_US while the main loop reads CLOCK_now for read_seconds.
+ *      A read interrupted in the middle is done again by clock.c, every value
+ *      read must be a valid time and never older than the one before. The host
+ *      time of a read is printed, the AVR cycles of CLOCK_now are measured by the
+ *      "CLOCK_now" case of Benchmark/bench_control.c.
+ */
+
+#include "clock.h"
+#include "diag.h"
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define CLOCK_BENCH_DAYS		7
+#define CLOCK_BENCH_READ_S		2
+#define CLOCK_BENCH_ISR_US		20
+
+/* a second of the wall clock set at the start of the drift runs, Wednesday 12:34:56 */
+#define CLOCK_BENCH_WALL		((2 * CLOCK_SECONDS_PER_DAY) + (12 * 3600UL) + (34 * 60UL) + 56)
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/* the Timer2 overflow ISR of clock.c, a plain function on the host */
+void TIMER2_OVF_vect(void);
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* the performance counters of diag.c, the ISR keeps isr_max_latency in them */
+DIAG_CountersType g_diag = {.version = DIAG_VERSION};
+
+/* crystal errors of the drift runs: exact, a watch crystal at its tolerance
+ * either way, and at the edge of its temperature range
+ */
+static const double g_errorsPpm[] = {0.0, 20.0, -20.0, -150.0};
+
+/* reads of the main loop interrupted by the signal ISR */
+static volatile sig_atomic_t g_reading = 0;
+static volatile unsigned long g_interrupted = 0;
+static volatile unsigned long g_interrupts = 0;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/* Description:
+ * the Timer2 overflow "interrupt" of the read run
+ */
+static void CLOCK_BENCH_signal(int a_signal)
+{
+	(void)a_signal;
+
+	TIMER2_OVF_vect();
+	g_interrupts++;
+	if (g_reading)
+	{
+		g_interrupted++;
+	}
+}
+
+static unsigned long long CLOCK_BENCH_ticks(const CLOCK_TimeType * a_time)
+{
+	return ((unsigned long long)a_time->seconds * CLOCK_TICKS_PER_SECOND) + a_time->ticks;
+}
+
+/* Description:
+ * run the clock for a_days of true time on a crystal a_ppm away from its
+ * nominal frequency, return 0 if the clock counted every overflow right
+ */
+static int CLOCK_BENCH_drift(unsigned long a_days, double a_ppm)
+{
+	/* true time of one overflow of the crystal */
+	double period = 256.0 / ((double)BOARD_RTC_CRYSTAL_HZ * (1.0 + (a_ppm / 1000000.0)));
+	double end = (double)a_days * CLOCK_SECONDS_PER_DAY;
+	unsigned long long overflows = 0;
+	unsigned long long start;
+	CLOCK_TimeType now;
+	uint32 seconds;
+	uint32 counts;
+	double error;
+
+	CLOCK_init();
+	CLOCK_now(&now);
+	CLOCK_setWall(CLOCK_BENCH_WALL);
+	start = CLOCK_BENCH_ticks(&now);
+	seconds = now.seconds;
+	counts = CLOCK_counts();
+
+	while (((double)(overflows + 1) * period) <= end)
+	{
+		TIMER2_OVF_vect();
+		overflows++;
+
+		CLOCK_now(&now);
+		if ((now.ticks >= CLOCK_TICKS_PER_SECOND) || ((CLOCK_BENCH_ticks(&now) - start) != overflows))
+		{
+			fprintf(stderr, "clock_bench: CLOCK_now is wrong after %llu overflows\n", overflows);
+			return 1;
+		}
+		counts += 256;
+		if ((CLOCK_counts() & 0xFFFFFFFFUL) != (counts & 0xFFFFFFFFUL))
+		{
+			fprintf(stderr, "clock_bench: CLOCK_counts is wrong after %llu overflows\n", overflows);
+			return 1;
+		}
+	}
+
+	if (CLOCK_wall() != CLOCK_BENCH_WALL + (now.seconds - seconds))
+	{
+		fprintf(stderr, "clock_bench: the wall clock didn't move with the clock\n");
+		return 1;
+	}
+
+	/* the true time of the last overflow, the clock shows it at that moment */
+	error = ((double)(CLOCK_BENCH_ticks(&now) - start) / CLOCK_TICKS_PER_SECOND) - ((double)overflows * period);
+	printf("drift:        crystal %+7.1f ppm, %lu days, clock %+9.3f s, %+7.1f ppm, %+7.3f s/day\n",
+		a_ppm, a_days, error, error * 1000000.0 / ((double)overflows * period),
+		error / (double)a_days);
+
+	/* with an exact crystal only the rounding of the printed value is left */
+	if ((a_ppm == 0.0) && ((error > 0.000001) || (error < -0.000001)))
+	{
+		fprintf(stderr, "clock_bench: the clock drifts with an exact crystal\n");
+		return 1;
+	}
+	return 0;
+}
+
+/* Description:
+ * read the clock while the signal ISR moves it, return 0 if every read was valid
+ */
+static int CLOCK_BENCH_reads(unsigned long a_seconds)
+{
+	struct itimerval timer;
+	struct sigaction action;
+	struct timespec begin;
+	struct timespec now;
+	CLOCK_TimeType time;
+	CLOCK_TimeType last;
+	unsigned long long reads = 0;
+	unsigned long changes = 0;
+	double elapsed = 0.0;
+	unsigned int i;
+
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = CLOCK_BENCH_signal;
+	sigaction(SIGALRM, &action, NULL);
+
+	timer.it_interval.tv_sec = 0;
+	timer.it_interval.tv_usec = CLOCK_BENCH_ISR_US;
+	timer.it_value = timer.it_interval;
+	setitimer(ITIMER_REAL, &timer, NULL);
+
+	CLOCK_now(&last);
+	clock_gettime(CLOCK_MONOTONIC, &begin);
+	while (elapsed < (double)a_seconds)
+	{
+		/* the clock is read in batches, the host time is only taken after them */
+		for (i = 0; i < 4096; i++)
+		{
+			g_reading = 1;
+			CLOCK_now(&time);
+			g_reading = 0;
+			reads++;
+
+			if ((time.ticks >= CLOCK_TICKS_PER_SECOND) || (time.seconds < last.seconds)
+				|| ((time.seconds == last.seconds) && (time.ticks < last.ticks)))
+			{
+				timer.it_value.tv_usec = 0;
+				timer.it_interval.tv_usec = 0;
+				setitimer(ITIMER_REAL, &timer, NULL);
+				fprintf(stderr, "clock_bench: torn read %lu.%u after %lu.%u\n",
+					(unsigned long)time.seconds, time.ticks, (unsigned long)last.seconds, last.ticks);
+				return 1;
+			}
+			if ((time.seconds != last.seconds) || (time.ticks != last.ticks))
+			{
+				changes++;
+			}
+			last = time;
+		}
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		elapsed = (double)(now.tv_sec - begin.tv_sec) + ((double)(now.tv_nsec - begin.tv_nsec) / 1e9);
+	}
+
+	timer.it_value.tv_usec = 0;
+	timer.it_interval.tv_usec = 0;
+	setitimer(ITIMER_REAL, &timer, NULL);
+
+	printf("reads:        %llu reads, %.1f ns/read on the host, %lu ISR calls, %lu changes seen\n",
+		reads, elapsed * 1e9 / (double)reads, g_interrupts, changes);
+	printf("              %lu reads interrupted by the ISR, no torn read\n", g_interrupted);
+	return 0;
+}
+
+int main(int argc, char * argv[])
+{
+	unsigned long days = CLOCK_BENCH_DAYS;
+	unsigned long readSeconds = CLOCK_BENCH_READ_S;
+	unsigned int i;
+
+	if (argc > 1)
+	{
+		days = strtoul(argv[1], NULL, 0);
+	}
+	if (argc > 2)
+	{
+		readSeconds = strtoul(argv[2], NULL, 0);
+	}
+	if ((argc > 3) || (days == 0))
+	{
+		fprintf(stderr, "usage: %s [days [read_seconds]]\n", argv[0]);
+		return 2;
+	}
+
+	printf("clock:        %lu Hz crystal, %lu ticks/s, CLOCK_counts unit %lu CPU cycles\n",
+		BOARD_RTC_CRYSTAL_HZ, CLOCK_TICKS_PER_SECOND, CLOCK_COUNT_CYCLES);
+
+	for (i = 0; i < sizeof(g_errorsPpm) / sizeof(g_errorsPpm[0]); i++)
+	{
+		if (CLOCK_BENCH_drift(days, g_errorsPpm[i]) != 0)
+		{
+			return 1;
+		}
+	}
+
+	if ((readSeconds != 0) && (CLOCK_BENCH_reads(readSeconds) != 0))
+	{
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,578 @@
+/*
+ * credential_bench.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: speed and correctness of the credential table, the compiler of
+ *      			 Host_Sim/tools/credential_compiler.cpp and the lookup of
+ *      			 Control_ECU/credential.c on the simulated 24C16
+ *
+ *      usage: credential_bench [users [runs]]
+ *
+ *      A CSV of random users (10000 by default) is compiled runs times into a
+ *      host-sized credential area, the time of every run is printed and the
+ *      images must be byte-identical.
+ *
+ *      Tables of up to the most users which fit in the credential area of the
+ *      24C16 are then compiled, written in the simulated EEPROM and loaded by
+ *      CRED_init. Every user must be found by CRED_find with its ID and group in
+ *      exactly one EEPROM read, PINs of no user must be refused after one read,
+ *      and a table with one wrong byte must be found empty.
+ *
+ *      The lookup by the minimal perfect hash is last compared with a linear and
+ *      a binary search of the same records sorted by tag, for 10 to 10000 users
+ *      on tables in the host memory. The reads and bytes of a lookup are
+ *      counted and the lookup cycles are the TWI time at 400 kHz on the 8 MHz
+ *      CPU, which waits for the TWI; the digest of the PIN is the same for the
+ *      three lookups and isn't counted.
+ *
+ *      credential_bench_flash is built with BOARD_CRED_STORE == BOARD_CRED_FLASH:
+ *      CRED_init copies the table from the simulated EEPROM to the simulated
+ *      flash, the time of the copy is printed and a second CRED_init must not
+ *      write the flash again. The lookups must not read the EEPROM at all, and
+ *      the lookup cycles are the ones of the lpm loop of FLASH_read.
+ */
+
+extern "C"
+{
+#include "credential.h"
+#include "cred_store.h"
+#include "diag.h"
+#include "twi.h"
+#include "sim.h"
+}
+#include "credential_compiler.h"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <set>
+#include <unistd.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define CREDENTIAL_BENCH_USERS		10000
+#define CREDENTIAL_BENCH_RUNS		5
+#define CREDENTIAL_BENCH_STRANGERS	2000
+#define CREDENTIAL_BENCH_TWI_HZ		400000UL	/* TWI_BITRATE 0x02 at 8 MHz */
+
+/* cost of a read of the storage: the bytes added to the record and the cycles
+ * of a byte, and the EEPROM reads of a lookup
+ */
+#if (BOARD_CRED_STORE == BOARD_CRED_FLASH)
+#define CREDENTIAL_BENCH_STORE			"flash"
+#define CREDENTIAL_BENCH_HEADER			0
+#define CREDENTIAL_BENCH_BYTE_CYCLES	7.0		/* lpm, st and the loop of FLASH_read */
+#define CREDENTIAL_BENCH_LOOKUP_READS	0
+#else
+#define CREDENTIAL_BENCH_STORE			"24C16"
+#define CREDENTIAL_BENCH_HEADER			4		/* device address, word address, device address again */
+#define CREDENTIAL_BENCH_BYTE_CYCLES	(9.0 * F_CPU / CREDENTIAL_BENCH_TWI_HZ)
+#define CREDENTIAL_BENCH_LOOKUP_READS	1
+#endif
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/* reads of the lookups of one search on a table in the host memory */
+typedef struct
+{
+	unsigned long long	reads	;
+	unsigned long long	bytes	;
+	unsigned long		maxReads;
+} CREDENTIAL_BENCH_CostType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+extern "C" const char SIM_nodeName[] = "credential_bench";
+
+/* virtual clock, moved by the delays only */
+static unsigned long long g_now = 0;
+
+/* EEPROM reads counted by the DIAG_eepromAccess hook of external_eeprom.c */
+static unsigned long g_reads = 0;
+
+static unsigned long g_seed = 1;
+
+/*******************************************************************************
+ *                      Simulation and diagnostics hooks                       *
+ *******************************************************************************/
+
+extern "C"
+{
+
+unsigned long long SIM_now(void)
+{
+	return g_now;
+}
+
+void SIM_delay(unsigned long long a_us)
+{
+	g_now += a_us;
+}
+
+void SIM_log(const char * a_format, ...)
+{
+	va_list args;
+
+	printf("[%s %10.3f] ", SIM_nodeName, (double)g_now / 1000000.0);
+	va_start(args, a_format);
+	vprintf(a_format, args);
+	va_end(args);
+	printf("\n");
+}
+
+void SIM_boardIdle(void)
+{
+}
+
+uint32 DIAG_now(void)
+{
+	return (uint32)(g_now * (F_CPU / 1000000UL) / DIAG_TICK_CYCLES);
+}
+
+void DIAG_eepromAccess(uint8 a_write, uint32 a_start, uint8 a_ok)
+{
+	(void)a_start;
+
+	if (!a_write)
+	{
+		g_reads++;
+	}
+	if (!a_ok)
+	{
+		fprintf(stderr, "credential_bench: EEPROM access failed\n");
+		exit(1);
+	}
+}
+
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+static unsigned long CREDENTIAL_BENCH_random(void)
+{
+	g_seed = (g_seed * 1103515245UL) + 12345UL;
+	return (g_seed >> 16) & 0x7FFF;
+}
+
+static double CREDENTIAL_BENCH_seconds(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + ((double)now.tv_nsec / 1e9);
+}
+
+/* Description:
+ * a CSV of a_count users with different PINs of 6 to 8 digits and a schedule
+ * for two of the groups, the PINs are kept in a_pins
+ */
+static std::string CREDENTIAL_BENCH_users(unsigned long a_count, std::vector<std::string> & a_pins)
+{
+	std::set<std::string> used;
+	std::string csv = "# generated by credential_bench\nschedule,1,mon-fri 08:00-18:00\nschedule,2,sat,sun 10:00-14:00\n";
+	std::string pin;
+	unsigned long i;
+	unsigned long size;
+
+	a_pins.clear();
+	for (i = 1; i <= a_count; i++)
+	{
+		do
+		{
+			size = 6 + (CREDENTIAL_BENCH_random() % 3);
+			pin.clear();
+			while (pin.size() < size)
+			{
+				pin += (char)('0' + (CREDENTIAL_BENCH_random() % 10));
+			}
+		} while (!used.insert(pin).second);
+		a_pins.push_back(pin);
+		csv += "user," + std::to_string(i) + "," + pin + "," + std::to_string(i % SCHEDULE_GROUPS) + "\n";
+	}
+	return csv;
+}
+
+/* Description:
+ * parse and build a CSV, return the error found or an empty string
+ */
+static std::string CREDENTIAL_BENCH_compile(const std::string & a_csv, unsigned long a_credSize,
+	std::vector<unsigned char> & a_image, CREDC_SummaryType & a_summary)
+{
+	CREDC_DatabaseType database;
+	std::string::size_type start = 0;
+	std::string::size_type end;
+	std::string error;
+	unsigned long number = 0;
+
+	CREDC_start(database);
+	while (start < a_csv.size())
+	{
+		end = a_csv.find('\n', start);
+		number++;
+		error = CREDC_parse(database, a_csv.substr(start, end - start), number);
+		if (error.empty())
+		{
+			error = (end == std::string::npos) ? "no end of line" : "";
+		}
+		if (!error.empty())
+		{
+			return error;
+		}
+		start = end + 1;
+	}
+
+	return CREDC_build(database, a_credSize, a_image, a_summary);
+}
+
+/* Description:
+ * write the image area in the EEPROM, one page at a time
+ */
+static void CREDENTIAL_BENCH_store(const std::vector<unsigned char> & a_image)
+{
+	unsigned long offset;
+
+	for (offset = 0; offset < a_image.size(); offset += EEPROM_PAGE_SIZE)
+	{
+		EEPROM_writeBlock((uint16)(EEPROM_IMAGE_ADDRESS + offset), &a_image[offset], EEPROM_PAGE_SIZE);
+		SIM_delay(10000);
+	}
+}
+
+/* Description:
+ * count one read of a record of a table in the host memory
+ */
+static void CREDENTIAL_BENCH_read(CREDENTIAL_BENCH_CostType & a_cost, unsigned long & a_reads)
+{
+	a_cost.reads++;
+	a_cost.bytes += CRED_RECORD_SIZE;
+	a_reads++;
+}
+
+/* Description:
+ * look up a_digest in a_records sorted by tag with a_search: 0 linear, 1 binary,
+ * 2 the minimal perfect hash of a_area. Return the ID found, 0 for none.
+ */
+static unsigned long CREDENTIAL_BENCH_search(int a_search, const unsigned char * a_area,
+	const std::vector<const unsigned char *> & a_records, const unsigned char * a_digest,
+	CREDENTIAL_BENCH_CostType & a_cost)
+{
+	const unsigned char * record = NULL;
+	unsigned long count = a_records.size();
+	unsigned long buckets = a_area[CRED_HEADER_BUCKETS] | ((unsigned long)a_area[CRED_HEADER_BUCKETS + 1] << 8);
+	unsigned long reads = 0;
+	unsigned long low = 0;
+	unsigned long high = count;
+	unsigned long middle;
+	unsigned long displacement;
+	int order;
+
+	if (a_search == 0)
+	{
+		for (low = 0; (low < count) && (record == NULL); low++)
+		{
+			CREDENTIAL_BENCH_read(a_cost, reads);
+			record = (memcmp(a_records[low], a_digest, CRED_TAG_SIZE) == 0) ? a_records[low] : NULL;
+		}
+	}
+	else if (a_search == 1)
+	{
+		while ((low < high) && (record == NULL))
+		{
+			middle = low + ((high - low) / 2);
+			CREDENTIAL_BENCH_read(a_cost, reads);
+			order = memcmp(a_records[middle], a_digest, CRED_TAG_SIZE);
+			if (order == 0)
+			{
+				record = a_records[middle];
+			}
+			else if (order < 0)
+			{
+				low = middle + 1;
+			}
+			else
+			{
+				high = middle;
+			}
+		}
+	}
+	else
+	{
+		/* the displacement is in RAM, the record is the one read */
+		displacement = a_area[CRED_DISPLACEMENT_OFFSET + (2 * CRED_BUCKET(a_digest, buckets))]
+			| ((unsigned long)a_area[CRED_DISPLACEMENT_OFFSET + (2 * CRED_BUCKET(a_digest, buckets)) + 1] << 8);
+		record = a_area + CRED_TABLE_OFFSET(buckets)
+			+ (CRED_SLOT(a_digest, displacement, count) * (unsigned long)CRED_RECORD_SIZE);
+		CREDENTIAL_BENCH_read(a_cost, reads);
+		record = (memcmp(record, a_digest, CRED_TAG_SIZE) == 0) ? record : NULL;
+	}
+
+	a_cost.bytes += reads * CREDENTIAL_BENCH_HEADER;
+	a_cost.maxReads = (reads > a_cost.maxReads) ? reads : a_cost.maxReads;
+	return (record == NULL) ? 0 : (record[CRED_RECORD_USER] | ((unsigned long)record[CRED_RECORD_USER + 1] << 8));
+}
+
+/* Description:
+ * compare the three searches on a_users users, the members then as many
+ * strangers, return 0 if every search found the right users
+ */
+static int CREDENTIAL_BENCH_compare(unsigned long a_users)
+{
+	static const char * const names[] = {"linear", "binary", "perfect hash"};
+	std::vector<std::string> pins;
+	std::vector<unsigned char> image;
+	std::vector<const unsigned char *> records;
+	CREDENTIAL_BENCH_CostType members;
+	CREDENTIAL_BENCH_CostType strangers;
+	CREDC_SummaryType summary;
+	const unsigned char * area;
+	unsigned char digest[DIGEST_TAG_SIZE];
+	std::string error;
+	unsigned long i;
+	int search;
+
+	g_seed = a_users;
+	error = CREDENTIAL_BENCH_compile(CREDENTIAL_BENCH_users(a_users, pins), CREDC_areaSize(a_users), image, summary);
+	if (!error.empty())
+	{
+		fprintf(stderr, "credential_bench: %s\n", error.c_str());
+		return 1;
+	}
+	area = &image[EEPROM_CRED_ADDRESS - EEPROM_IMAGE_ADDRESS];
+	for (i = 0; i < a_users; i++)
+	{
+		records.push_back(area + CRED_TABLE_OFFSET(summary.buckets) + (i * CRED_RECORD_SIZE));
+	}
+	std::sort(records.begin(), records.end(), [](const unsigned char * a_first, const unsigned char * a_second)
+	{
+		return memcmp(a_first, a_second, CRED_TAG_SIZE) < 0;
+	});
+
+	for (search = 0; search < 3; search++)
+	{
+		memset(&members, 0, sizeof(members));
+		memset(&strangers, 0, sizeof(strangers));
+		for (i = 0; i < a_users; i++)
+		{
+			CREDC_digest(area + CRED_SALT_OFFSET, pins[i], digest);
+			if (CREDENTIAL_BENCH_search(search, area, records, digest, members) != (i + 1))
+			{
+				fprintf(stderr, "credential_bench: %s search missed user %lu\n", names[search], i + 1);
+				return 1;
+			}
+			CREDC_digest(area + CRED_SALT_OFFSET, std::to_string(100000000UL + (i * 7919UL)), digest);
+			if (CREDENTIAL_BENCH_search(search, area, records, digest, strangers) != 0)
+			{
+				fprintf(stderr, "credential_bench: %s search let a stranger in\n", names[search]);
+				return 1;
+			}
+		}
+		printf("%-13s %5lu users, %-12s %8.2f reads %9.1f bytes %10.0f cycles, stranger %8.2f reads (%lu at most)\n",
+			(search == 0) ? "lookup:" : "", a_users, names[search], (double)members.reads / (double)a_users,
+			(double)members.bytes / (double)a_users,
+			(double)members.bytes * CREDENTIAL_BENCH_BYTE_CYCLES / (double)a_users,
+			(double)strangers.reads / (double)a_users, strangers.maxReads);
+	}
+
+	return 0;
+}
+
+/* Description:
+ * compile a_users users for the credential area of the 24C16, load them with
+ * CRED_init (twice, the second one must not write the flash) and look up every
+ * user and the strangers, return 0 if all is right
+ */
+static int CREDENTIAL_BENCH_lookup(unsigned long a_users)
+{
+	std::vector<std::string> pins;
+	std::vector<unsigned char> image;
+	CREDC_SummaryType summary;
+	CRED_UserType user;
+	std::string error;
+	unsigned long reads;
+	unsigned long maxReads = 0;
+	unsigned long totalReads = 0;
+	unsigned long refused = 0;
+	unsigned long i;
+	unsigned long long start;
+	unsigned long long time;
+	unsigned char digest[DIGEST_TAG_SIZE];
+
+	g_seed = a_users;
+	error = CREDENTIAL_BENCH_compile(CREDENTIAL_BENCH_users(a_users, pins), EEPROM_CRED_SIZE, image, summary);
+	if (!error.empty())
+	{
+		fprintf(stderr, "credential_bench: %s\n", error.c_str());
+		return 1;
+	}
+	CREDENTIAL_BENCH_store(image);
+	start = g_now;
+	CRED_init();
+	time = g_now - start;
+	CRED_init();
+	if ((CRED_count() != a_users) || (g_now != (start + time)))
+	{
+		fprintf(stderr, "credential_bench: %u users loaded of %lu, %llu us of the second CRED_init\n",
+			CRED_count(), a_users, g_now - (start + time));
+		return 1;
+	}
+
+	for (i = 0; i < a_users; i++)
+	{
+		CREDC_digest(CRED_salt(), pins[i], digest);
+		reads = g_reads;
+		if (!CRED_find(digest, &user) || (user.id != (i + 1)) || (user.group != ((i + 1) % SCHEDULE_GROUPS)))
+		{
+			fprintf(stderr, "credential_bench: user %lu not found\n", i + 1);
+			return 1;
+		}
+		reads = g_reads - reads;
+		totalReads += reads;
+		maxReads = (reads > maxReads) ? reads : maxReads;
+	}
+
+	/* PINs of nobody, the ones of 9 digits can't be a user of the bench */
+	for (i = 0; i < CREDENTIAL_BENCH_STRANGERS; i++)
+	{
+		CREDC_digest(CRED_salt(), std::to_string(100000000UL + (i * 7919UL)), digest);
+		reads = g_reads;
+		refused += !CRED_find(digest, &user);
+		reads = g_reads - reads;
+		maxReads = (reads > maxReads) ? reads : maxReads;
+	}
+	if (refused != CREDENTIAL_BENCH_STRANGERS)
+	{
+		fprintf(stderr, "credential_bench: %lu strangers let in\n", CREDENTIAL_BENCH_STRANGERS - refused);
+		return 1;
+	}
+
+	if ((totalReads != (a_users * CREDENTIAL_BENCH_LOOKUP_READS)) || (maxReads != CREDENTIAL_BENCH_LOOKUP_READS))
+	{
+		fprintf(stderr, "credential_bench: %lu EEPROM reads for %lu users, %lu at most\n",
+			totalReads, a_users, maxReads);
+		return 1;
+	}
+	printf("%-13s %2lu users, %2lu buckets, %2lu bytes of RAM, 1 read of %u bytes per lookup, %.0f cycles, "
+		"CRED_init copy %.1f ms\n", CREDENTIAL_BENCH_STORE ":", a_users, summary.buckets, summary.buckets * 2,
+		CRED_RECORD_SIZE, (CRED_RECORD_SIZE + CREDENTIAL_BENCH_HEADER) * CREDENTIAL_BENCH_BYTE_CYCLES,
+		(double)time / 1000.0);
+
+	/* one wrong byte of the last record empties the table */
+	image[(EEPROM_CRED_ADDRESS - EEPROM_IMAGE_ADDRESS) + summary.used - 1] ^= 0x01;
+	CREDENTIAL_BENCH_store(image);
+	CRED_init();
+	if (CRED_count() != 0)
+	{
+		fprintf(stderr, "credential_bench: corrupted table loaded\n");
+		return 1;
+	}
+
+	return 0;
+}
+
+int main(int argc, char * argv[])
+{
+	TWI_ConfigType twiType = {0x02, 0x01};
+	const unsigned long sizes[] = {10, 20, 40, CREDC_capacity(EEPROM_CRED_SIZE)};
+	char path[] = "/tmp/credential_bench_XXXXXX";
+	std::vector<std::string> pins;
+	std::vector<unsigned char> first;
+	std::vector<unsigned char> image;
+	CREDC_SummaryType summary;
+	std::string csv;
+	std::string error;
+	unsigned long users = CREDENTIAL_BENCH_USERS;
+	unsigned long runs = CREDENTIAL_BENCH_RUNS;
+	unsigned long i;
+	double start;
+	double time;
+	double worst = 0.0;
+	int fd;
+
+	if (argc > 1)
+	{
+		users = strtoul(argv[1], NULL, 0);
+	}
+	if (argc > 2)
+	{
+		runs = strtoul(argv[2], NULL, 0);
+	}
+	if ((argc > 3) || (users == 0) || (users > 65535) || (runs == 0))
+	{
+		fprintf(stderr, "usage: %s [users (1 to 65535) [runs]]\n", argv[0]);
+		return 2;
+	}
+
+	/* the compiler on a credential area sized for the users */
+	csv = CREDENTIAL_BENCH_users(users, pins);
+	for (i = 0; i < runs; i++)
+	{
+		start = CREDENTIAL_BENCH_seconds();
+		error = CREDENTIAL_BENCH_compile(csv, CREDC_areaSize(users), image, summary);
+		time = CREDENTIAL_BENCH_seconds() - start;
+		if (!error.empty())
+		{
+			fprintf(stderr, "credential_bench: %s\n", error.c_str());
+			return 1;
+		}
+		worst = (time > worst) ? time : worst;
+		if (i == 0)
+		{
+			first = image;
+		}
+		else if (image != first)
+		{
+			fprintf(stderr, "credential_bench: run %lu gave another image\n", i + 1);
+			return 1;
+		}
+	}
+	printf("compiler:     %lu users, %lu runs, worst %.1f ms, %.2f us/user, %lu byte images identical\n",
+		users, runs, worst * 1e3, worst * 1e6 / (double)users, (unsigned long)first.size());
+	printf("              %lu buckets, %lu bytes of displacements, largest displacement %lu, %lu bytes of credential area\n",
+		summary.buckets, summary.buckets * 2, summary.displacementMax, summary.used);
+
+	/* the lookup of the CONTROL_ECU on the simulated 24C16 */
+	fd = mkstemp(path);
+	if (fd < 0)
+	{
+		perror("credential_bench");
+		return 1;
+	}
+	close(fd);
+	unlink(path);
+	setenv(SIM_ENV_EEPROM, path, 1);
+	TWI_init(&twiType);
+
+	for (i = 0; i < (sizeof(sizes) / sizeof(sizes[0])); i++)
+	{
+		if (CREDENTIAL_BENCH_lookup(sizes[i]) != 0)
+		{
+			unlink(path);
+			return 1;
+		}
+	}
+	unlink(path);
+	printf("              every user found, %u strangers refused, a table with one wrong byte refused\n",
+		CREDENTIAL_BENCH_STRANGERS);
+
+	/* the three searches on tables of the host */
+	for (i = 10; i <= CREDENTIAL_BENCH_USERS; i *= 10)
+	{
+		if (CREDENTIAL_BENCH_compare(i) != 0)
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,185 @@
+/*
+ * credential_compile.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: compile a CSV database of the users into an EEPROM image
+ *
+ *      usage: credential_compile [-a area_bytes] [-e] users_file image_file
+ *
+ *      The users and the schedules (Host_Sim/tools/credential_compiler.h) are read
+ *      from users_file, or stdin for "-". image_file gets the image area, the
+ *      EEPROM_IMAGE_SIZE bytes sent by the provisioning. With -e image_file is a
+ *      whole 24C16 image, the SIM_EEPROM file of the simulation (door_sim -e) or
+ *      the content for a programmer: its image area is replaced and the rest is
+ *      kept, a missing file is created erased. -a builds another credential area
+ *      for the host only, -a 0 the area sized for the users. The same input
+ *      always gives the same image.
+ */
+
+#include "credential_compiler.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define CREDENTIAL_COMPILE_EEPROM_SIZE	2048	/* 24C16 */
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+static double CREDENTIAL_COMPILE_seconds(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + ((double)now.tv_nsec / 1e9);
+}
+
+int main(int argc, char * argv[])
+{
+	CREDC_DatabaseType database;
+	CREDC_SummaryType summary;
+	std::vector<unsigned char> image;
+	std::vector<unsigned char> eeprom;
+	std::ifstream input;
+	std::istream * stream = &std::cin;
+	std::string line;
+	std::string error;
+	unsigned long credSize = EEPROM_CRED_SIZE;
+	unsigned long number = 0;
+	unsigned long pinsOut = 0;
+	unsigned long i;
+	bool whole = false;
+	bool sized = false; /* -a 0, an area sized for the users */
+	double start;
+	double parseTime;
+	double buildTime;
+	FILE * file;
+	int arg = 1;
+
+	while ((arg < argc) && (argv[arg][0] == '-') && (argv[arg][1] != '\0'))
+	{
+		if ((strcmp(argv[arg], "-a") == 0) && ((arg + 1) < argc))
+		{
+			credSize = strtoul(argv[arg + 1], NULL, 0);
+			sized = (credSize == 0);
+			arg += 2;
+		}
+		else if (strcmp(argv[arg], "-e") == 0)
+		{
+			whole = true;
+			arg++;
+		}
+		else
+		{
+			break;
+		}
+	}
+	if (((argc - arg) != 2) || (whole && (credSize != EEPROM_CRED_SIZE)))
+	{
+		fprintf(stderr, "usage: %s [-a area_bytes] [-e] users_file image_file\n", argv[0]);
+		fprintf(stderr, "       -e keeps the credential area of the 24C16, %u bytes\n", EEPROM_CRED_SIZE);
+		return 2;
+	}
+
+	if (strcmp(argv[arg], "-") != 0)
+	{
+		input.open(argv[arg]);
+		if (!input)
+		{
+			perror(argv[arg]);
+			return 1;
+		}
+		stream = &input;
+	}
+
+	start = CREDENTIAL_COMPILE_seconds();
+	CREDC_start(database);
+	while (std::getline(*stream, line))
+	{
+		number++;
+		error = CREDC_parse(database, line, number);
+		if (!error.empty())
+		{
+			fprintf(stderr, "%s: %s\n", argv[arg], error.c_str());
+			return 1;
+		}
+	}
+	parseTime = CREDENTIAL_COMPILE_seconds() - start;
+
+	/* the HMI_ECU takes the PINs of the policy size only, the default one unless
+	 * the settings changed it
+	 */
+	for (i = 0; i < database.users.size(); i++)
+	{
+		pinsOut += (database.users[i].pin.size() < POLICY_DEFAULT_PASS_MIN)
+			|| (database.users[i].pin.size() > POLICY_DEFAULT_PASS_MAX);
+	}
+	if (pinsOut != 0)
+	{
+		fprintf(stderr, "%s: warning: %lu PINs out of the default policy of %u to %u digits\n", argv[arg],
+			pinsOut, POLICY_DEFAULT_PASS_MIN, POLICY_DEFAULT_PASS_MAX);
+	}
+
+	if (sized)
+	{
+		credSize = CREDC_areaSize(database.users.size());
+	}
+
+	start = CREDENTIAL_COMPILE_seconds();
+	error = CREDC_build(database, credSize, image, summary);
+	buildTime = CREDENTIAL_COMPILE_seconds() - start;
+	if (!error.empty())
+	{
+		fprintf(stderr, "%s: %s\n", argv[arg], error.c_str());
+		return 1;
+	}
+
+	/* the image area in a whole EEPROM image, the rest is kept */
+	if (whole)
+	{
+		eeprom.assign(CREDENTIAL_COMPILE_EEPROM_SIZE, 0xFF);
+		file = fopen(argv[arg + 1], "rb");
+		if (file != NULL)
+		{
+			if (fread(eeprom.data(), 1, eeprom.size(), file) != eeprom.size())
+			{
+				fprintf(stderr, "%s: short EEPROM image, the rest is erased\n", argv[arg + 1]);
+			}
+			fclose(file);
+		}
+		memcpy(&eeprom[EEPROM_IMAGE_ADDRESS], image.data(), image.size());
+		image.swap(eeprom);
+	}
+
+	file = fopen(argv[arg + 1], "wb");
+	if ((file == NULL) || (fwrite(image.data(), 1, image.size(), file) != image.size()))
+	{
+		perror(argv[arg + 1]);
+		return 1;
+	}
+	fclose(file);
+
+	printf("%lu users, %lu schedule rules, %s salt\n", summary.users, (unsigned long)database.rules.size(),
+		database.saltSet ? "given" : "derived");
+	printf("%lu buckets, %lu bytes of displacements in RAM, largest displacement %lu\n", summary.buckets,
+		summary.buckets * 2, summary.displacementMax);
+	if (summary.buckets > CRED_BUCKETS_MAX)
+	{
+		fprintf(stderr, "%s: warning: the CONTROL_ECU keeps %u buckets at most, the table is for the host only\n",
+			argv[arg], CRED_BUCKETS_MAX);
+	}
+	printf("%lu of %lu bytes of credential area, %lu bytes written\n", summary.used, credSize,
+		(unsigned long)image.size());
+	printf("parsed in %.3f ms, built in %.3f ms\n", parseTime * 1e3, buildTime * 1e3);
+
+	return 0;
+}
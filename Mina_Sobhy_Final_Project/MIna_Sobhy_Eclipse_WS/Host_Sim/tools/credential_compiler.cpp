@@ -0,0 +1,454 @@
+/*
+ * credential_compiler.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host compiler of a CSV database of the users into the image
+ *      			 area of the external EEPROM
+ */
+
+#include "credential_compiler.h"
+#include <util/crc16.h>
+#include <algorithm>
+#include <cstring>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define CREDC_ID_MAX		65535UL
+#define CREDC_FNV_OFFSET	0xCBF29CE484222325ULL
+#define CREDC_FNV_PRIME		0x100000001B3ULL
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/* a record of the table before it is stored */
+typedef struct
+{
+	unsigned char	digest[DIGEST_TAG_SIZE];
+	unsigned char	group	;
+	unsigned long	id		;
+	unsigned long	line	;
+} CREDC_RecordType;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static std::string CREDC_trim(const std::string & a_text);
+static bool CREDC_number(const std::string & a_text, unsigned long a_max, unsigned long & a_value);
+static std::string CREDC_error(unsigned long a_number, const std::string & a_text);
+static unsigned long long CREDC_mix(unsigned long long a_value);
+static unsigned long CREDC_buckets(unsigned long a_users, unsigned long a_keys);
+static bool CREDC_hash(const std::vector<CREDC_RecordType> & a_records, unsigned long a_buckets,
+	std::vector<unsigned long> & a_displacements, std::vector<unsigned long> & a_slots);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+static std::string CREDC_trim(const std::string & a_text)
+{
+	std::string::size_type first = a_text.find_first_not_of(" \t\r\n");
+	std::string::size_type last = a_text.find_last_not_of(" \t\r\n");
+
+	return (first == std::string::npos) ? std::string() : a_text.substr(first, last - first + 1);
+}
+
+/* Description:
+ * decimal digits only, at most a_max
+ */
+static bool CREDC_number(const std::string & a_text, unsigned long a_max, unsigned long & a_value)
+{
+	std::string::size_type i;
+
+	if (a_text.empty() || (a_text.size() > 9))
+	{
+		return false;
+	}
+	a_value = 0;
+	for (i = 0; i < a_text.size(); i++)
+	{
+		if ((a_text[i] < '0') || (a_text[i] > '9'))
+		{
+			return false;
+		}
+		a_value = (a_value * 10) + (unsigned long)(a_text[i] - '0');
+	}
+	return a_value <= a_max;
+}
+
+static std::string CREDC_error(unsigned long a_number, const std::string & a_text)
+{
+	return "line " + std::to_string(a_number) + ": " + a_text;
+}
+
+/* Description:
+ * splitmix64 finalizer, spreads the hash of the input into the derived salt
+ */
+static unsigned long long CREDC_mix(unsigned long long a_value)
+{
+	a_value += 0x9E3779B97F4A7C15ULL;
+	a_value = (a_value ^ (a_value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	a_value = (a_value ^ (a_value >> 27)) * 0x94D049BB133111EBULL;
+	return a_value ^ (a_value >> 31);
+}
+
+static unsigned long CREDC_buckets(unsigned long a_users, unsigned long a_keys)
+{
+	return (a_users + a_keys - 1) / a_keys;
+}
+
+/* Description:
+ * build the minimal perfect hash of the records (CHD): the buckets from the
+ * largest one take the first displacement which sends all their records to free
+ * slots, a bucket of one record finds any free slot as the displacements go over
+ * every 16-bit value. Return false if a bucket has no displacement.
+ */
+static bool CREDC_hash(const std::vector<CREDC_RecordType> & a_records, unsigned long a_buckets,
+	std::vector<unsigned long> & a_displacements, std::vector<unsigned long> & a_slots)
+{
+	std::vector<std::vector<unsigned long> > members(a_buckets);
+	std::vector<unsigned long> order(a_buckets);
+	std::vector<unsigned long> slots;
+	std::vector<char> taken(a_records.size(), 0);
+	unsigned long count = a_records.size();
+	unsigned long displacement;
+	unsigned long bucket;
+	unsigned long i;
+	unsigned long j;
+	bool free;
+
+	for (i = 0; i < count; i++)
+	{
+		members[CRED_BUCKET(a_records[i].digest, a_buckets)].push_back(i);
+	}
+	for (i = 0; i < a_buckets; i++)
+	{
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(), order.end(), [&members](unsigned long a_first, unsigned long a_second)
+	{
+		return members[a_first].size() > members[a_second].size();
+	});
+
+	a_displacements.assign(a_buckets, 0);
+	a_slots.assign(count, 0);
+	for (i = 0; (i < a_buckets) && !members[order[i]].empty(); i++)
+	{
+		bucket = order[i];
+		for (displacement = 0; displacement <= 0xFFFF; displacement++)
+		{
+			slots.clear();
+			free = true;
+			for (j = 0; free && (j < members[bucket].size()); j++)
+			{
+				slots.push_back(CRED_SLOT(a_records[members[bucket][j]].digest, displacement, count));
+				free = !taken[slots[j]] && (std::find(slots.begin(), slots.begin() + j, slots[j]) == (slots.begin() + j));
+			}
+			if (free)
+			{
+				break;
+			}
+		}
+		if (displacement > 0xFFFF)
+		{
+			return false;
+		}
+		a_displacements[bucket] = displacement;
+		for (j = 0; j < slots.size(); j++)
+		{
+			taken[slots[j]] = 1;
+			a_slots[members[bucket][j]] = slots[j];
+		}
+	}
+	return true;
+}
+
+void CREDC_start(CREDC_DatabaseType & a_database)
+{
+	a_database.users.clear();
+	a_database.rules.clear();
+	a_database.saltSet = false;
+	memset(a_database.salt, 0, sizeof(a_database.salt));
+	a_database.hash = CREDC_FNV_OFFSET;
+}
+
+std::string CREDC_parse(CREDC_DatabaseType & a_database, const std::string & a_line, unsigned long a_number)
+{
+	std::string record = CREDC_trim(a_line.substr(0, a_line.find('#')));
+	std::vector<std::string> fields;
+	std::string::size_type start = 0;
+	std::string::size_type comma;
+	CREDC_UserType user;
+	RULES_RuleType rule;
+	unsigned long value;
+	std::string::size_type i;
+	const char * error;
+	int found;
+
+	if (record.empty())
+	{
+		return std::string();
+	}
+
+	/* the salt derived from the input depends on the records only */
+	for (i = 0; i < record.size(); i++)
+	{
+		a_database.hash = (a_database.hash ^ (unsigned char)record[i]) * CREDC_FNV_PRIME;
+	}
+	a_database.hash = (a_database.hash ^ '\n') * CREDC_FNV_PRIME;
+
+	do
+	{
+		comma = record.find(',', start);
+		fields.push_back(CREDC_trim(record.substr(start, comma - start)));
+		start = comma + 1;
+	} while (comma != std::string::npos);
+
+	if (fields[0] == "user")
+	{
+		if (fields.size() != 4)
+		{
+			return CREDC_error(a_number, "expected user,<id>,<pin>,<group>");
+		}
+		if (!CREDC_number(fields[1], CREDC_ID_MAX, user.id) || (user.id == 0))
+		{
+			return CREDC_error(a_number, "the user ID must be 1 to 65535");
+		}
+		user.pin = fields[2];
+		if ((user.pin.size() < POLICY_PASS_MIN_SIZE) || (user.pin.size() > POLICY_PASS_MAX_SIZE)
+			|| (user.pin.find_first_not_of("0123456789") != std::string::npos))
+		{
+			return CREDC_error(a_number, "the PIN must be " + std::to_string(POLICY_PASS_MIN_SIZE) + " to "
+				+ std::to_string(POLICY_PASS_MAX_SIZE) + " digits");
+		}
+		if (!CREDC_number(fields[3], SCHEDULE_GROUPS - 1, value))
+		{
+			return CREDC_error(a_number, "the group must be 0 to " + std::to_string(SCHEDULE_GROUPS - 1));
+		}
+		user.group = (unsigned char)value;
+		user.line = a_number;
+		a_database.users.push_back(user);
+		return std::string();
+	}
+
+	if (fields[0] == "schedule")
+	{
+		if ((fields.size() < 3) || !CREDC_number(fields[1], SCHEDULE_GROUPS - 1, value))
+		{
+			return CREDC_error(a_number, "expected schedule,<group>,<rule> with a group 0 to "
+				+ std::to_string(SCHEDULE_GROUPS - 1));
+		}
+
+		/* the rule keeps its commas, "sat,sun" is a list of days */
+		start = record.find(',', record.find(',') + 1) + 1;
+		error = RULES_parse((fields[1] + " " + record.substr(start)).c_str(), &rule, &found);
+		if ((error != NULL) || !found)
+		{
+			return CREDC_error(a_number, (error != NULL) ? error : "no rule");
+		}
+		a_database.rules.push_back(rule);
+		return std::string();
+	}
+
+	if (fields[0] == "salt")
+	{
+		if ((fields.size() != 2) || (fields[1].size() != (2 * DIGEST_SALT_SIZE))
+			|| (fields[1].find_first_not_of("0123456789abcdefABCDEF") != std::string::npos))
+		{
+			return CREDC_error(a_number, "the salt must be " + std::to_string(2 * DIGEST_SALT_SIZE) + " hexadecimal digits");
+		}
+		for (i = 0; i < DIGEST_SALT_SIZE; i++)
+		{
+			a_database.salt[i] = (unsigned char)std::stoul(fields[1].substr(2 * i, 2), NULL, 16);
+		}
+		a_database.saltSet = true;
+		return std::string();
+	}
+
+	return CREDC_error(a_number, "unknown record \"" + fields[0] + "\"");
+}
+
+unsigned long CREDC_areaSize(unsigned long a_users)
+{
+	return (CRED_TABLE_OFFSET(CREDC_buckets(a_users, CRED_BUCKET_KEYS)) + (a_users * CRED_RECORD_SIZE)
+		+ EEPROM_PAGE_SIZE - 1) & ~(unsigned long)(EEPROM_PAGE_SIZE - 1);
+}
+
+unsigned long CREDC_capacity(unsigned long a_credSize)
+{
+	unsigned long users = (a_credSize < CRED_TABLE_OFFSET(1)) ? 0 : ((a_credSize - CRED_TABLE_OFFSET(1)) / CRED_RECORD_SIZE);
+
+	while ((users > 0) && (CREDC_areaSize(users) > a_credSize))
+	{
+		users--;
+	}
+	return users;
+}
+
+unsigned long CREDC_imageSize(unsigned long a_credSize)
+{
+	return (EEPROM_CRED_ADDRESS - EEPROM_IMAGE_ADDRESS) + a_credSize;
+}
+
+void CREDC_digest(const unsigned char * a_salt, const std::string & a_pin, unsigned char * a_digest)
+{
+	DIGEST_calculate(a_salt, (const uint8 *)a_pin.data(), (uint8)a_pin.size(), a_digest);
+}
+
+std::string CREDC_build(const CREDC_DatabaseType & a_database, unsigned long a_credSize,
+	std::vector<unsigned char> & a_image, CREDC_SummaryType & a_summary)
+{
+	std::vector<CREDC_RecordType> records(a_database.users.size());
+	std::vector<unsigned long long> ids; /* ID then line */
+	std::vector<unsigned long> displacements;
+	std::vector<unsigned long> slots;
+	unsigned char salt[DIGEST_SALT_SIZE];
+	unsigned char * area;
+	unsigned char * record;
+	unsigned long long value;
+	unsigned long count = a_database.users.size();
+	unsigned long keys;
+	unsigned long buckets = 0;
+	unsigned long end;
+	unsigned long i;
+	unsigned short crc = 0xFFFF;
+
+	if (((a_credSize % EEPROM_PAGE_SIZE) != 0) || (a_credSize < CRED_TABLE_OFFSET(1)))
+	{
+		return "the credential area must be whole pages of at least " + std::to_string(CRED_TABLE_OFFSET(1)) + " bytes";
+	}
+
+	a_image.assign(CREDC_imageSize(a_credSize), 0xFF);
+	area = &a_image[EEPROM_CRED_ADDRESS - EEPROM_IMAGE_ADDRESS];
+
+	/* the schedules of the groups, the rules in the order of the input */
+	RULES_start(&a_image[EEPROM_SCHEDULE_ADDRESS - EEPROM_IMAGE_ADDRESS]);
+	for (i = 0; i < a_database.rules.size(); i++)
+	{
+		RULES_apply(&a_image[EEPROM_SCHEDULE_ADDRESS - EEPROM_IMAGE_ADDRESS], &a_database.rules[i]);
+	}
+
+	/* the salt given or derived from the input */
+	if (a_database.saltSet)
+	{
+		memcpy(salt, a_database.salt, DIGEST_SALT_SIZE);
+	}
+	else
+	{
+		value = a_database.hash;
+		for (i = 0; i < DIGEST_SALT_SIZE; i++)
+		{
+			if ((i % 8) == 0)
+			{
+				value = CREDC_mix(value);
+			}
+			salt[i] = (unsigned char)(value >> (8 * (i % 8)));
+		}
+	}
+
+	/* a user ID is used once */
+	for (i = 0; i < count; i++)
+	{
+		ids.push_back(((unsigned long long)a_database.users[i].id << 32) | a_database.users[i].line);
+	}
+	std::sort(ids.begin(), ids.end());
+	for (i = 1; i < count; i++)
+	{
+		if ((ids[i] >> 32) == (ids[i - 1] >> 32))
+		{
+			return CREDC_error((unsigned long)(ids[i] & 0xFFFFFFFFUL), "user " + std::to_string(ids[i] >> 32)
+				+ " already on line " + std::to_string(ids[i - 1] & 0xFFFFFFFFUL));
+		}
+	}
+
+	/* the tags must all be different, sorted to find the same ones */
+	for (i = 0; i < count; i++)
+	{
+		DIGEST_calculate(salt, (const uint8 *)a_database.users[i].pin.data(), (uint8)a_database.users[i].pin.size(),
+			records[i].digest);
+		records[i].group = a_database.users[i].group;
+		records[i].id = a_database.users[i].id;
+		records[i].line = a_database.users[i].line;
+	}
+	std::sort(records.begin(), records.end(), [](const CREDC_RecordType & a_first, const CREDC_RecordType & a_second)
+	{
+		return memcmp(a_first.digest, a_second.digest, DIGEST_TAG_SIZE) < 0;
+	});
+	for (i = 1; i < count; i++)
+	{
+		if (memcmp(records[i].digest, records[i - 1].digest, CRED_TAG_SIZE) == 0)
+		{
+			return CREDC_error(records[i].line, "the PIN of user " + std::to_string(records[i].id)
+				+ " can't be told from the one of user " + std::to_string(records[i - 1].id));
+		}
+	}
+
+	/* less users per bucket, so more displacements, until the hash is found */
+	for (keys = CRED_BUCKET_KEYS; (count != 0) && (keys > 0); keys--)
+	{
+		buckets = CREDC_buckets(count, keys);
+		if (CREDC_hash(records, buckets, displacements, slots))
+		{
+			break;
+		}
+	}
+	if ((count != 0) && (keys == 0))
+	{
+		return "no perfect hash of the users, two PINs have the same hash";
+	}
+	end = CRED_TABLE_OFFSET(buckets) + (count * CRED_RECORD_SIZE);
+	if (end > a_credSize)
+	{
+		return std::to_string(count) + " users don't fit in " + std::to_string(a_credSize)
+			+ " bytes of credential area, at most " + std::to_string(CREDC_capacity(a_credSize));
+	}
+
+	/* header page */
+	memset(area, 0, EEPROM_PAGE_SIZE);
+	area[CRED_HEADER_VERSION] = CRED_VERSION;
+	area[CRED_HEADER_COUNT] = (unsigned char)count;
+	area[CRED_HEADER_COUNT + 1] = (unsigned char)(count >> 8);
+	area[CRED_HEADER_BUCKETS] = (unsigned char)buckets;
+	area[CRED_HEADER_BUCKETS + 1] = (unsigned char)(buckets >> 8);
+	memcpy(area + CRED_SALT_OFFSET, salt, DIGEST_SALT_SIZE);
+
+	a_summary.displacementMax = 0;
+	for (i = 0; i < buckets; i++)
+	{
+		area[CRED_DISPLACEMENT_OFFSET + (2 * i)] = (unsigned char)displacements[i];
+		area[CRED_DISPLACEMENT_OFFSET + (2 * i) + 1] = (unsigned char)(displacements[i] >> 8);
+		a_summary.displacementMax = std::max(a_summary.displacementMax, displacements[i]);
+	}
+
+	/* every record in the slot of its digest */
+	for (i = 0; i < count; i++)
+	{
+		record = area + CRED_TABLE_OFFSET(buckets) + (slots[i] * CRED_RECORD_SIZE);
+		memcpy(record, records[i].digest, CRED_TAG_SIZE);
+		record[CRED_RECORD_GROUP] = records[i].group;
+		record[CRED_RECORD_USER] = (unsigned char)records[i].id;
+		record[CRED_RECORD_USER + 1] = (unsigned char)(records[i].id >> 8);
+	}
+
+	/* CRC of the header then of everything after the header page */
+	for (i = 0; i < CRED_HEADER_CRC; i++)
+	{
+		crc = _crc_ccitt_update(crc, area[i]);
+	}
+	for (i = CRED_SALT_OFFSET; i < end; i++)
+	{
+		crc = _crc_ccitt_update(crc, area[i]);
+	}
+	area[CRED_HEADER_CRC] = (unsigned char)crc;
+	area[CRED_HEADER_CRC + 1] = (unsigned char)(crc >> 8);
+
+	a_summary.users = count;
+	a_summary.buckets = buckets;
+	a_summary.used = end;
+
+	return std::string();
+}
@@ -0,0 +1,122 @@
+/*
+ * credential_compiler.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host compiler of a CSV database of the users into the image
+ *      			 area of the external EEPROM, the access schedules
+ *      			 (Control_ECU/schedule.h) and the credential table
+ *      			 (Control_ECU/credential.h)
+ *
+ *      One record per line, '#' starts a comment:
+ *          user,<id>,<pin>,<group>
+ *          schedule,<group>,<days> <from>-<to>
+ *          salt,<32 hexadecimal digits>
+ *      <id> is 1 to 65535 (0 is the main password), <pin> is POLICY_PASS_MIN_SIZE
+ *      to POLICY_PASS_MAX_SIZE digits and <group> is below SCHEDULE_GROUPS. The
+ *      schedule rules are the ones of Host_Sim/tools/schedule_compiler.h without
+ *      their group. The salt of the table is derived from the input when there
+ *      is no salt line, so the same input always gives the same image.
+ *
+ *      The image holds the schedule area then the credential area, it is the
+ *      EEPROM_IMAGE_SIZE bytes written by the provisioning (provision.h). A
+ *      larger credential area can be built for the host, the CONTROL_ECU reads
+ *      only EEPROM_CRED_SIZE bytes.
+ */
+
+#ifndef CREDENTIAL_COMPILER_H_
+#define CREDENTIAL_COMPILER_H_
+
+extern "C"
+{
+#include "credential.h"
+#include "policy.h"
+#include "schedule_compiler.h"
+}
+#include <string>
+#include <vector>
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef struct
+{
+	unsigned long	id		;
+	std::string		pin		;
+	unsigned char	group	;
+	unsigned long	line	; /* line of the CSV, for the errors */
+} CREDC_UserType;
+
+typedef struct
+{
+	std::vector<CREDC_UserType>	users	;
+	std::vector<RULES_RuleType>	rules	;
+	bool						saltSet	;
+	unsigned char				salt[DIGEST_SALT_SIZE];
+	unsigned long long			hash	; /* of the input, for the derived salt */
+} CREDC_DatabaseType;
+
+/* counts of a built image */
+typedef struct
+{
+	unsigned long	users			;
+	unsigned long	buckets			;
+	unsigned long	displacementMax	;
+	unsigned long	used			; /* bytes of the credential area in use */
+} CREDC_SummaryType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Empty a_database before the first line.
+ */
+void CREDC_start(CREDC_DatabaseType & a_database);
+
+/*
+ * Description :
+ * Parse one line of the CSV, a_number is its line number.
+ * Return an empty string on success, else the error found.
+ */
+std::string CREDC_parse(CREDC_DatabaseType & a_database, const std::string & a_line, unsigned long a_number);
+
+/*
+ * Description :
+ * Return the size of the image with a credential area of a_credSize bytes.
+ */
+unsigned long CREDC_imageSize(unsigned long a_credSize);
+
+/*
+ * Description :
+ * Return the bytes of a credential area which holds a_users users with
+ * CRED_BUCKET_KEYS users per bucket.
+ */
+unsigned long CREDC_areaSize(unsigned long a_users);
+
+/*
+ * Description :
+ * Return the most users which fit in a credential area of a_credSize bytes.
+ */
+unsigned long CREDC_capacity(unsigned long a_credSize);
+
+/*
+ * Description :
+ * Build the image of a_database with a credential area of a_credSize bytes in
+ * a_image, the users are checked for duplicates and placed by the minimal
+ * perfect hash of their digests.
+ * Return an empty string on success, else the error found.
+ */
+std::string CREDC_build(const CREDC_DatabaseType & a_database, unsigned long a_credSize,
+	std::vector<unsigned char> & a_image, CREDC_SummaryType & a_summary);
+
+/*
+ * Description :
+ * Return the DIGEST_TAG_SIZE bytes digest of a_pin in a table of a_salt, as the
+ * CONTROL_ECU looks it up.
+ */
+void CREDC_digest(const unsigned char * a_salt, const std::string & a_pin, unsigned char * a_digest);
+
+#endif /* CREDENTIAL_COMPILER_H_ */
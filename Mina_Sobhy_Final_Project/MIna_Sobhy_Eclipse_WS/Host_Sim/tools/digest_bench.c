@@ -0,0 +1,385 @@
+/*
+ * digest_bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: correctness, cycles and timing of the password digest of
+ *      			 Control_ECU/digest.c
+ *
+ *      usage: digest_bench [pins]
+ *
+ *      The 64 reference vectors of SipHash-2-4 (key 00..0f, messages 00..3e of 0
+ *      to 63 bytes) are checked with DIGEST_calculate and with the bytes added
+ *      one by one.
+ *
+ *      The AVR cycles of a check (the digest of the password and DIGEST_equal)
+ *      are printed for every password size from the cycle model of
+ *      digest_model.cpp, the check of a POLICY_PASS_MAX_SIZE password must stay
+ *      under DIGEST_BENCH_BUDGET_CYCLES. The cycles of a SipRound must be the
+ *      DIGEST_ROUND_CYCLES charged by the host simulation.
+ *
+ *      The timing of a check must not depend on the password: for every size
+ *      of the policy, the host instructions of a check of random passwords (20
+ *      by default) and of the passwords which differ from the stored one in the
+ *      first or in the last byte are counted by single-stepping a child process
+ *      with ptrace, and they must all be the same. The test is skipped (exit
+ *      code 77) when ptrace isn't allowed.
+ */
+
+#include "digest.h"
+#include "digest_model.h"
+#include "policy.h"
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ptrace.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define DIGEST_BENCH_VECTORS		64
+#define DIGEST_BENCH_PINS			20
+#define DIGEST_BENCH_F_CPU			8000000UL	/* F_CPU of the CONTROL_ECU */
+#define DIGEST_BENCH_BUDGET_CYCLES	12000UL		/* 1.5ms at 8 MHz */
+#define DIGEST_BENCH_SKIP			77
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* SipHash-2-4 of the messages 00 01 02 .. of 0 to 63 bytes with the key 00..0f */
+static const unsigned char g_vectors[DIGEST_BENCH_VECTORS][DIGEST_TAG_SIZE] = {
+	{ 0x31, 0x0e, 0x0e, 0xdd, 0x47, 0xdb, 0x6f, 0x72 },
+	{ 0xfd, 0x67, 0xdc, 0x93, 0xc5, 0x39, 0xf8, 0x74 },
+	{ 0x5a, 0x4f, 0xa9, 0xd9, 0x09, 0x80, 0x6c, 0x0d },
+	{ 0x2d, 0x7e, 0xfb, 0xd7, 0x96, 0x66, 0x67, 0x85 },
+	{ 0xb7, 0x87, 0x71, 0x27, 0xe0, 0x94, 0x27, 0xcf },
+	{ 0x8d, 0xa6, 0x99, 0xcd, 0x64, 0x55, 0x76, 0x18 },
+	{ 0xce, 0xe3, 0xfe, 0x58, 0x6e, 0x46, 0xc9, 0xcb },
+	{ 0x37, 0xd1, 0x01, 0x8b, 0xf5, 0x00, 0x02, 0xab },
+	{ 0x62, 0x24, 0x93, 0x9a, 0x79, 0xf5, 0xf5, 0x93 },
+	{ 0xb0, 0xe4, 0xa9, 0x0b, 0xdf, 0x82, 0x00, 0x9e },
+	{ 0xf3, 0xb9, 0xdd, 0x94, 0xc5, 0xbb, 0x5d, 0x7a },
+	{ 0xa7, 0xad, 0x6b, 0x22, 0x46, 0x2f, 0xb3, 0xf4 },
+	{ 0xfb, 0xe5, 0x0e, 0x86, 0xbc, 0x8f, 0x1e, 0x75 },
+	{ 0x90, 0x3d, 0x84, 0xc0, 0x27, 0x56, 0xea, 0x14 },
+	{ 0xee, 0xf2, 0x7a, 0x8e, 0x90, 0xca, 0x23, 0xf7 },
+	{ 0xe5, 0x45, 0xbe, 0x49, 0x61, 0xca, 0x29, 0xa1 },
+	{ 0xdb, 0x9b, 0xc2, 0x57, 0x7f, 0xcc, 0x2a, 0x3f },
+	{ 0x94, 0x47, 0xbe, 0x2c, 0xf5, 0xe9, 0x9a, 0x69 },
+	{ 0x9c, 0xd3, 0x8d, 0x96, 0xf0, 0xb3, 0xc1, 0x4b },
+	{ 0xbd, 0x61, 0x79, 0xa7, 0x1d, 0xc9, 0x6d, 0xbb },
+	{ 0x98, 0xee, 0xa2, 0x1a, 0xf2, 0x5c, 0xd6, 0xbe },
+	{ 0xc7, 0x67, 0x3b, 0x2e, 0xb0, 0xcb, 0xf2, 0xd0 },
+	{ 0x88, 0x3e, 0xa3, 0xe3, 0x95, 0x67, 0x53, 0x93 },
+	{ 0xc8, 0xce, 0x5c, 0xcd, 0x8c, 0x03, 0x0c, 0xa8 },
+	{ 0x94, 0xaf, 0x49, 0xf6, 0xc6, 0x50, 0xad, 0xb8 },
+	{ 0xea, 0xb8, 0x85, 0x8a, 0xde, 0x92, 0xe1, 0xbc },
+	{ 0xf3, 0x15, 0xbb, 0x5b, 0xb8, 0x35, 0xd8, 0x17 },
+	{ 0xad, 0xcf, 0x6b, 0x07, 0x63, 0x61, 0x2e, 0x2f },
+	{ 0xa5, 0xc9, 0x1d, 0xa7, 0xac, 0xaa, 0x4d, 0xde },
+	{ 0x71, 0x65, 0x95, 0x87, 0x66, 0x50, 0xa2, 0xa6 },
+	{ 0x28, 0xef, 0x49, 0x5c, 0x53, 0xa3, 0x87, 0xad },
+	{ 0x42, 0xc3, 0x41, 0xd8, 0xfa, 0x92, 0xd8, 0x32 },
+	{ 0xce, 0x7c, 0xf2, 0x72, 0x2f, 0x51, 0x27, 0x71 },
+	{ 0xe3, 0x78, 0x59, 0xf9, 0x46, 0x23, 0xf3, 0xa7 },
+	{ 0x38, 0x12, 0x05, 0xbb, 0x1a, 0xb0, 0xe0, 0x12 },
+	{ 0xae, 0x97, 0xa1, 0x0f, 0xd4, 0x34, 0xe0, 0x15 },
+	{ 0xb4, 0xa3, 0x15, 0x08, 0xbe, 0xff, 0x4d, 0x31 },
+	{ 0x81, 0x39, 0x62, 0x29, 0xf0, 0x90, 0x79, 0x02 },
+	{ 0x4d, 0x0c, 0xf4, 0x9e, 0xe5, 0xd4, 0xdc, 0xca },
+	{ 0x5c, 0x73, 0x33, 0x6a, 0x76, 0xd8, 0xbf, 0x9a },
+	{ 0xd0, 0xa7, 0x04, 0x53, 0x6b, 0xa9, 0x3e, 0x0e },
+	{ 0x92, 0x59, 0x58, 0xfc, 0xd6, 0x42, 0x0c, 0xad },
+	{ 0xa9, 0x15, 0xc2, 0x9b, 0xc8, 0x06, 0x73, 0x18 },
+	{ 0x95, 0x2b, 0x79, 0xf3, 0xbc, 0x0a, 0xa6, 0xd4 },
+	{ 0xf2, 0x1d, 0xf2, 0xe4, 0x1d, 0x45, 0x35, 0xf9 },
+	{ 0x87, 0x57, 0x75, 0x19, 0x04, 0x8f, 0x53, 0xa9 },
+	{ 0x10, 0xa5, 0x6c, 0xf5, 0xdf, 0xcd, 0x9a, 0xdb },
+	{ 0xeb, 0x75, 0x09, 0x5c, 0xcd, 0x98, 0x6c, 0xd0 },
+	{ 0x51, 0xa9, 0xcb, 0x9e, 0xcb, 0xa3, 0x12, 0xe6 },
+	{ 0x96, 0xaf, 0xad, 0xfc, 0x2c, 0xe6, 0x66, 0xc7 },
+	{ 0x72, 0xfe, 0x52, 0x97, 0x5a, 0x43, 0x64, 0xee },
+	{ 0x5a, 0x16, 0x45, 0xb2, 0x76, 0xd5, 0x92, 0xa1 },
+	{ 0xb2, 0x74, 0xcb, 0x8e, 0xbf, 0x87, 0x87, 0x0a },
+	{ 0x6f, 0x9b, 0xb4, 0x20, 0x3d, 0xe7, 0xb3, 0x81 },
+	{ 0xea, 0xec, 0xb2, 0xa3, 0x0b, 0x22, 0xa8, 0x7f },
+	{ 0x99, 0x24, 0xa4, 0x3c, 0xc1, 0x31, 0x57, 0x24 },
+	{ 0xbd, 0x83, 0x8d, 0x3a, 0xaf, 0xbf, 0x8d, 0xb7 },
+	{ 0x0b, 0x1a, 0x2a, 0x32, 0x65, 0xd5, 0x1a, 0xea },
+	{ 0x13, 0x50, 0x79, 0xa3, 0x23, 0x1c, 0xe6, 0x60 },
+	{ 0x93, 0x2b, 0x28, 0x46, 0xe4, 0xd7, 0x06, 0x66 },
+	{ 0xe1, 0x91, 0x5f, 0x5c, 0xb1, 0xec, 0xa4, 0x6c },
+	{ 0xf3, 0x25, 0x96, 0x5c, 0xa1, 0x6d, 0x62, 0x9f },
+	{ 0x57, 0x5f, 0xf2, 0x8e, 0x60, 0x38, 0x1b, 0xe5 },
+	{ 0x72, 0x45, 0x06, 0xeb, 0x4c, 0x32, 0x8a, 0x95 },
+};
+
+/* salt and digest of the stored password of the timing test */
+static unsigned char g_salt[DIGEST_SALT_SIZE];
+static unsigned char g_stored[DIGEST_TAG_SIZE];
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+static void BENCH_print(const unsigned char * a_data, unsigned char a_size)
+{
+	unsigned char i;
+
+	for (i = 0; i < a_size; i++)
+	{
+		printf("%02x", a_data[i]);
+	}
+}
+
+/* Description:
+ * check the reference vectors, return the number of failures
+ */
+static int BENCH_vectors(void)
+{
+	DIGEST_StateType state;
+	unsigned char key[DIGEST_SALT_SIZE];
+	unsigned char message[DIGEST_BENCH_VECTORS];
+	unsigned char tag[DIGEST_TAG_SIZE];
+	unsigned char streamed[DIGEST_TAG_SIZE];
+	int failed = 0;
+	unsigned char i;
+
+	for (i = 0; i < DIGEST_SALT_SIZE; i++)
+	{
+		key[i] = i;
+	}
+	for (i = 0; i < DIGEST_BENCH_VECTORS; i++)
+	{
+		message[i] = i;
+	}
+
+	for (i = 0; i < DIGEST_BENCH_VECTORS; i++)
+	{
+		DIGEST_calculate(key, message, i, tag);
+
+		DIGEST_init(&state, key);
+		memset(state.block, 0xA5, sizeof(state.block));
+		for (unsigned char j = 0; j < i; j++)
+		{
+			DIGEST_update(&state, message[j]);
+		}
+		DIGEST_final(&state, streamed);
+
+		if (memcmp(tag, g_vectors[i], DIGEST_TAG_SIZE) != 0
+			|| memcmp(streamed, g_vectors[i], DIGEST_TAG_SIZE) != 0)
+		{
+			printf("FAIL vector %u: ", i);
+			BENCH_print(tag, DIGEST_TAG_SIZE);
+			printf(" streamed ");
+			BENCH_print(streamed, DIGEST_TAG_SIZE);
+			printf(" expected ");
+			BENCH_print(g_vectors[i], DIGEST_TAG_SIZE);
+			printf("\n");
+			failed++;
+		}
+	}
+	printf("vectors: %d of %d right\n", DIGEST_BENCH_VECTORS - failed, DIGEST_BENCH_VECTORS);
+
+	if (!DIGEST_equal(g_vectors[1], g_vectors[1], DIGEST_TAG_SIZE)
+		|| DIGEST_equal(g_vectors[1], g_vectors[2], DIGEST_TAG_SIZE))
+	{
+		printf("FAIL DIGEST_equal\n");
+		failed++;
+	}
+
+	return failed;
+}
+
+/* Description:
+ * print the modelled cycles of a check for every size, return 1 if the check
+ * of the longest password is over the budget
+ */
+static int BENCH_cycles(void)
+{
+	unsigned long cycles;
+	unsigned char size;
+
+	printf("cycle model: %lu cycles a SipRound\n", DIGEST_MODEL_roundCycles());
+	if (DIGEST_MODEL_roundCycles() != DIGEST_ROUND_CYCLES)
+	{
+		printf("FAIL DIGEST_ROUND_CYCLES is %u, the model gives %lu\n",
+			DIGEST_ROUND_CYCLES, DIGEST_MODEL_roundCycles());
+		return 1;
+	}
+	for (size = 0; size <= POLICY_PASS_MAX_SIZE; size++)
+	{
+		cycles = DIGEST_MODEL_calculateCycles(size);
+		printf("size %2u: %6lu cycles, %5lu us at %lu MHz, %6lu cycles after the last byte\n",
+			size, cycles, (cycles * 1000UL) / (DIGEST_BENCH_F_CPU / 1000UL),
+			DIGEST_BENCH_F_CPU / 1000000UL, DIGEST_MODEL_finalCycles(size));
+	}
+
+	cycles = DIGEST_MODEL_calculateCycles(POLICY_PASS_MAX_SIZE);
+	if (cycles > DIGEST_BENCH_BUDGET_CYCLES)
+	{
+		printf("FAIL check of %u characters: %lu cycles, budget %lu\n",
+			POLICY_PASS_MAX_SIZE, cycles, DIGEST_BENCH_BUDGET_CYCLES);
+		return 1;
+	}
+	return 0;
+}
+
+/* Description:
+ * the check of the timing test, between the two stops of the child
+ */
+static void BENCH_check(const unsigned char * a_pin, unsigned char a_size)
+{
+	unsigned char tag[DIGEST_TAG_SIZE];
+	static volatile unsigned char g_result;
+
+	raise(SIGSTOP);
+	DIGEST_calculate(g_salt, a_pin, a_size, tag);
+	g_result = DIGEST_equal(tag, g_stored, DIGEST_TAG_SIZE);
+	raise(SIGSTOP);
+	_exit(g_result);
+}
+
+/* Description:
+ * host instructions of the check of a_pin, 0 if ptrace isn't allowed
+ */
+static unsigned long BENCH_instructions(const unsigned char * a_pin, unsigned char a_size)
+{
+	unsigned long steps = 0;
+	pid_t child;
+	int status;
+
+	fflush(stdout);
+	child = fork();
+	if (child == 0)
+	{
+		if (ptrace(PTRACE_TRACEME, 0, NULL, NULL) != 0)
+		{
+			_exit(DIGEST_BENCH_SKIP);
+		}
+		BENCH_check(a_pin, a_size);
+	}
+
+	/* the first stop is before the check, the second one after it */
+	waitpid(child, &status, 0);
+	if (!WIFSTOPPED(status))
+	{
+		return 0;
+	}
+	for (;;)
+	{
+		if (ptrace(PTRACE_SINGLESTEP, child, NULL, NULL) != 0)
+		{
+			kill(child, SIGKILL);
+			waitpid(child, &status, 0);
+			return 0;
+		}
+		waitpid(child, &status, 0);
+		if (!WIFSTOPPED(status) || (WSTOPSIG(status) == SIGSTOP))
+		{
+			break;
+		}
+		steps++;
+	}
+
+	kill(child, SIGKILL);
+	waitpid(child, &status, 0);
+	return steps;
+}
+
+/* Description:
+ * compare the instructions of the checks of every size, return 1 if they
+ * differ, DIGEST_BENCH_SKIP if ptrace isn't allowed
+ */
+static int BENCH_timing(int a_pins)
+{
+	unsigned char pin[POLICY_PASS_MAX_SIZE];
+	unsigned char stored[POLICY_PASS_MAX_SIZE];
+	unsigned long first;
+	unsigned long steps;
+	unsigned char size;
+	int failed = 0;
+	int i;
+	int j;
+
+	for (i = 0; i < DIGEST_SALT_SIZE; i++)
+	{
+		g_salt[i] = (unsigned char)rand();
+	}
+
+	for (size = POLICY_PASS_MIN_SIZE; size <= POLICY_PASS_MAX_SIZE; size++)
+	{
+		for (i = 0; i < size; i++)
+		{
+			stored[i] = (unsigned char)('0' + (rand() % 10));
+		}
+		DIGEST_calculate(g_salt, stored, size, g_stored);
+
+		/* the stored password, one wrong in the first then in the last byte */
+		first = BENCH_instructions(stored, size);
+		if (first == 0)
+		{
+			printf("timing: ptrace not allowed, skipped\n");
+			return DIGEST_BENCH_SKIP;
+		}
+		for (i = -2; i < a_pins; i++)
+		{
+			memcpy(pin, stored, size);
+			if (i == -2)
+			{
+				pin[0] ^= 1;
+			}
+			else if (i == -1)
+			{
+				pin[size - 1] ^= 1;
+			}
+			else
+			{
+				for (j = 0; j < size; j++)
+				{
+					pin[j] = (unsigned char)('0' + (rand() % 10));
+				}
+			}
+
+			steps = BENCH_instructions(pin, size);
+			if (steps != first)
+			{
+				printf("FAIL size %u: %lu instructions for one password, %lu for the stored one\n",
+					size, steps, first);
+				failed = 1;
+			}
+		}
+		printf("size %2u: %lu host instructions for all the %d passwords\n", size, first, a_pins + 3);
+	}
+
+	return failed;
+}
+
+int main(int argc, char * argv[])
+{
+	int pins = (argc > 1) ? atoi(argv[1]) : DIGEST_BENCH_PINS;
+	int failed = 0;
+	int timing;
+
+	if (pins < 0)
+	{
+		fprintf(stderr, "usage: %s [pins]\n", argv[0]);
+		return 2;
+	}
+	srand(1);
+
+	failed |= BENCH_vectors() != 0;
+	failed |= BENCH_cycles();
+
+	timing = BENCH_timing(pins);
+	if (failed)
+	{
+		return 1;
+	}
+	return (timing == DIGEST_BENCH_SKIP) ? DIGEST_BENCH_SKIP : timing;
+}
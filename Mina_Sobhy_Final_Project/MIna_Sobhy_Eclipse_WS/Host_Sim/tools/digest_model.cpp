@@ -0,0 +1,141 @@
+/*
+ * digest_model.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: AVR cycle model of Control_ECU/digest.c for the host
+ */
+
+#include "digest_model.h"
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* cycles of avr-gcc -Os for the operations on a uint64 held in 8 registers:
+ * an add, xor or or is 8 instructions on the register pairs plus the moves of
+ * the operands between the registers and the stack frame, the shifts call
+ * __ashldi3 and __lshrdi3 of libgcc which move the whole bytes then shift the
+ * 8 registers one bit per loop (lsl, 7 rol, dec, brne)
+ */
+#define DIGEST_MODEL_OP_CYCLES		24
+#define DIGEST_MODEL_CALL_CYCLES	20
+#define DIGEST_MODEL_BYTE_CYCLES	8
+#define DIGEST_MODEL_BIT_CYCLES		11
+
+namespace avr_model
+{
+
+static unsigned long g_cycles = 0;
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/* uint64 of digest.c, every operation adds its cycles to g_cycles */
+class Word64
+{
+public:
+	Word64(unsigned long long a_value = 0) : m_value(a_value) {}
+
+	explicit operator unsigned char() const
+	{
+		return (unsigned char)m_value;
+	}
+
+	friend Word64 operator+(Word64 a_first, Word64 a_second)
+	{
+		g_cycles += DIGEST_MODEL_OP_CYCLES;
+		return Word64(a_first.m_value + a_second.m_value);
+	}
+
+	friend Word64 operator^(Word64 a_first, Word64 a_second)
+	{
+		g_cycles += DIGEST_MODEL_OP_CYCLES;
+		return Word64(a_first.m_value ^ a_second.m_value);
+	}
+
+	friend Word64 operator|(Word64 a_first, Word64 a_second)
+	{
+		g_cycles += DIGEST_MODEL_OP_CYCLES;
+		return Word64(a_first.m_value | a_second.m_value);
+	}
+
+	friend Word64 operator<<(Word64 a_word, int a_bits)
+	{
+		g_cycles += Word64::shiftCycles(a_bits);
+		return Word64(a_word.m_value << a_bits);
+	}
+
+	friend Word64 operator>>(Word64 a_word, int a_bits)
+	{
+		g_cycles += Word64::shiftCycles(a_bits);
+		return Word64(a_word.m_value >> a_bits);
+	}
+
+	Word64 & operator+=(Word64 a_other) { return *this = *this + a_other; }
+	Word64 & operator^=(Word64 a_other) { return *this = *this ^ a_other; }
+	Word64 & operator>>=(int a_bits) { return *this = *this >> a_bits; }
+
+private:
+	static unsigned long shiftCycles(int a_bits)
+	{
+		return DIGEST_MODEL_CALL_CYCLES + ((a_bits / 8) * DIGEST_MODEL_BYTE_CYCLES)
+			+ ((a_bits % 8) * DIGEST_MODEL_BIT_CYCLES);
+	}
+
+	unsigned long long m_value;
+};
+
+}
+
+/* digest.c unchanged with the model words, its functions are in avr_model */
+#define uint64 avr_model::Word64
+namespace avr_model
+{
+#include "digest.c"
+}
+#undef uint64
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+unsigned long DIGEST_MODEL_roundCycles(void)
+{
+	avr_model::DIGEST_StateType state;
+
+	avr_model::g_cycles = 0;
+	avr_model::DIGEST_rounds(&state, 1);
+	return avr_model::g_cycles;
+}
+
+unsigned long DIGEST_MODEL_calculateCycles(unsigned char a_size)
+{
+	uint8 salt[DIGEST_SALT_SIZE] = {0};
+	uint8 data[256] = {0};
+	uint8 tag[DIGEST_TAG_SIZE];
+
+	avr_model::g_cycles = 0;
+	avr_model::DIGEST_calculate(salt, data, a_size, tag);
+	return avr_model::g_cycles;
+}
+
+unsigned long DIGEST_MODEL_finalCycles(unsigned char a_size)
+{
+	avr_model::DIGEST_StateType state;
+	uint8 salt[DIGEST_SALT_SIZE] = {0};
+	uint8 tag[DIGEST_TAG_SIZE];
+	uint8 i;
+
+	avr_model::DIGEST_init(&state, salt);
+	for (i = 0; i < a_size; i++)
+	{
+		avr_model::DIGEST_update(&state, i);
+	}
+
+	avr_model::g_cycles = 0;
+	avr_model::DIGEST_final(&state, tag);
+	return avr_model::g_cycles;
+}
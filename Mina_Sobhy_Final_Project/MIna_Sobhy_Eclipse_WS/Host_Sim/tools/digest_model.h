@@ -0,0 +1,36 @@
+/*
+ * digest_model.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: AVR cycle model of Control_ECU/digest.c for the host
+ *
+ *      digest.c is compiled once more for the host with its 64-bit words replaced
+ *      by a type which adds the cycles avr-gcc spends on every operation. It is a
+ *      model of the generated code, not a measurement: the loops on bytes and the
+ *      calls are left out and only the 64-bit arithmetic is counted, which is
+ *      nearly all the time of SipHash on the 8-bit CPU.
+ */
+
+#ifndef DIGEST_MODEL_H_
+#define DIGEST_MODEL_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* modelled cycles of one SipRound */
+unsigned long DIGEST_MODEL_roundCycles(void);
+
+/* modelled cycles of DIGEST_calculate over a_size bytes */
+unsigned long DIGEST_MODEL_calculateCycles(unsigned char a_size);
+
+/* modelled cycles of DIGEST_final after a_size bytes */
+unsigned long DIGEST_MODEL_finalCycles(unsigned char a_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DIGEST_MODEL_H_ */
@@ -0,0 +1,1502 @@
+/*
+ * door_gateway.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: gateway daemon of many CONTROL_ECUs on serial lines, their
+ *      			 status, audit records and remote unlock on a Unix socket
+ *
+ *      usage: door_gateway [-s socket] [-w workers] [-p status_ms] [-a audit_ms] device...
+ *             door_gateway -l doors [-t seconds] [-r commands_per_s] [-e event_ms]
+ *                          [-w workers] [-p status_ms] [-a audit_ms]
+ *
+ *      Every device is the UART of one CONTROL_ECU at UART_BAUD_DEFAULT, the
+ *      gateway is its HMI_ECU (remote_link.h). The doors are shared by the
+ *      worker threads, each one waits on its own epoll for the lines of its
+ *      doors, the commands for them and a tick of GATEWAY_TICK_MS for the
+ *      timeouts. The bytes are read into the Rx buffer of the link and parsed
+ *      there. Every door is asked for its performance counters every status_ms
+ *      and for its audit log every audit_ms, the new records are added to one
+ *      ring of GATEWAY_EVENTS events numbered from 0.
+ *
+ *      The API thread serves the socket, one command per line and one command
+ *      at a time per client, every reply ends with a line "ok ..." or "error ...":
+ *      - doors                 : ok doors=N online=N ready=N events=N, ready doors
+ *                                have their first audit export
+ *      - status <door>         : ok door=N device=... state=... with the counters
+ *      - events <seq> [max]    : one line "event <seq> <door> <time> <event> <user> <result>"
+ *                                per event from seq (audit_log.h values), then ok next=<seq>
+ *      - unlock <door> <pass>  : ok matched, error unmatched|lockout|schedule|locked <s>|...
+ *      - setpass <door> <pass> : first password of a CONTROL_ECU without one
+ *
+ *      The load test (-l) opens a pty pair for every door, a model of the
+ *      CONTROL_ECU (door_model.h) runs on the master side in GATEWAY_MODEL_THREADS
+ *      threads and the gateway opens the slave side as it opens a real device.
+ *      Clients on the socket unlock the doors in turn at commands_per_s and read
+ *      the events as they come. Printed: time to bring all the doors online,
+ *      events per second delivered to the client, polls, and the command latency
+ *      from the request line to the reply line (p50, p99, longest).
+ */
+
+#include "remote_link.h"
+#include "door_model.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define GATEWAY_SOCKET			"/tmp/door_gateway.sock"
+#define GATEWAY_WORKERS			4
+#define GATEWAY_STATUS_MS		5000
+#define GATEWAY_AUDIT_MS		1000
+#define GATEWAY_TICK_MS			10
+
+/* ring of the audit records of all the doors */
+#define GATEWAY_EVENTS			65536
+#define GATEWAY_EVENTS_MAX		256		/* events of one reply */
+
+/* a command waiting for its door longer than this fails */
+#define GATEWAY_COMMAND_MS		60000
+
+#define GATEWAY_CLIENTS			64
+#define GATEWAY_LINE_MAX		128
+#define GATEWAY_CLIENT_TX		(GATEWAY_EVENTS_MAX * 64 + 256)
+
+/* load test */
+#define GATEWAY_MODEL_THREADS	4
+#define GATEWAY_LOAD_CLIENTS	8
+#define GATEWAY_LOAD_SECONDS	10.0
+#define GATEWAY_LOAD_RATE		200.0
+#define GATEWAY_LOAD_EVENT_MS	1000
+#define GATEWAY_LOAD_PASS		"1234"
+#define GATEWAY_LOAD_SYNC_MS	10000
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef struct GATEWAY_Command
+{
+	struct GATEWAY_Command *	next	;
+	REMOTE_OpType				op		;
+	unsigned int				door	;
+	char						pass[POLICY_PASS_MAX_SIZE + 1];
+	unsigned long				queued	; /* ms */
+	/* client which sent it */
+	unsigned int				client	;
+	unsigned long				serial	;
+	/* reply line without its end */
+	char						reply[48];
+} GATEWAY_CommandType;
+
+typedef struct
+{
+	REMOTE_LinkType			link	;
+	int						fd		;
+	char					device[64];
+	unsigned long			nextStatus; /* ms */
+	unsigned long			nextAudit;
+	GATEWAY_CommandType *	head	; /* commands waiting for the door */
+	GATEWAY_CommandType *	tail	;
+	GATEWAY_CommandType *	current	;
+	unsigned long			events	;
+} GATEWAY_DoorType;
+
+typedef struct
+{
+	pthread_t				thread	;
+	int						epoll	;
+	int						wake	; /* eventfd of the new commands */
+	/* the links are changed and read with it taken */
+	pthread_mutex_t			lock	;
+	GATEWAY_CommandType *	inbox	;
+	unsigned int			first	;
+	unsigned int			count	;
+	DECODE_RecordType		records[LOG_CAPACITY];
+} GATEWAY_WorkerType;
+
+typedef struct
+{
+	unsigned long		seq		;
+	unsigned int		door	;
+	DECODE_RecordType	record	;
+} GATEWAY_EventType;
+
+typedef struct
+{
+	int				fd		;
+	unsigned long	serial	; /* 0 for a free slot */
+	int				waiting	; /* a command is with a worker */
+	unsigned int	mask	; /* epoll events asked for */
+	unsigned int	rxSize	;
+	char			rx[GATEWAY_LINE_MAX];
+	unsigned int	txSize	;
+	unsigned int	txNext	;
+	char			tx[GATEWAY_CLIENT_TX];
+} GATEWAY_ClientType;
+
+/* one client of the load test */
+typedef struct
+{
+	pthread_t		thread	;
+	unsigned int	index	;
+	double *		latency	; /* ms */
+	unsigned long	count	;
+	unsigned long	size	;
+	unsigned long	failed	;
+	char			error[GATEWAY_LINE_MAX + 32];
+} GATEWAY_LoadClientType;
+
+typedef struct
+{
+	pthread_t			thread	;
+	MODEL_DoorType *	doors	;
+	unsigned int		count	;
+	int					epoll	;
+} GATEWAY_ModelThreadType;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static unsigned long GATEWAY_now(void);
+static double GATEWAY_seconds(void);
+static void GATEWAY_signal(int a_signal);
+static int GATEWAY_openDevice(GATEWAY_DoorType * a_door, const char * a_device);
+static void GATEWAY_publish(unsigned int a_door, const DECODE_RecordType * a_records, unsigned long a_count);
+static void GATEWAY_reply(GATEWAY_CommandType * a_command);
+static void GATEWAY_commandDone(GATEWAY_DoorType * a_door, const REMOTE_LinkType * a_link);
+static void GATEWAY_done(GATEWAY_WorkerType * a_worker, GATEWAY_DoorType * a_door, REMOTE_OpType a_op,
+	unsigned long a_now);
+static void GATEWAY_schedule(GATEWAY_DoorType * a_door, unsigned long a_now);
+static void GATEWAY_write(GATEWAY_DoorType * a_door);
+static void GATEWAY_read(GATEWAY_WorkerType * a_worker, GATEWAY_DoorType * a_door, unsigned long a_now);
+static void * GATEWAY_worker(void * a_arg);
+static void GATEWAY_post(GATEWAY_CommandType * a_command);
+static void GATEWAY_clientSend(GATEWAY_ClientType * a_client, const char * a_format, ...)
+	__attribute__((format(printf, 2, 3)));
+static void GATEWAY_clientFlush(GATEWAY_ClientType * a_client);
+static void GATEWAY_status(GATEWAY_ClientType * a_client, unsigned int a_door);
+static void GATEWAY_doors(GATEWAY_ClientType * a_client);
+static void GATEWAY_events(GATEWAY_ClientType * a_client, unsigned long a_seq, unsigned long a_max);
+static void GATEWAY_line(unsigned int a_index, char * a_line);
+static void GATEWAY_clientInput(unsigned int a_index);
+static void GATEWAY_clientClose(unsigned int a_index);
+static void * GATEWAY_api(void * a_arg);
+static int GATEWAY_start(char * const * a_devices, unsigned int a_count, const char * a_socket);
+static void GATEWAY_stop(void);
+static void * GATEWAY_modelThread(void * a_arg);
+static FILE * GATEWAY_connect(const char * a_socket, FILE ** a_out);
+static void * GATEWAY_loadCommands(void * a_arg);
+static void * GATEWAY_loadEvents(void * a_arg);
+static int GATEWAY_compare(const void * a_first, const void * a_second);
+static int GATEWAY_load(unsigned int a_doors);
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static GATEWAY_DoorType * g_doors;
+static unsigned int g_doorCount;
+static GATEWAY_WorkerType * g_workers;
+static unsigned int g_workerCount = GATEWAY_WORKERS;
+static unsigned long g_statusMs = GATEWAY_STATUS_MS;
+static unsigned long g_auditMs = GATEWAY_AUDIT_MS;
+static volatile sig_atomic_t g_stop = 0;
+
+static GATEWAY_EventType * g_events;
+static unsigned long g_eventSeq = 0;
+static pthread_mutex_t g_eventLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* API thread */
+static pthread_t g_apiThread;
+static int g_apiEpoll = -1;
+static int g_apiListen = -1;
+static int g_apiWake = -1; /* eventfd of the command replies */
+static GATEWAY_CommandType * g_replies;
+static pthread_mutex_t g_replyLock = PTHREAD_MUTEX_INITIALIZER;
+static GATEWAY_ClientType g_clients[GATEWAY_CLIENTS];
+static unsigned long g_clientSerial = 0;
+
+/* load test */
+static char g_loadSocket[64];
+static double g_loadSeconds = GATEWAY_LOAD_SECONDS;
+static double g_loadRate = GATEWAY_LOAD_RATE;
+static unsigned long g_loadEventMs = GATEWAY_LOAD_EVENT_MS;
+static double g_loadStart;
+static double g_loadEnd;
+static unsigned long g_loadNext = 0;
+static pthread_mutex_t g_loadLock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned long g_loadEvents = 0;
+static volatile int g_modelStop = 0;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+static unsigned long GATEWAY_now(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (unsigned long)now.tv_sec * 1000UL + (unsigned long)(now.tv_nsec / 1000000L);
+}
+
+static double GATEWAY_seconds(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + ((double)now.tv_nsec * 1e-9);
+}
+
+static void GATEWAY_signal(int a_signal)
+{
+	(void)a_signal;
+	g_stop = 1;
+}
+
+/* Description:
+ * open a serial device raw and non-blocking at UART_BAUD_DEFAULT
+ */
+static int GATEWAY_openDevice(GATEWAY_DoorType * a_door, const char * a_device)
+{
+	struct termios tty;
+
+	a_door->fd = open(a_device, O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if (a_door->fd < 0)
+	{
+		perror(a_device);
+		return 0;
+	}
+	snprintf(a_door->device, sizeof(a_door->device), "%s", a_device);
+
+	if (tcgetattr(a_door->fd, &tty) == 0)
+	{
+		cfmakeraw(&tty);
+		cfsetispeed(&tty, B9600);
+		cfsetospeed(&tty, B9600);
+		tty.c_cflag |= CLOCAL | CREAD;
+		tty.c_cc[VMIN] = 0;
+		tty.c_cc[VTIME] = 0;
+		tcsetattr(a_door->fd, TCSANOW, &tty);
+		tcflush(a_door->fd, TCIOFLUSH);
+	}
+	return 1;
+}
+
+/* Description:
+ * add the new audit records of a door to the ring of events
+ */
+static void GATEWAY_publish(unsigned int a_door, const DECODE_RecordType * a_records, unsigned long a_count)
+{
+	GATEWAY_EventType * event;
+	unsigned long i;
+
+	pthread_mutex_lock(&g_eventLock);
+	for (i = 0; i < a_count; i++)
+	{
+		event = &g_events[g_eventSeq % GATEWAY_EVENTS];
+		event->seq = g_eventSeq++;
+		event->door = a_door;
+		event->record = a_records[i];
+	}
+	pthread_mutex_unlock(&g_eventLock);
+}
+
+/* Description:
+ * hand a command back to the API thread with its reply
+ */
+static void GATEWAY_reply(GATEWAY_CommandType * a_command)
+{
+	uint64_t one = 1;
+
+	pthread_mutex_lock(&g_replyLock);
+	a_command->next = g_replies;
+	g_replies = a_command;
+	pthread_mutex_unlock(&g_replyLock);
+
+	if (write(g_apiWake, &one, sizeof(one)) < 0)
+	{
+		/* the counter is already set */
+	}
+}
+
+/* Description:
+ * reply to the command of the door with the result of the link
+ */
+static void GATEWAY_commandDone(GATEWAY_DoorType * a_door, const REMOTE_LinkType * a_link)
+{
+	GATEWAY_CommandType * command = a_door->current;
+
+	a_door->current = NULL;
+	switch (a_link->result)
+	{
+	case REMOTE_MATCHED:
+		strcpy(command->reply, (command->op == REMOTE_OP_SETPASS) ? "ok stored" : "ok matched");
+		break;
+	case REMOTE_UNMATCHED:
+		strcpy(command->reply, "error unmatched");
+		break;
+	case REMOTE_LOCKOUT:
+		strcpy(command->reply, "error lockout");
+		break;
+	case REMOTE_SCHEDULE:
+		strcpy(command->reply, "error schedule");
+		break;
+	case REMOTE_LOCKED_OUT:
+		snprintf(command->reply, sizeof(command->reply), "error locked %u", a_link->locked);
+		break;
+	default:
+		strcpy(command->reply, "error failed");
+		break;
+	}
+	GATEWAY_reply(command);
+}
+
+/* Description:
+ * take the end of an operation of the link of a_door
+ */
+static void GATEWAY_done(GATEWAY_WorkerType * a_worker, GATEWAY_DoorType * a_door, REMOTE_OpType a_op,
+	unsigned long a_now)
+{
+	REMOTE_LinkType * link = &a_door->link;
+
+	switch (a_op)
+	{
+	case REMOTE_OP_DIAG:
+		a_door->nextStatus = a_now + g_statusMs;
+		break;
+	case REMOTE_OP_EXPORT:
+		a_door->nextAudit = a_now + g_auditMs;
+		if ((link->result == REMOTE_DONE) && (link->freshCount != 0))
+		{
+			GATEWAY_publish((unsigned int)(a_door - g_doors), &a_worker->records[link->fresh], link->freshCount);
+			a_door->events += link->freshCount;
+		}
+		break;
+	case REMOTE_OP_UNLOCK:
+	case REMOTE_OP_SETPASS:
+		if (a_door->current != NULL)
+		{
+			GATEWAY_commandDone(a_door, link);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/* Description:
+ * start the next operation of a door, the commands before the polls
+ */
+static void GATEWAY_schedule(GATEWAY_DoorType * a_door, unsigned long a_now)
+{
+	REMOTE_LinkType * link = &a_door->link;
+	GATEWAY_CommandType * command = a_door->head;
+
+	if ((a_door->current == NULL) && (command != NULL))
+	{
+		if (REMOTE_start(link, command->op, command->pass, a_now))
+		{
+			a_door->head = command->next;
+			a_door->current = command;
+			return;
+		}
+
+		/* the commands which can't start on this door fail at once */
+		if (!link->online || (a_now - command->queued > GATEWAY_COMMAND_MS) ||
+			((command->op == REMOTE_OP_UNLOCK) && (link->state == REMOTE_EMPTY)) ||
+			((command->op == REMOTE_OP_SETPASS) && (link->state != REMOTE_EMPTY) && (link->op == REMOTE_OP_NONE)))
+		{
+			a_door->head = command->next;
+			strcpy(command->reply, !link->online ? "error offline" :
+				(a_now - command->queued > GATEWAY_COMMAND_MS) ? "error timeout" : "error state");
+			GATEWAY_reply(command);
+			return;
+		}
+	}
+
+	if (a_door->head != NULL)
+	{
+		/* the polls wait for the command */
+		return;
+	}
+	if (((long)(a_now - a_door->nextStatus) >= 0) && REMOTE_start(link, REMOTE_OP_DIAG, NULL, a_now))
+	{
+		return;
+	}
+	if (((long)(a_now - a_door->nextAudit) >= 0) && REMOTE_start(link, REMOTE_OP_EXPORT, NULL, a_now))
+	{
+		return;
+	}
+}
+
+static void GATEWAY_write(GATEWAY_DoorType * a_door)
+{
+	REMOTE_LinkType * link = &a_door->link;
+	ssize_t written;
+
+	while (link->txNext < link->txSize)
+	{
+		written = write(a_door->fd, &link->tx[link->txNext], link->txSize - link->txNext);
+		if (written <= 0)
+		{
+			/* the rest is written on the next tick */
+			return;
+		}
+		link->txNext += (unsigned int)written;
+	}
+	link->txNext = 0;
+	link->txSize = 0;
+}
+
+/* Description:
+ * read the line of a door straight into the Rx buffer of its link
+ */
+static void GATEWAY_read(GATEWAY_WorkerType * a_worker, GATEWAY_DoorType * a_door, unsigned long a_now)
+{
+	unsigned char * space;
+	unsigned long room;
+	ssize_t count;
+	REMOTE_OpType op;
+
+	for (;;)
+	{
+		space = REMOTE_rxSpace(&a_door->link, &room);
+		if (room == 0)
+		{
+			/* the link fails the reply which doesn't fit */
+			op = REMOTE_received(&a_door->link, 0, a_now);
+			GATEWAY_done(a_worker, a_door, op, a_now);
+			space = REMOTE_rxSpace(&a_door->link, &room);
+			if (room == 0)
+			{
+				break;
+			}
+		}
+		count = read(a_door->fd, space, room);
+		if (count <= 0)
+		{
+			break;
+		}
+		op = REMOTE_received(&a_door->link, (unsigned long)count, a_now);
+		GATEWAY_done(a_worker, a_door, op, a_now);
+	}
+}
+
+static void * GATEWAY_worker(void * a_arg)
+{
+	GATEWAY_WorkerType * worker = a_arg;
+	struct epoll_event events[64];
+	GATEWAY_DoorType * door;
+	GATEWAY_CommandType * command;
+	unsigned long now = GATEWAY_now();
+	unsigned long tick = now;
+	uint64_t value;
+	unsigned int i;
+	int count;
+
+	pthread_mutex_lock(&worker->lock);
+	while (!g_stop)
+	{
+		pthread_mutex_unlock(&worker->lock);
+		count = epoll_wait(worker->epoll, events, 64, GATEWAY_TICK_MS);
+		pthread_mutex_lock(&worker->lock);
+		now = GATEWAY_now();
+
+		for (i = 0; (count > 0) && (i < (unsigned int)count); i++)
+		{
+			if (events[i].data.ptr == NULL)
+			{
+				/* the commands are queued on their doors */
+				if (read(worker->wake, &value, sizeof(value)) < 0)
+				{
+					/* already taken */
+				}
+				while (worker->inbox != NULL)
+				{
+					command = worker->inbox;
+					worker->inbox = command->next;
+					command->next = NULL;
+					door = &g_doors[command->door];
+					if (door->head != NULL)
+					{
+						door->tail->next = command;
+					}
+					else
+					{
+						door->head = command;
+					}
+					door->tail = command;
+					GATEWAY_schedule(door, now);
+					GATEWAY_write(door);
+				}
+				continue;
+			}
+
+			door = events[i].data.ptr;
+			GATEWAY_read(worker, door, now);
+			GATEWAY_schedule(door, now);
+			GATEWAY_write(door);
+		}
+
+		/* timeouts and polls of all the doors */
+		if ((long)(now - tick) >= GATEWAY_TICK_MS)
+		{
+			tick = now;
+			for (i = 0; i < worker->count; i++)
+			{
+				door = &g_doors[worker->first + i];
+				GATEWAY_done(worker, door, REMOTE_timer(&door->link, now), now);
+				GATEWAY_schedule(door, now);
+				GATEWAY_write(door);
+			}
+		}
+	}
+	pthread_mutex_unlock(&worker->lock);
+
+	return NULL;
+}
+
+/* Description:
+ * give a command to the worker of its door
+ */
+static void GATEWAY_post(GATEWAY_CommandType * a_command)
+{
+	GATEWAY_WorkerType * worker;
+	GATEWAY_CommandType ** last;
+	uint64_t one = 1;
+
+	/* the doors are given to the workers in contiguous ranges */
+	for (worker = g_workers; a_command->door >= worker->first + worker->count; worker++)
+	{
+	}
+
+	pthread_mutex_lock(&worker->lock);
+	/* the inbox keeps the order of the commands */
+	a_command->next = NULL;
+	for (last = &worker->inbox; *last != NULL; last = &(*last)->next)
+	{
+	}
+	*last = a_command;
+	pthread_mutex_unlock(&worker->lock);
+
+	if (write(worker->wake, &one, sizeof(one)) < 0)
+	{
+		/* the counter is already set */
+	}
+}
+
+static void GATEWAY_clientSend(GATEWAY_ClientType * a_client, const char * a_format, ...)
+{
+	va_list args;
+	int size;
+
+	va_start(args, a_format);
+	size = vsnprintf(&a_client->tx[a_client->txSize], GATEWAY_CLIENT_TX - a_client->txSize, a_format, args);
+	va_end(args);
+
+	if (size > 0)
+	{
+		a_client->txSize += ((unsigned int)size < GATEWAY_CLIENT_TX - a_client->txSize) ?
+			(unsigned int)size : GATEWAY_CLIENT_TX - a_client->txSize - 1;
+	}
+}
+
+static void GATEWAY_clientFlush(GATEWAY_ClientType * a_client)
+{
+	struct epoll_event event;
+	ssize_t written;
+	unsigned int mask;
+
+	while (a_client->txNext < a_client->txSize)
+	{
+		written = send(a_client->fd, &a_client->tx[a_client->txNext], a_client->txSize - a_client->txNext,
+			MSG_NOSIGNAL);
+		if (written <= 0)
+		{
+			break;
+		}
+		a_client->txNext += (unsigned int)written;
+	}
+	if (a_client->txNext == a_client->txSize)
+	{
+		a_client->txNext = 0;
+		a_client->txSize = 0;
+	}
+
+	/* the rest is sent when the socket has room, nothing more is read while the
+	 * line buffer is full
+	 */
+	mask = ((a_client->rxSize < GATEWAY_LINE_MAX) ? EPOLLIN : 0) | ((a_client->txSize != 0) ? EPOLLOUT : 0);
+	if (mask != a_client->mask)
+	{
+		event.events = mask;
+		event.data.u32 = (unsigned int)(a_client - g_clients);
+		epoll_ctl(g_apiEpoll, EPOLL_CTL_MOD, a_client->fd, &event);
+		a_client->mask = mask;
+	}
+}
+
+static void GATEWAY_status(GATEWAY_ClientType * a_client, unsigned int a_door)
+{
+	GATEWAY_DoorType * door = &g_doors[a_door];
+	const REMOTE_LinkType * link = &door->link;
+	GATEWAY_WorkerType * worker;
+
+	for (worker = g_workers; a_door >= worker->first + worker->count; worker++)
+	{
+	}
+
+	pthread_mutex_lock(&worker->lock);
+	GATEWAY_clientSend(a_client, "ok door=%u device=%s state=%s online=%d password=%s log=%lu events=%lu "
+		"exports=%lu syncs=%lu timeouts=%lu errors=%lu rx=%lu tx=%lu",
+		a_door, door->device, REMOTE_stateName(link->state), link->online,
+		link->passStored ? "stored" : "empty", link->logCount, door->events,
+		link->exports, link->syncs, link->timeouts, link->errors, link->rxBytes, link->txBytes);
+	if (link->hasDiag)
+	{
+		GATEWAY_clientSend(a_client, " unlock_attempts=%u door_cycles=%u uart_errors=%u twi_errors=%u "
+			"idle=%u stack=%u isr_latency=%u",
+			link->diag.unlock_attempts, link->diag.door_cycles, link->diag.uart_errors,
+			link->diag.twi_errors, link->diag.idle_percent, link->diag.stack_high_water,
+			link->diag.isr_max_latency);
+	}
+	pthread_mutex_unlock(&worker->lock);
+	GATEWAY_clientSend(a_client, "\n");
+}
+
+static void GATEWAY_doors(GATEWAY_ClientType * a_client)
+{
+	unsigned int online = 0;
+	unsigned int ready = 0;
+	unsigned long events;
+	unsigned int w;
+	unsigned int i;
+
+	for (w = 0; w < g_workerCount; w++)
+	{
+		pthread_mutex_lock(&g_workers[w].lock);
+		for (i = g_workers[w].first; i < g_workers[w].first + g_workers[w].count; i++)
+		{
+			online += (g_doors[i].link.online != 0);
+			ready += (g_doors[i].link.hasLog != 0);
+		}
+		pthread_mutex_unlock(&g_workers[w].lock);
+	}
+
+	pthread_mutex_lock(&g_eventLock);
+	events = g_eventSeq;
+	pthread_mutex_unlock(&g_eventLock);
+
+	GATEWAY_clientSend(a_client, "ok doors=%u online=%u ready=%u events=%lu\n", g_doorCount, online, ready, events);
+}
+
+/* Description:
+ * send the events from a_seq, the oldest one kept if a_seq was overwritten
+ */
+static void GATEWAY_events(GATEWAY_ClientType * a_client, unsigned long a_seq, unsigned long a_max)
+{
+	const GATEWAY_EventType * event;
+	unsigned long end;
+
+	if ((a_max == 0) || (a_max > GATEWAY_EVENTS_MAX))
+	{
+		a_max = GATEWAY_EVENTS_MAX;
+	}
+
+	pthread_mutex_lock(&g_eventLock);
+	if (g_eventSeq > GATEWAY_EVENTS && a_seq < g_eventSeq - GATEWAY_EVENTS)
+	{
+		a_seq = g_eventSeq - GATEWAY_EVENTS;
+	}
+	if (a_seq > g_eventSeq)
+	{
+		a_seq = g_eventSeq;
+	}
+	end = (g_eventSeq - a_seq > a_max) ? a_seq + a_max : g_eventSeq;
+	for (; a_seq < end; a_seq++)
+	{
+		event = &g_events[a_seq % GATEWAY_EVENTS];
+		GATEWAY_clientSend(a_client, "event %lu %u %lu %u %u %u\n", event->seq, event->door,
+			event->record.time, event->record.event, event->record.user, event->record.result);
+	}
+	pthread_mutex_unlock(&g_eventLock);
+
+	GATEWAY_clientSend(a_client, "ok next=%lu\n", a_seq);
+}
+
+/* Description:
+ * run one command line of a client
+ */
+static void GATEWAY_line(unsigned int a_index, char * a_line)
+{
+	GATEWAY_ClientType * client = &g_clients[a_index];
+	GATEWAY_CommandType * command;
+	char name[16];
+	char pass[POLICY_PASS_MAX_SIZE + 2];
+	unsigned long first;
+	unsigned long second = 0;
+	int fields;
+
+	pass[0] = '\0';
+	fields = sscanf(a_line, "%15s %lu %13s", name, &first, pass);
+	if (fields <= 0)
+	{
+		return;
+	}
+
+	if (strcmp(name, "doors") == 0)
+	{
+		GATEWAY_doors(client);
+	}
+	else if ((strcmp(name, "status") == 0) && (fields == 2) && (first < g_doorCount))
+	{
+		GATEWAY_status(client, (unsigned int)first);
+	}
+	else if ((strcmp(name, "events") == 0) && (fields >= 2))
+	{
+		sscanf(a_line, "%*s %*u %lu", &second);
+		GATEWAY_events(client, first, second);
+	}
+	else if (((strcmp(name, "unlock") == 0) || (strcmp(name, "setpass") == 0)) && (fields == 3) &&
+		(first < g_doorCount) && (strlen(pass) <= POLICY_PASS_MAX_SIZE) && (strchr(pass, '#') == NULL))
+	{
+		command = calloc(1, sizeof(*command));
+		if (command == NULL)
+		{
+			GATEWAY_clientSend(client, "error memory\n");
+			return;
+		}
+		command->op = (name[0] == 'u') ? REMOTE_OP_UNLOCK : REMOTE_OP_SETPASS;
+		command->door = (unsigned int)first;
+		strcpy(command->pass, pass);
+		command->queued = GATEWAY_now();
+		command->client = a_index;
+		command->serial = client->serial;
+		client->waiting = 1;
+		GATEWAY_post(command);
+	}
+	else
+	{
+		GATEWAY_clientSend(client, "error bad command\n");
+	}
+}
+
+/* Description:
+ * run the complete lines of a client, one command with a worker at a time
+ */
+static void GATEWAY_clientInput(unsigned int a_index)
+{
+	GATEWAY_ClientType * client = &g_clients[a_index];
+	char * end;
+	unsigned int length;
+
+	for (;;)
+	{
+		GATEWAY_clientFlush(client);
+		if (client->waiting || (client->txSize != 0))
+		{
+			break;
+		}
+		end = memchr(client->rx, '\n', client->rxSize);
+		if (end == NULL)
+		{
+			if (client->rxSize == GATEWAY_LINE_MAX)
+			{
+				/* a line too long is dropped */
+				client->rxSize = 0;
+				GATEWAY_clientSend(client, "error line too long\n");
+			}
+			break;
+		}
+		*end = '\0';
+		length = (unsigned int)(end - client->rx) + 1;
+		GATEWAY_line(a_index, client->rx);
+		memmove(client->rx, &client->rx[length], client->rxSize - length);
+		client->rxSize -= length;
+	}
+}
+
+static void GATEWAY_clientClose(unsigned int a_index)
+{
+	GATEWAY_ClientType * client = &g_clients[a_index];
+
+	epoll_ctl(g_apiEpoll, EPOLL_CTL_DEL, client->fd, NULL);
+	close(client->fd);
+	client->fd = -1;
+	/* the reply of a command still with a worker is dropped */
+	client->serial = 0;
+}
+
+static void * GATEWAY_api(void * a_arg)
+{
+	struct epoll_event events[GATEWAY_CLIENTS + 2];
+	struct epoll_event event;
+	GATEWAY_ClientType * client;
+	GATEWAY_CommandType * command;
+	GATEWAY_CommandType * replies;
+	uint64_t value;
+	unsigned int index;
+	ssize_t count;
+	int ready;
+	int fd;
+	int i;
+
+	(void)a_arg;
+	while (!g_stop)
+	{
+		ready = epoll_wait(g_apiEpoll, events, GATEWAY_CLIENTS + 2, 100);
+		for (i = 0; i < ready; i++)
+		{
+			index = events[i].data.u32;
+			if (index == GATEWAY_CLIENTS)
+			{
+				/* new client */
+				fd = accept4(g_apiListen, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+				if (fd < 0)
+				{
+					continue;
+				}
+				for (index = 0; (index < GATEWAY_CLIENTS) && (g_clients[index].serial != 0); index++)
+				{
+				}
+				if (index == GATEWAY_CLIENTS)
+				{
+					close(fd);
+					continue;
+				}
+				client = &g_clients[index];
+				memset(client, 0, offsetof(GATEWAY_ClientType, tx));
+				client->fd = fd;
+				client->serial = ++g_clientSerial;
+				client->mask = EPOLLIN;
+				event.events = EPOLLIN;
+				event.data.u32 = index;
+				epoll_ctl(g_apiEpoll, EPOLL_CTL_ADD, fd, &event);
+			}
+			else if (index == GATEWAY_CLIENTS + 1)
+			{
+				/* replies of the workers */
+				if (read(g_apiWake, &value, sizeof(value)) < 0)
+				{
+					/* already taken */
+				}
+				pthread_mutex_lock(&g_replyLock);
+				replies = g_replies;
+				g_replies = NULL;
+				pthread_mutex_unlock(&g_replyLock);
+
+				while (replies != NULL)
+				{
+					command = replies;
+					replies = command->next;
+					client = &g_clients[command->client];
+					if (client->serial == command->serial)
+					{
+						client->waiting = 0;
+						GATEWAY_clientSend(client, "%s\n", command->reply);
+						GATEWAY_clientInput(command->client);
+					}
+					free(command);
+				}
+			}
+			else
+			{
+				client = &g_clients[index];
+				if (events[i].events & EPOLLOUT)
+				{
+					GATEWAY_clientFlush(client);
+				}
+				if ((events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) && (client->rxSize < GATEWAY_LINE_MAX))
+				{
+					count = recv(client->fd, &client->rx[client->rxSize], GATEWAY_LINE_MAX - client->rxSize, 0);
+					if ((count == 0) || ((count < 0) && (errno != EAGAIN) && (errno != EINTR)))
+					{
+						GATEWAY_clientClose(index);
+						continue;
+					}
+					if (count > 0)
+					{
+						client->rxSize += (unsigned int)count;
+					}
+				}
+				GATEWAY_clientInput(index);
+			}
+		}
+	}
+
+	return NULL;
+}
+
+/* Description:
+ * open the devices and start the workers and the API thread
+ */
+static int GATEWAY_start(char * const * a_devices, unsigned int a_count, const char * a_socket)
+{
+	struct sockaddr_un address;
+	struct epoll_event event;
+	GATEWAY_WorkerType * worker;
+	GATEWAY_DoorType * door;
+	unsigned long now = GATEWAY_now();
+	unsigned int i;
+	unsigned int w;
+
+	g_doorCount = a_count;
+	if (g_workerCount > a_count)
+	{
+		g_workerCount = a_count;
+	}
+	g_doors = calloc(a_count, sizeof(*g_doors));
+	g_workers = calloc(g_workerCount, sizeof(*g_workers));
+	g_events = calloc(GATEWAY_EVENTS, sizeof(*g_events));
+	if ((g_doors == NULL) || (g_workers == NULL) || (g_events == NULL))
+	{
+		fprintf(stderr, "door_gateway: out of memory\n");
+		return 0;
+	}
+
+	/* API socket */
+	g_apiListen = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	snprintf(address.sun_path, sizeof(address.sun_path), "%s", a_socket);
+	unlink(a_socket);
+	if ((g_apiListen < 0) || (bind(g_apiListen, (struct sockaddr *)&address, sizeof(address)) < 0) ||
+		(listen(g_apiListen, 16) < 0))
+	{
+		perror(a_socket);
+		return 0;
+	}
+	g_apiEpoll = epoll_create1(EPOLL_CLOEXEC);
+	g_apiWake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	event.events = EPOLLIN;
+	event.data.u32 = GATEWAY_CLIENTS;
+	epoll_ctl(g_apiEpoll, EPOLL_CTL_ADD, g_apiListen, &event);
+	event.data.u32 = GATEWAY_CLIENTS + 1;
+	epoll_ctl(g_apiEpoll, EPOLL_CTL_ADD, g_apiWake, &event);
+
+	for (w = 0; w < g_workerCount; w++)
+	{
+		worker = &g_workers[w];
+		worker->first = (a_count * w) / g_workerCount;
+		worker->count = ((a_count * (w + 1)) / g_workerCount) - worker->first;
+		worker->epoll = epoll_create1(EPOLL_CLOEXEC);
+		worker->wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		pthread_mutex_init(&worker->lock, NULL);
+		event.events = EPOLLIN;
+		event.data.ptr = NULL;
+		epoll_ctl(worker->epoll, EPOLL_CTL_ADD, worker->wake, &event);
+
+		for (i = worker->first; i < worker->first + worker->count; i++)
+		{
+			door = &g_doors[i];
+			if (!GATEWAY_openDevice(door, a_devices[i]))
+			{
+				return 0;
+			}
+			REMOTE_init(&door->link, worker->records, now);
+			/* the polls of the doors are spread over their periods */
+			door->nextStatus = now + ((g_statusMs * i) / a_count);
+			door->nextAudit = now + ((g_auditMs * i) / a_count);
+			/* edge triggered, the line is read until it is empty */
+			event.events = EPOLLIN | EPOLLET;
+			event.data.ptr = door;
+			epoll_ctl(worker->epoll, EPOLL_CTL_ADD, door->fd, &event);
+		}
+	}
+
+	for (w = 0; w < g_workerCount; w++)
+	{
+		pthread_create(&g_workers[w].thread, NULL, GATEWAY_worker, &g_workers[w]);
+	}
+	pthread_create(&g_apiThread, NULL, GATEWAY_api, NULL);
+	return 1;
+}
+
+static void GATEWAY_stop(void)
+{
+	unsigned int i;
+
+	g_stop = 1;
+	for (i = 0; i < g_workerCount; i++)
+	{
+		pthread_join(g_workers[i].thread, NULL);
+	}
+	pthread_join(g_apiThread, NULL);
+	for (i = 0; i < g_doorCount; i++)
+	{
+		close(g_doors[i].fd);
+	}
+	close(g_apiListen);
+}
+
+/* Description:
+ * run the models of a share of the doors of the load test
+ */
+static void * GATEWAY_modelThread(void * a_arg)
+{
+	GATEWAY_ModelThreadType * share = a_arg;
+	struct epoll_event events[64];
+	MODEL_DoorType * door;
+	unsigned long now;
+	unsigned long tick = 0;
+	unsigned int i;
+	int count;
+
+	while (!g_modelStop)
+	{
+		count = epoll_wait(share->epoll, events, 64, GATEWAY_TICK_MS);
+		now = GATEWAY_now();
+		for (i = 0; (count > 0) && (i < (unsigned int)count); i++)
+		{
+			door = events[i].data.ptr;
+			MODEL_service(door, now);
+		}
+
+		if ((long)(now - tick) >= GATEWAY_TICK_MS)
+		{
+			tick = now;
+			for (i = 0; i < share->count; i++)
+			{
+				door = &share->doors[i];
+				MODEL_timer(door, now);
+				if (MODEL_isPending(door, now))
+				{
+					MODEL_service(door, now);
+				}
+			}
+		}
+	}
+
+	return NULL;
+}
+
+/* Description:
+ * connect to the API socket, a_out is the stream to send the commands
+ */
+static FILE * GATEWAY_connect(const char * a_socket, FILE ** a_out)
+{
+	struct sockaddr_un address;
+	FILE * in;
+	int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	snprintf(address.sun_path, sizeof(address.sun_path), "%s", a_socket);
+	if ((fd < 0) || (connect(fd, (struct sockaddr *)&address, sizeof(address)) < 0))
+	{
+		perror(a_socket);
+		return NULL;
+	}
+	in = fdopen(fd, "r");
+	*a_out = fdopen(dup(fd), "w");
+	return in;
+}
+
+/* Description:
+ * client of the load test sending the unlock commands, the doors are taken in
+ * turn by all the clients so no door gets a command during its door cycle
+ */
+static void * GATEWAY_loadCommands(void * a_arg)
+{
+	GATEWAY_LoadClientType * client = a_arg;
+	double period = GATEWAY_LOAD_CLIENTS / g_loadRate;
+	double due = g_loadStart + (client->index * period / GATEWAY_LOAD_CLIENTS);
+	double sent;
+	double * grown;
+	char line[GATEWAY_LINE_MAX];
+	unsigned long door;
+	struct timespec pause;
+	FILE * out;
+	FILE * in = GATEWAY_connect(g_loadSocket, &out);
+
+	if (in == NULL)
+	{
+		return NULL;
+	}
+
+	while (due < g_loadEnd)
+	{
+		sent = GATEWAY_seconds();
+		if (sent < due)
+		{
+			pause.tv_sec = (time_t)(due - sent);
+			pause.tv_nsec = (long)(((due - sent) - (double)pause.tv_sec) * 1e9);
+			nanosleep(&pause, NULL);
+		}
+		due += period;
+
+		pthread_mutex_lock(&g_loadLock);
+		door = g_loadNext++ % g_doorCount;
+		pthread_mutex_unlock(&g_loadLock);
+
+		sent = GATEWAY_seconds();
+		fprintf(out, "unlock %lu %s\n", door, GATEWAY_LOAD_PASS);
+		fflush(out);
+		if (fgets(line, sizeof(line), in) == NULL)
+		{
+			break;
+		}
+
+		if (client->count == client->size)
+		{
+			client->size = client->size ? client->size * 2 : 1024;
+			grown = realloc(client->latency, client->size * sizeof(double));
+			if (grown == NULL)
+			{
+				break;
+			}
+			client->latency = grown;
+		}
+		client->latency[client->count++] = (GATEWAY_seconds() - sent) * 1000.0;
+
+		if (strncmp(line, "ok matched", 10) != 0)
+		{
+			client->failed++;
+			snprintf(client->error, sizeof(client->error), "door %lu: %s", door, line);
+		}
+	}
+
+	fclose(out);
+	fclose(in);
+	return NULL;
+}
+
+/* Description:
+ * client of the load test reading the events until the end of the test
+ */
+static void * GATEWAY_loadEvents(void * a_arg)
+{
+	char line[GATEWAY_LINE_MAX];
+	unsigned long next = 0;
+	unsigned long received;
+	struct timespec pause = {0, GATEWAY_TICK_MS * 1000000L};
+	FILE * out;
+	FILE * in = GATEWAY_connect(g_loadSocket, &out);
+
+	(void)a_arg;
+	if (in == NULL)
+	{
+		return NULL;
+	}
+
+	/* the records before the start of the test are skipped */
+	fprintf(out, "doors\n");
+	fflush(out);
+	if ((fgets(line, sizeof(line), in) == NULL) || (sscanf(line, "ok doors=%*u online=%*u ready=%*u events=%lu", &next) != 1))
+	{
+		next = 0;
+	}
+
+	while (GATEWAY_seconds() < g_loadEnd)
+	{
+		received = 0;
+		fprintf(out, "events %lu %d\n", next, GATEWAY_EVENTS_MAX);
+		fflush(out);
+		while (fgets(line, sizeof(line), in) != NULL)
+		{
+			if (strncmp(line, "event ", 6) == 0)
+			{
+				received++;
+				continue;
+			}
+			sscanf(line, "ok next=%lu", &next);
+			break;
+		}
+		pthread_mutex_lock(&g_loadLock);
+		g_loadEvents += received;
+		pthread_mutex_unlock(&g_loadLock);
+		if (received == 0)
+		{
+			nanosleep(&pause, NULL);
+		}
+	}
+
+	fclose(out);
+	fclose(in);
+	return NULL;
+}
+
+static int GATEWAY_compare(const void * a_first, const void * a_second)
+{
+	double first = *(const double *)a_first;
+	double second = *(const double *)a_second;
+
+	return (first > second) - (first < second);
+}
+
+/* Description:
+ * load test on a_doors pty pairs with the models of the CONTROL_ECU
+ */
+static int GATEWAY_load(unsigned int a_doors)
+{
+	GATEWAY_ModelThreadType shares[GATEWAY_MODEL_THREADS];
+	GATEWAY_LoadClientType clients[GATEWAY_LOAD_CLIENTS];
+	pthread_t eventThread;
+	MODEL_DoorType * models;
+	struct epoll_event event;
+	struct termios tty;
+	struct rlimit files;
+	char ** devices;
+	int * slaves;
+	double * latency;
+	double startup;
+	double seconds;
+	char line[GATEWAY_LINE_MAX];
+	unsigned long events = 0;
+	unsigned long generated = 0;
+	unsigned long exports = 0;
+	unsigned long timeouts = 0;
+	unsigned long failed = 0;
+	unsigned long count = 0;
+	unsigned long now;
+	unsigned int online = 0;
+	unsigned int ready = 0;
+	unsigned int i;
+	unsigned int k;
+	int master;
+	FILE * out;
+	FILE * in;
+
+	/* a master, a slave kept open and the slave of the gateway for every door */
+	if (getrlimit(RLIMIT_NOFILE, &files) == 0)
+	{
+		files.rlim_cur = files.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &files);
+	}
+
+	models = calloc(a_doors, sizeof(*models));
+	devices = calloc(a_doors, sizeof(*devices));
+	slaves = calloc(a_doors, sizeof(*slaves));
+	if ((models == NULL) || (devices == NULL) || (slaves == NULL))
+	{
+		fprintf(stderr, "door_gateway: out of memory\n");
+		return 1;
+	}
+
+	now = GATEWAY_now();
+	for (i = 0; i < a_doors; i++)
+	{
+		master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+		if ((master < 0) || (grantpt(master) < 0) || (unlockpt(master) < 0))
+		{
+			perror("door_gateway: pty");
+			return 1;
+		}
+		devices[i] = strdup(ptsname(master));
+
+		/* the slave kept open stops the hang-ups on the master while the
+		 * gateway has it closed, it sets the line raw before the first byte
+		 */
+		slaves[i] = open(devices[i], O_RDWR | O_NOCTTY | O_CLOEXEC);
+		if ((slaves[i] < 0) || (tcgetattr(slaves[i], &tty) < 0))
+		{
+			perror(devices[i]);
+			return 1;
+		}
+		cfmakeraw(&tty);
+		tcsetattr(slaves[i], TCSANOW, &tty);
+
+		MODEL_init(&models[i], master, GATEWAY_LOAD_PASS, g_loadEventMs, 0x9E3779B9UL * (i + 1), now);
+	}
+
+	for (k = 0; k < GATEWAY_MODEL_THREADS; k++)
+	{
+		shares[k].doors = &models[(a_doors * k) / GATEWAY_MODEL_THREADS];
+		shares[k].count = ((a_doors * (k + 1)) / GATEWAY_MODEL_THREADS) - ((a_doors * k) / GATEWAY_MODEL_THREADS);
+		shares[k].epoll = epoll_create1(EPOLL_CLOEXEC);
+		for (i = 0; i < shares[k].count; i++)
+		{
+			event.events = EPOLLIN | EPOLLOUT | EPOLLET;
+			event.data.ptr = &shares[k].doors[i];
+			epoll_ctl(shares[k].epoll, EPOLL_CTL_ADD, shares[k].doors[i].fd, &event);
+		}
+		pthread_create(&shares[k].thread, NULL, GATEWAY_modelThread, &shares[k]);
+	}
+
+	snprintf(g_loadSocket, sizeof(g_loadSocket), "/tmp/door_gateway_load.%d.sock", (int)getpid());
+	startup = GATEWAY_seconds();
+	if (!GATEWAY_start(devices, a_doors, g_loadSocket))
+	{
+		return 1;
+	}
+
+	/* wait until every door is online with its first export */
+	in = GATEWAY_connect(g_loadSocket, &out);
+	if (in == NULL)
+	{
+		return 1;
+	}
+	while (GATEWAY_seconds() - startup < GATEWAY_LOAD_SYNC_MS / 1000.0)
+	{
+		fprintf(out, "doors\n");
+		fflush(out);
+		if ((fgets(line, sizeof(line), in) == NULL) ||
+			(sscanf(line, "ok doors=%*u online=%u ready=%u", &online, &ready) != 2) || (ready == a_doors))
+		{
+			break;
+		}
+		usleep(10000);
+	}
+	startup = GATEWAY_seconds() - startup;
+
+	printf("door_gateway load test: %u doors, %u workers, %.1f s, %.0f unlocks/s, a record every %lu ms per door\n",
+		a_doors, g_workerCount, g_loadSeconds, g_loadRate, g_loadEventMs);
+	printf("  doors online:    %u of %u, %u with their first export after %.2f s\n", online, a_doors, ready, startup);
+
+	g_loadStart = GATEWAY_seconds();
+	g_loadEnd = g_loadStart + g_loadSeconds;
+	memset(clients, 0, sizeof(clients));
+	pthread_create(&eventThread, NULL, GATEWAY_loadEvents, NULL);
+	for (k = 0; k < GATEWAY_LOAD_CLIENTS; k++)
+	{
+		clients[k].index = k;
+		pthread_create(&clients[k].thread, NULL, GATEWAY_loadCommands, &clients[k]);
+	}
+	for (k = 0; k < GATEWAY_LOAD_CLIENTS; k++)
+	{
+		pthread_join(clients[k].thread, NULL);
+		count += clients[k].count;
+		failed += clients[k].failed;
+	}
+	pthread_join(eventThread, NULL);
+	seconds = GATEWAY_seconds() - g_loadStart;
+
+	fclose(out);
+	fclose(in);
+	GATEWAY_stop();
+	g_modelStop = 1;
+	for (k = 0; k < GATEWAY_MODEL_THREADS; k++)
+	{
+		pthread_join(shares[k].thread, NULL);
+	}
+	unlink(g_loadSocket);
+
+	for (i = 0; i < a_doors; i++)
+	{
+		generated += models[i].events;
+		exports += g_doors[i].link.exports;
+		timeouts += g_doors[i].link.timeouts;
+	}
+	events = g_loadEvents;
+
+	latency = malloc((count + 1) * sizeof(double));
+	count = 0;
+	for (k = 0; k < GATEWAY_LOAD_CLIENTS; k++)
+	{
+		if (clients[k].count != 0)
+		{
+			memcpy(&latency[count], clients[k].latency, clients[k].count * sizeof(double));
+			count += clients[k].count;
+		}
+		if (clients[k].failed != 0)
+		{
+			printf("  failed command:  %s", clients[k].error);
+		}
+		free(clients[k].latency);
+	}
+	qsort(latency, count, sizeof(double), GATEWAY_compare);
+
+	printf("  events:          %lu delivered, %.0f events/s (%lu records added by the doors in all)\n",
+		events, events / seconds, generated);
+	printf("  exports:         %.0f/s, %lu link timeouts\n", exports / (seconds + startup), timeouts);
+	if (count != 0)
+	{
+		printf("  unlock commands: %lu, %lu failed, %.1f/s, latency p50 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+			count, failed, count / seconds, latency[count / 2], latency[(count * 99) / 100], latency[count - 1]);
+	}
+
+	free(latency);
+	return ((ready != a_doors) || (failed != 0) || (count == 0)) ? 1 : 0;
+}
+
+int main(int argc, char * argv[])
+{
+	const char * path = GATEWAY_SOCKET;
+	unsigned int doors = 0;
+	int option;
+
+	while ((option = getopt(argc, argv, "s:w:p:a:l:t:r:e:")) != -1)
+	{
+		switch (option)
+		{
+		case 's':
+			path = optarg;
+			break;
+		case 'w':
+			g_workerCount = (unsigned int)atoi(optarg);
+			break;
+		case 'p':
+			g_statusMs = strtoul(optarg, NULL, 10);
+			break;
+		case 'a':
+			g_auditMs = strtoul(optarg, NULL, 10);
+			break;
+		case 'l':
+			doors = (unsigned int)atoi(optarg);
+			break;
+		case 't':
+			g_loadSeconds = atof(optarg);
+			break;
+		case 'r':
+			g_loadRate = atof(optarg);
+			break;
+		case 'e':
+			g_loadEventMs = strtoul(optarg, NULL, 10);
+			break;
+		default:
+			doors = 0;
+			optind = argc + 1;
+			break;
+		}
+	}
+
+	if ((g_workerCount == 0) || (g_loadSeconds <= 0.0) || (g_loadRate <= 0.0) || (optind > argc) ||
+		((doors == 0) && (optind == argc)))
+	{
+		fprintf(stderr, "usage: %s [-s socket] [-w workers] [-p status_ms] [-a audit_ms] device...\n"
+			"       %s -l doors [-t seconds] [-r commands_per_s] [-e event_ms] [-w workers] "
+			"[-p status_ms] [-a audit_ms]\n", argv[0], argv[0]);
+		return 2;
+	}
+
+	signal(SIGPIPE, SIG_IGN);
+	if (doors != 0)
+	{
+		return GATEWAY_load(doors);
+	}
+
+	signal(SIGINT, GATEWAY_signal);
+	signal(SIGTERM, GATEWAY_signal);
+	if (!GATEWAY_start(&argv[optind], (unsigned int)(argc - optind), path))
+	{
+		return 1;
+	}
+	while (!g_stop)
+	{
+		pause();
+	}
+	GATEWAY_stop();
+	unlink(path);
+	return 0;
+}
@@ -0,0 +1,467 @@
+/*
+ * door_model.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: light model of a CONTROL_ECU on its UART link for the load test
+ *      			 of the gateway
+ */
+
+#include "door_model.h"
+#include "baud.h"
+#include "diag.h"
+#include <util/crc16.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* states, in the order of control_main.c */
+#define MODEL_BAUD				0	/* waiting to propose a rate */
+#define MODEL_BAUD_REPLY		1
+#define MODEL_BAUD_END			2
+#define MODEL_POLICY			3
+#define MODEL_PASS_FLAG			4
+#define MODEL_MAIN				5	/* waiting for a main option */
+#define MODEL_REPLY				6	/* waiting to send the reply to the option */
+#define MODEL_PASS				7	/* receiving a password */
+#define MODEL_PASS_REPLY		8
+#define MODEL_LOCKED			9	/* sending the remaining lockout seconds */
+#define MODEL_DIAG				10
+#define MODEL_EXPORT			11
+
+#define MODEL_READY				'H'
+
+/* the rate proposed, the gateway keeps UART_BAUD_DEFAULT */
+#define MODEL_PROPOSED_BAUD		19200UL
+
+/* short door cycle so the load test can open every door again and again */
+#define MODEL_DOOR_MOVE			1
+#define MODEL_DOOR_HOLD			1
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static unsigned long MODEL_random(MODEL_DoorType * a_door);
+static void MODEL_send(MODEL_DoorType * a_door, const unsigned char * a_data, unsigned int a_size);
+static void MODEL_sendByte(MODEL_DoorType * a_door, unsigned char a_data);
+static void MODEL_flush(MODEL_DoorType * a_door);
+static void MODEL_append(MODEL_DoorType * a_door, unsigned char a_event, unsigned char a_user,
+	unsigned char a_result, unsigned long a_now);
+static unsigned int MODEL_varint(unsigned char * a_out, unsigned long a_value);
+static void MODEL_sendExport(MODEL_DoorType * a_door);
+static void MODEL_sendDiag(MODEL_DoorType * a_door);
+static unsigned char MODEL_option(MODEL_DoorType * a_door, unsigned char a_option, unsigned long a_now);
+static unsigned char MODEL_checkPass(MODEL_DoorType * a_door, unsigned long a_now);
+static void MODEL_byte(MODEL_DoorType * a_door, unsigned char a_byte, unsigned long a_now);
+static void MODEL_run(MODEL_DoorType * a_door, unsigned long a_now);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+static unsigned long MODEL_random(MODEL_DoorType * a_door)
+{
+	a_door->random ^= a_door->random << 13;
+	a_door->random ^= a_door->random >> 17;
+	a_door->random ^= a_door->random << 5;
+	a_door->random &= 0xFFFFFFFFUL;
+	return a_door->random;
+}
+
+static void MODEL_send(MODEL_DoorType * a_door, const unsigned char * a_data, unsigned int a_size)
+{
+	if (a_door->txSize + a_size > sizeof(a_door->tx))
+	{
+		memmove(a_door->tx, &a_door->tx[a_door->txNext], a_door->txSize - a_door->txNext);
+		a_door->txSize -= a_door->txNext;
+		a_door->txNext = 0;
+	}
+	memcpy(&a_door->tx[a_door->txSize], a_data, a_size);
+	a_door->txSize += a_size;
+	a_door->txBytes += a_size;
+}
+
+static void MODEL_sendByte(MODEL_DoorType * a_door, unsigned char a_data)
+{
+	MODEL_send(a_door, &a_data, 1);
+}
+
+static void MODEL_flush(MODEL_DoorType * a_door)
+{
+	ssize_t written;
+
+	while (a_door->txNext < a_door->txSize)
+	{
+		written = write(a_door->fd, &a_door->tx[a_door->txNext], a_door->txSize - a_door->txNext);
+		if (written <= 0)
+		{
+			/* the rest is written when the line has room */
+			return;
+		}
+		a_door->txNext += (unsigned int)written;
+	}
+	a_door->txNext = 0;
+	a_door->txSize = 0;
+}
+
+static void MODEL_append(MODEL_DoorType * a_door, unsigned char a_event, unsigned char a_user,
+	unsigned char a_result, unsigned long a_now)
+{
+	MODEL_RecordType * record = &a_door->log[a_door->logHead];
+
+	record->event = a_event;
+	record->user = a_user;
+	record->result = a_result;
+	record->time = (a_now - a_door->start) / 1000;
+
+	a_door->logHead = (a_door->logHead + 1) % LOG_CAPACITY;
+	if (a_door->logCount < LOG_CAPACITY)
+	{
+		a_door->logCount++;
+	}
+	a_door->events++;
+}
+
+static unsigned int MODEL_varint(unsigned char * a_out, unsigned long a_value)
+{
+	unsigned int size = 0;
+
+	while (a_value >= 0x80)
+	{
+		a_out[size++] = (unsigned char)(a_value | 0x80);
+		a_value >>= 7;
+	}
+	a_out[size++] = (unsigned char)a_value;
+	return size;
+}
+
+/* Description:
+ * send the log as EXPORT_send does, every record with its own token (no repeat
+ * or run token), EXPORT_BLOCK_RECORDS records per data frame
+ */
+static void MODEL_sendExport(MODEL_DoorType * a_door)
+{
+	const MODEL_RecordType * record;
+	unsigned char frame[1 + EXPORT_FRAME_MAX];
+	unsigned char user = LOG_USER_MAIN;
+	unsigned long time = 0;
+	unsigned short crc = 0xFFFF;
+	unsigned int length = 0;
+	unsigned int i;
+	unsigned int k;
+	long delta;
+
+	frame[0] = EXPORT_HEADER_SIZE;
+	frame[1] = EXPORT_VERSION;
+	frame[2] = (unsigned char)a_door->logCount;
+	frame[3] = (unsigned char)(a_door->logCount >> 8);
+	MODEL_send(a_door, frame, 1 + EXPORT_HEADER_SIZE);
+
+	for (i = 0; i < a_door->logCount; i++)
+	{
+		record = &a_door->log[(a_door->logHead + LOG_CAPACITY - a_door->logCount + i) % LOG_CAPACITY];
+
+		frame[1 + length++] = (unsigned char)((record->event << 4) | (record->result << 1) |
+			((record->user != user) ? EXPORT_USER_CHANGED : 0));
+		if (record->user != user)
+		{
+			length += MODEL_varint(&frame[1 + length], record->user);
+			user = record->user;
+		}
+		/* zigzag of the time delta, the time of the model never goes back */
+		delta = (long)(record->time - time);
+		length += MODEL_varint(&frame[1 + length], (delta >= 0) ? ((unsigned long)delta << 1) :
+			(((unsigned long)-delta << 1) - 1));
+		time = record->time;
+
+		if ((((i + 1) % EXPORT_BLOCK_RECORDS) == 0) || (i + 1 == a_door->logCount))
+		{
+			for (k = 0; k < length; k++)
+			{
+				crc = _crc_ccitt_update(crc, frame[1 + k]);
+			}
+			frame[0] = (unsigned char)length;
+			MODEL_send(a_door, frame, 1 + length);
+			length = 0;
+		}
+	}
+
+	frame[0] = 0;
+	frame[1] = (unsigned char)crc;
+	frame[2] = (unsigned char)(crc >> 8);
+	MODEL_send(a_door, frame, 3);
+}
+
+/* Description:
+ * send the frame of DIAG_send with the counters of the model
+ */
+static void MODEL_sendDiag(MODEL_DoorType * a_door)
+{
+	unsigned char frame[1 + REMOTE_DIAG_SIZE];
+
+	memset(frame, 0, sizeof(frame));
+	frame[0] = REMOTE_DIAG_SIZE;
+	frame[1] = DIAG_VERSION;
+	frame[2] = (unsigned char)a_door->rxBytes;
+	frame[3] = (unsigned char)(a_door->rxBytes >> 8);
+	frame[4] = (unsigned char)a_door->txBytes;
+	frame[5] = (unsigned char)(a_door->txBytes >> 8);
+	frame[22] = (unsigned char)a_door->unlocks;
+	frame[23] = (unsigned char)(a_door->unlocks >> 8);
+	frame[24] = (unsigned char)a_door->doorCycles;
+	frame[25] = (unsigned char)(a_door->doorCycles >> 8);
+	frame[28] = 95;
+	frame[29] = 120;
+	MODEL_send(a_door, frame, sizeof(frame));
+}
+
+/* Description:
+ * reply to a main option as CONTROL_optionFlag does
+ */
+static unsigned char MODEL_option(MODEL_DoorType * a_door, unsigned char a_option, unsigned long a_now)
+{
+	unsigned char flag = '0';
+
+	switch (a_option)
+	{
+	case '+':
+		flag = '1';
+		break;
+	case '%':
+		flag = '8';
+		break;
+	case 'L':
+		flag = '9';
+		break;
+	}
+
+	if (((long)(a_now - a_door->lockoutUntil) < 0) && (flag == '1'))
+	{
+		flag = '3';
+	}
+	return flag;
+}
+
+/* Description:
+ * state of the password received, as CONTROL_passStatus does
+ */
+static unsigned char MODEL_checkPass(MODEL_DoorType * a_door, unsigned long a_now)
+{
+	const unsigned char * policy = a_door->policy;
+
+	a_door->unlocks++;
+	if ((a_door->length == strlen(a_door->pass)) && (memcmp(a_door->entered, a_door->pass, a_door->length) == 0))
+	{
+		a_door->attempts = 0;
+		a_door->doorCycles++;
+		a_door->busyUntil = a_now + (((2UL * policy[REMOTE_POLICY_DOOR_MOVE]) + policy[REMOTE_POLICY_DOOR_HOLD]) * 1000UL);
+		MODEL_append(a_door, LOG_EVENT_DOOR_OPEN, LOG_USER_MAIN, LOG_RESULT_SUCCESS, a_now);
+		return '1';
+	}
+
+	MODEL_append(a_door, LOG_EVENT_DOOR_OPEN, LOG_USER_MAIN, LOG_RESULT_WRONG_PASS, a_now);
+	if (++a_door->attempts >= policy[3])
+	{
+		a_door->attempts = 0;
+		a_door->lockoutUntil = a_now + ((policy[4] | ((unsigned long)policy[5] << 8)) * 1000UL);
+		MODEL_append(a_door, LOG_EVENT_LOCKOUT, LOG_USER_MAIN, 1, a_now);
+		return '2';
+	}
+	return '0';
+}
+
+static void MODEL_byte(MODEL_DoorType * a_door, unsigned char a_byte, unsigned long a_now)
+{
+	unsigned long remaining;
+
+	/* the states which send a byte wait for HMI_ECU_READY first */
+	if ((a_door->state != MODEL_BAUD_REPLY) && (a_door->state != MODEL_MAIN) &&
+		(a_door->state != MODEL_PASS) && (a_byte != MODEL_READY))
+	{
+		return;
+	}
+
+	switch (a_door->state)
+	{
+	case MODEL_BAUD:
+		MODEL_sendByte(a_door, BAUD_PROPOSE);
+		MODEL_sendByte(a_door, (unsigned char)((MODEL_PROPOSED_BAUD / 100) >> 8));
+		MODEL_sendByte(a_door, (unsigned char)(MODEL_PROPOSED_BAUD / 100));
+		a_door->state = MODEL_BAUD_REPLY;
+		break;
+	case MODEL_BAUD_REPLY:
+		/* only the default rate is modelled, an accepted rate isn't tested */
+		a_door->state = MODEL_BAUD_END;
+		break;
+	case MODEL_BAUD_END:
+		MODEL_sendByte(a_door, BAUD_END);
+		a_door->step = 0;
+		a_door->state = MODEL_POLICY;
+		break;
+	case MODEL_POLICY:
+		MODEL_sendByte(a_door, a_door->policy[a_door->step++]);
+		if (a_door->step == REMOTE_POLICY_SIZE)
+		{
+			a_door->state = MODEL_PASS_FLAG;
+		}
+		break;
+	case MODEL_PASS_FLAG:
+		MODEL_sendByte(a_door, '5');
+		a_door->state = MODEL_MAIN;
+		break;
+	case MODEL_MAIN:
+		/* HMI_ECU_READY is also BAUD_READY, the rate is negotiated again from the
+		 * next one
+		 */
+		if (a_byte == MODEL_READY)
+		{
+			a_door->state = MODEL_BAUD;
+			break;
+		}
+		a_door->flag = MODEL_option(a_door, a_byte, a_now);
+		a_door->state = MODEL_REPLY;
+		break;
+	case MODEL_REPLY:
+		MODEL_sendByte(a_door, a_door->flag);
+		a_door->step = 0;
+		a_door->length = 0;
+		a_door->state = (a_door->flag == '1') ? MODEL_PASS :
+			(a_door->flag == '8') ? MODEL_DIAG :
+			(a_door->flag == '9') ? MODEL_EXPORT :
+			(a_door->flag == '3') ? MODEL_LOCKED : MODEL_MAIN;
+		break;
+	case MODEL_PASS:
+		if (a_byte == '#')
+		{
+			a_door->state = MODEL_PASS_REPLY;
+		}
+		else if (a_door->length < POLICY_PASS_MAX_SIZE)
+		{
+			a_door->entered[a_door->length++] = (char)a_byte;
+		}
+		break;
+	case MODEL_PASS_REPLY:
+		a_door->flag = MODEL_checkPass(a_door, a_now);
+		MODEL_sendByte(a_door, a_door->flag);
+		a_door->length = 0;
+		a_door->state = (a_door->flag == '0') ? MODEL_PASS : MODEL_MAIN;
+		break;
+	case MODEL_LOCKED:
+		remaining = ((long)(a_door->lockoutUntil - a_now) > 0) ? ((a_door->lockoutUntil - a_now) + 999) / 1000 : 0;
+		MODEL_sendByte(a_door, (unsigned char)((a_door->step == 0) ? (remaining >> 8) : remaining));
+		if (++a_door->step == 2)
+		{
+			a_door->state = MODEL_MAIN;
+		}
+		break;
+	case MODEL_DIAG:
+		MODEL_sendDiag(a_door);
+		a_door->state = MODEL_MAIN;
+		break;
+	case MODEL_EXPORT:
+		MODEL_sendExport(a_door);
+		a_door->state = MODEL_MAIN;
+		break;
+	}
+}
+
+/* Description:
+ * take the bytes received, they wait in the buffer during the door cycle
+ */
+static void MODEL_run(MODEL_DoorType * a_door, unsigned long a_now)
+{
+	unsigned int taken = 0;
+
+	while ((taken < a_door->rxSize) && ((long)(a_now - a_door->busyUntil) >= 0))
+	{
+		MODEL_byte(a_door, a_door->rx[taken++], a_now);
+	}
+	memmove(a_door->rx, &a_door->rx[taken], a_door->rxSize - taken);
+	a_door->rxSize -= taken;
+
+	MODEL_flush(a_door);
+}
+
+void MODEL_init(MODEL_DoorType * a_door, int a_fd, const char * a_pass, unsigned long a_eventMs,
+	unsigned long a_seed, unsigned long a_now)
+{
+	memset(a_door, 0, sizeof(*a_door));
+	a_door->fd = a_fd;
+	a_door->state = MODEL_BAUD;
+	a_door->start = a_now;
+	a_door->busyUntil = a_now;
+	a_door->lockoutUntil = a_now;
+	a_door->random = a_seed | 1;
+	a_door->eventMs = a_eventMs;
+	a_door->nextEvent = a_now + ((a_eventMs != 0) ? (MODEL_random(a_door) % a_eventMs) : 0);
+	strncpy(a_door->pass, a_pass, POLICY_PASS_MAX_SIZE);
+
+	a_door->policy[0] = POLICY_VERSION;
+	a_door->policy[1] = POLICY_PASS_MIN_SIZE;
+	a_door->policy[2] = POLICY_PASS_MAX_SIZE;
+	a_door->policy[3] = POLICY_DEFAULT_ATTEMPTS;
+	a_door->policy[4] = (unsigned char)POLICY_DEFAULT_LOCKOUT;
+	a_door->policy[5] = (unsigned char)(POLICY_DEFAULT_LOCKOUT >> 8);
+	a_door->policy[REMOTE_POLICY_DOOR_MOVE] = MODEL_DOOR_MOVE;
+	a_door->policy[REMOTE_POLICY_DOOR_HOLD] = MODEL_DOOR_HOLD;
+
+	MODEL_append(a_door, LOG_EVENT_BOOT, LOG_USER_NONE, LOG_RESULT_SUCCESS, a_now);
+}
+
+int MODEL_service(MODEL_DoorType * a_door, unsigned long a_now)
+{
+	ssize_t count;
+
+	while (a_door->rxSize < MODEL_RX_SIZE)
+	{
+		count = read(a_door->fd, &a_door->rx[a_door->rxSize], MODEL_RX_SIZE - a_door->rxSize);
+		if (count > 0)
+		{
+			a_door->rxSize += (unsigned int)count;
+			a_door->rxBytes += (unsigned int)count;
+			continue;
+		}
+		if ((count < 0) && ((errno == EAGAIN) || (errno == EINTR)))
+		{
+			break;
+		}
+		return 0;
+	}
+
+	MODEL_run(a_door, a_now);
+	return 1;
+}
+
+unsigned long MODEL_timer(MODEL_DoorType * a_door, unsigned long a_now)
+{
+	unsigned long next = 1000;
+
+	if (a_door->eventMs != 0)
+	{
+		while ((long)(a_now - a_door->nextEvent) >= 0)
+		{
+			MODEL_append(a_door, LOG_EVENT_DOOR_OPEN, (unsigned char)(1 + (MODEL_random(a_door) % 4)),
+				LOG_RESULT_SUCCESS, a_now);
+			a_door->nextEvent += (a_door->eventMs / 2) + (MODEL_random(a_door) % (a_door->eventMs + 1));
+		}
+		next = a_door->nextEvent - a_now;
+	}
+
+	/* the bytes kept during the door cycle are taken by MODEL_service at its end */
+	if ((a_door->rxSize != 0) && ((long)(a_door->busyUntil - a_now) > 0) && (a_door->busyUntil - a_now < next))
+	{
+		next = a_door->busyUntil - a_now;
+	}
+	return next;
+}
+
+int MODEL_isPending(const MODEL_DoorType * a_door, unsigned long a_now)
+{
+	return ((a_door->rxSize != 0) && ((long)(a_now - a_door->busyUntil) >= 0)) ||
+		(a_door->txNext < a_door->txSize);
+}
@@ -0,0 +1,114 @@
+/*
+ * door_model.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: light model of a CONTROL_ECU on its UART link for the load test
+ *      			 of the gateway, thousands of them run in a few threads
+ *
+ *      The model answers the HMI_ECU side of the link as control_main.c does:
+ *      one baud rate proposal then BAUD_END, the policy and PASS_STORED, then the
+ *      main options '+' (password and door cycle), '%' (diagnostics frame of
+ *      DIAG_VERSION 2) and 'L' (audit log export of log_export.h), with the
+ *      lockout after max_attempts wrong passwords. Every byte waits for
+ *      HMI_ECU_READY as CONTROL_sendState does, HMI_ECU_READY instead of a main
+ *      option starts the baud rate negotiation again. The keypad of the door adds a
+ *      door_open record to the log every eventMs on average.
+ */
+
+#ifndef DOOR_MODEL_H_
+#define DOOR_MODEL_H_
+
+#include "remote_link.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define MODEL_RX_SIZE			64
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef struct
+{
+	unsigned char	event	;
+	unsigned char	user	;
+	unsigned char	result	;
+	unsigned long	time	;
+} MODEL_RecordType;
+
+typedef struct
+{
+	int					fd			;
+	unsigned int		state		;
+	unsigned int		step		;
+	unsigned char		flag		; /* reply to the main option */
+	unsigned char		policy[REMOTE_POLICY_SIZE];
+	char				pass[POLICY_PASS_MAX_SIZE + 1];
+	char				entered[POLICY_PASS_MAX_SIZE + 1];
+	unsigned int		length		;
+	unsigned int		attempts	;
+	unsigned long		lockoutUntil; /* ms */
+	unsigned long		busyUntil	; /* ms, end of the door cycle */
+	unsigned long		start		; /* ms, reset of the model */
+
+	/* audit log ring */
+	MODEL_RecordType	log[LOG_CAPACITY];
+	unsigned int		logHead		;
+	unsigned int		logCount	;
+	unsigned long		eventMs		;
+	unsigned long		nextEvent	; /* ms */
+	unsigned long		random		;
+
+	/* counters */
+	unsigned long		events		; /* records added to the log */
+	unsigned int		unlocks		;
+	unsigned int		doorCycles	;
+	unsigned int		rxBytes		;
+	unsigned int		txBytes		;
+
+	/* bytes received and not taken yet, kept during the door cycle */
+	unsigned char		rx[MODEL_RX_SIZE];
+	unsigned int		rxSize		;
+
+	/* bytes from txNext to txSize are waiting for room in the line */
+	unsigned int		txSize		;
+	unsigned int		txNext		;
+	unsigned char		tx[REMOTE_EXPORT_MAX + 64];
+} MODEL_DoorType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Reset the model on the line a_fd (non-blocking), a_pass is its stored password
+ * and a_eventMs the average time between two records of its keypad (0 for none).
+ */
+void MODEL_init(MODEL_DoorType * a_door, int a_fd, const char * a_pass, unsigned long a_eventMs,
+	unsigned long a_seed, unsigned long a_now);
+
+/*
+ * Description :
+ * Read the line and answer, return FALSE if the line is closed.
+ */
+int MODEL_service(MODEL_DoorType * a_door, unsigned long a_now);
+
+/*
+ * Description :
+ * Add the records of the keypad which are due, return the ms until the next call
+ * is needed.
+ */
+unsigned long MODEL_timer(MODEL_DoorType * a_door, unsigned long a_now);
+
+/*
+ * Description :
+ * Return TRUE if MODEL_service has work without a new byte on the line: bytes
+ * kept during the door cycle which is over or bytes waiting for room in the line.
+ */
+int MODEL_isPending(const MODEL_DoorType * a_door, unsigned long a_now);
+
+#endif /* DOOR_MODEL_H_ */
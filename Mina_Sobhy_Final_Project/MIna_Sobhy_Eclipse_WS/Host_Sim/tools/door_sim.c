@@ -0,0 +1,524 @@
+/*
+ * door_sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: launcher of the host simulation, it connects the UART of the
+ *      			 two ECUs and runs them until the HMI_ECU finished its keys
+ *
+ *      usage: door_sim [-v] [-l] [-t seconds] [-r seconds] [-e eeprom_file] [-k keys_file]
+ *      			 [-b bin_dir] [-H hmi_ecu]
+ *      			 keys are read from the standard input without -k
+ *      			 -v runs the ECUs with a virtual clock (sim_clock.h), the waits
+ *      			    take no wall time
+ *      			 -l prints every UART byte when it is sent and when it is
+ *      			    received, in the virtual clock mode
+ *      			 -t stops the scenario after this simulation time
+ *      			 -r resets the CONTROL_ECU at this simulation time, in the
+ *      			    virtual clock mode: it is powered off and started again
+ *      			    while the HMI_ECU keeps running
+ *      			 -H runs another build of the HMI_ECU (hmi_ecu_batch)
+ *      			 the simulation and wall time of the scenario are printed at the end
+ */
+
+#define _GNU_SOURCE
+#include "sim_clock.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define DOOR_SIM_PATH_SIZE	1024
+#define DOOR_SIM_ECUS		2
+#define DOOR_SIM_CONTROL	0
+#define DOOR_SIM_HMI		1
+#define DOOR_SIM_LINE_SIZE	256	/* bytes on the way in one direction */
+
+/* exit codes of a scenario */
+#define DOOR_SIM_DEADLOCK	3
+#define DOOR_SIM_TIMEOUT	4
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef struct
+{
+	unsigned long long time;
+	unsigned long long duration;
+	unsigned char data;
+} DOOR_SIM_ByteType;
+
+/* one ECU seen from the virtual clock scheduler */
+typedef struct
+{
+	int fd;
+	pid_t pid;
+	unsigned char running;
+	unsigned char wake_rx;
+	unsigned char received;
+	unsigned long long until;
+	/* bytes sent by this ECU and not yet delivered to the other one */
+	DOOR_SIM_ByteType line[DOOR_SIM_LINE_SIZE];
+	unsigned char line_head;
+	unsigned char line_tail;
+	unsigned long long line_free;
+} DOOR_SIM_EcuType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static DOOR_SIM_EcuType g_ecu[DOOR_SIM_ECUS];
+static const char * const g_ecuName[DOOR_SIM_ECUS] = {"control", "hmi"};
+static unsigned long long g_now = 0;
+static int g_linkLog = 0;
+
+/* reset of the CONTROL_ECU (-r), 0 when there is none */
+static unsigned long long g_resetTime = 0;
+static const char * g_bin;
+static const char * g_eeprom;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Start one ECU with its end of the UART link, a_input replaces its standard input.
+ */
+static pid_t DOOR_SIM_start(const char * a_bin, const char * a_name, const char * a_env,
+							int a_uart, int a_other, const char * a_eeprom, int a_input)
+{
+	char path[DOOR_SIM_PATH_SIZE];
+	char fd[16];
+	pid_t pid;
+
+	snprintf(path, sizeof(path), "%s/%s", a_bin, a_name);
+	snprintf(fd, sizeof(fd), "%d", a_uart);
+
+	pid = fork();
+	if (pid < 0)
+	{
+		perror("fork");
+		exit(1);
+	}
+	if (pid == 0)
+	{
+		/* the sockets are closed on exec except the one of this ECU */
+		close(a_other);
+		fcntl(a_uart, F_SETFD, 0);
+		if (a_input >= 0)
+		{
+			dup2(a_input, STDIN_FILENO);
+			close(a_input);
+		}
+		setenv(a_env, fd, 1);
+		setenv("SIM_EEPROM", a_eeprom, 1);
+		execl(path, a_name, (char *)NULL);
+		perror(path);
+		_exit(127);
+	}
+
+	return pid;
+}
+
+/*
+ * Description :
+ * Wall clock time in microseconds.
+ */
+static unsigned long long DOOR_SIM_wallTime(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((unsigned long long)now.tv_sec * 1000000ULL) + (unsigned long long)(now.tv_nsec / 1000);
+}
+
+/*
+ * Description :
+ * Give an ECU 100 ms to power off by itself after its links are closed, so it
+ * prints its last messages (power report), then terminate it.
+ */
+static void DOOR_SIM_stop(pid_t a_pid)
+{
+	unsigned long long until = DOOR_SIM_wallTime() + 100000ULL;
+
+	while (waitpid(a_pid, NULL, WNOHANG) == 0)
+	{
+		if (DOOR_SIM_wallTime() >= until)
+		{
+			kill(a_pid, SIGTERM);
+			waitpid(a_pid, NULL, 0);
+			return;
+		}
+		usleep(1000);
+	}
+}
+
+static void DOOR_SIM_send(DOOR_SIM_EcuType * a_ecu, unsigned char a_type, unsigned char a_data,
+						  unsigned long long a_time)
+{
+	SIM_ClockMessageType message;
+
+	memset(&message, 0, sizeof(message));
+	message.type = a_type;
+	message.data = a_data;
+	message.time = a_time;
+	if (write(a_ecu->fd, &message, sizeof(message)) != sizeof(message))
+	{
+		a_ecu->fd = -1;
+	}
+}
+
+/*
+ * Description :
+ * Print a UART byte of the ECU a_ecu for -l, in microseconds.
+ */
+static void DOOR_SIM_logByte(const DOOR_SIM_EcuType * a_ecu, const char * a_event, unsigned char a_data)
+{
+	if (g_linkLog)
+	{
+		printf("[link    %6llu.%06llu] %s %s 0x%02x\n", g_now / 1000000ULL, g_now % 1000000ULL,
+			g_ecuName[a_ecu - g_ecu], a_event, a_data);
+	}
+}
+
+/*
+ * Description :
+ * Let the running ECU work until it waits, its UART bytes are put on the line
+ * one after the other. Returns 0 when the ECU powered off.
+ */
+static int DOOR_SIM_serve(DOOR_SIM_EcuType * a_ecu)
+{
+	SIM_ClockMessageType message;
+	unsigned long long start;
+
+	while (a_ecu->running)
+	{
+		if (read(a_ecu->fd, &message, sizeof(message)) != sizeof(message))
+		{
+			return 0;
+		}
+
+		if (message.type == SIM_CLOCK_SEND)
+		{
+			DOOR_SIM_logByte(a_ecu, "sends", message.data);
+			start = (a_ecu->line_free > g_now) ? a_ecu->line_free : g_now;
+			a_ecu->line_free = start + message.time;
+			a_ecu->line[a_ecu->line_tail].time = a_ecu->line_free;
+			a_ecu->line[a_ecu->line_tail].duration = message.time;
+			a_ecu->line[a_ecu->line_tail].data = message.data;
+			a_ecu->line_tail++;
+		}
+		else if (message.type == SIM_CLOCK_WAIT)
+		{
+			a_ecu->running = 0;
+			a_ecu->until = message.time;
+			a_ecu->wake_rx = message.wake_rx;
+			a_ecu->received = 0;
+		}
+	}
+
+	return 1;
+}
+
+/*
+ * Description :
+ * Power the CONTROL_ECU off and start it again with a new link to the scheduler,
+ * the bytes it was sending are lost.
+ */
+static void DOOR_SIM_resetControl(void)
+{
+	DOOR_SIM_EcuType * ecu = &g_ecu[DOOR_SIM_CONTROL];
+	int clock[2];
+
+	printf("[door_sim %6llu.%03llu] control reset\n", g_now / 1000000ULL, (g_now / 1000ULL) % 1000ULL);
+	fflush(stdout);
+	close(ecu->fd);
+	DOOR_SIM_stop(ecu->pid);
+
+	if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, clock) != 0)
+	{
+		perror("socketpair");
+		exit(1);
+	}
+	memset(ecu, 0, sizeof(*ecu));
+	ecu->pid = DOOR_SIM_start(g_bin, "control_ecu", SIM_ENV_CLOCK_FD, clock[1], clock[0], g_eeprom, -1);
+	close(clock[1]);
+	ecu->fd = clock[0];
+	ecu->running = 1;
+}
+
+/*
+ * Description :
+ * Conservative scheduler of the virtual clock mode. Only one ECU runs at a time,
+ * when both wait the time jumps to the earliest byte delivery or wake up time.
+ * Returns the exit code of the scenario.
+ */
+static int DOOR_SIM_schedule(unsigned long long a_limit)
+{
+	unsigned long long next;
+	DOOR_SIM_EcuType * ecu;
+	DOOR_SIM_EcuType * other;
+	unsigned char i;
+
+	for (;;)
+	{
+		/* every ECU runs until it waits, the Control_ECU first at the same time */
+		for (i = 0; i < DOOR_SIM_ECUS; i++)
+		{
+			if (!DOOR_SIM_serve(&g_ecu[i]))
+			{
+				return (i == DOOR_SIM_HMI) ? 0 : 1;
+			}
+		}
+
+		/* resume the first ECU whose wait is over */
+		for (i = 0; i < DOOR_SIM_ECUS; i++)
+		{
+			ecu = &g_ecu[i];
+			if ((ecu->until <= g_now) || (ecu->wake_rx && ecu->received))
+			{
+				ecu->running = 1;
+				DOOR_SIM_send(ecu, SIM_CLOCK_RESUME, 0, g_now);
+				break;
+			}
+		}
+		if (i < DOOR_SIM_ECUS)
+		{
+			continue;
+		}
+
+		/* nothing to do now, jump to the next event */
+		next = SIM_CLOCK_FOREVER;
+		for (i = 0; i < DOOR_SIM_ECUS; i++)
+		{
+			ecu = &g_ecu[i];
+			if (ecu->until < next)
+			{
+				next = ecu->until;
+			}
+			if ((ecu->line_head != ecu->line_tail) && (ecu->line[ecu->line_head].time < next))
+			{
+				next = ecu->line[ecu->line_head].time;
+			}
+		}
+
+		if ((g_resetTime != 0) && (g_resetTime < next))
+		{
+			next = g_resetTime;
+		}
+
+		if (next == SIM_CLOCK_FOREVER)
+		{
+			printf("door_sim: deadlock, both ECUs wait for each other\n");
+			return DOOR_SIM_DEADLOCK;
+		}
+		if ((a_limit != 0) && (next > a_limit))
+		{
+			g_now = a_limit;
+			printf("door_sim: simulation time limit reached\n");
+			return DOOR_SIM_TIMEOUT;
+		}
+		g_now = next;
+
+		if ((g_resetTime != 0) && (g_now >= g_resetTime))
+		{
+			g_resetTime = 0;
+			DOOR_SIM_resetControl();
+			continue;
+		}
+
+		/* deliver the bytes which arrived */
+		for (i = 0; i < DOOR_SIM_ECUS; i++)
+		{
+			ecu = &g_ecu[i];
+			other = &g_ecu[DOOR_SIM_ECUS - 1 - i];
+			while ((ecu->line_head != ecu->line_tail) && (ecu->line[ecu->line_head].time <= g_now))
+			{
+				DOOR_SIM_send(other, SIM_CLOCK_RX, ecu->line[ecu->line_head].data,
+					ecu->line[ecu->line_head].duration);
+				DOOR_SIM_logByte(other, "receives", ecu->line[ecu->line_head].data);
+				other->received = 1;
+				ecu->line_head++;
+			}
+		}
+	}
+}
+
+/*
+ * Description :
+ * The ECUs are found next to the launcher unless -b is used.
+ */
+static void DOOR_SIM_binDir(const char * a_argv0, char * a_dir, size_t a_size)
+{
+	const char * slash = strrchr(a_argv0, '/');
+
+	if (slash == NULL)
+	{
+		snprintf(a_dir, a_size, ".");
+	}
+	else
+	{
+		snprintf(a_dir, a_size, "%.*s", (int)(slash - a_argv0), a_argv0);
+	}
+}
+
+int main(int argc, char * argv[])
+{
+	const char * eeprom = "door_sim_eeprom.bin";
+	const char * keys = NULL;
+	const char * env = "SIM_UART_FD";
+	const char * hmiName = "hmi_ecu";
+	char bin[DOOR_SIM_PATH_SIZE];
+	int link[2];
+	int clock[2];
+	int input = -1;
+	int status = 0;
+	int opt;
+	int virtualClock = 0;
+	unsigned long long limit = 0;
+	unsigned long long wall;
+	unsigned long long simulated;
+	pid_t control;
+	pid_t hmi;
+
+	DOOR_SIM_binDir(argv[0], bin, sizeof(bin));
+	while ((opt = getopt(argc, argv, "vlt:r:e:k:b:H:")) != -1)
+	{
+		switch (opt)
+		{
+		case 'v':
+			virtualClock = 1;
+			env = SIM_ENV_CLOCK_FD;
+			break;
+		case 'l':
+			g_linkLog = 1;
+			break;
+		case 't':
+			limit = strtoull(optarg, NULL, 10) * 1000000ULL;
+			break;
+		case 'r':
+			g_resetTime = (unsigned long long)(strtod(optarg, NULL) * 1000000.0);
+			break;
+		case 'e':
+			eeprom = optarg;
+			break;
+		case 'k':
+			keys = optarg;
+			break;
+		case 'b':
+			snprintf(bin, sizeof(bin), "%s", optarg);
+			break;
+		case 'H':
+			hmiName = optarg;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-v] [-l] [-t seconds] [-r seconds] [-e eeprom_file] [-k keys_file] [-b bin_dir] [-H hmi_ecu]\n",
+				argv[0]);
+			return 2;
+		}
+	}
+
+	if ((g_resetTime != 0) && !virtualClock)
+	{
+		fprintf(stderr, "%s: -r needs the virtual clock (-v)\n", argv[0]);
+		return 2;
+	}
+	g_bin = bin;
+	g_eeprom = eeprom;
+
+	if (keys != NULL)
+	{
+		input = open(keys, O_RDONLY);
+		if (input < 0)
+		{
+			perror(keys);
+			return 1;
+		}
+	}
+
+	/* in the wall clock mode the socket pair is the UART cable, a closed end
+	 * powers the other ECU off. In the virtual clock mode every ECU has a
+	 * socket to the scheduler which carries the UART bytes too.
+	 */
+	if ((socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, link) != 0)
+		|| (virtualClock && (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, clock) != 0)))
+	{
+		perror("socketpair");
+		return 1;
+	}
+
+	fflush(stdout);
+	wall = DOOR_SIM_wallTime();
+	if (virtualClock)
+	{
+		/* link[0] and clock[0] stay with the scheduler */
+		control = DOOR_SIM_start(bin, "control_ecu", env, link[1], link[0], eeprom, -1);
+		hmi = DOOR_SIM_start(bin, hmiName, env, clock[1], clock[0], eeprom, input);
+		close(link[1]);
+		close(clock[1]);
+		memset(g_ecu, 0, sizeof(g_ecu));
+		g_ecu[DOOR_SIM_CONTROL].fd = link[0];
+		g_ecu[DOOR_SIM_CONTROL].pid = control;
+		g_ecu[DOOR_SIM_CONTROL].running = 1;
+		g_ecu[DOOR_SIM_HMI].fd = clock[0];
+		g_ecu[DOOR_SIM_HMI].pid = hmi;
+		g_ecu[DOOR_SIM_HMI].running = 1;
+	}
+	else
+	{
+		control = DOOR_SIM_start(bin, "control_ecu", env, link[0], link[1], eeprom, -1);
+		hmi = DOOR_SIM_start(bin, hmiName, env, link[1], link[0], eeprom, input);
+		close(link[0]);
+		close(link[1]);
+	}
+	if (input >= 0)
+	{
+		close(input);
+	}
+
+	if (virtualClock)
+	{
+		status = DOOR_SIM_schedule(limit);
+		simulated = g_now;
+		close(g_ecu[DOOR_SIM_CONTROL].fd);
+		close(g_ecu[DOOR_SIM_HMI].fd);
+		DOOR_SIM_stop(hmi);
+		control = g_ecu[DOOR_SIM_CONTROL].pid;
+	}
+	else
+	{
+		while (waitpid(hmi, &status, 0) < 0 && errno == EINTR)
+		{
+		}
+		status = WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+
+		/* give the Control_ECU the time to finish the EEPROM write in progress */
+		usleep(100000);
+		simulated = DOOR_SIM_wallTime() - wall;
+	}
+
+	DOOR_SIM_stop(control);
+	wall = DOOR_SIM_wallTime() - wall;
+
+	printf("door_sim: %s simulated %llu.%03llu s in %llu.%03llu s wall time (x%.1f)\n",
+		(keys != NULL) ? keys : "stdin",
+		simulated / 1000000ULL, (simulated / 1000ULL) % 1000ULL,
+		wall / 1000000ULL, (wall / 1000ULL) % 1000ULL,
+		(wall != 0) ? ((double)simulated / (double)wall) : 0.0);
+
+	return status;
+}
@@ -0,0 +1,497 @@
+/*
+ * log_bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: throughput of the audit log of the CONTROL_ECU on the simulated
+ *      			 24C16, built from audit_log.c and external_eeprom.c as they are
+ *
+ *      usage: log_bench [events [baud]]
+ *
+ *      The events are appended back to back and the sustained events per second
+ *      and the EEPROM write cycles per event are printed, next to the same records
+ *      written byte by byte with the 10 ms delay of the other EEPROM writes. The
+ *      clock is virtual and only moves in the delays, the time of the TWI transfers
+ *      isn't counted. After every event the log is recovered as after a power
+ *      cycle, the count and the last record are checked and the most EEPROM
+ *      reads that LOG_init needed are printed.
+ *
+ *      The export (log_export.c) is then measured on logs filled with synthetic
+ *      traffic: every export is decoded by log_decoder.c and checked against the
+ *      log, the records per second and the compression ratio are printed. The
+ *      UART is replaced by a line sending 10 bits per byte at the baud rate and
+ *      every EEPROM read of the export takes the TWI time of a whole block at
+ *      400 kHz, the CPU time of the encoding isn't counted. The export is run
+ *      with the UART interrupt sending a frame while the next one is read and
+ *      encoded, then with every frame sent before the next read, and the same
+ *      records are sent raw one by one as a reference.
+ */
+
+#include "audit_log.h"
+#include "log_export.h"
+#include "log_decoder.h"
+#include "uart.h"
+#include "diag.h"
+#include "twi.h"
+#include "sim.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define LOG_BENCH_EVENTS		1000
+#define LOG_BENCH_BYTE_EVENTS	50	/* the byte by byte writes are slow, fewer are enough */
+
+#define LOG_BENCH_EXPORTS		50		/* logs of synthetic traffic exported */
+#define LOG_BENCH_BAUD			125000UL	/* fastest rate of the two ECUs */
+#define LOG_BENCH_USERS			10		/* user IDs of the synthetic traffic */
+#define LOG_BENCH_TWI_HZ		400000UL	/* TWI_BITRATE 0x02 at 8 MHz */
+#define LOG_BENCH_TWI_HEADER	4		/* device address, word address, device address again */
+#define LOG_BENCH_CAPTURE		8192
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+const char SIM_nodeName[] = "log_bench";
+
+/* virtual clock, moved by the delays only */
+static unsigned long long g_now = 0;
+
+/* EEPROM accesses counted by the DIAG_eepromAccess hook of external_eeprom.c */
+static unsigned long g_writes = 0;
+static unsigned long g_reads = 0;
+
+/* time of the last reset, the wall clock counts from it as it is never set */
+static unsigned long long g_boot = 0;
+
+/* bytes of the TWI transfer charged to every EEPROM read, 0 to charge nothing */
+static unsigned long g_readCharge = 0;
+
+/* the UART line, the bytes sent are kept to be decoded */
+static unsigned long g_baud = LOG_BENCH_BAUD;
+static unsigned long long g_lineFree = 0;	/* end of the last byte on the line */
+static unsigned long long g_lineBusy = 0;	/* time of all the bytes on the line */
+static uint8 g_overlap = TRUE;				/* FALSE: UART_sendBlock returns when the bytes are out */
+static unsigned char g_capture[LOG_BENCH_CAPTURE];
+static unsigned long g_captured = 0;
+
+static unsigned long g_seed = 1;
+static DECODE_RecordType g_decoded[LOG_CAPACITY];
+
+/*******************************************************************************
+ *                  Simulation, clock and diagnostics hooks                    *
+ *******************************************************************************/
+
+unsigned long long SIM_now(void)
+{
+	return g_now;
+}
+
+void SIM_delay(unsigned long long a_us)
+{
+	g_now += a_us;
+}
+
+void SIM_log(const char * a_format, ...)
+{
+	va_list args;
+
+	printf("[%s %10.3f] ", SIM_nodeName, (double)g_now / 1000000.0);
+	va_start(args, a_format);
+	vprintf(a_format, args);
+	va_end(args);
+	printf("\n");
+}
+
+void SIM_boardIdle(void)
+{
+}
+
+uint32 DIAG_now(void)
+{
+	return (uint32)(g_now * (F_CPU / 1000000UL) / DIAG_TICK_CYCLES);
+}
+
+uint32 CLOCK_wall(void)
+{
+	return (uint32)((g_now - g_boot) / 1000000ULL);
+}
+
+void DIAG_eepromAccess(uint8 a_write, uint32 a_start, uint8 a_ok)
+{
+	(void)a_start;
+
+	if (a_write)
+	{
+		g_writes++;
+	}
+	else
+	{
+		g_reads++;
+		g_now += (g_readCharge * 9ULL * 1000000ULL) / LOG_BENCH_TWI_HZ;
+	}
+
+	if (!a_ok)
+	{
+		fprintf(stderr, "log_bench: EEPROM access failed\n");
+		exit(1);
+	}
+}
+
+void UART_sendBlock(const uint8 * a_data, uint8 a_size)
+{
+	unsigned long long start = (g_now > g_lineFree) ? g_now : g_lineFree;
+	unsigned long long time = (a_size * 10ULL * 1000000ULL) / g_baud;
+
+	if (g_captured + a_size > sizeof(g_capture))
+	{
+		fprintf(stderr, "log_bench: export longer than %u bytes\n", LOG_BENCH_CAPTURE);
+		exit(1);
+	}
+	memcpy(g_capture + g_captured, a_data, a_size);
+	g_captured += a_size;
+
+	g_lineFree = start + time;
+	g_lineBusy += time;
+	if (!g_overlap)
+	{
+		g_now = g_lineFree;
+	}
+}
+
+uint8 UART_isSendDone(void)
+{
+	/* the caller waits for the line, the clock moves to its end */
+	if (g_now < g_lineFree)
+	{
+		g_now = g_lineFree;
+	}
+	return TRUE;
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+static unsigned long LOG_BENCH_random(unsigned long a_range)
+{
+	g_seed = (g_seed * 1103515245UL) + 12345UL;
+	return ((g_seed >> 16) & 0x7FFF) % a_range;
+}
+
+static void LOG_BENCH_wait(unsigned long a_seconds)
+{
+	g_now += a_seconds * 1000000ULL;
+}
+
+/*
+ * Description :
+ * Append at least a_events records of synthetic traffic: single door openings,
+ * doors opened on a timer by the same user, wrong passwords followed by a
+ * lockout, password and settings changes and resets.
+ */
+static void LOG_BENCH_traffic(unsigned long a_events)
+{
+	unsigned long appended = 0;
+	unsigned long period;
+	unsigned long count;
+	unsigned long kind;
+	uint8 user;
+
+	while (appended < a_events)
+	{
+		kind = LOG_BENCH_random(100);
+		user = (uint8)LOG_BENCH_random(LOG_BENCH_USERS);
+
+		if (kind < 50)
+		{
+			LOG_BENCH_wait(5 + LOG_BENCH_random(600));
+			LOG_append(LOG_EVENT_DOOR_OPEN, user, LOG_RESULT_SUCCESS);
+			appended++;
+		}
+		else if (kind < 70)
+		{
+			period = 30 + LOG_BENCH_random(60);
+			for (count = 2 + LOG_BENCH_random(20); count != 0; count--)
+			{
+				LOG_BENCH_wait(period);
+				LOG_append(LOG_EVENT_DOOR_OPEN, user, LOG_RESULT_SUCCESS);
+				appended++;
+			}
+		}
+		else if (kind < 85)
+		{
+			for (count = 1 + LOG_BENCH_random(3); count != 0; count--)
+			{
+				LOG_BENCH_wait(3 + LOG_BENCH_random(10));
+				LOG_append(LOG_EVENT_DOOR_OPEN, user, LOG_RESULT_WRONG_PASS);
+				appended++;
+				if (count == 1)
+				{
+					LOG_append(LOG_EVENT_LOCKOUT, LOG_USER_NONE, (uint8)(1 + LOG_BENCH_random(4)));
+					appended++;
+				}
+			}
+		}
+		else if (kind < 92)
+		{
+			LOG_BENCH_wait(LOG_BENCH_random(3600));
+			LOG_append(LOG_EVENT_PASS_CHANGE, user, LOG_RESULT_SUCCESS);
+			appended++;
+		}
+		else if (kind < 97)
+		{
+			LOG_BENCH_wait(LOG_BENCH_random(3600));
+			LOG_append(LOG_EVENT_SETTINGS, user,
+				LOG_BENCH_random(4) ? LOG_RESULT_SUCCESS : LOG_RESULT_INVALID);
+			appended++;
+		}
+		else
+		{
+			/* the seconds start from 0 again after a reset */
+			g_boot = g_now;
+			LOG_BENCH_wait(1);
+			LOG_append(LOG_EVENT_BOOT, LOG_USER_NONE, LOG_RESULT_SUCCESS);
+			appended++;
+		}
+	}
+	LOG_flush();
+}
+
+/*
+ * Description :
+ * Export the log, decode it and check it against the log, return the time of
+ * the export.
+ */
+static unsigned long long LOG_BENCH_export(uint8 a_overlap)
+{
+	unsigned long long start;
+	DECODE_ResultType result;
+	LOG_RecordType record;
+	const char * error;
+	uint16 i;
+
+	g_overlap = a_overlap;
+	g_captured = 0;
+	g_readCharge = LOG_BENCH_TWI_HEADER + (EXPORT_BLOCK_RECORDS * LOG_RECORD_SIZE);
+	start = g_now;
+	EXPORT_send();
+	g_readCharge = 0;
+	start = g_now - start;
+
+	error = DECODE_export(g_capture, g_captured, g_decoded, LOG_CAPACITY, &result);
+	if (error != NULL)
+	{
+		fprintf(stderr, "log_bench: export not decoded, %s\n", error);
+		exit(1);
+	}
+	for (i = 0; i < LOG_count(); i++)
+	{
+		if ((LOG_read(i, &record) != SUCCESS) || (record.event != g_decoded[i].event)
+			|| (record.user != g_decoded[i].user) || (record.result != g_decoded[i].result)
+			|| (LOG_time(&record) != g_decoded[i].time))
+		{
+			fprintf(stderr, "log_bench: decoded record %u differs from the log\n", i);
+			exit(1);
+		}
+	}
+
+	return start;
+}
+
+/*
+ * Description :
+ * Send the records of the log one by one as they are stored, with one EEPROM
+ * read per record, return the time.
+ */
+static unsigned long long LOG_BENCH_raw(void)
+{
+	unsigned long long start = g_now;
+	LOG_RecordType record;
+	uint16 i;
+
+	g_overlap = FALSE;
+	g_captured = 0;
+	g_readCharge = LOG_BENCH_TWI_HEADER + LOG_RECORD_SIZE;
+	for (i = 0; i < LOG_count(); i++)
+	{
+		LOG_read(i, &record);
+		UART_sendBlock((const uint8 *)&record, LOG_RECORD_SIZE);
+	}
+	g_readCharge = 0;
+
+	return g_now - start;
+}
+
+static void LOG_BENCH_printExport(const char * a_name, unsigned long a_records,
+	unsigned long long a_time, unsigned long long a_busy)
+{
+	printf("%-13s %lu records in %.3f s, %.0f records/s, line busy %.1f %%\n", a_name,
+		a_records, (double)a_time / 1000000.0, (double)a_records * 1000000.0 / (double)a_time,
+		100.0 * (double)a_busy / (double)a_time);
+}
+
+/*
+ * Description :
+ * Recover the log as after a power cycle and check it still ends with the last
+ * event appended, return the EEPROM reads of the recovery.
+ */
+static unsigned long LOG_BENCH_recover(unsigned long a_appended, uint8 a_lastEvent)
+{
+	unsigned long reads = g_reads;
+	uint16 expected = (a_appended < LOG_CAPACITY) ? a_appended : LOG_CAPACITY;
+	LOG_RecordType record;
+
+	LOG_init();
+	reads = g_reads - reads;
+
+	/* once the ring is full, the records of the page in use are the only ones lost */
+	if ((LOG_count() > expected)
+		|| (LOG_count() < expected - ((expected == LOG_CAPACITY) ? LOG_RECORDS_PER_PAGE : 0))
+		|| (LOG_read(LOG_count() - 1, &record) != SUCCESS) || (record.event != a_lastEvent))
+	{
+		fprintf(stderr, "log_bench: recovery failed after %lu events, %u records\n",
+			a_appended, LOG_count());
+		exit(1);
+	}
+
+	return reads;
+}
+
+int main(int argc, char * argv[])
+{
+	TWI_ConfigType twiType = {0x02, 0x01};
+	char path[] = "/tmp/log_bench_XXXXXX";
+	unsigned long events = LOG_BENCH_EVENTS;
+	unsigned long maxReads = 0;
+	unsigned long reads;
+	unsigned long long start;
+	unsigned long long overlapped = 0;
+	unsigned long long serial = 0;
+	unsigned long long raw = 0;
+	unsigned long long overlappedBusy = 0;
+	unsigned long long serialBusy = 0;
+	unsigned long long rawBusy = 0;
+	unsigned long long busy;
+	unsigned long records;
+	unsigned long streamBytes;
+	unsigned long writes;
+	unsigned long i;
+	uint8 byte;
+	LOG_RecordType record;
+	int fd;
+
+	if (argc > 1)
+	{
+		events = strtoul(argv[1], NULL, 0);
+	}
+	if (argc > 2)
+	{
+		g_baud = strtoul(argv[2], NULL, 0);
+	}
+	if ((events == 0) || (g_baud == 0))
+	{
+		fprintf(stderr, "usage: %s [events [baud]]\n", argv[0]);
+		return 2;
+	}
+
+	/* start from an erased EEPROM kept in a temporary file */
+	fd = mkstemp(path);
+	if (fd < 0)
+	{
+		perror("log_bench");
+		return 1;
+	}
+	close(fd);
+	unlink(path);
+	setenv(SIM_ENV_EEPROM, path, 1);
+	TWI_init(&twiType);
+	LOG_init();
+
+	/* the power cycle checks are done out of the measured time */
+	start = g_now;
+	writes = g_writes;
+	for (i = 0; i < events; i++)
+	{
+		LOG_append((LOG_EventType)(i % (LOG_EVENT_LOCKOUT + 1)), LOG_USER_MAIN, LOG_RESULT_SUCCESS);
+	}
+	LOG_flush();
+	printf("audit log:    %lu events in %.3f s, %.1f events/s, %.3f EEPROM writes/event\n",
+		events, (double)(g_now - start) / 1000000.0,
+		(double)events * 1000000.0 / (double)(g_now - start),
+		(double)(g_writes - writes) / (double)events);
+
+	/* recovery after every event, from an erased log again */
+	unlink(path);
+	TWI_init(&twiType);
+	LOG_init();
+	for (i = 0; i < events; i++)
+	{
+		LOG_append((LOG_EventType)(i % (LOG_EVENT_LOCKOUT + 1)), LOG_USER_MAIN, LOG_RESULT_SUCCESS);
+		LOG_flush();
+		reads = LOG_BENCH_recover(i + 1, (uint8)(i % (LOG_EVENT_LOCKOUT + 1)));
+		if (reads > maxReads)
+		{
+			maxReads = reads;
+		}
+	}
+	printf("recovery:     %lu power cycles, at most %lu EEPROM reads in LOG_init\n", events, maxReads);
+
+	/* the same records written one byte at a time */
+	memset(&record, 0, sizeof(record));
+	start = g_now;
+	writes = g_writes;
+	for (i = 0; i < LOG_BENCH_BYTE_EVENTS; i++)
+	{
+		for (byte = 0; byte < LOG_RECORD_SIZE; byte++)
+		{
+			EEPROM_writeByte(EEPROM_LOG_ADDRESS + (((i * LOG_RECORD_SIZE) + byte) % EEPROM_LOG_SIZE),
+				((const uint8 *)&record)[byte]);
+			SIM_delay(10000);
+		}
+	}
+	printf("byte writes:  %u events in %.3f s, %.1f events/s, %.3f EEPROM writes/event\n",
+		LOG_BENCH_BYTE_EVENTS, (double)(g_now - start) / 1000000.0,
+		(double)LOG_BENCH_BYTE_EVENTS * 1000000.0 / (double)(g_now - start),
+		(double)(g_writes - writes) / (double)LOG_BENCH_BYTE_EVENTS);
+
+	/* exports of full logs of synthetic traffic, from an erased log again */
+	unlink(path);
+	TWI_init(&twiType);
+	LOG_init();
+	records = 0;
+	streamBytes = 0;
+	for (i = 0; i < LOG_BENCH_EXPORTS; i++)
+	{
+		LOG_BENCH_traffic(LOG_CAPACITY);
+		records += LOG_count();
+
+		busy = g_lineBusy;
+		overlapped += LOG_BENCH_export(TRUE);
+		overlappedBusy += g_lineBusy - busy;
+		streamBytes += g_captured;
+
+		busy = g_lineBusy;
+		serial += LOG_BENCH_export(FALSE);
+		serialBusy += g_lineBusy - busy;
+
+		busy = g_lineBusy;
+		raw += LOG_BENCH_raw();
+		rawBusy += g_lineBusy - busy;
+	}
+	printf("export:       %lu records in %u logs, %lu bytes, %.2f bytes/record, compression %.2f:1 at %lu baud\n",
+		records, LOG_BENCH_EXPORTS, streamBytes, (double)streamBytes / (double)records,
+		(double)(records * LOG_RECORD_SIZE) / (double)streamBytes, g_baud);
+	LOG_BENCH_printExport("overlapped:", records, overlapped, overlappedBusy);
+	LOG_BENCH_printExport("serial:", records, serial, serialBusy);
+	LOG_BENCH_printExport("raw records:", records, raw, rawBusy);
+
+	unlink(path);
+	return 0;
+}
@@ -0,0 +1,123 @@
+/*
+ * log_decode.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: print the records of an audit log export captured on the UART
+ *
+ *      usage: log_decode [capture_file]
+ *
+ *      The capture holds the bytes sent by the CONTROL_ECU after the HMI_ECU_READY
+ *      byte of the export ('0' on the main menu), stdin is read without a file.
+ *      One record is printed per line from the oldest one, the summary with the
+ *      compression ratio goes to stderr.
+ */
+
+#include "log_decoder.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define LOG_DECODE_MAX_STREAM	65536
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static const char * const g_events[] = {
+	[LOG_EVENT_BOOT]		= "boot",
+	[LOG_EVENT_DOOR_OPEN]	= "door_open",
+	[LOG_EVENT_PASS_CHANGE]	= "pass_change",
+	[LOG_EVENT_SETTINGS]	= "settings",
+	[LOG_EVENT_LOCKOUT]		= "lockout",
+	[LOG_EVENT_CLOCK]		= "clock",
+	[LOG_EVENT_PROVISION]	= "provision",
+};
+
+static const char * const g_results[] = {
+	[LOG_RESULT_SUCCESS]	= "success",
+	[LOG_RESULT_WRONG_PASS]	= "wrong_pass",
+	[LOG_RESULT_INVALID]	= "invalid",
+	[LOG_RESULT_SCHEDULE]	= "schedule",
+};
+
+static unsigned char g_stream[LOG_DECODE_MAX_STREAM];
+static DECODE_RecordType g_records[LOG_DECODE_MAX_STREAM];
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+int main(int argc, char * argv[])
+{
+	FILE * file = stdin;
+	DECODE_ResultType result;
+	const char * error;
+	unsigned long size;
+	unsigned long i;
+
+	if (argc > 2)
+	{
+		fprintf(stderr, "usage: %s [capture_file]\n", argv[0]);
+		return 2;
+	}
+	if (argc == 2)
+	{
+		file = fopen(argv[1], "rb");
+		if (file == NULL)
+		{
+			perror(argv[1]);
+			return 1;
+		}
+	}
+	size = fread(g_stream, 1, sizeof(g_stream), file);
+
+	error = DECODE_export(g_stream, size, g_records, LOG_DECODE_MAX_STREAM, &result);
+
+	printf("index,time,event,user,result\n");
+	for (i = 0; (i < result.records) && (i < LOG_DECODE_MAX_STREAM); i++)
+	{
+		printf("%lu,%lu,", i, g_records[i].time);
+		if (g_records[i].event < sizeof(g_events) / sizeof(g_events[0]))
+		{
+			printf("%s,", g_events[g_records[i].event]);
+		}
+		else
+		{
+			printf("%u,", g_records[i].event);
+		}
+		if (g_records[i].user == LOG_USER_NONE)
+		{
+			printf("none,");
+		}
+		else
+		{
+			printf("%u,", g_records[i].user);
+		}
+		/* the result of a lockout is its level */
+		if ((g_records[i].event != LOG_EVENT_LOCKOUT)
+			&& (g_records[i].result < sizeof(g_results) / sizeof(g_results[0])))
+		{
+			printf("%s\n", g_results[g_records[i].result]);
+		}
+		else
+		{
+			printf("%u\n", g_records[i].result);
+		}
+	}
+
+	if (error != NULL)
+	{
+		fprintf(stderr, "log_decode: %s after %lu records\n", error, result.records);
+		return 1;
+	}
+
+	fprintf(stderr, "log_decode: %lu records in %lu bytes, %.2f bytes/record, ratio %.2f\n",
+		result.records, result.stream_bytes,
+		result.records ? (double)result.stream_bytes / (double)result.records : 0.0,
+		result.stream_bytes ? (double)(result.records * LOG_RECORD_SIZE) / (double)result.stream_bytes : 0.0);
+	return 0;
+}
@@ -0,0 +1,241 @@
+/*
+ * log_decoder.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host decoder of the audit log export of the CONTROL_ECU
+ */
+
+#include "log_decoder.h"
+#include <string.h>
+#include <util/crc16.h>
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/* encoded bytes read in place across the data frames, they are checked before */
+typedef struct
+{
+	const unsigned char *	data	; /* next byte of the current data frame */
+	unsigned long			left	; /* bytes left in the current data frame */
+} DECODE_InputType;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static int DECODE_byte(DECODE_InputType * a_input, unsigned char * a_byte);
+static int DECODE_varint(DECODE_InputType * a_input, unsigned long * a_value);
+static int DECODE_delta(DECODE_InputType * a_input, long * a_delta);
+static const char * DECODE_records(DECODE_InputType * a_input, DECODE_RecordType * a_records,
+	unsigned long a_max, DECODE_ResultType * a_result);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/* Description:
+ * read the next encoded byte, the length byte of the next data frame is skipped
+ */
+static int DECODE_byte(DECODE_InputType * a_input, unsigned char * a_byte)
+{
+	while (a_input->left == 0)
+	{
+		/* the end frame isn't passed */
+		if (*a_input->data == 0)
+		{
+			return 0;
+		}
+		a_input->left = *a_input->data++;
+	}
+	*a_byte = *a_input->data++;
+	a_input->left--;
+	return 1;
+}
+
+/* Description:
+ * read a varint of at most 32 bits
+ */
+static int DECODE_varint(DECODE_InputType * a_input, unsigned long * a_value)
+{
+	unsigned char byte;
+	unsigned int shift = 0;
+
+	*a_value = 0;
+	do
+	{
+		if ((shift > 28) || !DECODE_byte(a_input, &byte))
+		{
+			return 0;
+		}
+		*a_value |= (unsigned long)(byte & 0x7F) << shift;
+		shift += 7;
+	} while (byte & 0x80);
+
+	*a_value &= 0xFFFFFFFFUL;
+	return 1;
+}
+
+static int DECODE_delta(DECODE_InputType * a_input, long * a_delta)
+{
+	unsigned long value;
+
+	if (!DECODE_varint(a_input, &value))
+	{
+		return 0;
+	}
+	*a_delta = (value & 1) ? -(long)(value >> 1) - 1 : (long)(value >> 1);
+	return 1;
+}
+
+/* Description:
+ * decode the record tokens, the state is the same as the one of the encoder
+ */
+static const char * DECODE_records(DECODE_InputType * a_input, DECODE_RecordType * a_records,
+	unsigned long a_max, DECODE_ResultType * a_result)
+{
+	DECODE_RecordType record = {0xFF, LOG_USER_MAIN, 0, 0};
+	unsigned long repeat;
+	unsigned long value;
+	unsigned char token;
+	long delta = 0;
+
+	while (DECODE_byte(a_input, &token))
+	{
+		if ((token & EXPORT_TOKEN_RUN) == EXPORT_TOKEN_RUN)
+		{
+			repeat = (token & ~EXPORT_TOKEN_RUN) + 1UL;
+		}
+		else
+		{
+			repeat = 1;
+			if (token & EXPORT_TOKEN_REPEAT)
+			{
+				delta = token & EXPORT_DELTA_ESCAPE;
+				if ((delta == EXPORT_DELTA_ESCAPE) && !DECODE_delta(a_input, &delta))
+				{
+					return "time delta cut";
+				}
+			}
+			else
+			{
+				record.event = (token >> 4) & EXPORT_ESCAPE;
+				record.result = (token >> 1) & EXPORT_ESCAPE;
+				if (((record.event == EXPORT_ESCAPE) && !DECODE_byte(a_input, &record.event))
+					|| ((record.result == EXPORT_ESCAPE) && !DECODE_byte(a_input, &record.result)))
+				{
+					return "escaped event or result cut";
+				}
+				if (token & EXPORT_USER_CHANGED)
+				{
+					if (!DECODE_varint(a_input, &value) || (value > 0xFF))
+					{
+						return "bad user ID";
+					}
+					record.user = (unsigned char)value;
+				}
+				if (!DECODE_delta(a_input, &delta))
+				{
+					return "time delta cut";
+				}
+			}
+		}
+
+		if (record.event == 0xFF)
+		{
+			return "repeat before the first record";
+		}
+
+		while (repeat != 0)
+		{
+			record.time = (record.time + (unsigned long)delta) & 0xFFFFFFFFUL;
+			if (a_result->records < a_max)
+			{
+				a_records[a_result->records] = record;
+			}
+			a_result->records++;
+			repeat--;
+		}
+	}
+
+	return NULL;
+}
+
+const char * DECODE_export(const unsigned char * a_stream, unsigned long a_size,
+	DECODE_RecordType * a_records, unsigned long a_max, DECODE_ResultType * a_result)
+{
+	DECODE_InputType input;
+	const char * error = NULL;
+	unsigned long next;
+	unsigned short crc = 0xFFFF;
+	unsigned char length;
+
+	memset(a_result, 0, sizeof(*a_result));
+
+	if ((a_size < 1 + EXPORT_HEADER_SIZE) || (a_stream[0] != EXPORT_HEADER_SIZE))
+	{
+		return "no header frame";
+	}
+	if (a_stream[1] != EXPORT_VERSION)
+	{
+		return "unknown export version";
+	}
+	a_result->header_count = a_stream[2] | ((unsigned long)a_stream[3] << 8);
+
+	/* the frames are checked and the CRC calculated in place, the tokens are then
+	 * read across the frames without joining them, a_stream is never copied
+	 */
+	next = 1 + EXPORT_HEADER_SIZE;
+	for (;;)
+	{
+		if (next >= a_size)
+		{
+			error = "no end frame";
+			break;
+		}
+		length = a_stream[next++];
+		if (length == 0)
+		{
+			break;
+		}
+		if (next + length > a_size)
+		{
+			error = "data frame cut";
+			break;
+		}
+		a_result->encoded_bytes += length;
+		while (length != 0)
+		{
+			crc = _crc_ccitt_update(crc, a_stream[next++]);
+			length--;
+		}
+	}
+
+	if (error == NULL)
+	{
+		if (next + 2 > a_size)
+		{
+			error = "CRC cut";
+		}
+		else if (crc != (a_stream[next] | ((unsigned short)a_stream[next + 1] << 8)))
+		{
+			error = "wrong CRC";
+		}
+		a_result->stream_bytes = next + 2;
+	}
+
+	if (error == NULL)
+	{
+		input.data = a_stream + 1 + EXPORT_HEADER_SIZE;
+		input.left = 0;
+		error = DECODE_records(&input, a_records, a_max, a_result);
+	}
+
+	if ((error == NULL) && (a_result->records != a_result->header_count))
+	{
+		error = "record count differs from the header";
+	}
+
+	return error;
+}
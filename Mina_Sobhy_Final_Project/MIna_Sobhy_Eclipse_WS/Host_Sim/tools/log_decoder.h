@@ -0,0 +1,48 @@
+/*
+ * log_decoder.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host decoder of the audit log export of the CONTROL_ECU, the
+ *      			 format is described in Control_ECU/log_export.h
+ */
+
+#ifndef LOG_DECODER_H_
+#define LOG_DECODER_H_
+
+#include "log_export.h"
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef struct
+{
+	unsigned char	event	;
+	unsigned char	user	;
+	unsigned char	result	;
+	unsigned long	time	; /* seconds since the reset */
+} DECODE_RecordType;
+
+typedef struct
+{
+	unsigned long	header_count	; /* records announced by the header frame */
+	unsigned long	records			; /* records decoded */
+	unsigned long	stream_bytes	; /* bytes of the export, frames and CRC included */
+	unsigned long	encoded_bytes	; /* bytes of the encoded records */
+} DECODE_ResultType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Decode the export in a_stream, at most a_max records are stored in a_records.
+ * a_stream is read in place, it isn't copied. Return NULL on success, else the
+ * error found, a_result holds what was decoded before it.
+ */
+const char * DECODE_export(const unsigned char * a_stream, unsigned long a_size,
+	DECODE_RecordType * a_records, unsigned long a_max, DECODE_ResultType * a_result);
+
+#endif /* LOG_DECODER_H_ */
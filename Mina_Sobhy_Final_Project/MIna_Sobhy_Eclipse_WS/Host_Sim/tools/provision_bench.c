@@ -0,0 +1,489 @@
+/*
+ * provision_bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: speed of the provisioning of a credential image over the UART,
+ *      			 provision.c and external_eeprom.c as they are on the simulated 24C16
+ *
+ *      usage: provision_bench [bytes per user [seed]]
+ *
+ *      The host tool is modelled on the other end of the line: it sends the
+ *      chunks of a random image as soon as the window allows, takes the ACKs and
+ *      sends again from the page of a NACK. The line sends 10 bits per byte at
+ *      the baud rate in both directions, the Rx buffer of the CONTROL_ECU is
+ *      checked for an overrun at every read. The clock is virtual, it moves in
+ *      the delays of the session and in the TWI time of every page write at
+ *      400 kHz, the CPU time and the ACK polls aren't counted.
+ *
+ *      For every rate of UART_BAUD_TABLE the whole image area is written three
+ *      times: with the window of the CONTROL_ECU, with a window of one chunk (the
+ *      host waits for every ACK) and with the window and bytes damaged on the
+ *      line. Every image is read back and checked. The time of 1000 users is the
+ *      time of the image bytes at the measured rate, with the bytes of one user
+ *      in the image given on the command line (the 24C16 holds fewer users than that).
+ */
+
+#include "provision.h"
+#include "uart.h"
+#include "diag.h"
+#include "twi.h"
+#include "sim.h"
+#include <util/crc16.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define BENCH_USER_SIZE			8		/* bytes of one user in the image */
+#define BENCH_TWI_HZ			400000UL	/* TWI_BITRATE 0x02 at 8 MHz */
+#define BENCH_TWI_HEADER		3		/* device address and word address with the start */
+#define BENCH_ERROR_RATE		0.002	/* damaged bytes of the noisy run */
+#define BENCH_LINE_SIZE			8192	/* bytes on the line at the same time */
+#define BENCH_NEVER				(~0ULL)
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/* a byte on the line and the time its stop bit is received */
+typedef struct
+{
+	unsigned long long	time	;
+	unsigned char		data	;
+} BENCH_ByteType;
+
+typedef struct
+{
+	BENCH_ByteType		bytes[BENCH_LINE_SIZE];
+	unsigned long		head	; /* next byte sent */
+	unsigned long		tail	; /* next byte received */
+	unsigned long long	free	; /* end of the last byte */
+	unsigned long long	busy	; /* time of all the bytes */
+} BENCH_LineType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+const char SIM_nodeName[] = "provision_bench";
+
+/* virtual clock */
+static unsigned long long g_now = 0;
+
+static unsigned long long g_byteUs;
+static double g_errorRate = 0;
+static unsigned long g_seed = 1;
+
+/* host to CONTROL_ECU and back */
+static BENCH_LineType g_toEcu;
+static BENCH_LineType g_toHost;
+
+/* the host tool */
+static unsigned char g_image[EEPROM_IMAGE_SIZE];
+static unsigned int g_pages;
+static unsigned int g_window;		/* most chunks not acknowledged, 0 before the window reply */
+static unsigned int g_windowMax;	/* window used by the host, 0 for the one of the CONTROL_ECU */
+static unsigned int g_acked;		/* pages acknowledged */
+static unsigned int g_next;			/* next page sent */
+static unsigned long long g_hostTime;
+static unsigned char g_reply[2];
+static unsigned int g_replySize;
+static int g_done;
+static unsigned long long g_doneTime;
+static unsigned long g_nacks;
+static unsigned long g_chunks;
+static unsigned long g_damaged;
+
+/* page writes counted by the DIAG_eepromAccess hook of external_eeprom.c */
+static unsigned long g_writes = 0;
+
+/*******************************************************************************
+ *                  Simulation, clock and diagnostics hooks                    *
+ *******************************************************************************/
+
+unsigned long long SIM_now(void)
+{
+	return g_now;
+}
+
+void SIM_delay(unsigned long long a_us)
+{
+	g_now += a_us;
+}
+
+void SIM_log(const char * a_format, ...)
+{
+	va_list args;
+
+	printf("[%s %10.3f] ", SIM_nodeName, (double)g_now / 1000000.0);
+	va_start(args, a_format);
+	vprintf(a_format, args);
+	va_end(args);
+	printf("\n");
+}
+
+void SIM_boardIdle(void)
+{
+}
+
+uint32 DIAG_now(void)
+{
+	return (uint32)(g_now * (F_CPU / 1000000UL) / DIAG_TICK_CYCLES);
+}
+
+void DIAG_eepromAccess(uint8 a_write, uint32 a_start, uint8 a_ok)
+{
+	(void)a_start;
+
+	if (a_write)
+	{
+		g_writes++;
+		g_now += ((BENCH_TWI_HEADER + EEPROM_PAGE_SIZE) * 9ULL * 1000000ULL) / BENCH_TWI_HZ;
+	}
+	if (!a_ok)
+	{
+		fprintf(stderr, "provision_bench: EEPROM access failed\n");
+		exit(1);
+	}
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+static unsigned long BENCH_random(void)
+{
+	g_seed = (g_seed * 1103515245UL) + 12345UL;
+	return (g_seed >> 16) & 0x7FFF;
+}
+
+/*
+ * Description :
+ * Put a byte on a line after the bytes before it, a_start is the earliest time
+ * it can start.
+ */
+static void BENCH_lineSend(BENCH_LineType * a_line, unsigned long long a_start, unsigned char a_data)
+{
+	if (a_line->head - a_line->tail == BENCH_LINE_SIZE)
+	{
+		fprintf(stderr, "provision_bench: more than %u bytes on the line\n", BENCH_LINE_SIZE);
+		exit(1);
+	}
+	if (a_start < a_line->free)
+	{
+		a_start = a_line->free;
+	}
+	a_line->free = a_start + g_byteUs;
+	a_line->busy += g_byteUs;
+	a_line->bytes[a_line->head % BENCH_LINE_SIZE].time = a_line->free;
+	a_line->bytes[a_line->head % BENCH_LINE_SIZE].data = a_data;
+	a_line->head++;
+}
+
+static unsigned long long BENCH_lineNext(const BENCH_LineType * a_line)
+{
+	return (a_line->head == a_line->tail) ? BENCH_NEVER : a_line->bytes[a_line->tail % BENCH_LINE_SIZE].time;
+}
+
+/*
+ * Description :
+ * The host sends a chunk, a byte is damaged on the line at BENCH_ERROR_RATE in
+ * the noisy run.
+ */
+static void BENCH_hostChunk(unsigned int a_page)
+{
+	unsigned char frame[PROVISION_FRAME_SIZE];
+	uint16 crc = 0xFFFF;
+	unsigned int i;
+
+	frame[0] = PROVISION_FRAME_LENGTH;
+	frame[1] = (unsigned char)a_page;
+	memcpy(&frame[2], &g_image[a_page * EEPROM_PAGE_SIZE], EEPROM_PAGE_SIZE);
+	for (i = 1; i < 2 + EEPROM_PAGE_SIZE; i++)
+	{
+		crc = _crc_ccitt_update(crc, frame[i]);
+	}
+	frame[2 + EEPROM_PAGE_SIZE] = (unsigned char)crc;
+	frame[3 + EEPROM_PAGE_SIZE] = (unsigned char)(crc >> 8);
+
+	for (i = 0; i < PROVISION_FRAME_SIZE; i++)
+	{
+		if ((g_errorRate != 0) && ((double)BENCH_random() < g_errorRate * 32768.0))
+		{
+			frame[i] ^= (unsigned char)(1 << (BENCH_random() % 8));
+			g_damaged++;
+		}
+		BENCH_lineSend(&g_toEcu, g_hostTime, frame[i]);
+	}
+	g_chunks++;
+}
+
+/*
+ * Description :
+ * Run the host until a_until: it sends what the window allows and takes the
+ * replies of the CONTROL_ECU in the order they are received.
+ */
+static void BENCH_hostRun(unsigned long long a_until)
+{
+	BENCH_ByteType * byte;
+
+	for (;;)
+	{
+		while ((g_window != 0) && (g_next < g_pages) && (g_next - g_acked < g_window))
+		{
+			BENCH_hostChunk(g_next);
+			g_next++;
+		}
+
+		if ((g_toHost.head == g_toHost.tail) || (BENCH_lineNext(&g_toHost) > a_until))
+		{
+			return;
+		}
+		byte = &g_toHost.bytes[g_toHost.tail % BENCH_LINE_SIZE];
+		g_toHost.tail++;
+		if (byte->time > g_hostTime)
+		{
+			g_hostTime = byte->time;
+		}
+
+		g_reply[g_replySize] = byte->data;
+		g_replySize++;
+		if (g_replySize < 2)
+		{
+			continue;
+		}
+		g_replySize = 0;
+
+		switch (g_reply[0])
+		{
+		case PROVISION_WINDOW:
+			g_window = ((g_windowMax != 0) && (g_windowMax < g_reply[1])) ? g_windowMax : g_reply[1];
+			break;
+		case PROVISION_ACK:
+			if (g_reply[1] + 1U > g_acked)
+			{
+				g_acked = g_reply[1] + 1U;
+			}
+			break;
+		case PROVISION_NACK:
+			/* the pages before the one expected are all queued */
+			g_acked = g_reply[1];
+			g_next = g_reply[1];
+			g_nacks++;
+			break;
+		case PROVISION_DONE:
+			g_done = 1;
+			g_doneTime = g_hostTime;
+			break;
+		default:
+			fprintf(stderr, "provision_bench: unknown reply 0x%02X\n", g_reply[0]);
+			exit(1);
+		}
+	}
+}
+
+void UART_sendBlock(const uint8 * a_data, uint8 a_size)
+{
+	uint8 i;
+
+	for (i = 0; i < a_size; i++)
+	{
+		BENCH_lineSend(&g_toHost, g_now, a_data[i]);
+	}
+}
+
+uint8 UART_isSendDone(void)
+{
+	/* the caller waits for the line, the clock moves to its end */
+	if (g_now < g_toHost.free)
+	{
+		g_now = g_toHost.free;
+	}
+	return TRUE;
+}
+
+uint8 UART_receiveByteTimeout(uint8 * a_data, uint16 a_timeout_ms)
+{
+	unsigned long long until = g_now + (a_timeout_ms * 1000ULL);
+	unsigned long long next;
+	unsigned long received = 0;
+	unsigned long i;
+
+	/* the host only sends after the replies it got until then */
+	BENCH_hostRun(until);
+
+	/* the bytes received by the interrupt and not read yet */
+	for (i = g_toEcu.tail; (i != g_toEcu.head) && (g_toEcu.bytes[i % BENCH_LINE_SIZE].time <= g_now); i++)
+	{
+		received++;
+	}
+	if (received > UART_RX_SIZE - 1)
+	{
+		fprintf(stderr, "provision_bench: Rx buffer overrun, %lu bytes\n", received);
+		exit(1);
+	}
+
+	next = BENCH_lineNext(&g_toEcu);
+	if (next > until)
+	{
+		g_now = until;
+		return FALSE;
+	}
+	if (next > g_now)
+	{
+		g_now = next;
+	}
+	*a_data = g_toEcu.bytes[g_toEcu.tail % BENCH_LINE_SIZE].data;
+	g_toEcu.tail++;
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Write the whole image area at a_baud with a host window of a_window chunks (0
+ * for the window of the CONTROL_ECU) and check it, return the time from the
+ * first byte of the host to the PROVISION_DONE reply.
+ */
+static unsigned long long BENCH_run(unsigned long a_baud, unsigned int a_window, double a_errorRate,
+	unsigned long long * a_lineBusy)
+{
+	unsigned char page[EEPROM_PAGE_SIZE];
+	unsigned long long start;
+	unsigned int i;
+
+	/* the clock goes on from the run before, the EEPROM may still be in a write cycle */
+	start = g_now;
+	memset(&g_toEcu, 0, sizeof(g_toEcu));
+	memset(&g_toHost, 0, sizeof(g_toHost));
+	g_byteUs = (10ULL * 1000000ULL + a_baud - 1) / a_baud;
+	g_errorRate = a_errorRate;
+	g_hostTime = start;
+	g_pages = PROVISION_PAGES;
+	g_window = 0;
+	g_windowMax = a_window;
+	g_acked = 0;
+	g_next = 0;
+	g_replySize = 0;
+	g_done = 0;
+
+	for (i = 0; i < EEPROM_IMAGE_SIZE; i++)
+	{
+		g_image[i] = (unsigned char)BENCH_random();
+	}
+
+	/* the number of pages opens the session */
+	BENCH_lineSend(&g_toEcu, start, (unsigned char)g_pages);
+	if (PROVISION_receive() != SUCCESS)
+	{
+		fprintf(stderr, "provision_bench: session failed at %lu baud\n", a_baud);
+		exit(1);
+	}
+	BENCH_hostRun(BENCH_NEVER);
+	if (!g_done)
+	{
+		fprintf(stderr, "provision_bench: no PROVISION_DONE at %lu baud\n", a_baud);
+		exit(1);
+	}
+
+	for (i = 0; i < g_pages; i++)
+	{
+		if ((EEPROM_readBlock(EEPROM_IMAGE_ADDRESS + (i * EEPROM_PAGE_SIZE), page, EEPROM_PAGE_SIZE) != SUCCESS)
+			|| (memcmp(page, &g_image[i * EEPROM_PAGE_SIZE], EEPROM_PAGE_SIZE) != 0))
+		{
+			fprintf(stderr, "provision_bench: page %u differs at %lu baud\n", i, a_baud);
+			exit(1);
+		}
+	}
+
+	*a_lineBusy = g_toEcu.busy;
+	return g_doneTime - start;
+}
+
+static void BENCH_print(const char * a_name, unsigned long long a_time, unsigned long long a_busy,
+	unsigned long a_userSize)
+{
+	double seconds = (double)a_time / 1000000.0;
+	double rate = (double)EEPROM_IMAGE_SIZE / seconds;
+
+	printf("  %-14s %6.3f s, %6.0f bytes/s, %7.1f s per 1000 users, line busy %5.1f %%\n",
+		a_name, seconds, rate, (1000.0 * a_userSize) / rate, 100.0 * (double)a_busy / (double)a_time);
+}
+
+#define BENCH_BAUD_ENTRY(baud)	baud,
+
+int main(int argc, char * argv[])
+{
+	static const unsigned long bauds[] = { UART_BAUD_TABLE(BENCH_BAUD_ENTRY) };
+	TWI_ConfigType twiType = {0x02, 0x01};
+	char path[] = "/tmp/provision_bench_XXXXXX";
+	unsigned long userSize = BENCH_USER_SIZE;
+	unsigned long long time;
+	unsigned long long busy;
+	unsigned long writes;
+	unsigned int i;
+	int fd;
+
+	if (argc > 1)
+	{
+		userSize = strtoul(argv[1], NULL, 0);
+	}
+	if (argc > 2)
+	{
+		g_seed = strtoul(argv[2], NULL, 0);
+	}
+	if (userSize == 0)
+	{
+		fprintf(stderr, "usage: %s [bytes per user [seed]]\n", argv[0]);
+		return 2;
+	}
+
+	/* start from an erased EEPROM kept in a temporary file */
+	fd = mkstemp(path);
+	if (fd < 0)
+	{
+		perror("provision_bench");
+		return 1;
+	}
+	close(fd);
+	unlink(path);
+	setenv(SIM_ENV_EEPROM, path, 1);
+	TWI_init(&twiType);
+
+	printf("image: %u bytes in %u chunks of %u bytes, window %u chunks, queue %u pages, %lu bytes per user\n",
+		EEPROM_IMAGE_SIZE, PROVISION_PAGES, PROVISION_FRAME_SIZE, PROVISION_WINDOW_CHUNKS,
+		PROVISION_QUEUE_PAGES, userSize);
+
+	for (i = 0; i < sizeof(bauds) / sizeof(bauds[0]); i++)
+	{
+		printf("%lu baud:\n", bauds[i]);
+
+		writes = g_writes;
+		time = BENCH_run(bauds[i], 0, 0, &busy);
+		BENCH_print("windowed:", time, busy, userSize);
+		if (g_writes - writes != PROVISION_PAGES)
+		{
+			fprintf(stderr, "provision_bench: %lu page writes for %u pages\n", g_writes - writes, PROVISION_PAGES);
+			return 1;
+		}
+
+		time = BENCH_run(bauds[i], 1, 0, &busy);
+		BENCH_print("stop and wait:", time, busy, userSize);
+
+		g_nacks = 0;
+		g_chunks = 0;
+		g_damaged = 0;
+		time = BENCH_run(bauds[i], 0, BENCH_ERROR_RATE, &busy);
+		BENCH_print("noisy line:", time, busy, userSize);
+		printf("  %-14s %lu chunks for %u pages, %lu bytes damaged, %lu NACKs\n", "",
+			g_chunks, PROVISION_PAGES, g_damaged, g_nacks);
+	}
+
+	unlink(path);
+	return 0;
+}
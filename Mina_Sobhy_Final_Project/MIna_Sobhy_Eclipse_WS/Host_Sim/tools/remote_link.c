@@ -0,0 +1,601 @@
+/*
+ * remote_link.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: gateway side of the UART link to one CONTROL_ECU
+ */
+
+#include "remote_link.h"
+#include "baud.h"
+#include <string.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* the bytes of control_main.c */
+#define REMOTE_PASS_END			'#'
+#define REMOTE_FLAG_MATCHED		'1'
+#define REMOTE_FLAG_UNMATCHED	'0'
+#define REMOTE_FLAG_COMPARE		'2'
+#define REMOTE_FLAG_LOCKED		'3'
+#define REMOTE_FLAG_PASS_EMPTY	'4'
+#define REMOTE_FLAG_STORED		'5'
+#define REMOTE_FLAG_SCHEDULE	'B'
+#define REMOTE_FLAG_UNKNOWN		'0'
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static const char * const g_stateNames[] = {
+	[REMOTE_QUIET]		= "quiet",
+	[REMOTE_SYNC]		= "sync",
+	[REMOTE_PROPOSAL]	= "baud",
+	[REMOTE_POLICY]		= "policy",
+	[REMOTE_PASS_FLAG]	= "pass_flag",
+	[REMOTE_EMPTY]		= "no_password",
+	[REMOTE_IDLE]		= "idle",
+	[REMOTE_RETRY]		= "pass_retry",
+	[REMOTE_OPTION]		= "option",
+	[REMOTE_LOCKED]		= "locked",
+	[REMOTE_DIAG]		= "diag",
+	[REMOTE_EXPORT]		= "export",
+	[REMOTE_PASS]		= "password",
+};
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void REMOTE_send(REMOTE_LinkType * a_link, const char * a_data, unsigned int a_size);
+static void REMOTE_sendPass(REMOTE_LinkType * a_link, const char * a_pass);
+static void REMOTE_wait(REMOTE_LinkType * a_link, REMOTE_StateType a_state, unsigned long a_now);
+static REMOTE_OpType REMOTE_end(REMOTE_LinkType * a_link, REMOTE_ResultType a_result);
+static REMOTE_OpType REMOTE_fail(REMOTE_LinkType * a_link, unsigned long a_now);
+static unsigned long REMOTE_cycleMs(const REMOTE_LinkType * a_link);
+static unsigned int REMOTE_get16(const unsigned char * a_data);
+static unsigned long REMOTE_get32(const unsigned char * a_data);
+static int REMOTE_sameRecord(const DECODE_RecordType * a_first, const DECODE_RecordType * a_second);
+static REMOTE_OpType REMOTE_byte(REMOTE_LinkType * a_link, unsigned char a_byte, unsigned long a_now);
+static REMOTE_OpType REMOTE_diag(REMOTE_LinkType * a_link, unsigned long a_now);
+static REMOTE_OpType REMOTE_export(REMOTE_LinkType * a_link, unsigned long a_now);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+static void REMOTE_send(REMOTE_LinkType * a_link, const char * a_data, unsigned int a_size)
+{
+	memcpy(&a_link->tx[a_link->txSize], a_data, a_size);
+	a_link->txSize += a_size;
+	a_link->txBytes += a_size;
+}
+
+/* Description:
+ * send a password then ask for its state
+ */
+static void REMOTE_sendPass(REMOTE_LinkType * a_link, const char * a_pass)
+{
+	REMOTE_send(a_link, a_pass, (unsigned int)strlen(a_pass));
+	REMOTE_send(a_link, "#H", 2);
+}
+
+static void REMOTE_wait(REMOTE_LinkType * a_link, REMOTE_StateType a_state, unsigned long a_now)
+{
+	a_link->state = a_state;
+	a_link->deadline = a_now + REMOTE_REPLY_MS;
+}
+
+static REMOTE_OpType REMOTE_end(REMOTE_LinkType * a_link, REMOTE_ResultType a_result)
+{
+	REMOTE_OpType op = a_link->op;
+
+	a_link->op = REMOTE_OP_NONE;
+	a_link->result = a_result;
+	return op;
+}
+
+/* Description:
+ * drop what was received and what wasn't sent, the link syncs again once the
+ * line is quiet
+ */
+static REMOTE_OpType REMOTE_fail(REMOTE_LinkType * a_link, unsigned long a_now)
+{
+	a_link->state = REMOTE_QUIET;
+	a_link->deadline = a_now + REMOTE_QUIET_MS;
+	a_link->rxSize = 0;
+	a_link->rxNext = 0;
+	a_link->txSize = 0;
+	a_link->txNext = 0;
+
+	return (a_link->op != REMOTE_OP_NONE) ? REMOTE_end(a_link, REMOTE_FAILED) : REMOTE_OP_NONE;
+}
+
+/* Description:
+ * the door cycle of CONTROL_doorCycle, with the default policy if the link started
+ * on a CONTROL_ECU which was already running
+ */
+static unsigned long REMOTE_cycleMs(const REMOTE_LinkType * a_link)
+{
+	unsigned long move = POLICY_DEFAULT_DOOR_MOVE;
+	unsigned long hold = POLICY_DEFAULT_DOOR_HOLD;
+
+	if (a_link->hasPolicy)
+	{
+		move = a_link->policy[REMOTE_POLICY_DOOR_MOVE];
+		hold = a_link->policy[REMOTE_POLICY_DOOR_HOLD];
+	}
+	return ((2 * move) + hold) * 1000UL + REMOTE_CYCLE_MARGIN_MS;
+}
+
+/* the AVR is little-endian */
+static unsigned int REMOTE_get16(const unsigned char * a_data)
+{
+	return a_data[0] | ((unsigned int)a_data[1] << 8);
+}
+
+static unsigned long REMOTE_get32(const unsigned char * a_data)
+{
+	return REMOTE_get16(a_data) | ((unsigned long)REMOTE_get16(a_data + 2) << 16);
+}
+
+static int REMOTE_sameRecord(const DECODE_RecordType * a_first, const DECODE_RecordType * a_second)
+{
+	return (a_first->event == a_second->event) && (a_first->user == a_second->user) &&
+		(a_first->result == a_second->result) && (a_first->time == a_second->time);
+}
+
+/* Description:
+ * take a reply of one byte in the state waiting for it
+ */
+static REMOTE_OpType REMOTE_byte(REMOTE_LinkType * a_link, unsigned char a_byte, unsigned long a_now)
+{
+	static const unsigned char flags[] = {
+		[REMOTE_OP_DIAG]	= '8',
+		[REMOTE_OP_EXPORT]	= '9',
+		[REMOTE_OP_UNLOCK]	= '1',
+	};
+
+	switch (a_link->state)
+	{
+	case REMOTE_QUIET:
+		/* the reply to an old request, the line isn't quiet yet */
+		a_link->deadline = a_now + REMOTE_QUIET_MS;
+		return REMOTE_OP_NONE;
+
+	case REMOTE_SYNC:
+		a_link->online = 1;
+		a_link->syncMisses = 0;
+		if (a_byte == BAUD_PROPOSE)
+		{
+			a_link->step = 0;
+			REMOTE_wait(a_link, REMOTE_PROPOSAL, a_now);
+		}
+		else if (a_byte == BAUD_END)
+		{
+			/* the CONTROL_ECU was reset, it sends the policy then the password state */
+			a_link->step = 0;
+			REMOTE_send(a_link, "H", 1);
+			REMOTE_wait(a_link, REMOTE_POLICY, a_now);
+		}
+		else if (a_byte == REMOTE_FLAG_UNKNOWN)
+		{
+			a_link->state = REMOTE_IDLE;
+		}
+		else if (a_byte == REMOTE_FLAG_LOCKED)
+		{
+			a_link->step = 0;
+			REMOTE_send(a_link, "H", 1);
+			REMOTE_wait(a_link, REMOTE_LOCKED, a_now);
+		}
+		else
+		{
+			return REMOTE_fail(a_link, a_now);
+		}
+		return REMOTE_OP_NONE;
+
+	case REMOTE_PROPOSAL:
+		/* the rate / 100 in two bytes, the rate is rejected and the next command asked for */
+		if (++a_link->step == 2)
+		{
+			REMOTE_send(a_link, "NH", 2);
+			REMOTE_wait(a_link, REMOTE_SYNC, a_now);
+		}
+		return REMOTE_OP_NONE;
+
+	case REMOTE_POLICY:
+		a_link->policy[a_link->step++] = a_byte;
+		REMOTE_send(a_link, "H", 1);
+		if (a_link->step == REMOTE_POLICY_SIZE)
+		{
+			a_link->hasPolicy = 1;
+			REMOTE_wait(a_link, REMOTE_PASS_FLAG, a_now);
+		}
+		else
+		{
+			REMOTE_wait(a_link, REMOTE_POLICY, a_now);
+		}
+		return REMOTE_OP_NONE;
+
+	case REMOTE_PASS_FLAG:
+		if ((a_byte != REMOTE_FLAG_STORED) && (a_byte != REMOTE_FLAG_PASS_EMPTY))
+		{
+			return REMOTE_fail(a_link, a_now);
+		}
+		a_link->passStored = (a_byte == REMOTE_FLAG_STORED);
+		a_link->state = a_link->passStored ? REMOTE_IDLE : REMOTE_EMPTY;
+		return REMOTE_OP_NONE;
+
+	case REMOTE_OPTION:
+		if (a_byte == REMOTE_FLAG_LOCKED)
+		{
+			a_link->step = 0;
+			REMOTE_send(a_link, "H", 1);
+			REMOTE_wait(a_link, REMOTE_LOCKED, a_now);
+		}
+		else if (a_byte != flags[a_link->op])
+		{
+			/* the option isn't known by this build, the CONTROL_ECU is back to its main options */
+			a_link->state = REMOTE_IDLE;
+			return REMOTE_end(a_link, REMOTE_FAILED);
+		}
+		else if (a_link->op == REMOTE_OP_UNLOCK)
+		{
+			REMOTE_sendPass(a_link, a_link->pass);
+			REMOTE_wait(a_link, REMOTE_PASS, a_now);
+		}
+		else
+		{
+			/* the frames start at the next received byte */
+			a_link->frameScan = 0;
+			REMOTE_send(a_link, "H", 1);
+			REMOTE_wait(a_link, (a_link->op == REMOTE_OP_DIAG) ? REMOTE_DIAG : REMOTE_EXPORT, a_now);
+		}
+		return REMOTE_OP_NONE;
+
+	case REMOTE_LOCKED:
+		if (a_link->step++ == 0)
+		{
+			a_link->locked = (unsigned int)a_byte << 8;
+			REMOTE_send(a_link, "H", 1);
+			REMOTE_wait(a_link, REMOTE_LOCKED, a_now);
+			return REMOTE_OP_NONE;
+		}
+		a_link->locked |= a_byte;
+		a_link->state = REMOTE_IDLE;
+		return (a_link->op != REMOTE_OP_NONE) ? REMOTE_end(a_link, REMOTE_LOCKED_OUT) : REMOTE_OP_NONE;
+
+	case REMOTE_PASS:
+		a_link->state = REMOTE_IDLE;
+		if (a_link->op == REMOTE_OP_SETPASS)
+		{
+			if (a_byte == REMOTE_FLAG_MATCHED)
+			{
+				a_link->passStored = 1;
+				return REMOTE_end(a_link, REMOTE_MATCHED);
+			}
+			if (a_byte == REMOTE_FLAG_UNMATCHED)
+			{
+				a_link->state = REMOTE_EMPTY;
+				return REMOTE_end(a_link, REMOTE_UNMATCHED);
+			}
+		}
+		else
+		{
+			switch (a_byte)
+			{
+			case REMOTE_FLAG_MATCHED:
+				/* the CONTROL_ECU doesn't read the link until the door is locked again */
+				a_link->busyUntil = a_now + REMOTE_cycleMs(a_link);
+				return REMOTE_end(a_link, REMOTE_MATCHED);
+			case REMOTE_FLAG_UNMATCHED:
+				a_link->state = REMOTE_RETRY;
+				return REMOTE_end(a_link, REMOTE_UNMATCHED);
+			case REMOTE_FLAG_COMPARE:
+				return REMOTE_end(a_link, REMOTE_LOCKOUT);
+			case REMOTE_FLAG_SCHEDULE:
+				return REMOTE_end(a_link, REMOTE_SCHEDULE);
+			}
+		}
+		return REMOTE_fail(a_link, a_now);
+
+	default:
+		/* the CONTROL_ECU never sends anything which wasn't asked for */
+		return REMOTE_fail(a_link, a_now);
+	}
+}
+
+/* Description:
+ * take the diagnostics frame in place when it is complete
+ */
+static REMOTE_OpType REMOTE_diag(REMOTE_LinkType * a_link, unsigned long a_now)
+{
+	const unsigned char * frame = &a_link->rx[a_link->rxNext];
+	unsigned long size = a_link->rxSize - a_link->rxNext;
+
+	if ((frame[0] != REMOTE_DIAG_SIZE) || ((size > 1) && (frame[1] != REMOTE_DIAG_VERSION)))
+	{
+		a_link->errors++;
+		return REMOTE_fail(a_link, a_now);
+	}
+	if (size < 1 + REMOTE_DIAG_SIZE)
+	{
+		return REMOTE_OP_NONE;
+	}
+
+	frame++;
+	a_link->diag.uart_rx_bytes = REMOTE_get16(frame + 1);
+	a_link->diag.uart_tx_bytes = REMOTE_get16(frame + 3);
+	a_link->diag.uart_errors = REMOTE_get16(frame + 5);
+	a_link->diag.eeprom_reads = REMOTE_get16(frame + 7);
+	a_link->diag.eeprom_writes = REMOTE_get16(frame + 9);
+	a_link->diag.eeprom_read_cycles = REMOTE_get32(frame + 11);
+	a_link->diag.eeprom_write_cycles = REMOTE_get32(frame + 15);
+	a_link->diag.twi_errors = REMOTE_get16(frame + 19);
+	a_link->diag.unlock_attempts = REMOTE_get16(frame + 21);
+	a_link->diag.door_cycles = REMOTE_get16(frame + 23);
+	a_link->diag.isr_max_latency = REMOTE_get16(frame + 25);
+	a_link->diag.idle_percent = frame[27];
+	a_link->diag.stack_high_water = REMOTE_get16(frame + 28);
+	a_link->hasDiag = 1;
+
+	a_link->rxNext += 1 + REMOTE_DIAG_SIZE;
+	a_link->state = REMOTE_IDLE;
+	return REMOTE_end(a_link, REMOTE_DONE);
+}
+
+/* Description:
+ * check the frames of the export received so far, decode it in place when the
+ * end frame and the CRC are in and find the records which are new since the
+ * export before
+ */
+static REMOTE_OpType REMOTE_export(REMOTE_LinkType * a_link, unsigned long a_now)
+{
+	const unsigned char * stream = &a_link->rx[a_link->rxNext];
+	unsigned long size = a_link->rxSize - a_link->rxNext;
+	DECODE_ResultType result;
+	unsigned long count;
+	unsigned long i;
+
+	/* only the frames which are complete are passed */
+	for (;;)
+	{
+		if (a_link->frameScan >= size)
+		{
+			return REMOTE_OP_NONE;
+		}
+		if ((a_link->frameScan != 0) && (stream[a_link->frameScan] == 0))
+		{
+			break;
+		}
+		if (a_link->frameScan + 1 + stream[a_link->frameScan] > size)
+		{
+			return REMOTE_OP_NONE;
+		}
+		a_link->frameScan += 1 + stream[a_link->frameScan];
+	}
+	if (a_link->frameScan + 3 > size)
+	{
+		return REMOTE_OP_NONE;
+	}
+
+	if ((DECODE_export(stream, a_link->frameScan + 3, a_link->records, LOG_CAPACITY, &result) != NULL)
+		|| (result.records > LOG_CAPACITY))
+	{
+		a_link->errors++;
+		return REMOTE_fail(a_link, a_now);
+	}
+	count = result.records;
+	a_link->exports++;
+
+	/* the new records follow the last one of the export before, it is found from
+	 * its place in the log until the log is full, then from the newest record back
+	 */
+	a_link->fresh = 0;
+	if (a_link->hasLog && (a_link->logCount != 0))
+	{
+		if ((a_link->logCount <= count) &&
+			REMOTE_sameRecord(&a_link->records[a_link->logCount - 1], &a_link->last))
+		{
+			a_link->fresh = a_link->logCount;
+		}
+		else
+		{
+			for (i = count; i != 0; i--)
+			{
+				if (REMOTE_sameRecord(&a_link->records[i - 1], &a_link->last))
+				{
+					a_link->fresh = i;
+					break;
+				}
+			}
+		}
+	}
+	a_link->freshCount = count - a_link->fresh;
+	a_link->logCount = count;
+	a_link->hasLog = 1;
+	if (count != 0)
+	{
+		a_link->last = a_link->records[count - 1];
+	}
+
+	a_link->rxNext += a_link->frameScan + 3;
+	a_link->state = REMOTE_IDLE;
+	return REMOTE_end(a_link, REMOTE_DONE);
+}
+
+void REMOTE_init(REMOTE_LinkType * a_link, DECODE_RecordType * a_records, unsigned long a_now)
+{
+	memset(a_link, 0, sizeof(*a_link));
+	a_link->records = a_records;
+	a_link->op = REMOTE_OP_NONE;
+	REMOTE_fail(a_link, a_now);
+}
+
+unsigned char * REMOTE_rxSpace(REMOTE_LinkType * a_link, unsigned long * a_space)
+{
+	*a_space = REMOTE_RX_SIZE - a_link->rxSize;
+	return &a_link->rx[a_link->rxSize];
+}
+
+REMOTE_OpType REMOTE_received(REMOTE_LinkType * a_link, unsigned long a_count, unsigned long a_now)
+{
+	REMOTE_OpType done = REMOTE_OP_NONE;
+
+	a_link->rxSize += a_count;
+	a_link->rxBytes += a_count;
+
+	while ((a_link->rxNext < a_link->rxSize) && (done == REMOTE_OP_NONE))
+	{
+		if ((a_link->state == REMOTE_DIAG) || (a_link->state == REMOTE_EXPORT))
+		{
+			/* the frames are parsed where they were received */
+			a_link->deadline = a_now + REMOTE_REPLY_MS;
+			done = (a_link->state == REMOTE_DIAG) ? REMOTE_diag(a_link, a_now) : REMOTE_export(a_link, a_now);
+			if ((done == REMOTE_OP_NONE) && ((a_link->state == REMOTE_DIAG) || (a_link->state == REMOTE_EXPORT)))
+			{
+				if (a_link->rxSize == REMOTE_RX_SIZE)
+				{
+					a_link->errors++;
+					done = REMOTE_fail(a_link, a_now);
+				}
+				break;
+			}
+		}
+		else
+		{
+			done = REMOTE_byte(a_link, a_link->rx[a_link->rxNext++], a_now);
+		}
+	}
+
+	/* a frame always starts at the head of the buffer */
+	if (a_link->rxNext == a_link->rxSize)
+	{
+		a_link->rxNext = 0;
+		a_link->rxSize = 0;
+	}
+	else if ((done != REMOTE_OP_NONE) || ((a_link->state != REMOTE_DIAG) && (a_link->state != REMOTE_EXPORT)))
+	{
+		memmove(a_link->rx, &a_link->rx[a_link->rxNext], a_link->rxSize - a_link->rxNext);
+		a_link->rxSize -= a_link->rxNext;
+		a_link->rxNext = 0;
+	}
+
+	return done;
+}
+
+REMOTE_OpType REMOTE_timer(REMOTE_LinkType * a_link, unsigned long a_now)
+{
+	if ((long)(a_now - a_link->deadline) < 0)
+	{
+		return REMOTE_OP_NONE;
+	}
+
+	switch (a_link->state)
+	{
+	case REMOTE_EMPTY:
+	case REMOTE_IDLE:
+	case REMOTE_RETRY:
+		return REMOTE_OP_NONE;
+
+	case REMOTE_QUIET:
+		a_link->syncs++;
+		REMOTE_send(a_link, "H", 1);
+		REMOTE_wait(a_link, REMOTE_SYNC, a_now);
+		return REMOTE_OP_NONE;
+
+	case REMOTE_SYNC:
+		/* a CONTROL_ECU which was running takes the first 'H' as its main option */
+		if (++a_link->syncMisses >= REMOTE_OFFLINE_SYNCS)
+		{
+			a_link->online = 0;
+		}
+		REMOTE_send(a_link, "H", 1);
+		REMOTE_wait(a_link, REMOTE_SYNC, a_now);
+		return REMOTE_OP_NONE;
+
+	default:
+		a_link->timeouts++;
+		return REMOTE_fail(a_link, a_now);
+	}
+}
+
+int REMOTE_canStart(const REMOTE_LinkType * a_link, REMOTE_OpType a_op, unsigned long a_now)
+{
+	if ((a_link->op != REMOTE_OP_NONE) || ((long)(a_now - a_link->busyUntil) < 0))
+	{
+		return 0;
+	}
+
+	switch (a_op)
+	{
+	case REMOTE_OP_DIAG:
+	case REMOTE_OP_EXPORT:
+		return a_link->state == REMOTE_IDLE;
+	case REMOTE_OP_UNLOCK:
+		return (a_link->state == REMOTE_IDLE) || (a_link->state == REMOTE_RETRY);
+	case REMOTE_OP_SETPASS:
+		return a_link->state == REMOTE_EMPTY;
+	default:
+		return 0;
+	}
+}
+
+int REMOTE_start(REMOTE_LinkType * a_link, REMOTE_OpType a_op, const char * a_pass, unsigned long a_now)
+{
+	if (!REMOTE_canStart(a_link, a_op, a_now))
+	{
+		return 0;
+	}
+	if ((a_op == REMOTE_OP_UNLOCK) || (a_op == REMOTE_OP_SETPASS))
+	{
+		if ((a_pass == NULL) || (a_pass[0] == '\0') || (strlen(a_pass) > POLICY_PASS_MAX_SIZE) ||
+			(strchr(a_pass, REMOTE_PASS_END) != NULL))
+		{
+			return 0;
+		}
+		strcpy(a_link->pass, a_pass);
+	}
+
+	a_link->op = a_op;
+	switch (a_op)
+	{
+	case REMOTE_OP_DIAG:
+		REMOTE_send(a_link, "%H", 2);
+		REMOTE_wait(a_link, REMOTE_OPTION, a_now);
+		break;
+	case REMOTE_OP_EXPORT:
+		REMOTE_send(a_link, "LH", 2);
+		REMOTE_wait(a_link, REMOTE_OPTION, a_now);
+		break;
+	case REMOTE_OP_UNLOCK:
+		if (a_link->state == REMOTE_RETRY)
+		{
+			/* the CONTROL_ECU still waits for the password */
+			REMOTE_sendPass(a_link, a_link->pass);
+			REMOTE_wait(a_link, REMOTE_PASS, a_now);
+		}
+		else
+		{
+			REMOTE_send(a_link, "+H", 2);
+			REMOTE_wait(a_link, REMOTE_OPTION, a_now);
+		}
+		break;
+	default:
+		/* the password and its confirmation */
+		REMOTE_send(a_link, a_pass, (unsigned int)strlen(a_pass));
+		REMOTE_send(a_link, "#", 1);
+		REMOTE_sendPass(a_link, a_pass);
+		REMOTE_wait(a_link, REMOTE_PASS, a_now);
+		break;
+	}
+
+	return 1;
+}
+
+const char * REMOTE_stateName(REMOTE_StateType a_state)
+{
+	return g_stateNames[a_state];
+}
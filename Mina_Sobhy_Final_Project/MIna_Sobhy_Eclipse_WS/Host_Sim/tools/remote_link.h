@@ -0,0 +1,225 @@
+/*
+ * remote_link.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: gateway side of the UART link to one CONTROL_ECU, the gateway
+ *      			 takes the place of the HMI_ECU on the point-to-point link
+ *
+ *      The link is a state machine without I/O: the gateway reads the serial
+ *      device straight into the Rx buffer of the link (REMOTE_rxSpace) and the
+ *      replies are parsed there in place, the diagnostics frame and the whole
+ *      audit log export included. The bytes to send are taken from tx.
+ *
+ *      Every byte of the CONTROL_ECU is asked for with HMI_ECU_READY ('H') as
+ *      the HMI_ECU does, the link only waits for one reply at a time:
+ *      1. sync: 'H' is sent until a reply comes. 'H' is also BAUD_READY, so the
+ *         CONTROL_ECU which was just reset or was already running answers with
+ *         its baud rate proposals, they are all rejected so the link stays at
+ *         UART_BAUD_DEFAULT, then the policy and the password state are read as
+ *         at the start of the HMI_ECU.
+ *      2. idle: the main options are sent by REMOTE_start, '%' for the
+ *         performance counters, 'L' for the audit log export and '+' with a
+ *         password to open the door. A wrong password leaves the CONTROL_ECU
+ *         waiting for another one (REMOTE_RETRY), only an unlock is accepted then.
+ *         The door cycle after a right password blocks the CONTROL_ECU, nothing
+ *         is sent until it is over.
+ *      3. a reply which doesn't come in time or doesn't fit the state sends the
+ *         link back to sync once the line is quiet.
+ *
+ *      The CONTROL_ECU never sends anything by itself, the new audit records are
+ *      found by comparing every export with the last record of the one before.
+ */
+
+#ifndef REMOTE_LINK_H_
+#define REMOTE_LINK_H_
+
+#include "log_decoder.h"
+#include "policy.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* longest export: the header, every record of the log at its longest, the length
+ * byte of every data frame, the end frame and the CRC
+ */
+#define REMOTE_EXPORT_MAX		(1 + EXPORT_HEADER_SIZE + (LOG_CAPACITY * EXPORT_RECORD_MAX) + \
+								 ((LOG_CAPACITY / EXPORT_BLOCK_RECORDS) + 1) + 1 + 2)
+#define REMOTE_RX_SIZE			(REMOTE_EXPORT_MAX + 64)
+#define REMOTE_TX_SIZE			(2 * (POLICY_PASS_MAX_SIZE + 1) + 4)
+
+/* POLICY_ConfigType on the AVR, sent byte by byte */
+#define REMOTE_POLICY_SIZE		8
+#define REMOTE_POLICY_DOOR_MOVE	6
+#define REMOTE_POLICY_DOOR_HOLD	7
+
+/* reply of the CONTROL_ECU, ms from the request or from the last byte of a frame */
+#define REMOTE_REPLY_MS			500
+/* time without any byte before a sync */
+#define REMOTE_QUIET_MS			100
+/* sync replies missed in a row before the door is reported offline */
+#define REMOTE_OFFLINE_SYNCS	5
+/* added to the door cycle before the CONTROL_ECU is asked for anything */
+#define REMOTE_CYCLE_MARGIN_MS	500
+
+/* length byte of the diagnostics frame of diag.h (DIAG_VERSION 2, packed AVR layout) */
+#define REMOTE_DIAG_SIZE		30
+#define REMOTE_DIAG_VERSION		2
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef enum
+{
+	REMOTE_QUIET,		/* dropping the bytes before a sync */
+	REMOTE_SYNC,		/* waiting for the reply to 'H' */
+	REMOTE_PROPOSAL,	/* receiving a baud rate proposal */
+	REMOTE_POLICY,		/* receiving the policy */
+	REMOTE_PASS_FLAG,	/* receiving the password state */
+	REMOTE_EMPTY,		/* no password stored, the CONTROL_ECU waits for a new one */
+	REMOTE_IDLE,		/* main options */
+	REMOTE_RETRY,		/* wrong password, the CONTROL_ECU waits for another one */
+	REMOTE_OPTION,		/* waiting for the reply to a main option */
+	REMOTE_LOCKED,		/* receiving the remaining lockout seconds */
+	REMOTE_DIAG,		/* receiving the diagnostics frame */
+	REMOTE_EXPORT,		/* receiving the audit log export */
+	REMOTE_PASS			/* waiting for the state of a password */
+} REMOTE_StateType;
+
+typedef enum
+{
+	REMOTE_OP_NONE, REMOTE_OP_DIAG, REMOTE_OP_EXPORT, REMOTE_OP_UNLOCK, REMOTE_OP_SETPASS
+} REMOTE_OpType;
+
+typedef enum
+{
+	REMOTE_DONE,		/* diagnostics or export received */
+	REMOTE_MATCHED,		/* the door is opened */
+	REMOTE_UNMATCHED,	/* wrong password, REMOTE_RETRY */
+	REMOTE_LOCKOUT,		/* wrong password, the system is locked */
+	REMOTE_SCHEDULE,	/* right password out of the access schedule */
+	REMOTE_LOCKED_OUT,	/* the system is locked, remaining seconds in locked */
+	REMOTE_FAILED		/* no reply or a wrong one */
+} REMOTE_ResultType;
+
+/* the counters of DIAG_CountersType */
+typedef struct
+{
+	unsigned int	uart_rx_bytes		;
+	unsigned int	uart_tx_bytes		;
+	unsigned int	uart_errors			;
+	unsigned int	eeprom_reads		;
+	unsigned int	eeprom_writes		;
+	unsigned long	eeprom_read_cycles	;
+	unsigned long	eeprom_write_cycles	;
+	unsigned int	twi_errors			;
+	unsigned int	unlock_attempts		;
+	unsigned int	door_cycles			;
+	unsigned int	isr_max_latency		;
+	unsigned int	idle_percent		;
+	unsigned int	stack_high_water	;
+} REMOTE_DiagType;
+
+typedef struct
+{
+	REMOTE_StateType	state		;
+	unsigned int		step		; /* byte of the policy or of the lockout seconds */
+	unsigned long		deadline	; /* ms, end of the wait of the state */
+	unsigned long		busyUntil	; /* ms, end of the door cycle */
+	unsigned int		syncMisses	;
+	int					online		;
+
+	/* operation started by REMOTE_start */
+	REMOTE_OpType		op			;
+	REMOTE_ResultType	result		;
+	unsigned int		locked		; /* remaining lockout seconds of REMOTE_LOCKED_OUT */
+	char				pass[POLICY_PASS_MAX_SIZE + 1];
+
+	/* what was read from the CONTROL_ECU */
+	unsigned char		policy[REMOTE_POLICY_SIZE];
+	int					hasPolicy	;
+	int					passStored	;
+	REMOTE_DiagType		diag		;
+	int					hasDiag		;
+	int					hasLog		;
+	DECODE_RecordType	last		; /* newest record of the last export */
+	unsigned long		logCount	; /* records of the last export */
+	unsigned long		fresh		; /* first new record of the last export */
+	unsigned long		freshCount	;
+
+	/* counters */
+	unsigned long		syncs		;
+	unsigned long		timeouts	;
+	unsigned long		errors		;
+	unsigned long		exports		;
+	unsigned long		rxBytes		;
+	unsigned long		txBytes		;
+
+	/* Rx bytes from rxNext to rxSize aren't parsed yet */
+	unsigned long		rxSize		;
+	unsigned long		rxNext		;
+	unsigned long		frameScan	; /* end of the export frames checked */
+	unsigned char		rx[REMOTE_RX_SIZE];
+
+	/* bytes from txNext to txSize are waiting to be written */
+	unsigned int		txSize		;
+	unsigned int		txNext		;
+	unsigned char		tx[REMOTE_TX_SIZE];
+
+	/* decoded records of the last export, given by the owner of the link */
+	DECODE_RecordType *	records		;
+} REMOTE_LinkType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Setup the link, a_records holds LOG_CAPACITY records and can be shared by the
+ * links which are served by the same thread. The link starts with a sync.
+ */
+void REMOTE_init(REMOTE_LinkType * a_link, DECODE_RecordType * a_records, unsigned long a_now);
+
+/*
+ * Description :
+ * Return where the next received bytes are stored and the room there in a_space.
+ */
+unsigned char * REMOTE_rxSpace(REMOTE_LinkType * a_link, unsigned long * a_space);
+
+/*
+ * Description :
+ * Parse a_count bytes stored at REMOTE_rxSpace. Return the operation which ended,
+ * its result is in a_link->result, else REMOTE_OP_NONE.
+ */
+REMOTE_OpType REMOTE_received(REMOTE_LinkType * a_link, unsigned long a_count, unsigned long a_now);
+
+/*
+ * Description :
+ * Check the wait of the state at a_now (ms), return the operation which failed
+ * as REMOTE_received does.
+ */
+REMOTE_OpType REMOTE_timer(REMOTE_LinkType * a_link, unsigned long a_now);
+
+/*
+ * Description :
+ * Return TRUE if REMOTE_start can start a_op now.
+ */
+int REMOTE_canStart(const REMOTE_LinkType * a_link, REMOTE_OpType a_op, unsigned long a_now);
+
+/*
+ * Description :
+ * Start a_op, a_pass is the password of REMOTE_OP_UNLOCK and REMOTE_OP_SETPASS.
+ * Return FALSE if it can't start now.
+ */
+int REMOTE_start(REMOTE_LinkType * a_link, REMOTE_OpType a_op, const char * a_pass, unsigned long a_now);
+
+/*
+ * Description :
+ * Return the name of a_state.
+ */
+const char * REMOTE_stateName(REMOTE_StateType a_state);
+
+#endif /* REMOTE_LINK_H_ */
@@ -0,0 +1,416 @@
+/*
+ * schedule_bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: speed and correctness of the access schedules, the compiler of
+ *      			 Host_Sim/tools/schedule_compiler.c and the check of
+ *      			 Control_ECU/schedule.c on the simulated 24C16
+ *
+ *      usage: schedule_bench [rule_sets [checks]]
+ *
+ *      Random rule sets of 1 to SCHEDULE_BENCH_RULES_MAX rules are written as
+ *      text and compiled, the rules per second of the compiler are printed. The
+ *      bitmaps of every set are compared with the rules evaluated one by one for
+ *      every slot of the week of every group.
+ *
+ *      The first SCHEDULE_BENCH_EEPROM_SETS sets are then written in the
+ *      simulated EEPROM and SCHEDULE_isAllowed is checked at random times against
+ *      the rules. Every check must read at most one EEPROM byte. The TWI time of
+ *      a check at 400 kHz is printed next to the time to read the same rules as a
+ *      list from the EEPROM, and the host time of the bitmap lookup next to the
+ *      evaluation of the rules.
+ */
+
+#include "schedule.h"
+#include "schedule_compiler.h"
+#include "clock.h"
+#include "diag.h"
+#include "twi.h"
+#include "sim.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SCHEDULE_BENCH_SETS			2000
+#define SCHEDULE_BENCH_CHECKS		20000
+#define SCHEDULE_BENCH_RULES_MAX	16
+#define SCHEDULE_BENCH_EEPROM_SETS	20
+#define SCHEDULE_BENCH_LINE_MAX		64
+#define SCHEDULE_BENCH_TWI_HZ		400000UL	/* TWI_BITRATE 0x02 at 8 MHz */
+#define SCHEDULE_BENCH_TWI_HEADER	4			/* device address, word address, device address again */
+#define SCHEDULE_BENCH_RULE_BYTES	5			/* group, days, start and length of a stored rule */
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef struct
+{
+	unsigned long	count;
+	char			lines[SCHEDULE_BENCH_RULES_MAX][SCHEDULE_BENCH_LINE_MAX];
+	RULES_RuleType	rules[SCHEDULE_BENCH_RULES_MAX];
+	unsigned char	area[SCHEDULE_AREA_SIZE];
+} SCHEDULE_BENCH_SetType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+const char SIM_nodeName[] = "schedule_bench";
+
+/* virtual clock, moved by the delays only */
+static unsigned long long g_now = 0;
+
+/* EEPROM reads counted by the DIAG_eepromAccess hook of external_eeprom.c */
+static unsigned long g_reads = 0;
+
+/* the wall clock seen by schedule.c */
+static uint32 g_wall = 0;
+static uint8 g_wallSet = TRUE;
+
+static unsigned long g_seed = 1;
+static SCHEDULE_BENCH_SetType * g_sets;
+
+/*******************************************************************************
+ *                      Simulation, clock and diagnostics hooks                *
+ *******************************************************************************/
+
+unsigned long long SIM_now(void)
+{
+	return g_now;
+}
+
+void SIM_delay(unsigned long long a_us)
+{
+	g_now += a_us;
+}
+
+void SIM_log(const char * a_format, ...)
+{
+	va_list args;
+
+	printf("[%s %10.3f] ", SIM_nodeName, (double)g_now / 1000000.0);
+	va_start(args, a_format);
+	vprintf(a_format, args);
+	va_end(args);
+	printf("\n");
+}
+
+void SIM_boardIdle(void)
+{
+}
+
+uint32 DIAG_now(void)
+{
+	return (uint32)(g_now * (F_CPU / 1000000UL) / DIAG_TICK_CYCLES);
+}
+
+void DIAG_eepromAccess(uint8 a_write, uint32 a_start, uint8 a_ok)
+{
+	(void)a_start;
+
+	if (!a_write)
+	{
+		g_reads++;
+	}
+	if (!a_ok)
+	{
+		fprintf(stderr, "schedule_bench: EEPROM access failed\n");
+		exit(1);
+	}
+}
+
+uint32 CLOCK_wall(void)
+{
+	return g_wall;
+}
+
+uint8 CLOCK_isSet(void)
+{
+	return g_wallSet;
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+static unsigned long SCHEDULE_BENCH_random(void)
+{
+	g_seed = (g_seed * 1103515245UL) + 12345UL;
+	return (g_seed >> 16) & 0x7FFF;
+}
+
+static double SCHEDULE_BENCH_seconds(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + ((double)now.tv_nsec / 1e9);
+}
+
+/* Description:
+ * write a random rule in the syntax of schedule_compiler.h
+ */
+static void SCHEDULE_BENCH_rule(char * a_line)
+{
+	static const char * const days[] = {"mon-fri", "sat,sun", "daily", "fri-mon", "tue", "mon,wed,fri", "sun"};
+	unsigned long group = SCHEDULE_BENCH_random() % SCHEDULE_GROUPS;
+	unsigned long kind = SCHEDULE_BENCH_random() % 32;
+	unsigned long from = SCHEDULE_BENCH_random() % SCHEDULE_SLOTS_PER_DAY;
+	unsigned long to = SCHEDULE_BENCH_random() % (SCHEDULE_SLOTS_PER_DAY + 1);
+
+	if (kind == 0)
+	{
+		sprintf(a_line, "%lu always", group);
+	}
+	else if (kind == 1)
+	{
+		sprintf(a_line, "%lu never # nobody", group);
+	}
+	else
+	{
+		sprintf(a_line, "%lu %s %02lu:%02lu-%02lu:%02lu\n", group,
+			days[SCHEDULE_BENCH_random() % (sizeof(days) / sizeof(days[0]))],
+			(from * RULES_SLOT_MINUTES) / 60, (from * RULES_SLOT_MINUTES) % 60,
+			(to * RULES_SLOT_MINUTES) / 60, (to * RULES_SLOT_MINUTES) % 60);
+	}
+}
+
+/* Description:
+ * compile the text of a set, return 0 if every rule was parsed
+ */
+static int SCHEDULE_BENCH_compile(SCHEDULE_BENCH_SetType * a_set)
+{
+	const char * error;
+	unsigned long i;
+	int found;
+
+	RULES_start(a_set->area);
+	for (i = 0; i < a_set->count; i++)
+	{
+		error = RULES_parse(a_set->lines[i], &a_set->rules[i], &found);
+		if ((error != NULL) || !found)
+		{
+			fprintf(stderr, "schedule_bench: \"%s\" not compiled, %s\n", a_set->lines[i],
+				(error != NULL) ? error : "no rule");
+			return 1;
+		}
+		RULES_apply(a_set->area, &a_set->rules[i]);
+	}
+	return 0;
+}
+
+/* Description:
+ * compare every bit of the bitmaps with the rules, return the mismatches
+ */
+static unsigned long SCHEDULE_BENCH_verify(const SCHEDULE_BENCH_SetType * a_set)
+{
+	unsigned long mismatches = 0;
+	unsigned long wall;
+	unsigned int group;
+	unsigned int slot;
+	int bit;
+
+	for (group = 0; group < SCHEDULE_GROUPS; group++)
+	{
+		for (slot = 0; slot < SCHEDULE_SLOTS; slot++)
+		{
+			/* anywhere in the slot */
+			wall = (slot * SCHEDULE_SLOT_SECONDS) + (SCHEDULE_BENCH_random() % SCHEDULE_SLOT_SECONDS);
+			bit = (a_set->area[group] == SCHEDULE_UNRESTRICTED)
+				|| ((a_set->area[EEPROM_PAGE_SIZE + (group * SCHEDULE_BITMAP_SIZE) + (slot >> 3)] >> (slot & 7)) & 1);
+			if (bit != RULES_allows(a_set->rules, a_set->count, (unsigned char)group, wall))
+			{
+				mismatches++;
+			}
+		}
+	}
+	return mismatches;
+}
+
+/* Description:
+ * store the schedule area of a set in the EEPROM, one page at a time
+ */
+static void SCHEDULE_BENCH_store(const SCHEDULE_BENCH_SetType * a_set)
+{
+	uint16 offset;
+
+	for (offset = 0; offset < SCHEDULE_AREA_SIZE; offset += EEPROM_PAGE_SIZE)
+	{
+		EEPROM_writeBlock(EEPROM_SCHEDULE_ADDRESS + offset, &a_set->area[offset],
+			((SCHEDULE_AREA_SIZE - offset) < EEPROM_PAGE_SIZE) ? (uint8)(SCHEDULE_AREA_SIZE - offset) : EEPROM_PAGE_SIZE);
+		SIM_delay(10000);
+	}
+}
+
+int main(int argc, char * argv[])
+{
+	TWI_ConfigType twiType = {0x02, 0x01};
+	char path[] = "/tmp/schedule_bench_XXXXXX";
+	unsigned long sets = SCHEDULE_BENCH_SETS;
+	unsigned long checks = SCHEDULE_BENCH_CHECKS;
+	unsigned long rules = 0;
+	unsigned long listRules = 0;
+	unsigned long mismatches = 0;
+	unsigned long restricted = 0;
+	unsigned long maxReads = 0;
+	unsigned long reads;
+	unsigned long allowed = 0;
+	unsigned long i;
+	unsigned long j;
+	unsigned char group;
+	double start;
+	double compileTime;
+	double bitmapTime = 0.0;
+	double rulesTime = 0.0;
+	volatile int sink = 0;
+	int fd;
+
+	if (argc > 1)
+	{
+		sets = strtoul(argv[1], NULL, 0);
+	}
+	if (argc > 2)
+	{
+		checks = strtoul(argv[2], NULL, 0);
+	}
+	if ((argc > 3) || (sets == 0) || (checks == 0))
+	{
+		fprintf(stderr, "usage: %s [rule_sets [checks]]\n", argv[0]);
+		return 2;
+	}
+
+	g_sets = calloc(sets, sizeof(SCHEDULE_BENCH_SetType));
+	if (g_sets == NULL)
+	{
+		fprintf(stderr, "schedule_bench: out of memory\n");
+		return 1;
+	}
+	for (i = 0; i < sets; i++)
+	{
+		g_sets[i].count = 1 + (SCHEDULE_BENCH_random() % SCHEDULE_BENCH_RULES_MAX);
+		for (j = 0; j < g_sets[i].count; j++)
+		{
+			SCHEDULE_BENCH_rule(g_sets[i].lines[j]);
+		}
+		rules += g_sets[i].count;
+	}
+
+	/* the compiler from the text to the bitmaps */
+	start = SCHEDULE_BENCH_seconds();
+	for (i = 0; i < sets; i++)
+	{
+		if (SCHEDULE_BENCH_compile(&g_sets[i]) != 0)
+		{
+			return 1;
+		}
+	}
+	compileTime = SCHEDULE_BENCH_seconds() - start;
+	printf("compiler:     %lu rule sets, %lu rules in %.3f s, %.0f rules/s, %.1f us/set\n",
+		sets, rules, compileTime, (double)rules / compileTime, compileTime * 1e6 / (double)sets);
+
+	for (i = 0; i < sets; i++)
+	{
+		mismatches += SCHEDULE_BENCH_verify(&g_sets[i]);
+	}
+	printf("bitmaps:      %lu slots compared with the rules, %lu mismatches\n",
+		sets * SCHEDULE_GROUPS * SCHEDULE_SLOTS, mismatches);
+	if (mismatches != 0)
+	{
+		return 1;
+	}
+
+	/* the check of the CONTROL_ECU on the simulated EEPROM */
+	fd = mkstemp(path);
+	if (fd < 0)
+	{
+		perror("schedule_bench");
+		return 1;
+	}
+	close(fd);
+	unlink(path);
+	setenv(SIM_ENV_EEPROM, path, 1);
+	TWI_init(&twiType);
+
+	for (i = 0; (i < sets) && (i < SCHEDULE_BENCH_EEPROM_SETS); i++)
+	{
+		SCHEDULE_BENCH_store(&g_sets[i]);
+		SCHEDULE_init();
+		listRules += g_sets[i].count;
+
+		for (j = 0; j < checks; j++)
+		{
+			group = (unsigned char)(SCHEDULE_BENCH_random() % SCHEDULE_GROUPS);
+			g_wall = (uint32)((SCHEDULE_BENCH_random() << 15) | SCHEDULE_BENCH_random());
+			g_wallSet = TRUE;
+
+			reads = g_reads;
+			if (SCHEDULE_isAllowed(group) != RULES_allows(g_sets[i].rules, g_sets[i].count, group, g_wall))
+			{
+				fprintf(stderr, "schedule_bench: set %lu group %u at %lu differs from the rules\n",
+					i, group, (unsigned long)g_wall);
+				return 1;
+			}
+			reads = g_reads - reads;
+			if (reads > maxReads)
+			{
+				maxReads = reads;
+			}
+			restricted += (g_sets[i].area[group] != SCHEDULE_UNRESTRICTED);
+
+			/* a restricted group is refused until the clock is set */
+			g_wallSet = FALSE;
+			if ((g_sets[i].area[group] != SCHEDULE_UNRESTRICTED) && SCHEDULE_isAllowed(group))
+			{
+				fprintf(stderr, "schedule_bench: restricted group %u allowed without clock\n", group);
+				return 1;
+			}
+		}
+	}
+	unlink(path);
+
+	printf("check:        %lu checks of %lu sets, %lu on restricted groups, at most %lu EEPROM read\n",
+		checks * i, i, restricted, maxReads);
+	printf("              TWI time %.1f us/check, %.1f us to read the same rules as a list\n",
+		(SCHEDULE_BENCH_TWI_HEADER + 1) * 9.0 * 1e6 / SCHEDULE_BENCH_TWI_HZ,
+		(SCHEDULE_BENCH_TWI_HEADER + ((double)listRules / (double)i * SCHEDULE_BENCH_RULE_BYTES))
+			* 9.0 * 1e6 / SCHEDULE_BENCH_TWI_HZ);
+
+	/* host time of the lookup in the compiled area against the rules */
+	start = SCHEDULE_BENCH_seconds();
+	for (i = 0; i < sets; i++)
+	{
+		for (j = 0; j < 64; j++)
+		{
+			g_wall = (uint32)(j * 9973UL);
+			sink += (g_sets[i].area[0] == SCHEDULE_UNRESTRICTED)
+				|| ((g_sets[i].area[EEPROM_PAGE_SIZE + (SCHEDULE_slot(g_wall) >> 3)] >> (SCHEDULE_slot(g_wall) & 7)) & 1);
+		}
+	}
+	bitmapTime = SCHEDULE_BENCH_seconds() - start;
+	start = SCHEDULE_BENCH_seconds();
+	for (i = 0; i < sets; i++)
+	{
+		for (j = 0; j < 64; j++)
+		{
+			allowed += RULES_allows(g_sets[i].rules, g_sets[i].count, 0, j * 9973UL);
+		}
+	}
+	rulesTime = SCHEDULE_BENCH_seconds() - start;
+	printf("              host %.1f ns/check with the bitmap, %.1f ns/check with %.1f rules a set\n",
+		bitmapTime * 1e9 / (double)(sets * 64), rulesTime * 1e9 / (double)(sets * 64),
+		(double)rules / (double)sets);
+
+	(void)sink;
+	(void)allowed;
+	free(g_sets);
+	return 0;
+}
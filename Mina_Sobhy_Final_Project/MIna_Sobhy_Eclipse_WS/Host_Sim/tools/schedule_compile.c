@@ -0,0 +1,120 @@
+/*
+ * schedule_compile.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: compile the access schedule rules into an EEPROM image
+ *
+ *      usage: schedule_compile rules_file eeprom_file
+ *
+ *      The rules (Host_Sim/tools/schedule_compiler.h) are read from rules_file,
+ *      or stdin for "-". The schedule area of eeprom_file is replaced and the
+ *      rest of the image is kept, a missing file is created erased. The image
+ *      is the SIM_EEPROM file of the simulation (door_sim -e) and the content
+ *      of the 24C16 for a programmer. One line is printed for every group.
+ */
+
+#include "schedule_compiler.h"
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SCHEDULE_COMPILE_EEPROM_SIZE	2048	/* 24C16 */
+#define SCHEDULE_COMPILE_LINE_MAX		256
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static unsigned char g_eeprom[SCHEDULE_COMPILE_EEPROM_SIZE];
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+int main(int argc, char * argv[])
+{
+	unsigned char * area = g_eeprom + EEPROM_SCHEDULE_ADDRESS;
+	char line[SCHEDULE_COMPILE_LINE_MAX];
+	RULES_RuleType rule;
+	const char * error;
+	FILE * file;
+	unsigned long number = 0;
+	unsigned long rules = 0;
+	unsigned int slots;
+	unsigned int group;
+	unsigned int i;
+	int found;
+
+	if (argc != 3)
+	{
+		fprintf(stderr, "usage: %s rules_file eeprom_file\n", argv[0]);
+		return 2;
+	}
+
+	/* keep the rest of the image, a new device is erased */
+	memset(g_eeprom, 0xFF, sizeof(g_eeprom));
+	file = fopen(argv[2], "rb");
+	if (file != NULL)
+	{
+		if (fread(g_eeprom, 1, sizeof(g_eeprom), file) != sizeof(g_eeprom))
+		{
+			fprintf(stderr, "%s: short EEPROM image, the rest is erased\n", argv[2]);
+		}
+		fclose(file);
+	}
+
+	file = (strcmp(argv[1], "-") == 0) ? stdin : fopen(argv[1], "r");
+	if (file == NULL)
+	{
+		perror(argv[1]);
+		return 1;
+	}
+
+	RULES_start(area);
+	while (fgets(line, sizeof(line), file) != NULL)
+	{
+		number++;
+		error = RULES_parse(line, &rule, &found);
+		if (error != NULL)
+		{
+			fprintf(stderr, "%s:%lu: %s\n", argv[1], number, error);
+			return 1;
+		}
+		if (found)
+		{
+			RULES_apply(area, &rule);
+			rules++;
+		}
+	}
+
+	file = fopen(argv[2], "wb");
+	if ((file == NULL) || (fwrite(g_eeprom, 1, sizeof(g_eeprom), file) != sizeof(g_eeprom)))
+	{
+		perror(argv[2]);
+		return 1;
+	}
+	fclose(file);
+
+	printf("%lu rules\n", rules);
+	for (group = 0; group < SCHEDULE_GROUPS; group++)
+	{
+		if (area[group] == SCHEDULE_UNRESTRICTED)
+		{
+			printf("group %u: no schedule\n", group);
+			continue;
+		}
+		slots = 0;
+		for (i = 0; i < SCHEDULE_SLOTS; i++)
+		{
+			slots += (area[EEPROM_PAGE_SIZE + (group * SCHEDULE_BITMAP_SIZE) + (i >> 3)] >> (i & 7)) & 1;
+		}
+		printf("group %u: %u of %u slots, %.2f hours a week\n", group, slots, SCHEDULE_SLOTS,
+			(double)slots * SCHEDULE_SLOT_SECONDS / 3600.0);
+	}
+
+	return 0;
+}
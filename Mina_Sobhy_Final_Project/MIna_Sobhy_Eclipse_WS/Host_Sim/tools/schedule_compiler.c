@@ -0,0 +1,305 @@
+/*
+ * schedule_compiler.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host compiler of the access schedule rules of the CONTROL_ECU
+ */
+
+#include "schedule_compiler.h"
+#include "clock.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static const char * const g_days[7] = {"mon", "tue", "wed", "thu", "fri", "sat", "sun"};
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static const char * RULES_word(const char ** a_text, char * a_word, unsigned int a_size);
+static int RULES_day(const char * a_name, unsigned int a_length);
+static const char * RULES_days(const char * a_list, unsigned char * a_days);
+static const char * RULES_time(const char * a_text, const char ** a_end, unsigned short * a_minutes);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/* Description:
+ * copy the next word of *a_text to a_word, an empty word at the end of the line
+ */
+static const char * RULES_word(const char ** a_text, char * a_word, unsigned int a_size)
+{
+	const char * text = *a_text;
+	unsigned int length = 0;
+
+	while ((*text != '\0') && isspace((unsigned char)*text))
+	{
+		text++;
+	}
+	while ((*text != '\0') && (*text != '#') && !isspace((unsigned char)*text))
+	{
+		if (length + 1 >= a_size)
+		{
+			return "word too long";
+		}
+		a_word[length++] = *text++;
+	}
+	a_word[length] = '\0';
+	*a_text = text;
+
+	return NULL;
+}
+
+/* Description:
+ * return the day of a_name (0 for Monday) or -1
+ */
+static int RULES_day(const char * a_name, unsigned int a_length)
+{
+	int day;
+
+	for (day = 0; day < 7; day++)
+	{
+		if ((a_length == 3) && (strncasecmp(a_name, g_days[day], 3) == 0))
+		{
+			return day;
+		}
+	}
+	return -1;
+}
+
+static const char * RULES_days(const char * a_list, unsigned char * a_days)
+{
+	const char * item = a_list;
+	const char * dash;
+	const char * end;
+	int first;
+	int last;
+
+	*a_days = 0;
+	if (strcasecmp(a_list, "daily") == 0)
+	{
+		*a_days = RULES_ALL_DAYS;
+		return NULL;
+	}
+
+	while (*item != '\0')
+	{
+		end = strchr(item, ',');
+		if (end == NULL)
+		{
+			end = item + strlen(item);
+		}
+		dash = memchr(item, '-', (size_t)(end - item));
+
+		first = RULES_day(item, (unsigned int)(((dash != NULL) ? dash : end) - item));
+		last = (dash != NULL) ? RULES_day(dash + 1, (unsigned int)(end - dash - 1)) : first;
+		if ((first < 0) || (last < 0))
+		{
+			return "unknown day";
+		}
+
+		/* a range can go over the end of the week, "fri-mon" */
+		for (;;)
+		{
+			*a_days |= (unsigned char)(1 << first);
+			if (first == last)
+			{
+				break;
+			}
+			first = (first + 1) % 7;
+		}
+
+		item = (*end == ',') ? end + 1 : end;
+	}
+
+	return NULL;
+}
+
+/* Description:
+ * read HH:MM on a slot boundary, 24:00 included
+ */
+static const char * RULES_time(const char * a_text, const char ** a_end, unsigned short * a_minutes)
+{
+	char * end;
+	unsigned long hours;
+	unsigned long minutes;
+
+	if (!isdigit((unsigned char)a_text[0]))
+	{
+		return "time expected";
+	}
+	hours = strtoul(a_text, &end, 10);
+	if ((*end != ':') || !isdigit((unsigned char)end[1]))
+	{
+		return "time is not HH:MM";
+	}
+	minutes = strtoul(end + 1, &end, 10);
+	if ((hours > 24) || (minutes > 59) || ((hours == 24) && (minutes != 0)))
+	{
+		return "time out of range";
+	}
+	if ((minutes % RULES_SLOT_MINUTES) != 0)
+	{
+		return "time is not on a 15 minutes boundary";
+	}
+
+	*a_minutes = (unsigned short)((hours * 60) + minutes);
+	*a_end = end;
+	return NULL;
+}
+
+void RULES_start(unsigned char * a_area)
+{
+	memset(a_area, 0xFF, SCHEDULE_AREA_SIZE);
+}
+
+const char * RULES_parse(const char * a_line, RULES_RuleType * a_rule, int * a_found)
+{
+	char group[8];
+	char days[64];
+	char window[32];
+	char rest[8];
+	const char * text = a_line;
+	const char * end;
+	const char * error;
+	unsigned short to;
+	char * number;
+	unsigned long value;
+
+	*a_found = 0;
+	if (((error = RULES_word(&text, group, sizeof(group))) != NULL)
+		|| ((error = RULES_word(&text, days, sizeof(days))) != NULL)
+		|| ((error = RULES_word(&text, window, sizeof(window))) != NULL)
+		|| ((error = RULES_word(&text, rest, sizeof(rest))) != NULL))
+	{
+		return error;
+	}
+	if (group[0] == '\0')
+	{
+		return NULL;
+	}
+	if (rest[0] != '\0')
+	{
+		return "text after the rule";
+	}
+
+	value = strtoul(group, &number, 10);
+	if ((*number != '\0') || (value >= SCHEDULE_GROUPS))
+	{
+		return "bad group";
+	}
+	a_rule->group = (unsigned char)value;
+
+	if ((strcasecmp(days, "always") == 0) || (strcasecmp(days, "never") == 0))
+	{
+		if (window[0] != '\0')
+		{
+			return "no time window after always or never";
+		}
+		a_rule->days = (strcasecmp(days, "always") == 0) ? RULES_ALL_DAYS : 0;
+		a_rule->from = 0;
+		a_rule->length = (a_rule->days != 0) ? RULES_MINUTES_PER_DAY : 0;
+		*a_found = 1;
+		return NULL;
+	}
+
+	if (days[0] == '\0')
+	{
+		return "days expected";
+	}
+	if ((error = RULES_days(days, &a_rule->days)) != NULL)
+	{
+		return error;
+	}
+
+	if ((error = RULES_time(window, &end, &a_rule->from)) != NULL)
+	{
+		return error;
+	}
+	if (*end != '-')
+	{
+		return "time window is not HH:MM-HH:MM";
+	}
+	if ((error = RULES_time(end + 1, &end, &to)) != NULL)
+	{
+		return error;
+	}
+	if ((*end != '\0') || (a_rule->from == RULES_MINUTES_PER_DAY))
+	{
+		return "bad time window";
+	}
+
+	/* the window goes on the next day when it doesn't end after its start */
+	a_rule->length = (to > a_rule->from) ? (to - a_rule->from) : ((RULES_MINUTES_PER_DAY - a_rule->from) + to);
+	*a_found = 1;
+	return NULL;
+}
+
+void RULES_apply(unsigned char * a_area, const RULES_RuleType * a_rule)
+{
+	unsigned char * bitmap = a_area + EEPROM_PAGE_SIZE + (a_rule->group * SCHEDULE_BITMAP_SIZE);
+	unsigned int slot;
+	unsigned int count;
+	unsigned int day;
+
+	if (a_area[a_rule->group] == SCHEDULE_UNRESTRICTED)
+	{
+		a_area[a_rule->group] = SCHEDULE_RESTRICTED;
+		memset(bitmap, 0, SCHEDULE_BITMAP_SIZE);
+	}
+
+	for (day = 0; day < 7; day++)
+	{
+		if (!(a_rule->days & (1 << day)))
+		{
+			continue;
+		}
+		slot = (day * SCHEDULE_SLOTS_PER_DAY) + (a_rule->from / RULES_SLOT_MINUTES);
+		for (count = a_rule->length / RULES_SLOT_MINUTES; count != 0; count--)
+		{
+			bitmap[slot >> 3] |= (unsigned char)(1 << (slot & 7));
+			slot = (slot + 1) % SCHEDULE_SLOTS;
+		}
+	}
+}
+
+int RULES_allows(const RULES_RuleType * a_rules, unsigned long a_count, unsigned char a_group,
+	unsigned long a_wall)
+{
+	unsigned long second = a_wall % CLOCK_SECONDS_PER_WEEK;
+	unsigned long start;
+	unsigned long i;
+	int restricted = 0;
+	unsigned int day;
+
+	for (i = 0; i < a_count; i++)
+	{
+		if (a_rules[i].group != a_group)
+		{
+			continue;
+		}
+		restricted = 1;
+		for (day = 0; day < 7; day++)
+		{
+			if (!(a_rules[i].days & (1 << day)))
+			{
+				continue;
+			}
+			start = (day * CLOCK_SECONDS_PER_DAY) + (a_rules[i].from * 60UL);
+			if (((second + CLOCK_SECONDS_PER_WEEK - start) % CLOCK_SECONDS_PER_WEEK) < (a_rules[i].length * 60UL))
+			{
+				return 1;
+			}
+		}
+	}
+
+	return !restricted;
+}
@@ -0,0 +1,79 @@
+/*
+ * schedule_compiler.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host compiler of the access schedule rules into the week
+ *      			 bitmaps of the CONTROL_ECU (Control_ECU/schedule.h)
+ *
+ *      One rule per line, '#' starts a comment:
+ *          <group> <days> <from>-<to>
+ *          <group> always
+ *          <group> never
+ *      <days> is "daily" or a list of days and day ranges separated by commas
+ *      ("mon-fri", "sat,sun", "fri-mon"), <from> and <to> are HH:MM on a
+ *      15 minutes boundary. A window whose end isn't after its start goes on the
+ *      next day ("22:00-06:00"), "24:00" is the end of the day. The windows of
+ *      the rules of a group are added, a group without rule keeps no schedule
+ *      and is allowed at any time.
+ */
+
+#ifndef SCHEDULE_COMPILER_H_
+#define SCHEDULE_COMPILER_H_
+
+#include "schedule.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define RULES_MINUTES_PER_DAY	1440
+#define RULES_SLOT_MINUTES		(SCHEDULE_SLOT_SECONDS / 60)
+#define RULES_ALL_DAYS			0x7F
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef struct
+{
+	unsigned char	group	;
+	unsigned char	days	; /* bit 0 for Monday to bit 6 for Sunday */
+	unsigned short	from	; /* minutes since 00:00 */
+	unsigned short	length	; /* minutes, 0 for a group which is never allowed */
+} RULES_RuleType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Fill the SCHEDULE_AREA_SIZE bytes of a_area as an erased EEPROM, every group
+ * without schedule.
+ */
+void RULES_start(unsigned char * a_area);
+
+/*
+ * Description :
+ * Parse one line in a_rule, *a_found is 0 for a line without rule.
+ * Return NULL on success, else the error found.
+ */
+const char * RULES_parse(const char * a_line, RULES_RuleType * a_rule, int * a_found);
+
+/*
+ * Description :
+ * Add the windows of a_rule to the bitmap of its group, the first rule of a
+ * group restricts it and clears its bitmap.
+ */
+void RULES_apply(unsigned char * a_area, const RULES_RuleType * a_rule);
+
+/*
+ * Description :
+ * Reference check of the rules without bitmap, return 1 if a_group is allowed
+ * at a_wall (seconds since Monday 00:00).
+ */
+int RULES_allows(const RULES_RuleType * a_rules, unsigned long a_count, unsigned char a_group,
+	unsigned long a_wall);
+
+#endif /* SCHEDULE_COMPILER_H_ */
@@ -0,0 +1,451 @@
+/*
+ * session_bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host bench of the keypad sessions of the RS-485 bus, every
+ *      			 flow of control_main.c built with BOARD_BUS_NODES run by
+ *      			 keypads which stop in the middle of them
+ *
+ *      usage: session_bench [rounds]
+ *
+ *      control_main.c is included as it is with its main renamed and bus.c is
+ *      replaced by a queue of bytes for every keypad, so the main loop passes
+ *      are counted. A keypad of the model speaks the protocol of the HMI_ECU: it
+ *      sends the bytes of a step one per pass, then asks for every reply with
+ *      HMI_ECU_READY. The EEPROM of the CONTROL_ECU starts erased and is kept in
+ *      RAM only.
+ *
+ *      1. keypad 1 creates the first password, changes it, sets the policy and
+ *         sets the clock
+ *      2. keypad 1 stops in the middle of the settings while the other keypads
+ *         change the password rounds times
+ *      3. keypad 1 restarts and goes back to the main options
+ *
+ *      Printed: the longest reply latency in main loop passes and the longest
+ *      pass. The run fails if a session waits for a byte which wasn't received
+ *      (the main loop would block on the bus), on a wrong reply, on a reply
+ *      later than BENCH_LATENCY_LIMIT passes or if the flows don't end.
+ */
+
+#define main CONTROL_main
+#include "control_main.c"
+#undef main
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define BENCH_ROUNDS			20
+
+/* passes from the last byte of a request to its first reply */
+#define BENCH_LATENCY_LIMIT		2
+
+/* passes of a phase before it is failed as not ending */
+#define BENCH_PASS_LIMIT		100000UL
+
+/* bytes sent by a keypad and not taken yet by its session */
+#define BENCH_QUEUE_SIZE		64
+
+#define BENCH_SEND				0
+#define BENCH_RECEIVE			1
+
+/* weekday (Wednesday), hour and minute set by keypad 1 */
+#define BENCH_DAY				3
+#define BENCH_HOUR				12
+#define BENCH_MINUTE			30
+
+#define BENCH_STEP_SEND(data)		{BENCH_SEND, (const uint8 *)(data), sizeof(data) - 1}
+#define BENCH_STEP_RECEIVE(data)	{BENCH_RECEIVE, (const uint8 *)(data), sizeof(data) - 1}
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/* a step of the script of a keypad, a NULL_PTR data receives any size bytes */
+typedef struct
+{
+	uint8			type	;
+	const uint8 *	data	;
+	uint32			size	;
+} BENCH_StepType;
+
+/* a keypad, with its end of the bus */
+typedef struct
+{
+	uint8					present		;
+	uint8					isNew		; /* restarted, not seen by BUS_isNew yet */
+	const BENCH_StepType *	steps		;
+	uint32					stepCount	;
+	uint32					loop		; /* first step of the rounds */
+	uint32					rounds		;
+	uint32					step		;
+	uint32					offset		;
+	uint8					waiting		; /* HMI_ECU_READY sent, no reply yet */
+	long					sentAt		; /* pass of the last byte of a request, -1 if none */
+	uint8					queue[BENCH_QUEUE_SIZE];
+	uint32					head		; /* free running, the queue holds head - tail bytes */
+	uint32					tail		;
+} BENCH_KeypadType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static BENCH_KeypadType g_keypads[BOARD_BUS_NODES];
+static unsigned long g_pass = 0;
+static long g_latencyMax = 0;
+static unsigned long long g_passMax = 0;
+
+/* the policy set by keypad 1, the longest password is one more character */
+static POLICY_ConfigType g_policy;
+static uint8 g_default[sizeof(POLICY_ConfigType)];
+static const uint8 g_clock[] = {BENCH_DAY, BENCH_HOUR, BENCH_MINUTE};
+static const uint8 g_partial[] = {POLICY_VERSION, 4, 4};
+
+/* 1. first password, password change, settings and clock */
+static BENCH_StepType g_flows[] =
+{
+	{BENCH_RECEIVE, g_default, sizeof(g_default)},
+	BENCH_STEP_RECEIVE("4"),
+	BENCH_STEP_SEND("12345#12346#"),
+	BENCH_STEP_RECEIVE("0"),
+	BENCH_STEP_SEND("12345#12345#"),
+	BENCH_STEP_RECEIVE("1"),
+
+	BENCH_STEP_SEND("-"),
+	BENCH_STEP_RECEIVE("2"),
+	BENCH_STEP_SEND("11111#"),
+	BENCH_STEP_RECEIVE("0"),
+	BENCH_STEP_SEND("12345#"),
+	BENCH_STEP_RECEIVE("1"),
+	BENCH_STEP_SEND("54321#54321#"),
+	BENCH_STEP_RECEIVE("1"),
+
+	BENCH_STEP_SEND("*"),
+	BENCH_STEP_RECEIVE("6"),
+	BENCH_STEP_SEND("54321#"),
+	BENCH_STEP_RECEIVE("1"),
+	{BENCH_SEND, (const uint8 *)&g_policy, sizeof(g_policy)},
+	{BENCH_RECEIVE, (const uint8 *)&g_policy, sizeof(g_policy)},
+
+	BENCH_STEP_SEND("K"),
+	BENCH_STEP_RECEIVE("A"),
+	BENCH_STEP_SEND("54321#"),
+	BENCH_STEP_RECEIVE("1"),
+	{BENCH_RECEIVE, NULL_PTR, 4},
+	{BENCH_SEND, g_clock, sizeof(g_clock)},
+	{BENCH_RECEIVE, NULL_PTR, 4},
+};
+
+/* 2. keypad 1 stops after a part of the new policy */
+static const BENCH_StepType g_unplugged[] =
+{
+	BENCH_STEP_SEND("*"),
+	BENCH_STEP_RECEIVE("6"),
+	BENCH_STEP_SEND("54321#"),
+	BENCH_STEP_RECEIVE("1"),
+	{BENCH_SEND, g_partial, sizeof(g_partial)},
+};
+
+/* 2. the other keypads start and change the password in rounds */
+static const BENCH_StepType g_changes[] =
+{
+	{BENCH_RECEIVE, (const uint8 *)&g_policy, sizeof(g_policy)},
+	BENCH_STEP_RECEIVE("5"),
+	BENCH_STEP_SEND("-"),
+	BENCH_STEP_RECEIVE("2"),
+	BENCH_STEP_SEND("54321#"),
+	BENCH_STEP_RECEIVE("1"),
+	BENCH_STEP_SEND("54321#54321#"),
+	BENCH_STEP_RECEIVE("1"),
+};
+
+/* 3. keypad 1 restarts, the bytes after it are main options */
+static const BENCH_StepType g_restart[] =
+{
+	{BENCH_RECEIVE, (const uint8 *)&g_policy, sizeof(g_policy)},
+	BENCH_STEP_RECEIVE("5"),
+	BENCH_STEP_SEND("9"),
+	BENCH_STEP_RECEIVE("0"),
+};
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/* Description:
+ * the bus of the model, the bytes of a keypad are in its queue as bus.c gives them
+ */
+void BUS_init(void)
+{
+}
+
+uint8 BUS_isNew(uint8 a_node)
+{
+	BENCH_KeypadType * keypad = &g_keypads[a_node - 1];
+
+	if (!keypad->isNew)
+	{
+		return FALSE;
+	}
+	keypad->isNew = FALSE;
+	keypad->tail = keypad->head;
+	return TRUE;
+}
+
+uint8 BUS_isDataAvailable(uint8 a_node)
+{
+	return (g_keypads[a_node - 1].head != g_keypads[a_node - 1].tail);
+}
+
+uint8 BUS_receiveByte(uint8 a_node)
+{
+	BENCH_KeypadType * keypad = &g_keypads[a_node - 1];
+
+	/* bus.c would sleep here until the keypad sends a byte, forever if it stopped */
+	if (keypad->head == keypad->tail)
+	{
+		fprintf(stderr, "session_bench: pass %lu waits for keypad %u on the bus\n", g_pass, a_node);
+		exit(1);
+	}
+	return keypad->queue[(keypad->tail++) % BENCH_QUEUE_SIZE];
+}
+
+void BUS_sendByte(uint8 a_node, uint8 a_data)
+{
+	BENCH_KeypadType * keypad = &g_keypads[a_node - 1];
+	const BENCH_StepType * step = &keypad->steps[keypad->step];
+
+	if (!keypad->present || !keypad->waiting)
+	{
+		fprintf(stderr, "session_bench: keypad %u got 0x%02X without asking for it\n", a_node, a_data);
+		exit(1);
+	}
+	if ((step->data != NULL_PTR) && (step->data[keypad->offset] != a_data))
+	{
+		fprintf(stderr, "session_bench: keypad %u got 0x%02X for 0x%02X in step %lu\n", a_node, a_data,
+			step->data[keypad->offset], (unsigned long)keypad->step);
+		exit(1);
+	}
+	keypad->waiting = FALSE;
+
+	if (keypad->sentAt >= 0)
+	{
+		if ((long)g_pass - keypad->sentAt > g_latencyMax)
+		{
+			g_latencyMax = (long)g_pass - keypad->sentAt;
+		}
+		keypad->sentAt = -1;
+	}
+
+	keypad->offset++;
+	if (keypad->offset == step->size)
+	{
+		keypad->offset = 0;
+		keypad->step++;
+	}
+}
+
+/* Description:
+ * start the script of a keypad, the steps from a_loop are run a_rounds times
+ */
+static void BENCH_plug(uint8 a_node, const BENCH_StepType * a_steps, uint32 a_stepCount,
+	uint32 a_loop, uint32 a_rounds)
+{
+	BENCH_KeypadType * keypad = &g_keypads[a_node - 1];
+
+	memset(keypad, 0, sizeof(*keypad));
+	keypad->present = TRUE;
+	keypad->isNew = TRUE;
+	keypad->steps = a_steps;
+	keypad->stepCount = a_stepCount;
+	keypad->loop = a_loop;
+	keypad->rounds = a_rounds;
+	keypad->sentAt = -1;
+}
+
+/* Description:
+ * go on with the script of a keypad without a restart
+ */
+static void BENCH_script(uint8 a_node, const BENCH_StepType * a_steps, uint32 a_stepCount)
+{
+	BENCH_KeypadType * keypad = &g_keypads[a_node - 1];
+
+	keypad->steps = a_steps;
+	keypad->stepCount = a_stepCount;
+	keypad->loop = 0;
+	keypad->rounds = 1;
+	keypad->step = 0;
+	keypad->offset = 0;
+}
+
+/* Description:
+ * return TRUE if the script of a keypad ended, it is silent after it
+ */
+static uint8 BENCH_done(const BENCH_KeypadType * a_keypad)
+{
+	return !a_keypad->present || (a_keypad->step == a_keypad->stepCount);
+}
+
+/* Description:
+ * a keypad sends the next byte of its script, or asks for a reply
+ */
+static void BENCH_keypad(BENCH_KeypadType * a_keypad)
+{
+	const BENCH_StepType * step;
+
+	/* the bytes before the restart is seen are dropped by the bus */
+	if (BENCH_done(a_keypad) || a_keypad->waiting || a_keypad->isNew)
+	{
+		return;
+	}
+	step = &a_keypad->steps[a_keypad->step];
+
+	if (step->type == BENCH_RECEIVE)
+	{
+		a_keypad->queue[(a_keypad->head++) % BENCH_QUEUE_SIZE] = HMI_ECU_READY;
+		a_keypad->waiting = TRUE;
+		return;
+	}
+
+	a_keypad->queue[(a_keypad->head++) % BENCH_QUEUE_SIZE] = step->data[a_keypad->offset];
+	a_keypad->sentAt = (long)g_pass;
+	a_keypad->offset++;
+	if (a_keypad->offset == step->size)
+	{
+		a_keypad->offset = 0;
+		a_keypad->step++;
+	}
+}
+
+/* Description:
+ * run the main loop until the script of every keypad ended
+ */
+static void BENCH_run(const char * a_phase)
+{
+	unsigned long passes;
+	unsigned long long start;
+	uint8 node;
+	uint8 done;
+
+	for (passes = 0; passes < BENCH_PASS_LIMIT; passes++)
+	{
+		done = TRUE;
+		for (node = 0; node < BOARD_BUS_NODES; node++)
+		{
+			/* the rounds start again at the end of the script */
+			if ((g_keypads[node].present) && BENCH_done(&g_keypads[node]) && (g_keypads[node].rounds > 1))
+			{
+				g_keypads[node].rounds--;
+				g_keypads[node].step = g_keypads[node].loop;
+			}
+			BENCH_keypad(&g_keypads[node]);
+			done = done && BENCH_done(&g_keypads[node]) && !g_keypads[node].waiting;
+		}
+		if (done)
+		{
+			printf("%-32s %6lu passes\n", a_phase, passes);
+			return;
+		}
+
+		/* the main loop of the CONTROL_ECU */
+		start = SIM_now();
+		LOCKOUT_service();
+		CONTROL_doorService();
+		for (node = 1; node <= BOARD_BUS_NODES; node++)
+		{
+			CONTROL_session(node);
+		}
+		if (SIM_now() - start > g_passMax)
+		{
+			g_passMax = SIM_now() - start;
+		}
+		g_pass++;
+	}
+
+	fprintf(stderr, "session_bench: %s didn't end\n", a_phase);
+	exit(1);
+}
+
+int main(int argc, char ** argv)
+{
+	TWI_ConfigType twiType = {TWI_BITRATE, TWI_ADDRESS};
+	uint32 rounds = BENCH_ROUNDS;
+	uint32 target = ((BENCH_DAY - 1) * CLOCK_SECONDS_PER_DAY) + (BENCH_HOUR * 3600UL) + (BENCH_MINUTE * 60UL);
+	uint32 wall;
+	uint8 node;
+
+	if (argc > 1)
+	{
+		rounds = strtoul(argv[1], NULL, 0);
+	}
+	if (rounds == 0)
+	{
+		fprintf(stderr, "usage: %s [rounds]\n", argv[0]);
+		return 2;
+	}
+
+	/* the modules of the sessions as at the start of the CONTROL_ECU, the EEPROM
+	 * is erased
+	 */
+	CLOCK_init();
+	TWI_init(&twiType);
+	CONFIG_init();
+	LOCKOUT_init();
+	SCHEDULE_init();
+	CRED_init();
+	LOG_init();
+
+	memcpy(g_default, CONFIG_get(), sizeof(g_default));
+	g_policy = *CONFIG_get();
+	g_policy.pass_max++;
+	g_policy.door_hold++;
+
+	BENCH_plug(1, g_flows, sizeof(g_flows) / sizeof(g_flows[0]), 0, 1);
+	BENCH_run("flows of keypad 1");
+
+	if (memcmp(CONFIG_get(), &g_policy, sizeof(g_policy)) != 0)
+	{
+		fprintf(stderr, "session_bench: the policy wasn't set\n");
+		return 1;
+	}
+	wall = CLOCK_wall() % CLOCK_SECONDS_PER_WEEK;
+	if ((wall < target) || (wall > target + 60))
+	{
+		fprintf(stderr, "session_bench: the clock is %lu s in the week for %lu s\n",
+			(unsigned long)wall, (unsigned long)target);
+		return 1;
+	}
+
+	BENCH_script(1, g_unplugged, sizeof(g_unplugged) / sizeof(g_unplugged[0]));
+	for (node = 2; node <= BOARD_BUS_NODES; node++)
+	{
+		BENCH_plug(node, g_changes, sizeof(g_changes) / sizeof(g_changes[0]), 2, rounds);
+	}
+	BENCH_run("keypad 1 stopped in the settings");
+
+	BENCH_plug(1, g_restart, sizeof(g_restart) / sizeof(g_restart[0]), 0, 1);
+	BENCH_run("keypad 1 restarted");
+
+	/* the part of the policy sent before the stop isn't used */
+	if (memcmp(CONFIG_get(), &g_policy, sizeof(g_policy)) != 0)
+	{
+		fprintf(stderr, "session_bench: the policy changed after the stop\n");
+		return 1;
+	}
+
+	printf("%u keypads: longest reply %ld passes, longest pass %llu us\n", BOARD_BUS_NODES,
+		g_latencyMax, g_passMax);
+	if (g_latencyMax > BENCH_LATENCY_LIMIT)
+	{
+		fprintf(stderr, "session_bench: a reply took more than %u passes\n", BENCH_LATENCY_LIMIT);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,80 @@
+/*
+ * session_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host test of the check of the password of a keypad session
+ *      			 of the RS-485 bus, control_main.c built with BOARD_BUS_NODES
+ *
+ *      usage: session_test eeprom_file pass...
+ *
+ *      control_main.c is included as it is with its main renamed, so its
+ *      sessions can be given a password without the bus. The EEPROM of the
+ *      CONTROL_ECU is eeprom_file, with the credential table written in it by
+ *      credential_compile -e. Every pass is received by the session of node 1
+ *      as bus.c gives it, one character at a time, then checked by
+ *      CONTROL_sessionPass: "<pass>: door" is printed if it opens the door,
+ *      "<pass>: refused" if not. test/session_pass.sh runs it.
+ */
+
+#define main CONTROL_main
+#include "control_main.c"
+#undef main
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+int main(int argc, char ** argv)
+{
+	TWI_ConfigType twiType = {TWI_BITRATE, TWI_ADDRESS};
+	CONTROL_SessionType * session = &g_sessions[0];
+	const char * pass;
+	int i;
+
+	if (argc < 3)
+	{
+		fprintf(stderr, "usage: %s eeprom_file pass...\n", argv[0]);
+		return 2;
+	}
+	setenv(SIM_ENV_EEPROM, argv[1], 1);
+
+	/* the modules of the password check as at the start of the CONTROL_ECU */
+	CLOCK_init();
+	TWI_init(&twiType);
+	CONFIG_init();
+	LOCKOUT_init();
+	SCHEDULE_init();
+	CRED_init();
+	LOG_init();
+
+	for (i = 2; i < argc; i++)
+	{
+		/* the characters after POLICY_PASS_MAX_SIZE are only counted, as
+		 * CONTROL_session does
+		 */
+		memset(session, 0, sizeof(*session));
+		session->state = SESSION_PASS;
+		session->flow = '1';
+		for (pass = argv[i]; *pass != '\0'; pass++)
+		{
+			if (session->passSize < POLICY_PASS_MAX_SIZE)
+			{
+				session->pass[session->passSize] = (uint8)*pass;
+			}
+			if (session->passSize < 0xFF)
+			{
+				session->passSize++;
+			}
+		}
+
+		CONTROL_sessionPass(session);
+		printf("%s: %s\n", argv[i], (session->state == SESSION_DOOR) ? "door" : "refused");
+	}
+
+	return 0;
+}
@@ -0,0 +1,290 @@
+/*
+ * uart_fuzz.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: host fuzz test of the Rx ring buffer of uart.c and of its
+ *      			 in place message API, with its receive interrupt called by
+ *      			 the test
+ *
+ *      usage: uart_fuzz_control|uart_fuzz_hmi [operations [seed]]
+ *
+ *      uart.c is included as it is, with the board_config.h of the ECU, so the
+ *      ring buffer and its indexes can be checked. POWER_sleep, where the driver
+ *      waits for bytes, calls the receive interrupt with random bytes: mostly
+ *      '#' or any byte, or bytes of a length-prefixed frame, some of them with a
+ *      frame error. A full buffer drops the byte, the bytes kept by the
+ *      interrupt are recorded in the order they are received.
+ *
+ *      Every operation is a random call of UART_receiveByte,
+ *      UART_receiveMessage, UART_receiveFrame, UART_receiveString (into a heap
+ *      buffer of the given size) or UART_flush, with random limits. The test
+ *      fails if a view isn't inside the ring buffer, if a byte, message or
+ *      string differs from the recorded ones, if a limit isn't kept or if the
+ *      error count is wrong. The CMake build adds the address and undefined
+ *      behaviour sanitizers when the host compiler has them, so any write out
+ *      of a buffer stops the test too.
+ */
+
+#include "uart.c"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define FUZZ_OPERATIONS			200000L
+
+/* bytes recorded by a run, every operation receives less than 256 of them */
+#define FUZZ_RECORD_SIZE		(1UL << 26)
+
+/* 1 byte of FUZZ_ERROR_RATE is received with a frame error */
+#define FUZZ_ERROR_RATE			16
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void FUZZ_inject(void);
+static void FUZZ_checkView(const uint8 * a_data, uint8 a_size);
+static void FUZZ_fail(const char * a_what);
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+#if BOARD_DIAG
+/* the performance counters of diag.c, the driver counts its bytes in them */
+DIAG_CountersType g_diag;
+#endif
+
+/* every byte kept by the interrupt, g_in of them, g_out taken by the driver */
+static uint8 * g_record;
+static unsigned long g_in = 0;
+static unsigned long g_out = 0;
+static unsigned long g_dropped = 0;
+static unsigned long g_errors = 0;
+
+/* 1: bytes of frames, 0: '#' or any byte */
+static int g_frames;
+static long g_operation;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/* the test doesn't run the delays of the timeouts */
+void _delay_ms(double a_ms)
+{
+	(void)a_ms;
+}
+
+void _delay_us(double a_us)
+{
+	(void)a_us;
+}
+
+/* the driver waits for bytes here, a few are received while it sleeps */
+void POWER_sleep(uint8 a_wake)
+{
+	int bytes = 1 + (rand() % 6);
+
+	(void)a_wake;
+	while (bytes--)
+	{
+		FUZZ_inject();
+	}
+	sei();
+}
+
+/* Description:
+ * receive a random byte by the interrupt of uart.c and record it if it is kept
+ */
+static void FUZZ_inject(void)
+{
+	uint8 head = g_rxHead;
+	int random = rand();
+
+	UCSRA = ((random % FUZZ_ERROR_RATE) == 0) ? (1<<FE) : 0;
+	if (UCSRA)
+	{
+		g_errors++;
+	}
+	if (g_frames)
+	{
+		UDR = (uint8)((random >> 8) % 70);
+	}
+	else
+	{
+		UDR = ((random % 9) == 0) ? '#' : (uint8)(random >> 8);
+	}
+
+	USART_RXC_vect();
+	if (g_rxHead != head)
+	{
+		g_record[g_in++] = UDR;
+	}
+	else
+	{
+		g_dropped++;
+	}
+}
+
+/* Description:
+ * a view must be inside the ring buffer and hold the next recorded bytes
+ */
+static void FUZZ_checkView(const uint8 * a_data, uint8 a_size)
+{
+	if ((a_data < g_rxBuffer) || ((a_data + a_size) > (g_rxBuffer + sizeof(g_rxBuffer))))
+	{
+		FUZZ_fail("view out of the Rx buffer");
+	}
+	if (memcmp(a_data, &g_record[g_out], a_size) != 0)
+	{
+		FUZZ_fail("view not matching the received bytes");
+	}
+}
+
+static void FUZZ_fail(const char * a_what)
+{
+	printf("FAIL operation %ld: %s, %lu bytes taken\n", g_operation, a_what, g_out);
+	exit(1);
+}
+
+int main(int argc, char ** argv)
+{
+	UART_ConfigType uartType = {EIGHT_BIT, DISABLED, ONE_BIT, 9600};
+	UART_MessageType message;
+	long operations = (argc > 1) ? atol(argv[1]) : FUZZ_OPERATIONS;
+	unsigned long used;
+	uint8 * string;
+	uint8 size;
+	uint8 tail;
+	uint8 max;
+	uint8 ok;
+	int bytes;
+
+	srand((argc > 2) ? (unsigned)atoi(argv[2]) : 1);
+	g_record = malloc(FUZZ_RECORD_SIZE);
+	if (g_record == NULL)
+	{
+		puts("FAIL no memory for the record");
+		return 1;
+	}
+
+	UART_init(&uartType);
+
+	for (g_operation = 0; g_operation < operations; g_operation++)
+	{
+		if ((g_in + 1024) > FUZZ_RECORD_SIZE)
+		{
+			FUZZ_fail("record full, run less operations");
+		}
+
+		g_frames = rand() & 1;
+		max = (uint8)rand();
+
+		/* sometimes bytes wait in the buffer before the call */
+		if ((rand() % 3) == 0)
+		{
+			for (bytes = rand() % 80; bytes > 0; bytes--)
+			{
+				FUZZ_inject();
+			}
+		}
+
+		switch (rand() % 6)
+		{
+		case 0:
+			if (UART_receiveByte() != g_record[g_out])
+			{
+				FUZZ_fail("byte not matching the received one");
+			}
+			g_out++;
+			break;
+
+		case 1:
+			ok = UART_receiveMessage(&message, '#', max);
+			if ((message.length > UART_MESSAGE_MAX) || (message.length > max))
+			{
+				FUZZ_fail("message longer than its limit");
+			}
+			FUZZ_checkView(message.data, message.size);
+			if (ok != (message.size == (message.length + 1)))
+			{
+				FUZZ_fail("message size without its delimiter");
+			}
+			if (ok && (message.data[message.length] != '#'))
+			{
+				FUZZ_fail("message without its delimiter");
+			}
+			g_out += message.size;
+			UART_releaseMessage(&message);
+			break;
+
+		case 2:
+			/* the view of a frame starts after its length byte */
+			ok = UART_receiveFrame(&message, max);
+			FUZZ_checkView(message.data - 1, message.size);
+			if (ok && (message.data[-1] != message.length))
+			{
+				FUZZ_fail("frame length not matching its length byte");
+			}
+			if (!ok && ((message.length != 0) || (message.size != 1)))
+			{
+				FUZZ_fail("rejected frame not empty");
+			}
+			g_out += message.size;
+			UART_releaseMessage(&message);
+			break;
+
+		case 3:
+			/* a heap buffer of the exact size, the sanitizer stops any write after it */
+			size = (uint8)(rand() % 70);
+			string = malloc(size ? size : 1);
+			tail = g_rxTail;
+			ok = UART_receiveString(string, size);
+			used = (uint8)(g_rxTail - tail) & (UART_RX_SIZE - 1);
+			if (size != 0)
+			{
+				unsigned long length = ok ? (used - 1) : used;
+
+				if ((length > (unsigned long)(size - 1)) ||
+					(memcmp(string, &g_record[g_out], length) != 0) || (string[length] != 0))
+				{
+					FUZZ_fail("string not matching the received bytes");
+				}
+				if (ok && (g_record[g_out + length] != '#'))
+				{
+					FUZZ_fail("string without its '#'");
+				}
+			}
+			g_out += used;
+			free(string);
+			break;
+
+		case 4:
+			if ((rand() % 50) == 0)
+			{
+				UART_flush();
+				g_out = g_in;
+			}
+			break;
+
+		case 5:
+			if (UART_takeErrors() != ((g_errors > 0xFF) ? 0xFF : g_errors))
+			{
+				FUZZ_fail("error count not matching the frame errors");
+			}
+			g_errors = 0;
+			break;
+		}
+	}
+
+	printf("ok: %ld operations, %lu bytes received, %lu dropped by a full buffer\n",
+		operations, g_in, g_dropped);
+	free(g_record);
+	return 0;
+}
@@ -0,0 +1,353 @@
+/*
+ * baud.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: source file of the UART baud rate negotiation
+ */
+
+#include "baud.h"
+#include <util/crc16.h>
+#include <util/delay.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* bytes received with an error since the last negotiation */
+static uint8 g_errors = 0;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static uint8 BAUD_isSupported(UART_BaudRate a_baud);
+static uint8 BAUD_pattern(uint8 a_index);
+static void BAUD_sendTest(void);
+static uint8 BAUD_receiveTest(void);
+static uint8 BAUD_testMaster(void);
+static uint8 BAUD_testSlave(void);
+static uint8 BAUD_waitReady(void);
+static uint8 BAUD_receiveAnswer(void);
+static uint8 BAUD_receiveCommand(void);
+static UART_BaudRate BAUD_start(UART_BaudRate a_baud);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/* Description:
+ * return TRUE if a_baud is in the UART_BAUD_TABLE of this ECU
+ */
+static uint8 BAUD_isSupported(UART_BaudRate a_baud)
+{
+	uint8 i;
+
+	for (i = 0; i < UART_BAUD_COUNT; i++)
+	{
+		if (g_uartBaudTable[i].baud_rate == a_baud)
+		{
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/* Description:
+ * byte a_index of the test burst, all the bit patterns change along the burst
+ */
+static uint8 BAUD_pattern(uint8 a_index)
+{
+	return (uint8)((a_index * 37) ^ 0x55);
+}
+
+/* Description:
+ * send the test burst and its CRC, low byte first
+ */
+static void BAUD_sendTest(void)
+{
+	uint16 crc = 0xFFFF;
+	uint8 data;
+	uint8 i;
+
+	for (i = 0; i < BAUD_TEST_SIZE; i++)
+	{
+		data = BAUD_pattern(i);
+		crc = _crc_ccitt_update(crc, data);
+		UART_sendByte(data);
+	}
+	UART_sendByte((uint8)crc);
+	UART_sendByte((uint8)(crc >> 8));
+}
+
+/* Description:
+ * receive the test burst, return TRUE if every byte came in time with the right CRC
+ */
+static uint8 BAUD_receiveTest(void)
+{
+	uint16 crc = 0xFFFF;
+	uint8 low;
+	uint8 high;
+	uint8 data;
+	uint8 i;
+
+	for (i = 0; i < BAUD_TEST_SIZE; i++)
+	{
+		if (!UART_receiveByteTimeout(&data, BAUD_TIMEOUT_MS))
+		{
+			return FALSE;
+		}
+		crc = _crc_ccitt_update(crc, data);
+	}
+
+	if (!UART_receiveByteTimeout(&low, BAUD_TIMEOUT_MS) ||
+		!UART_receiveByteTimeout(&high, BAUD_TIMEOUT_MS))
+	{
+		return FALSE;
+	}
+	return (crc == (((uint16)high << 8) | low)) ? TRUE : FALSE;
+}
+
+/* Description:
+ * master side of the test of the new rate, the master sends its burst first
+ */
+static uint8 BAUD_testMaster(void)
+{
+	uint8 data;
+
+	/* the slave tells when it switched */
+	if (!UART_receiveByteTimeout(&data, BAUD_TIMEOUT_MS) || (data != BAUD_READY))
+	{
+		return FALSE;
+	}
+
+	BAUD_sendTest();
+	if (!UART_receiveByteTimeout(&data, BAUD_TIMEOUT_MS) || (data != BAUD_PASS))
+	{
+		return FALSE;
+	}
+
+	if (!BAUD_receiveTest())
+	{
+		return FALSE;
+	}
+
+	/* the slave keeps the rate when it gets BAUD_PASS, the master when it gets
+	 * the confirmation, a lost confirmation is found by BAUD_checkLink
+	 */
+	UART_sendByte(BAUD_PASS);
+	return (UART_receiveByteTimeout(&data, BAUD_TIMEOUT_MS) && (data == BAUD_CONFIRM)) ?
+		TRUE : FALSE;
+}
+
+/* Description:
+ * slave side of the test of the new rate
+ */
+static uint8 BAUD_testSlave(void)
+{
+	uint8 data;
+
+	UART_sendByte(BAUD_READY);
+	if (!BAUD_receiveTest())
+	{
+		return FALSE;
+	}
+
+	UART_sendByte(BAUD_PASS);
+	BAUD_sendTest();
+
+	if (!UART_receiveByteTimeout(&data, BAUD_TIMEOUT_MS) || (data != BAUD_PASS))
+	{
+		return FALSE;
+	}
+
+	UART_sendByte(BAUD_CONFIRM);
+	return TRUE;
+}
+
+/* Description:
+ * master side, wait for the BAUD_READY of the slave and drop the other bytes,
+ * return FALSE if it doesn't come in BAUD_READY_WAIT_MS
+ */
+static uint8 BAUD_waitReady(void)
+{
+	uint16 waited;
+	uint8 data;
+
+	for (waited = 0; waited < BAUD_READY_WAIT_MS; waited += BAUD_READY_PERIOD_MS)
+	{
+		if (UART_receiveByteTimeout(&data, BAUD_READY_PERIOD_MS) && (data == BAUD_READY))
+		{
+			/* the BAUD_READY sent again while the master was busy are dropped */
+			UART_flush();
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/* Description:
+ * master side, the answer of the slave to a proposed rate, the BAUD_READY sent
+ * again before the proposal came are dropped
+ */
+static uint8 BAUD_receiveAnswer(void)
+{
+	uint8 data;
+
+	do
+	{
+		if (!UART_receiveByteTimeout(&data, BAUD_READY_PERIOD_MS))
+		{
+			return BAUD_REJECT;
+		}
+	} while (data == BAUD_READY);
+
+	return data;
+}
+
+/* Description:
+ * slave side, send BAUD_READY every BAUD_READY_PERIOD_MS until a command
+ * comes, BAUD_END if none came in BAUD_READY_WAIT_MS
+ */
+static uint8 BAUD_receiveCommand(void)
+{
+	uint16 waited;
+	uint8 command;
+
+	for (waited = 0; waited < BAUD_READY_WAIT_MS; waited += BAUD_READY_PERIOD_MS)
+	{
+		UART_sendByte(BAUD_READY);
+		if (UART_receiveByteTimeout(&command, BAUD_READY_PERIOD_MS) &&
+			((command == BAUD_PROPOSE) || (command == BAUD_END)))
+		{
+			return command;
+		}
+	}
+	return BAUD_END;
+}
+
+/* Description:
+ * the errors of the negotiation aren't counted by BAUD_checkLink, return a_baud
+ */
+static UART_BaudRate BAUD_start(UART_BaudRate a_baud)
+{
+	(void)UART_takeErrors();
+	g_errors = 0;
+	return a_baud;
+}
+
+UART_BaudRate BAUD_negotiateMaster(void)
+{
+	UART_BaudRate baud;
+	uint8 i = UART_BAUD_COUNT;
+	uint8 ready = BAUD_waitReady();
+
+	/* from the highest rate down to the first one above the default, while the
+	 * slave answers
+	 */
+	while (ready && (i > 0) && (g_uartBaudTable[i - 1].baud_rate > UART_BAUD_DEFAULT))
+	{
+		i--;
+		baud = g_uartBaudTable[i].baud_rate;
+
+		UART_sendByte(BAUD_PROPOSE);
+		UART_sendByte((uint8)((baud / 100) >> 8));
+		UART_sendByte((uint8)(baud / 100));
+
+		if (BAUD_receiveAnswer() == BAUD_ACCEPT)
+		{
+			UART_setBaudRate(baud);
+			if (BAUD_testMaster())
+			{
+				return BAUD_start(baud);
+			}
+
+			/* the bytes of the failed rate are dropped before the next BAUD_READY */
+			UART_setBaudRate(UART_BAUD_DEFAULT);
+			_delay_ms(BAUD_MASTER_SETTLE_MS);
+			UART_flush();
+		}
+
+		/* wait until the slave is ready for the next command */
+		ready = BAUD_waitReady();
+	}
+
+	if (ready)
+	{
+		UART_sendByte(BAUD_END);
+	}
+	else if (i == UART_BAUD_COUNT)
+	{
+		/* no BAUD_READY at all, a slave left at another rate by the reset of the
+		 * master gets bytes it can't read and starts the negotiation again
+		 */
+		for (i = 0; i < BAUD_ERROR_LIMIT; i++)
+		{
+			UART_sendByte(BAUD_END);
+		}
+		return BAUD_start(BAUD_NO_SLAVE);
+	}
+	return BAUD_start(UART_BAUD_DEFAULT);
+}
+
+UART_BaudRate BAUD_negotiateSlave(void)
+{
+	UART_BaudRate baud;
+	uint8 high;
+	uint8 low;
+
+	for (;;)
+	{
+		if (BAUD_receiveCommand() == BAUD_END)
+		{
+			return BAUD_start(UART_BAUD_DEFAULT);
+		}
+
+		/* BAUD_PROPOSE, a rate cut by a lost byte is asked again */
+		if (!UART_receiveByteTimeout(&high, BAUD_TIMEOUT_MS) ||
+			!UART_receiveByteTimeout(&low, BAUD_TIMEOUT_MS))
+		{
+			continue;
+		}
+		baud = (((UART_BaudRate)high << 8) | low) * 100;
+
+		if (!BAUD_isSupported(baud))
+		{
+			UART_sendByte(BAUD_REJECT);
+			continue;
+		}
+
+		UART_sendByte(BAUD_ACCEPT);
+		UART_setBaudRate(baud);
+		if (BAUD_testSlave())
+		{
+			return BAUD_start(baud);
+		}
+
+		UART_setBaudRate(UART_BAUD_DEFAULT);
+		_delay_ms(BAUD_SLAVE_SETTLE_MS);
+		UART_flush();
+	}
+}
+
+uint8 BAUD_checkLink(void)
+{
+	uint8 errors = UART_takeErrors();
+
+	if (errors == 0)
+	{
+		return BAUD_LINK_OK;
+	}
+
+	/* the bytes received with the errors can't be trusted */
+	UART_flush();
+	g_errors = (errors >= (BAUD_ERROR_LIMIT - g_errors)) ? BAUD_ERROR_LIMIT : (g_errors + errors);
+	if (g_errors < BAUD_ERROR_LIMIT)
+	{
+		return BAUD_LINK_ERROR;
+	}
+
+	UART_setBaudRate(UART_BAUD_DEFAULT);
+	g_errors = 0;
+	return BAUD_LINK_LOST;
+}
@@ -0,0 +1,106 @@
+/*
+ * baud.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: header file of the UART baud rate negotiation, the two ECUs
+ *      			 start at UART_BAUD_DEFAULT and step up to the highest rate of
+ *      			 both baud tables which passes a CRC checked exchange
+ *
+ *      The CONTROL_ECU is the master, it proposes its rates from the highest and
+ *      the HMI_ECU accepts the rates of its own table. After an accepted rate both
+ *      ECUs switch and send a test burst with its CRC-CCITT in each direction.
+ *      The master answers the burst of the slave with BAUD_PASS and the slave
+ *      confirms it with BAUD_CONFIRM, the rate is kept by the master only after
+ *      the confirmation. Else both ECUs go back to UART_BAUD_DEFAULT and the next
+ *      lower rate is tried.
+ *
+ *      The slave sends BAUD_READY again every BAUD_READY_PERIOD_MS until it gets
+ *      a command and the master waits for it BAUD_READY_WAIT_MS at most, so an
+ *      ECU started alone keeps UART_BAUD_DEFAULT instead of waiting forever.
+ *
+ *      The ECUs don't run at the same rate after the reset of one of them or a
+ *      lost BAUD_CONFIRM, the bytes are then received with frame errors. When
+ *      BAUD_checkLink counts BAUD_ERROR_LIMIT of them it goes back to
+ *      UART_BAUD_DEFAULT and the negotiation is run again: the slave starts it
+ *      with its BAUD_READY, the master runs it when it gets BAUD_READY instead of
+ *      a command. A master which got no BAUD_READY at its reset sends
+ *      BAUD_ERROR_LIMIT bytes at UART_BAUD_DEFAULT, so a slave left at another
+ *      rate sees them.
+ *
+ *      The test burst is as long as the longest frame sent without a handshake
+ *      (the trace dump), a receiver too slow for the rate overruns in it.
+ */
+
+#ifndef BAUD_H_
+#define BAUD_H_
+
+#include "uart.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* negotiation bytes */
+#define BAUD_READY				'H' /* the slave waits for the next command */
+#define BAUD_PROPOSE			'B' /* followed by the rate / 100, high byte first */
+#define BAUD_END				'E' /* no more rate to try, UART_BAUD_DEFAULT is kept */
+#define BAUD_ACCEPT				'Y'
+#define BAUD_REJECT				'N'
+#define BAUD_PASS				'A' /* the test burst was received with a right CRC */
+#define BAUD_CONFIRM			'C' /* the slave got the BAUD_PASS of the master */
+
+/* test burst bytes, the CRC-CCITT follows them */
+#define BAUD_TEST_SIZE			64
+
+/* wait for every byte at the tested rate */
+#define BAUD_TIMEOUT_MS			20
+
+/* after a failed rate the master waits for the slave to stop sending before it
+ * drops the received bytes, the slave waits longer so its BAUD_READY comes after
+ */
+#define BAUD_MASTER_SETTLE_MS	(4 * BAUD_TIMEOUT_MS)
+#define BAUD_SLAVE_SETTLE_MS	(8 * BAUD_TIMEOUT_MS)
+
+/* BAUD_READY of the slave, it is sent again every period until the wait is over */
+#define BAUD_READY_PERIOD_MS	50
+#define BAUD_READY_WAIT_MS		1000
+
+/* bytes received with an error before BAUD_checkLink drops the rate */
+#define BAUD_ERROR_LIMIT		4
+
+/* BAUD_negotiateMaster without any BAUD_READY, the rate is UART_BAUD_DEFAULT */
+#define BAUD_NO_SLAVE			0
+
+/* results of BAUD_checkLink */
+#define BAUD_LINK_OK			0
+#define BAUD_LINK_ERROR			1 /* bytes with an error were dropped */
+#define BAUD_LINK_LOST			2 /* the rate is back at UART_BAUD_DEFAULT */
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * CONTROL_ECU side of the negotiation, return the baud rate in use at the end
+ * or BAUD_NO_SLAVE if the slave never answered.
+ */
+UART_BaudRate BAUD_negotiateMaster(void);
+
+/*
+ * Description :
+ * HMI_ECU side of the negotiation, return the baud rate in use at the end.
+ */
+UART_BaudRate BAUD_negotiateSlave(void);
+
+/*
+ * Description :
+ * Count the bytes received with an error since the last negotiation, the Rx
+ * buffer is emptied when there are new ones. Return BAUD_LINK_LOST after
+ * BAUD_ERROR_LIMIT of them, the UART is then back at UART_BAUD_DEFAULT and the
+ * caller must negotiate again.
+ */
+uint8 BAUD_checkLink(void);
+
+#endif /* BAUD_H_ */
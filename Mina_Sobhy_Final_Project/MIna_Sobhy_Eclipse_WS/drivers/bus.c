@@ -0,0 +1,630 @@
+/*
+ * bus.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: source file of the RS-485 multi-drop bus, the master side is
+ *      			 built for the CONTROL_ECU (BOARD_BUS_NODES) and the node side
+ *      			 for the HMI_ECU (BOARD_BUS_ADDRESS), nothing without them
+ */
+
+#include "bus.h"
+#include "uart.h"
+#include "common_macros.h"
+#include "trace.h"
+#include "power.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/crc16.h>
+#include <util/delay.h>
+
+#if BUS_ENABLED
+
+/* the boards with performance counters count the bus traffic in diag.c */
+#if BOARD_DIAG
+#include "diag.h"
+#else
+#define DIAG_COUNT(counter)
+#endif
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#if !defined(BUS_DE_PORT) || !defined(BUS_DE_DDR) || !defined(BUS_DE_PIN)
+#error "bus.c: board_config.h must give the driver enable pin (BUS_DE_PORT, BUS_DE_DDR, BUS_DE_PIN)"
+#endif
+
+#define BUS_IS_MASTER			(BOARD_BUS_NODES != 0)
+#define BUS_LINKS				(BUS_IS_MASTER ? BOARD_BUS_NODES : 1)
+#define BUS_QUEUE_MASK			(BUS_QUEUE_SIZE - 1)
+
+/* sent with the driver disabled to time the answers, it never reaches the wires */
+#define BUS_FILLER				0xFF
+
+/* a node starts its answer two bits after the poll, the master drops its driver
+ * enable at the end of the stop bit and the node sees the frame in the middle of it
+ */
+#define BUS_TURNAROUND_US		(2000000UL / BUS_BAUD)
+
+/* link flags */
+#define BUS_LINK_SEQUENCE		0x01	/* sequence bit of the data in flight or sent next */
+#define BUS_LINK_EXPECTED		0x02	/* sequence bit of the next data taken */
+#define BUS_LINK_RESET			0x04	/* this side restarted, not acknowledged yet */
+#define BUS_LINK_RESET_ACK		0x08	/* the other side restarted, acknowledged until it stops saying so */
+#define BUS_LINK_SEEN			0x10	/* master: the node answered since the start */
+#define BUS_LINK_NEW			0x20	/* master: the node is new, BUS_isNew didn't take it yet */
+
+/* master states of the poll of a node */
+#define BUS_STATE_POLL			0	/* poll frame sent with the driver enabled */
+#define BUS_STATE_WAIT			1	/* filler bytes until the answer */
+#define BUS_STATE_DONE			2	/* answer received, the filler being sent ends it */
+#define BUS_STATE_GUARD			3	/* one more filler while the node drops its driver */
+
+/* the UBRR value is taken from the UART formula, the build fails if the rate is too far */
+#define BUS_UBRR				UART_UBRR(BUS_BAUD)
+typedef char BUS_baudCheck[(UART_BAUD_ERROR(BUS_BAUD) <= UART_BAUD_MAX_ERROR) ? 1 : -1];
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef struct
+{
+	uint8			data[BUS_QUEUE_SIZE];
+	volatile uint8	head	; /* next byte written */
+	volatile uint8	tail	; /* next byte read */
+} BUS_QueueType;
+
+/* one direction pair with the other side: a node for the master, the master for a node */
+typedef struct
+{
+	BUS_QueueType	rx			; /* received, read by the main context */
+	BUS_QueueType	tx			; /* written by the main context, sent by the interrupts */
+	volatile uint8	flags		;
+	uint8			inflight	; /* bytes at the tx tail sent and not acknowledged */
+#if BUS_IS_MASTER
+	uint8			misses		; /* polls without an answer in a row */
+	uint8			rxStart		; /* first byte received since the node became new */
+#endif
+} BUS_LinkType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static BUS_LinkType g_links[BUS_LINKS];
+static BUS_StatsType g_stats;
+
+/* frame sent by the data register empty interrupt, the CRC is added at its end */
+static uint8 g_txFrame[BUS_FRAME_DATA + 2];
+static uint8 g_txSize = 0;
+static uint8 g_txIndex = 0;
+static uint8 g_txCrc = 0;
+
+/* control and data bytes of the frame being received */
+static uint8 g_rxFrame[BUS_FRAME_DATA + 1];
+static uint8 g_rxIndex = 0;
+static uint8 g_rxCrc = 0;
+static uint8 g_rxActive = FALSE;
+
+#if BUS_IS_MASTER
+static uint8 g_node = BOARD_BUS_NODES; /* node polled, the first poll goes to node 1 */
+static uint8 g_state = BUS_STATE_POLL;
+static uint8 g_fillers = 0;
+static uint8 g_filler = FALSE; /* TRUE: the data register empty interrupt sends a filler */
+static uint8 g_cycle = 0;
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static BUS_LinkType * BUS_link(uint8 a_node);
+static uint8 BUS_count(const BUS_QueueType * a_queue);
+static void BUS_startFrame(uint8 a_address, BUS_LinkType * a_link);
+static void BUS_takeFrame(BUS_LinkType * a_link);
+static void BUS_error(void);
+#if BUS_IS_MASTER
+static void BUS_nextPoll(void);
+static void BUS_sendFiller(void);
+#endif
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+
+ISR(USART_RXC_vect)
+{
+	uint8 status = UCSRA;
+	uint8 address = BIT_IS_SET(UCSRB, RXB8); /* the 9th bit is read before UDR */
+	uint8 data = UDR;
+#if BUS_IS_MASTER
+	BUS_LinkType * link;
+#endif
+
+	if (status & ((1<<FE) | (1<<DOR)))
+	{
+		BUS_error();
+		return;
+	}
+
+	if (address)
+	{
+		/* a frame starts, only the frames to this board are taken. The master
+		 * takes the answer of the polled node only while it waits for it
+		 */
+		g_rxActive = (data == BOARD_BUS_ADDRESS);
+#if BUS_IS_MASTER
+		g_rxActive = g_rxActive && (g_state == BUS_STATE_WAIT);
+#else
+		if (g_rxActive)
+		{
+			CLEAR_BIT(UCSRA, MPCM);
+		}
+#endif
+		g_rxIndex = 0;
+		g_rxCrc = _crc8_ccitt_update(0, data);
+		return;
+	}
+
+	if (!g_rxActive)
+	{
+		return;
+	}
+
+	/* the control byte then its data bytes */
+	if ((g_rxIndex == 0) || (g_rxIndex <= (g_rxFrame[0] & BUS_CONTROL_LENGTH)))
+	{
+		if ((g_rxIndex == 0) && ((data & BUS_CONTROL_LENGTH) > BUS_FRAME_DATA))
+		{
+			BUS_error();
+			return;
+		}
+		g_rxFrame[g_rxIndex] = data;
+		g_rxIndex++;
+		g_rxCrc = _crc8_ccitt_update(g_rxCrc, data);
+		return;
+	}
+
+	/* the CRC ends the frame */
+	g_rxActive = FALSE;
+#if !BUS_IS_MASTER
+	SET_BIT(UCSRA, MPCM);
+#endif
+	if (data != g_rxCrc)
+	{
+		BUS_error();
+		return;
+	}
+	g_stats.answers++;
+
+#if BUS_IS_MASTER
+	link = &g_links[g_node - 1];
+	link->misses = 0;
+
+	/* a node answering for the first time since the start is new as well */
+	if (!(link->flags & BUS_LINK_SEEN))
+	{
+		link->flags |= BUS_LINK_SEEN | BUS_LINK_NEW;
+		link->rxStart = link->rx.head;
+	}
+	BUS_takeFrame(link);
+	g_state = BUS_STATE_DONE;
+#else
+	BUS_takeFrame(&g_links[0]);
+
+	/* the node answers at once, the master waits for it */
+	_delay_us(BUS_TURNAROUND_US);
+	BUS_startFrame(BUS_MASTER, &g_links[0]);
+#endif
+}
+
+ISR(USART_UDRE_vect)
+{
+	uint8 data;
+
+#if BUS_IS_MASTER
+	if (g_filler)
+	{
+		CLEAR_BIT(UCSRB, TXB8);
+		UDR = BUS_FILLER;
+		CLEAR_BIT(UCSRB, UDRIE);
+		return;
+	}
+#endif
+
+	/* the CRC ends the frame, the transmit complete interrupt comes after it */
+	if (g_txIndex == g_txSize)
+	{
+		UDR = g_txCrc;
+		CLEAR_BIT(UCSRB, UDRIE);
+		return;
+	}
+
+	/* the 9th bit marks the address byte, it is written before UDR */
+	data = g_txFrame[g_txIndex];
+	if (g_txIndex == 0)
+	{
+		SET_BIT(UCSRB, TXB8);
+		g_txCrc = 0;
+	}
+	else
+	{
+		CLEAR_BIT(UCSRB, TXB8);
+	}
+	g_txCrc = _crc8_ccitt_update(g_txCrc, data);
+	UDR = data;
+	g_txIndex++;
+}
+
+ISR(USART_TXC_vect)
+{
+#if BUS_IS_MASTER
+	BUS_LinkType * link;
+
+	switch (g_state)
+	{
+	/* the poll is out, the wires are left to the node */
+	case BUS_STATE_POLL:
+		CLEAR_BIT(BUS_DE_PORT, BUS_DE_PIN);
+		g_state = BUS_STATE_WAIT;
+		g_fillers = BUS_REPLY_SLOT;
+		break;
+
+	/* no complete answer at the end of the slot */
+	case BUS_STATE_WAIT:
+		if (g_fillers == 0)
+		{
+			g_rxActive = FALSE;
+			g_stats.timeouts++;
+			link = &g_links[g_node - 1];
+			if (link->misses != 0xFF)
+			{
+				link->misses++;
+			}
+			BUS_nextPoll();
+			return;
+		}
+		break;
+
+	case BUS_STATE_DONE:
+		g_state = BUS_STATE_GUARD;
+		break;
+
+	default:
+		BUS_nextPoll();
+		return;
+	}
+
+	BUS_sendFiller();
+#else
+	/* the answer is out, the wires are left to the master */
+	CLEAR_BIT(BUS_DE_PORT, BUS_DE_PIN);
+#endif
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+static BUS_LinkType * BUS_link(uint8 a_node)
+{
+#if BUS_IS_MASTER
+	return &g_links[a_node - 1];
+#else
+	(void)a_node;
+	return &g_links[0];
+#endif
+}
+
+static uint8 BUS_count(const BUS_QueueType * a_queue)
+{
+	return (uint8)(a_queue->head - a_queue->tail) & BUS_QUEUE_MASK;
+}
+
+/* Description:
+ * count a frame dropped by the receiver
+ */
+static void BUS_error(void)
+{
+	g_rxActive = FALSE;
+#if !BUS_IS_MASTER
+	SET_BIT(UCSRA, MPCM);
+#endif
+	if (g_stats.errors != 0xFFFF)
+	{
+		g_stats.errors++;
+	}
+	DIAG_COUNT(uart_errors);
+}
+
+/* Description:
+ * build the next frame to a_address from the queue of a_link and start sending it
+ */
+static void BUS_startFrame(uint8 a_address, BUS_LinkType * a_link)
+{
+	uint8 tail = a_link->tx.tail;
+	uint8 control;
+	uint8 i;
+
+	/* the data in flight is sent again until it is acknowledged, a new node
+	 * gets no data until the main context took it
+	 */
+	if (a_link->inflight != 0)
+	{
+		if (g_stats.retries != 0xFFFF)
+		{
+			g_stats.retries++;
+		}
+	}
+#if BUS_IS_MASTER
+	else if (!(a_link->flags & BUS_LINK_NEW))
+#else
+	else
+#endif
+	{
+		a_link->inflight = BUS_count(&a_link->tx);
+		if (a_link->inflight > BUS_FRAME_DATA)
+		{
+			a_link->inflight = BUS_FRAME_DATA;
+		}
+	}
+
+	control = a_link->inflight;
+	if (a_link->flags & BUS_LINK_SEQUENCE)
+	{
+		control |= BUS_CONTROL_SEQUENCE;
+	}
+	if (a_link->flags & BUS_LINK_EXPECTED)
+	{
+		control |= BUS_CONTROL_ACK;
+	}
+	if (a_link->flags & BUS_LINK_RESET)
+	{
+		control |= BUS_CONTROL_RESET;
+	}
+	if (a_link->flags & BUS_LINK_RESET_ACK)
+	{
+		control |= BUS_CONTROL_RESET_ACK;
+	}
+
+	g_txFrame[0] = a_address;
+	g_txFrame[1] = control;
+	for (i = 0; i < a_link->inflight; i++)
+	{
+		g_txFrame[2 + i] = a_link->tx.data[(tail + i) & BUS_QUEUE_MASK];
+	}
+	g_txSize = 2 + a_link->inflight;
+	g_txIndex = 0;
+
+	/* the driver is enabled before the first byte, the transmit complete
+	 * interrupt of the last one disables it
+	 */
+	SET_BIT(BUS_DE_PORT, BUS_DE_PIN);
+	SET_BIT(UCSRB, UDRIE);
+}
+
+/* Description:
+ * take the acknowledgement and the data of a received frame
+ */
+static void BUS_takeFrame(BUS_LinkType * a_link)
+{
+	uint8 control = g_rxFrame[0];
+	uint8 length = control & BUS_CONTROL_LENGTH;
+	uint8 head;
+	uint8 i;
+
+	/* a restart of the other side is taken once, the sequence bits start again */
+	if (control & BUS_CONTROL_RESET)
+	{
+		if (!(a_link->flags & BUS_LINK_RESET_ACK))
+		{
+			a_link->flags &= ~(BUS_LINK_SEQUENCE | BUS_LINK_EXPECTED);
+			a_link->flags |= BUS_LINK_RESET_ACK;
+			a_link->inflight = 0;
+#if BUS_IS_MASTER
+			a_link->flags |= BUS_LINK_NEW;
+			a_link->rxStart = a_link->rx.head;
+#endif
+		}
+	}
+	else
+	{
+		a_link->flags &= ~BUS_LINK_RESET_ACK;
+	}
+	if (control & BUS_CONTROL_RESET_ACK)
+	{
+		a_link->flags &= ~BUS_LINK_RESET;
+	}
+
+	/* the other side expects the next sequence bit: the data in flight arrived */
+	if ((a_link->inflight != 0) && (!(control & BUS_CONTROL_ACK) != !(a_link->flags & BUS_LINK_SEQUENCE)))
+	{
+		a_link->tx.tail = (a_link->tx.tail + a_link->inflight) & BUS_QUEUE_MASK;
+		a_link->inflight = 0;
+		a_link->flags ^= BUS_LINK_SEQUENCE;
+	}
+
+	/* new data is taken if it fits, else it isn't acknowledged and comes again */
+	if ((length != 0) && (!(control & BUS_CONTROL_SEQUENCE) == !(a_link->flags & BUS_LINK_EXPECTED))
+		&& ((BUS_QUEUE_SIZE - 1 - BUS_count(&a_link->rx)) >= length))
+	{
+		head = a_link->rx.head;
+		for (i = 0; i < length; i++)
+		{
+			a_link->rx.data[head] = g_rxFrame[1 + i];
+			head = (head + 1) & BUS_QUEUE_MASK;
+		}
+		a_link->rx.head = head;
+		a_link->flags ^= BUS_LINK_EXPECTED;
+	}
+}
+
+#if BUS_IS_MASTER
+/* Description:
+ * poll the next node, the absent nodes are only polled once every
+ * BUS_ABSENT_CYCLES cycles and not all in the same cycle
+ */
+static void BUS_nextPoll(void)
+{
+	uint8 i;
+
+	for (i = 0; i < BOARD_BUS_NODES; i++)
+	{
+		g_node++;
+		if (g_node > BOARD_BUS_NODES)
+		{
+			g_node = 1;
+			g_cycle++;
+			g_stats.cycles++;
+		}
+		if ((g_links[g_node - 1].misses < BUS_ABSENT_MISSES)
+			|| (((uint8)(g_cycle + g_node) % BUS_ABSENT_CYCLES) == 0))
+		{
+			break;
+		}
+	}
+
+	g_filler = FALSE;
+	g_state = BUS_STATE_POLL;
+	g_stats.polls++;
+	BUS_startFrame(g_node, &g_links[g_node - 1]);
+}
+
+/* Description:
+ * send one filler byte, its transmit complete interrupt comes one byte time later
+ */
+static void BUS_sendFiller(void)
+{
+	if (g_fillers != 0)
+	{
+		g_fillers--;
+	}
+	g_filler = TRUE;
+	SET_BIT(UCSRB, UDRIE);
+}
+#endif
+
+void BUS_init(void)
+{
+	uint8 i;
+
+	for (i = 0; i < BUS_LINKS; i++)
+	{
+		g_links[i].flags = BUS_LINK_RESET;
+	}
+
+	/* the transceiver listens until a frame is sent */
+	CLEAR_BIT(BUS_DE_PORT, BUS_DE_PIN);
+	SET_BIT(BUS_DE_DDR, BUS_DE_PIN);
+
+	/* U2X = 1, a node only receives the address bytes (MPCM) until its own */
+#if BUS_IS_MASTER
+	UCSRA = (1<<U2X);
+#else
+	UCSRA = (1<<U2X) | (1<<MPCM);
+#endif
+
+	/* 9 data bits (UCSZ2:0 = 7), no parity, 1 stop bit, the three interrupts of
+	 * the bus with the receiver and the transmitter
+	 */
+	UCSRB = (1<<RXCIE) | (1<<TXCIE) | (1<<RXEN) | (1<<TXEN) | (1<<UCSZ2);
+	UCSRC = (1<<URSEL) | (1<<UCSZ1) | (1<<UCSZ0);
+	UBRRH = (uint8)(BUS_UBRR >> 8);
+	UBRRL = (uint8)BUS_UBRR;
+
+#if BUS_IS_MASTER
+	/* the polls run in the interrupts from now on */
+	BUS_nextPoll();
+#endif
+}
+
+void BUS_sendByte(uint8 a_node, uint8 a_data)
+{
+	BUS_QueueType * queue = &BUS_link(a_node)->tx;
+	uint8 head = queue->head;
+	uint8 next = (head + 1) & BUS_QUEUE_MASK;
+
+	TRACE(TRACE_UART_TX, a_data);
+	DIAG_COUNT(uart_tx_bytes);
+
+	/* the interrupts free the queue when the other side acknowledges the bytes,
+	 * they are disabled for the last check as in BUS_receiveByte
+	 */
+	cli();
+	while (next == queue->tail)
+	{
+		POWER_sleep(POWER_WAKE_UART);
+		cli();
+	}
+	sei();
+
+	queue->data[head] = a_data;
+	queue->head = next;
+}
+
+uint8 BUS_receiveByte(uint8 a_node)
+{
+	BUS_QueueType * queue = &BUS_link(a_node)->rx;
+	uint8 data;
+
+	/* the interrupts are disabled for the last check, as in UART_receiveByte */
+	cli();
+	while (queue->head == queue->tail)
+	{
+		POWER_sleep(POWER_WAKE_UART);
+		cli();
+	}
+	sei();
+
+	data = queue->data[queue->tail];
+	queue->tail = (queue->tail + 1) & BUS_QUEUE_MASK;
+	TRACE(TRACE_UART_RX, data);
+	DIAG_COUNT(uart_rx_bytes);
+
+	return data;
+}
+
+uint8 BUS_isDataAvailable(uint8 a_node)
+{
+	const BUS_QueueType * queue = &BUS_link(a_node)->rx;
+
+	return (queue->head != queue->tail);
+}
+
+uint8 BUS_isNew(uint8 a_node)
+{
+#if BUS_IS_MASTER
+	BUS_LinkType * link = BUS_link(a_node);
+	uint8 sreg = SREG;
+	uint8 isNew = FALSE;
+
+	cli();
+	if (link->flags & BUS_LINK_NEW)
+	{
+		link->flags &= ~BUS_LINK_NEW;
+		link->rx.tail = link->rxStart;
+		link->tx.tail = link->tx.head;
+		link->inflight = 0;
+		isNew = TRUE;
+	}
+	SREG = sreg;
+
+	return isNew;
+#else
+	(void)a_node;
+	return FALSE;
+#endif
+}
+
+void BUS_getStats(BUS_StatsType * a_stats)
+{
+	uint8 sreg = SREG;
+
+	cli();
+	*a_stats = g_stats;
+	SREG = sreg;
+}
+
+#endif /* BUS_ENABLED */
@@ -0,0 +1,162 @@
+/*
+ * bus.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: header file of the RS-485 multi-drop bus, the CONTROL_ECU
+ *      			 polls up to BUS_NODES_MAX HMI_ECU keypads on one pair of wires,
+ *      			 the same file is used by the two ECUs
+ *
+ *      The bus replaces the point-to-point UART link when board_config.h sets
+ *      BOARD_BUS_NODES (CONTROL_ECU, number of HMI_ECUs polled) or
+ *      BOARD_BUS_ADDRESS (HMI_ECU, its node address from 1). The UART runs with
+ *      9 data bits, the 9th bit marks the address byte starting every frame and
+ *      the HMI_ECUs use the multi-processor mode (MPCM) so the frames of the
+ *      other nodes don't interrupt them.
+ *
+ *      Frame: address | control | 0 to BUS_FRAME_DATA bytes | CRC-8 of the rest
+ *
+ *      The master sends one frame to every node in turn, the node answers at
+ *      once from its receive interrupt with a frame to BUS_MASTER. The master
+ *      times the answer with its own transmitter: it sends BUS_REPLY_SLOT filler
+ *      bytes with the RS-485 driver disabled, so they never reach the wires, and
+ *      the node is skipped if its answer isn't complete at the end of them. The
+ *      driver enable pin is raised before the first byte of a frame and dropped
+ *      in the transmit complete interrupt of its last byte.
+ *
+ *      Every direction of every node is an alternating bit link: the data of a
+ *      frame is sent again until the other side acknowledges its sequence bit,
+ *      a frame with a wrong CRC is dropped. A node which restarted sets
+ *      BUS_CONTROL_RESET until the other side acknowledges it, then both sides
+ *      start their sequence bits again.
+ *
+ *      Poll cycle: every node takes a poll frame, the turnaround, its answer and
+ *      one filler while its driver is released, with no data about 8 bytes of
+ *      11 bits (1.4 ms at 62500 baud, 23 ms for 16 nodes). A node missing
+ *      BUS_ABSENT_MISSES answers is only polled once every BUS_ABSENT_CYCLES
+ *      cycles, so the keypads which aren't fitted add little to the cycle.
+ */
+
+#ifndef BUS_H_
+#define BUS_H_
+
+#include "std_types.h"
+#include "board_config.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* the board which doesn't set one of them isn't on that side of the bus */
+#ifndef BOARD_BUS_NODES
+#define BOARD_BUS_NODES			0
+#endif
+#ifndef BOARD_BUS_ADDRESS
+#define BOARD_BUS_ADDRESS		0
+#endif
+
+#define BUS_MASTER				0	/* address of the CONTROL_ECU */
+#define BUS_NODES_MAX			16
+
+#define BUS_ENABLED				((BOARD_BUS_NODES != 0) || (BOARD_BUS_ADDRESS != 0))
+
+#if (BOARD_BUS_NODES != 0) && (BOARD_BUS_ADDRESS != 0)
+#error "bus.h: a board is either the bus master or a node"
+#endif
+#if (BOARD_BUS_NODES > BUS_NODES_MAX) || (BOARD_BUS_ADDRESS > BUS_NODES_MAX)
+#error "bus.h: more than BUS_NODES_MAX nodes"
+#endif
+
+/* the two ECUs set the same rate, exact for UBRR at 1 MHz and 8 MHz with U2X */
+#ifndef BUS_BAUD
+#define BUS_BAUD				62500UL
+#endif
+
+/* bytes of the queues of every node, a power of 2 up to 128 */
+#ifndef BUS_QUEUE_SIZE
+#define BUS_QUEUE_SIZE			16
+#endif
+
+#if (BUS_QUEUE_SIZE & (BUS_QUEUE_SIZE - 1)) || (BUS_QUEUE_SIZE < 16) || (BUS_QUEUE_SIZE > 128)
+#error "BUS_QUEUE_SIZE must be a power of 2 from 16 to 128"
+#endif
+
+/* most data bytes in a frame */
+#define BUS_FRAME_DATA			8
+
+/* control byte */
+#define BUS_CONTROL_LENGTH		0x0F	/* data bytes of the frame */
+#define BUS_CONTROL_SEQUENCE	0x10	/* sequence bit of the data */
+#define BUS_CONTROL_ACK			0x20	/* sequence bit expected next from the other side */
+#define BUS_CONTROL_RESET		0x40	/* the sender restarted */
+#define BUS_CONTROL_RESET_ACK	0x80	/* the restart of the other side was seen */
+
+/* filler bytes sent by the master after a poll: the turnaround of the node and
+ * its longest answer, with one byte of margin
+ */
+#define BUS_REPLY_SLOT			(BUS_FRAME_DATA + 3 + 2)
+
+/* a node missing this number of answers in a row is absent */
+#define BUS_ABSENT_MISSES		3
+#define BUS_ABSENT_CYCLES		8
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef struct
+{
+	uint32	cycles		; /* poll cycles of all the nodes */
+	uint32	polls		; /* frames sent by the master */
+	uint32	answers		; /* frames received with a right CRC */
+	uint16	timeouts	; /* polls without a complete answer */
+	uint16	errors		; /* frames with a wrong CRC, frame or overrun errors */
+	uint16	retries		; /* data frames sent again */
+} BUS_StatsType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Setup the UART for 9 data bits at BUS_BAUD and the driver enable pin, the
+ * master starts polling its nodes in the interrupts.
+ */
+void BUS_init(void);
+
+/*
+ * Description :
+ * Queue a byte for a_node (BUS_MASTER on a node), it is sent in the next frames.
+ * The CPU sleeps while the queue of a_node is full.
+ */
+void BUS_sendByte(uint8 a_node, uint8 a_data);
+
+/*
+ * Description :
+ * Receive a byte from a_node (BUS_MASTER on a node), the CPU sleeps until one
+ * is received.
+ */
+uint8 BUS_receiveByte(uint8 a_node);
+
+/*
+ * Description :
+ * Return TRUE if a byte received from a_node is waiting, it doesn't block.
+ */
+uint8 BUS_isDataAvailable(uint8 a_node);
+
+/*
+ * Description :
+ * Master only: return TRUE once after a_node answered for the first time or
+ * restarted. The bytes received from the node before and the bytes still
+ * queued for it are dropped, no data is sent to the node until this call.
+ */
+uint8 BUS_isNew(uint8 a_node);
+
+/*
+ * Description :
+ * Copy the counters of the bus.
+ */
+void BUS_getStats(BUS_StatsType * a_stats);
+
+#endif /* BUS_H_ */
@@ -0,0 +1,46 @@
+################################################################################
+# drivers.mk
+#
+#  Created on: Oct 19, 2026
+#      Author: Mina sobhy
+#      description: release build of an ECU image with the shared drivers, it is
+#      			 included by the makefile.targets of the two Eclipse projects
+#      			 and runs from their Debug directory with "make lto"
+#
+#      The application and the drivers are built in one avr-gcc call with the
+#      board_config.h of the ECU. -flto and --gc-sections drop every function the
+#      ECU doesn't call (UART_sendString, the unused side of baud.c, ...) and the
+#      flash and RAM of the image are printed at the end.
+#
+#      variables set by the project: BOARD_NAME (image name), BOARD_F_CPU,
+#      BOARD_LDFLAGS (linker options of the board, may be empty)
+################################################################################
+
+DRIVERS_DIR := ../../drivers
+LTO_DIR := lto
+LTO_ELF := $(LTO_DIR)/$(BOARD_NAME).elf
+LTO_SRCS := $(wildcard ../*.c) $(wildcard $(DRIVERS_DIR)/*.c)
+LTO_HDRS := $(wildcard ../*.h) $(wildcard $(DRIVERS_DIR)/*.h)
+
+# the options of the Debug configuration, optimized for size
+LTO_CFLAGS := -Wall -Os -flto -fpack-struct -fshort-enums -ffunction-sections -fdata-sections \
+	-std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega32 -DF_CPU=$(BOARD_F_CPU) \
+	-I".." -I"$(DRIVERS_DIR)"
+LTO_LDFLAGS := -Wl,--gc-sections -Wl,-Map,$(LTO_DIR)/$(BOARD_NAME).map $(BOARD_LDFLAGS)
+
+lto: $(LTO_ELF)
+	@echo 'Invoking: Print Size'
+	-avr-size --format=avr --mcu=atmega32 $(LTO_ELF)
+
+$(LTO_ELF): $(LTO_SRCS) $(LTO_HDRS) $(DRIVERS_DIR)/drivers.mk
+	@echo 'Building target: $@'
+	@mkdir -p $(LTO_DIR)
+	avr-gcc $(LTO_CFLAGS) $(LTO_LDFLAGS) -o $@ $(LTO_SRCS)
+	-avr-objcopy -R .eeprom -R .fuse -R .lock -R .signature -O ihex $@ $(LTO_DIR)/$(BOARD_NAME).hex
+	@echo 'Finished building target: $@'
+	@echo ' '
+
+lto-clean:
+	-$(RM) $(LTO_DIR)
+
+.PHONY: lto lto-clean
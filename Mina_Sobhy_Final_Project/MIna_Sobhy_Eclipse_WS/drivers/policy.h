@@ -0,0 +1,55 @@
+/*
+ * policy.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: system policy shared by the two ECUs, the CONTROL_ECU keeps it
+ *      			 in the external EEPROM and sends it to the HMI_ECU at the start
+ *      			 and after every change
+ */
+
+#ifndef POLICY_H_
+#define POLICY_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* changed whenever the policy record layout changes */
+#define POLICY_VERSION				1
+
+/* allowed range of every policy value */
+#define POLICY_PASS_MIN_SIZE		4
+#define POLICY_PASS_MAX_SIZE		12
+#define POLICY_ATTEMPTS_MIN			1
+#define POLICY_ATTEMPTS_MAX			9
+#define POLICY_LOCKOUT_MIN			10
+#define POLICY_LOCKOUT_MAX			3600
+#define POLICY_DOOR_MIN				1
+#define POLICY_DOOR_MAX				60
+
+/* default policy used when the EEPROM has no valid policy record */
+#define POLICY_DEFAULT_PASS_MIN		5
+#define POLICY_DEFAULT_PASS_MAX		5
+#define POLICY_DEFAULT_ATTEMPTS		3
+#define POLICY_DEFAULT_LOCKOUT		60
+#define POLICY_DEFAULT_DOOR_MOVE	15
+#define POLICY_DEFAULT_DOOR_HOLD	3
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+typedef struct
+{
+	uint8	version			; /* POLICY_VERSION, an erased EEPROM reads 0xFF */
+	uint8	pass_min		; /* minimum number of password characters */
+	uint8	pass_max		; /* maximum number of password characters */
+	uint8	max_attempts	; /* wrong passwords before the system is locked */
+	uint16	lockout_seconds	; /* duration of the first lockout */
+	uint8	door_move		; /* seconds to unlock or lock the door */
+	uint8	door_hold		; /* seconds the door is kept open */
+} POLICY_ConfigType;
+
+#endif /* POLICY_H_ */
@@ -0,0 +1,131 @@
+/*
+ * power.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: source file of the power manager
+ */
+
+#include "power.h"
+#include "common_macros.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static uint8 POWER_enabledWake(uint8 a_wake);
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+
+/* nothing to do, the interrupt only wakes the CPU */
+ISR(TIMER2_COMP_vect)
+{
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void POWER_init(void)
+{
+	/* ADC off, it is off after the reset but it would draw current in every mode */
+	CLEAR_BIT(ADCSRA, ADEN);
+
+	/* analog comparator off, it is on after the reset */
+	SET_BIT(ACSR, ACD);
+}
+
+void POWER_startTick(void)
+{
+	TCNT2 = 0;
+	OCR2 = POWER_TICK_COUNT - 1;
+
+	/* CTC mode, OC2 disconnected, clock = F_CPU/1024 */
+	TCCR2 = (1<<WGM21) | (1<<CS22) | (1<<CS21) | (1<<CS20);
+
+	/* Enable Timer2 Compare Interrupt */
+	SET_BIT(TIMSK, OCIE2);
+}
+
+POWER_ModeType POWER_selectMode(uint8 a_wake)
+{
+	/* the UART and Timer1 are clocked by the I/O clock which only runs in idle */
+	if (a_wake & (POWER_WAKE_UART | POWER_WAKE_TIMER1))
+	{
+		return POWER_IDLE;
+	}
+
+	/* Timer2 keeps running in power save only on its own 32 kHz crystal */
+	if (a_wake & POWER_WAKE_TIMER2)
+	{
+		return BIT_IS_SET(ASSR, AS2) ? POWER_SAVE : POWER_IDLE;
+	}
+
+	return POWER_DOWN;
+}
+
+/* Description:
+ * remove the wake sources whose interrupt can't happen
+ */
+static uint8 POWER_enabledWake(uint8 a_wake)
+{
+	/* the UART driver receives in its interrupt */
+	if (BIT_IS_CLEAR(UCSRB, RXCIE))
+	{
+		a_wake &= ~POWER_WAKE_UART;
+	}
+
+	/* a timer wakes the CPU only when it is clocked and one of its interrupts is enabled */
+	if (!(TCCR1B & 0x07) || !(TIMSK & ((1<<OCIE1A) | (1<<OCIE1B) | (1<<TOIE1))))
+	{
+		a_wake &= ~POWER_WAKE_TIMER1;
+	}
+	if (!(TCCR2 & 0x07) || !(TIMSK & ((1<<OCIE2) | (1<<TOIE2))))
+	{
+		a_wake &= ~POWER_WAKE_TIMER2;
+	}
+	if (!(GICR & ((1<<INT0) | (1<<INT1) | (1<<INT2))))
+	{
+		a_wake &= ~POWER_WAKE_EXT;
+	}
+
+	return a_wake;
+}
+
+void POWER_sleep(uint8 a_wake)
+{
+	a_wake = POWER_enabledWake(a_wake);
+	if (a_wake == 0)
+	{
+		sei();
+		return;
+	}
+
+	switch (POWER_selectMode(a_wake))
+	{
+	case POWER_IDLE:
+		set_sleep_mode(SLEEP_MODE_IDLE);
+		break;
+	case POWER_SAVE:
+		set_sleep_mode(SLEEP_MODE_PWR_SAVE);
+		break;
+	case POWER_DOWN:
+		set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+		break;
+	}
+
+	cli();
+	sleep_enable();
+
+	/* the instruction after sei is always executed before a pending interrupt,
+	 * so an interrupt coming after the checks can't be lost before the sleep
+	 */
+	sei();
+	sleep_cpu();
+	sleep_disable();
+}
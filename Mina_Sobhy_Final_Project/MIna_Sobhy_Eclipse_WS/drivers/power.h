@@ -0,0 +1,83 @@
+/*
+ * power.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: header file of the power manager, the same file is used by
+ *      			 the two ECUs
+ *
+ *      The busy waits of the drivers call POWER_sleep with the interrupts that
+ *      can end the wait, the deepest sleep mode keeping these interrupts alive is
+ *      used. The ATmega32 has no power reduction register and no pin change
+ *      interrupt, so the unused peripherals are switched off by their own enable
+ *      bits and the keypad is scanned on the Timer2 tick of POWER_startTick.
+ */
+
+#ifndef POWER_H_
+#define POWER_H_
+
+#include "std_types.h"
+#include "board_config.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* interrupts that can end a POWER_sleep, they can be combined */
+#define POWER_WAKE_UART			0x01	/* UART receive complete */
+#define POWER_WAKE_TIMER1		0x02	/* Timer1 compare or overflow */
+#define POWER_WAKE_TIMER2		0x04	/* Timer2 compare or overflow */
+#define POWER_WAKE_EXT			0x08	/* INT0, INT1 or INT2 */
+
+/* period of the Timer2 tick started by POWER_startTick */
+#define POWER_TICK_MS			16
+#define POWER_TICK_COUNT		((F_CPU / 1024UL * POWER_TICK_MS) / 1000UL)
+
+#if (POWER_TICK_COUNT == 0) || (POWER_TICK_COUNT > 256)
+#error "POWER_TICK_MS doesn't fit Timer2 at F_CPU/1024"
+#endif
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+typedef enum
+{
+	POWER_IDLE,			/* CPU stopped, all the peripherals run */
+	POWER_SAVE,			/* like POWER_DOWN with Timer2 on its own crystal (AS2 = 1) */
+	POWER_DOWN			/* all the clocks stopped, external interrupts only */
+} POWER_ModeType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Switch off the peripherals which are never used (ADC, analog comparator).
+ */
+void POWER_init(void);
+
+/*
+ * Description :
+ * Start Timer2 in CTC mode to wake the CPU every POWER_TICK_MS, only for an
+ * ECU which doesn't use Timer2 (the CONTROL_ECU uses it for the diagnostics).
+ */
+void POWER_startTick(void);
+
+/*
+ * Description :
+ * Return the deepest sleep mode which keeps the a_wake interrupts working.
+ */
+POWER_ModeType POWER_selectMode(uint8 a_wake);
+
+/*
+ * Description :
+ * Sleep until one of the a_wake interrupts, or any other enabled interrupt.
+ * The wake sources which aren't enabled are ignored and the function returns
+ * at once if none is left, so a busy wait calling it in its loop never hangs.
+ * It returns with the interrupts enabled, so the caller can disable them for
+ * its last check: an interrupt coming after the check still ends the sleep.
+ */
+void POWER_sleep(uint8 a_wake);
+
+#endif /* POWER_H_ */
@@ -0,0 +1,77 @@
+/*
+ * stack.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: source file of the stack high-water measurement
+ */
+
+#include "stack.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* set by the linker: first byte after the variables and the top of the RAM */
+extern uint8 _end;
+extern uint8 __stack;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+void STACK_paint(void) __attribute__((naked, used, section(".init1")));
+static const uint8 * STACK_deepest(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/* Description:
+ * paint the RAM from _end to the top of the RAM, it is placed in .init1 so the
+ * startup code runs it before the stack pointer is set and before main.
+ * It is written in assembly as a naked function has no stack frame for the
+ * local variables of a C loop, and it must not return (no ret) to continue
+ * with the next .init section.
+ */
+void STACK_paint(void)
+{
+	__asm__ __volatile__ (
+		"	ldi r30, lo8(_end)		\n"
+		"	ldi r31, hi8(_end)		\n"
+		"	ldi r24, %0				\n"
+		"	ldi r25, hi8(__stack)	\n"
+		"	rjmp 2f					\n"
+		"1:	st Z+, r24				\n"
+		"2:	cpi r30, lo8(__stack)	\n"
+		"	cpc r31, r25			\n"
+		"	brlo 1b					\n"
+		"	breq 1b					\n"
+		:
+		: "M" (STACK_PAINT));
+}
+
+/* Description:
+ * return the lowest RAM address which isn't painted anymore
+ */
+static const uint8 * STACK_deepest(void)
+{
+	const uint8 * ptr = &_end;
+
+	while ((ptr <= &__stack) && (*ptr == STACK_PAINT))
+	{
+		ptr++;
+	}
+
+	return ptr;
+}
+
+uint16 STACK_highWater(void)
+{
+	return (uint16)(&__stack - STACK_deepest()) + 1;
+}
+
+uint16 STACK_free(void)
+{
+	return (uint16)(STACK_deepest() - &_end);
+}
@@ -0,0 +1,44 @@
+/*
+ * stack.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: header file of the stack high-water measurement, the same
+ *      			 file is used by the two ECUs
+ *
+ *      The free RAM between the end of the variables (.bss) and the top of the
+ *      RAM is painted with STACK_PAINT at reset, before the stack is used. The
+ *      stack grows down from the top of the RAM, so the lowest byte which isn't
+ *      painted anymore gives the deepest stack reached since the reset.
+ */
+
+#ifndef STACK_H_
+#define STACK_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* value written in the free RAM at reset */
+#define STACK_PAINT			0xC5
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Return the maximum number of stack bytes used since the reset.
+ */
+uint16 STACK_highWater(void);
+
+/*
+ * Description :
+ * Return the number of bytes between the variables and the deepest stack
+ * reached since the reset, the RAM left for new variables and deeper calls.
+ */
+uint16 STACK_free(void);
+
+#endif /* STACK_H_ */
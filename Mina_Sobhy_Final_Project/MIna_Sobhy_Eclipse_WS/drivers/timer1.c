@@ -7,6 +7,7 @@
  */
 
 #include "timer1.h"
+#include "trace.h"
 #include <avr/interrupt.h>
 #include <avr/io.h>
 
@@ -22,6 +23,8 @@ static volatile void (*g_callBackPtr)(void) = NULL_PTR;
  *******************************************************************************/
 ISR(TIMER1_OVF_vect)
 {
+	TRACE(TRACE_TIMER1_OVF, 0);
+
 	if(g_callBackPtr != NULL_PTR)
 	{
 		/* Call the Call Back function in the application after the OVF ISR is fired */
@@ -31,6 +34,8 @@ ISR(TIMER1_OVF_vect)
 
 ISR(TIMER1_COMPA_vect)
 {
+	TRACE(TRACE_TIMER1_COMPA, 0);
+
 	if(g_callBackPtr != NULL_PTR)
 	{
 		/* Call the Call Back function in the application after the COMPA ISR is fired */
@@ -0,0 +1,76 @@
+/*
+ * trace.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: circular trace buffer of the ISR, UART and state machine events
+ */
+
+#include "trace.h"
+#include "uart.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+#ifdef TRACE_ENABLE
+TRACE_RecordType g_traceBuffer[TRACE_BUFFER_SIZE];
+volatile uint8 g_traceHead = 0;
+volatile uint8 g_traceCount = 0;
+volatile uint8 g_tracePaused = FALSE; /* the dump itself isn't traced */
+#endif
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void TRACE_dump(void)
+{
+#ifdef TRACE_ENABLE
+	const uint8 * record;
+	uint8 index;
+	uint8 count;
+	uint8 i;
+
+	g_tracePaused = TRUE;
+
+	count = g_traceCount;
+	index = (g_traceHead - count) & TRACE_BUFFER_MASK;
+
+	UART_sendByte(count);
+	while (count != 0)
+	{
+		record = (const uint8 *)&g_traceBuffer[index];
+		for (i = 0; i < sizeof(TRACE_RecordType); i++)
+		{
+			UART_sendByte(record[i]);
+		}
+		index = (index + 1) & TRACE_BUFFER_MASK;
+		count--;
+	}
+
+	g_tracePaused = FALSE;
+#else
+	UART_sendByte(0);
+#endif
+}
+
+void TRACE_skip(void)
+{
+	uint16 size;
+
+#ifdef TRACE_ENABLE
+	g_tracePaused = TRUE;
+#endif
+
+	size = (uint16)UART_receiveByte() * sizeof(TRACE_RecordType);
+	while (size != 0)
+	{
+		UART_receiveByte();
+		size--;
+	}
+
+#ifdef TRACE_ENABLE
+	g_tracePaused = FALSE;
+#endif
+}
@@ -0,0 +1,138 @@
+/*
+ * trace.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mina sobhy
+ *      description: circular trace buffer of the ISR, UART and state machine events,
+ *      			 the same file is used by the two ECUs
+ *
+ *      Every event is a 4 bytes record (event, arg, TCNT1) written by TRACE() in a
+ *      few instructions with the interrupts disabled. TRACE() compiles to nothing
+ *      and the buffer is not allocated when board_config.h doesn't define TRACE_ENABLE.
+ *      TCNT1 only counts while Timer1 runs (door cycle, lockout), the record order
+ *      is kept in the buffer anyway.
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include "std_types.h"
+#include "board_config.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* TRACE_ENABLE is defined by board_config.h, the board can change the number of
+ * records kept, the oldest records are overwritten (power of 2, max 128)
+ */
+#ifndef TRACE_BUFFER_SIZE
+#define TRACE_BUFFER_SIZE		64
+#endif
+#define TRACE_BUFFER_MASK		(TRACE_BUFFER_SIZE - 1)
+
+/* events */
+#define TRACE_TIMER1_OVF		0x01	/* arg: 0 */
+#define TRACE_TIMER1_COMPA		0x02	/* arg: 0 */
+#define TRACE_UART_TX			0x03	/* arg: byte sent */
+#define TRACE_UART_RX			0x04	/* arg: byte received */
+#define TRACE_STATE				0x05	/* arg: TRACE_STATE_* of the function entered */
+
+/* state functions of the CONTROL_ECU */
+#define TRACE_STATE_CONTROL_MAIN_OPTIONS	0x10
+#define TRACE_STATE_CONTROL_CHECK_PASS		0x11
+#define TRACE_STATE_CONTROL_STORE_PASS		0x12
+#define TRACE_STATE_CONTROL_OPEN_DOOR		0x13
+#define TRACE_STATE_CONTROL_CHANGE_PASS		0x14
+#define TRACE_STATE_CONTROL_SETTINGS		0x15
+#define TRACE_STATE_CONTROL_TRACE_DUMP		0x16
+#define TRACE_STATE_CONTROL_DIAGNOSTICS		0x17
+#define TRACE_STATE_CONTROL_LOG_EXPORT		0x18
+#define TRACE_STATE_CONTROL_CLOCK			0x19
+#define TRACE_STATE_CONTROL_PROVISION		0x1A
+
+/* state functions of the HMI_ECU */
+#define TRACE_STATE_HMI_MAIN_OPTIONS		0x20
+#define TRACE_STATE_HMI_CREATE_PASS			0x21
+#define TRACE_STATE_HMI_OPEN_DOOR			0x22
+#define TRACE_STATE_HMI_CHANGE_PASS			0x23
+#define TRACE_STATE_HMI_SETTINGS			0x24
+#define TRACE_STATE_HMI_ERROR				0x25
+#define TRACE_STATE_HMI_LOCKED				0x26
+#define TRACE_STATE_HMI_TRACE_DUMP			0x27
+#define TRACE_STATE_HMI_DIAGNOSTICS			0x28
+#define TRACE_STATE_HMI_LOG_EXPORT			0x29
+#define TRACE_STATE_HMI_CLOCK				0x2A
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+typedef struct
+{
+	uint8	event	;
+	uint8	arg		;
+	uint16	time	; /* TCNT1 when the event happened */
+} TRACE_RecordType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+#ifdef TRACE_ENABLE
+
+extern TRACE_RecordType g_traceBuffer[TRACE_BUFFER_SIZE];
+extern volatile uint8 g_traceHead;
+extern volatile uint8 g_traceCount;
+extern volatile uint8 g_tracePaused;
+
+/*
+ * Description :
+ * Add a record to the trace buffer, inlined at every TRACE() even without optimization.
+ */
+static inline __attribute__((always_inline)) void TRACE_emit(uint8 a_event, uint8 a_arg)
+{
+	uint8 sreg = SREG;
+	uint8 head;
+
+	cli();
+	if (!g_tracePaused)
+	{
+		head = g_traceHead;
+		g_traceBuffer[head].event = a_event;
+		g_traceBuffer[head].arg = a_arg;
+		g_traceBuffer[head].time = TCNT1;
+		g_traceHead = (head + 1) & TRACE_BUFFER_MASK;
+		if (g_traceCount != TRACE_BUFFER_SIZE)
+		{
+			g_traceCount++;
+		}
+	}
+	SREG = sreg;
+}
+
+#define TRACE(event, arg)		TRACE_emit((event), (arg))
+
+#else
+
+#define TRACE(event, arg)
+
+#endif /* TRACE_ENABLE */
+
+/*
+ * Description :
+ * Send the records on the UART from the oldest one: the number of records then
+ * 4 bytes for every record (event, arg, time low byte, time high byte).
+ * Only the number 0 is sent when the trace is disabled.
+ */
+void TRACE_dump(void);
+
+/*
+ * Description :
+ * Receive and drop a dump sent by the other ECU.
+ */
+void TRACE_skip(void);
+
+#endif /* TRACE_H_ */
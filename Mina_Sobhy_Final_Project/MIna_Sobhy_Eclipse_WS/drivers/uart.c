@@ -0,0 +1,512 @@
+/*
+ * uart.c
+ *
+ *  Created on: Oct 27, 2022
+ *      Author: Mina sobhy
+ *      description: source file for UART
+ */
+
+#include "uart.h"
+#include "avr/io.h" /* To use the UART Registers */
+#include "common_macros.h" /* To use the macros like SET_BIT */
+#include <avr/interrupt.h>
+#include <util/delay.h>
+#include "trace.h"
+#include "power.h"
+#include "bus.h"
+
+/* the boards with performance counters count the UART traffic in diag.c */
+#if BOARD_DIAG
+#include "diag.h"
+#else
+#define DIAG_COUNT(counter)
+#define DIAG_ADD(counter, value)
+#endif
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* step of the UART_receiveByteTimeout polling */
+#define UART_POLL_US			100
+
+/* a rate of UART_BAUD_TABLE more than UART_BAUD_MAX_ERROR off at F_CPU gives a
+ * negative array size, the compiler error names the rate (UART_baudCheck<rate>)
+ */
+#define UART_BAUD_CHECK(baud) \
+	typedef char UART_baudCheck##baud[(UART_BAUD_ERROR(baud) <= UART_BAUD_MAX_ERROR) ? 1 : -1];
+UART_BAUD_TABLE(UART_BAUD_CHECK)
+
+#define UART_BAUD_ENTRY(baud)	{(baud), UART_UBRR(baud)},
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+const UART_BaudType g_uartBaudTable[UART_BAUD_COUNT] = {
+	UART_BAUD_TABLE(UART_BAUD_ENTRY)
+};
+
+/* TRUE once a byte was sent, the TXC flag stays cleared until then */
+static uint8 g_txUsed = FALSE;
+
+/* Rx ring buffer, every byte is written twice UART_RX_SIZE apart so a message
+ * of up to UART_RX_SIZE bytes is contiguous from any start in the first half
+ */
+static uint8 g_rxBuffer[2 * UART_RX_SIZE];
+static volatile uint8 g_rxHead = 0; /* next byte written by the interrupt */
+static volatile uint8 g_rxTail = 0; /* next byte read by the driver */
+
+/* block sent by the data register empty interrupt, g_txSize is 0 when it is done */
+static const uint8 * volatile g_txData;
+static volatile uint8 g_txSize = 0;
+
+/* bytes received with a frame, overrun or parity error since UART_takeErrors */
+static volatile uint8 g_rxErrors = 0;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void UART_waitData(uint8 a_count);
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+
+/* the RS-485 bus (bus.c) takes the interrupts of the UART, the functions of
+ * this file aren't used with it
+ */
+#if !BUS_ENABLED
+
+ISR(USART_RXC_vect)
+{
+	uint8 data;
+	uint8 head = g_rxHead;
+	uint8 next = (head + 1) & (UART_RX_SIZE - 1);
+
+	/* the error flags belong to the byte in UDR, so they are read before it */
+	if (UCSRA & ((1<<FE) | (1<<DOR) | (1<<PE)))
+	{
+		DIAG_COUNT(uart_errors);
+		if (g_rxErrors != 0xFF)
+		{
+			g_rxErrors++;
+		}
+	}
+	data = UDR;
+
+	/* a full buffer drops the byte, it is lost as with an overrun */
+	if (next == g_rxTail)
+	{
+		DIAG_COUNT(uart_errors);
+		return;
+	}
+
+	g_rxBuffer[head] = data;
+	g_rxBuffer[head + UART_RX_SIZE] = data;
+	g_rxHead = next;
+}
+
+ISR(USART_UDRE_vect)
+{
+	UDR = *g_txData;
+	g_txData++;
+	g_txSize--;
+
+	/* the interrupt is disabled after the last byte, UDR stays empty then */
+	if (g_txSize == 0)
+	{
+		CLEAR_BIT(UCSRB,UDRIE);
+	}
+}
+
+#endif /* !BUS_ENABLED */
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Functional responsible for Initialize the UART device by:
+ * 1. Setup the Frame format like number of data bits, parity bit type and number of stop bits.
+ * 2. Enable the UART.
+ * 3. Setup the UART baud rate, UART_BAUD_DEFAULT if it isn't in UART_BAUD_TABLE.
+ */
+void UART_init(const UART_ConfigType * Config_Ptr)
+{
+	/* U2X = 1 for double transmission speed */
+	UCSRA = (1<<U2X);
+
+	/************************** UCSRB Description **************************
+	 * RXCIE = 1 Enable USART RX Complete Interrupt Enable
+	 * TXCIE = 0 Disable USART Tx Complete Interrupt Enable
+	 * UDRIE = 0 Disable USART Data Register Empty Interrupt Enable
+	 * RXEN  = 1 Receiver Enable
+	 * RXEN  = 1 Transmitter Enable
+	 * UCSZ2 = 0 For 8-bit data mode
+	 * RXB8 & TXB8 not used for 8-bit data mode
+	 ***********************************************************************/ 
+	g_rxHead = 0;
+	g_rxTail = 0;
+	g_txSize = 0;
+	UCSRB = (1<<RXCIE) | (1<<RXEN) | (1<<TXEN);
+	
+	/************************** UCSRC Description **************************
+	 * URSEL   = 1 The URSEL must be one when writing the UCSRC
+	 * UMSEL   = 0 Asynchronous Operation
+	 * UPM1:0  = depend on the parity mode configuration
+	 * USBS    = depend on the stop bits configuration
+	 * UCSZ1:0 = depend on the character size configuration
+	 * UCPOL   = 0 Used with the Synchronous operation only
+	 ***********************************************************************/ 	
+	UCSRC |= (1<<URSEL) ;
+	UCSRC = (UCSRC & 0xCF) | ( (Config_Ptr->parity)<<4 );
+	UCSRC = (UCSRC & 0xF7) | ( (Config_Ptr->stop_bit)<< 3);
+	UCSRC = (UCSRC & 0xF9) | ( ((Config_Ptr->bit_data)<< 1) & 0x06);
+	UCSRB = (UCSRB & 0xFB) | ( (Config_Ptr->bit_data) & 0x04);
+	
+	/* the UBRR values are computed at compile time in g_uartBaudTable */
+	if (!UART_setBaudRate(Config_Ptr->baud_rate))
+	{
+		UART_setBaudRate(UART_BAUD_DEFAULT);
+	}
+}
+
+/*
+ * Description :
+ * Change the baud rate after the last sent byte is out of the transmitter.
+ * Return FALSE and keep the rate if a_baud isn't in UART_BAUD_TABLE.
+ */
+uint8 UART_setBaudRate(UART_BaudRate a_baud)
+{
+	uint8 i;
+
+	for (i = 0; i < UART_BAUD_COUNT; i++)
+	{
+		if (g_uartBaudTable[i].baud_rate == a_baud)
+		{
+			/* a byte still in the shift register would be sent at the new rate */
+			while (g_txSize != 0){}
+			if (g_txUsed)
+			{
+				while(BIT_IS_CLEAR(UCSRA,TXC)){}
+			}
+
+			/* First 8 bits from the BAUD_PRESCALE inside UBRRL and last 4 bits in UBRRH*/
+			UBRRH = g_uartBaudTable[i].ubrr>>8;
+			UBRRL = g_uartBaudTable[i].ubrr;
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/*
+ * Description :
+ * Functional responsible for send byte to another UART device.
+ */
+void UART_sendByte(const uint8 data)
+{
+	TRACE(TRACE_UART_TX, data);
+	DIAG_COUNT(uart_tx_bytes);
+
+	/* the bytes of a block come first */
+	while (g_txSize != 0){}
+
+	/*
+	 * UDRE flag is set when the Tx buffer (UDR) is empty and ready for
+	 * transmitting a new byte so wait until this flag is set to one
+	 */
+	while(BIT_IS_CLEAR(UCSRA,UDRE)){}
+
+	/* TXC is set again when this byte is out, UART_setBaudRate waits for it */
+	SET_BIT(UCSRA,TXC);
+	g_txUsed = TRUE;
+
+	/*
+	 * Put the required data in the UDR register and it also clear the UDRE flag as
+	 * the UDR register is not empty now
+	 */
+	UDR = data;
+
+	/************************* Another Method *************************
+	UDR = data;
+	while(BIT_IS_CLEAR(UCSRA,TXC)){} // Wait until the transmission is complete TXC = 1
+	SET_BIT(UCSRA,TXC); // Clear the TXC flag
+	*******************************************************************/
+}
+
+/*
+ * Description :
+ * Start sending a_size bytes of a_data from the data register empty interrupt
+ * and return at once, after the block sent before if it isn't out yet. a_data
+ * must not change until UART_isSendDone returns TRUE.
+ */
+void UART_sendBlock(const uint8 * a_data, uint8 a_size)
+{
+	if (a_size == 0)
+	{
+		return;
+	}
+
+	/* the bytes of the block aren't traced one by one, the interrupt has no time for it */
+	DIAG_ADD(uart_tx_bytes, a_size);
+
+	while (g_txSize != 0){}
+
+	/* TXC is set again when the last byte is out, UART_setBaudRate waits for it */
+	SET_BIT(UCSRA,TXC);
+	g_txUsed = TRUE;
+
+	/* UDRIE is clear while g_txSize is 0, so the interrupt doesn't see a half written pointer */
+	g_txData = a_data;
+	g_txSize = a_size;
+	SET_BIT(UCSRB,UDRIE);
+}
+
+/*
+ * Description :
+ * Return TRUE when the bytes of the last UART_sendBlock are all in the transmitter.
+ */
+uint8 UART_isSendDone(void)
+{
+	return (g_txSize == 0);
+}
+
+/* Description:
+ * sleep until the Rx buffer holds at least a_count bytes
+ */
+static void UART_waitData(uint8 a_count)
+{
+	/* the interrupts are disabled for the last check, a byte received after it
+	 * wakes the CPU as POWER_sleep enables them just before the sleep
+	 */
+	cli();
+	while (((uint8)(g_rxHead - g_rxTail) & (UART_RX_SIZE - 1)) < a_count)
+	{
+		POWER_sleep(POWER_WAKE_UART);
+		cli();
+	}
+	sei();
+}
+
+/*
+ * Description :
+ * Functional responsible for receive byte from another UART device, the bytes
+ * are taken from the Rx buffer filled by the receive interrupt.
+ */
+uint8 UART_receiveByte(void)
+{
+	uint8 data;
+
+	/* the CPU sleeps until the byte is received */
+	UART_waitData(1);
+
+	data = g_rxBuffer[g_rxTail];
+	g_rxTail = (g_rxTail + 1) & (UART_RX_SIZE - 1);
+	TRACE(TRACE_UART_RX, data);
+	DIAG_COUNT(uart_rx_bytes);
+
+	return data;
+}
+
+/*
+ * Description :
+ * Wait for a message ended by a_delimiter, at most a_max bytes before it
+ * (UART_MESSAGE_MAX if more). Return TRUE with the message before the delimiter,
+ * or FALSE with the first a_max bytes if the delimiter doesn't come after them.
+ * The message stays in the Rx buffer and no other byte can be received until
+ * UART_releaseMessage.
+ */
+uint8 UART_receiveMessage(UART_MessageType * a_message, uint8 a_delimiter, uint8 a_max)
+{
+	const uint8 * data = &g_rxBuffer[g_rxTail];
+	uint8 length = 0;
+
+	if (a_max > UART_MESSAGE_MAX)
+	{
+		a_max = UART_MESSAGE_MAX;
+	}
+	a_message->data = data;
+
+	/* the tail is kept until the release, so the interrupt can't overwrite the
+	 * message and length + 1 never passes the UART_RX_SIZE - 1 buffered bytes
+	 */
+	for (;;)
+	{
+		UART_waitData(length + 1);
+		if (data[length] == a_delimiter)
+		{
+			a_message->length = length;
+			a_message->size = length + 1;
+			return TRUE;
+		}
+		if (length == a_max)
+		{
+			a_message->length = length;
+			a_message->size = length;
+			return FALSE;
+		}
+		length++;
+	}
+}
+
+/*
+ * Description :
+ * Wait for a message sent after its length byte, at most a_max bytes
+ * (UART_MESSAGE_MAX if more). Return FALSE with an empty message holding only
+ * the length byte if the length is more than a_max.
+ * The message stays in the Rx buffer until UART_releaseMessage.
+ */
+uint8 UART_receiveFrame(UART_MessageType * a_message, uint8 a_max)
+{
+	const uint8 * data = &g_rxBuffer[g_rxTail];
+	uint8 length;
+
+	if (a_max > UART_MESSAGE_MAX)
+	{
+		a_max = UART_MESSAGE_MAX;
+	}
+	a_message->data = data + 1;
+
+	UART_waitData(1);
+	length = data[0];
+	if (length > a_max)
+	{
+		a_message->length = 0;
+		a_message->size = 1;
+		return FALSE;
+	}
+
+	UART_waitData(length + 1);
+	a_message->length = length;
+	a_message->size = length + 1;
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Free the Rx buffer bytes of a message, its data can't be used after.
+ */
+void UART_releaseMessage(const UART_MessageType * a_message)
+{
+	g_rxTail = (g_rxTail + a_message->size) & (UART_RX_SIZE - 1);
+}
+
+/*
+ * Description :
+ * Return TRUE if a received byte is waiting in the Rx buffer, it doesn't block
+ * so the caller can keep doing other work while waiting for the other device.
+ */
+uint8 UART_isDataAvailable(void)
+{
+	if(g_rxHead != g_rxTail)
+	{
+		return TRUE;
+	}
+	return FALSE;
+}
+
+/*
+ * Description :
+ * Receive a byte in a_data, return FALSE if nothing is received in a_timeout_ms.
+ */
+uint8 UART_receiveByteTimeout(uint8 * a_data, uint16 a_timeout_ms)
+{
+	uint32 polls = (uint32)a_timeout_ms * (1000 / UART_POLL_US);
+
+	while(g_rxHead == g_rxTail)
+	{
+		if (polls == 0)
+		{
+			return FALSE;
+		}
+		polls--;
+		_delay_us(UART_POLL_US);
+	}
+
+	*a_data = UART_receiveByte();
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Drop the bytes waiting in the Rx buffer.
+ */
+void UART_flush(void)
+{
+	g_rxTail = g_rxHead;
+}
+
+/*
+ * Description :
+ * Return the number of bytes received with a frame, overrun or parity error
+ * since the last call, at most 255.
+ */
+uint8 UART_takeErrors(void)
+{
+	uint8 errors;
+
+	cli();
+	errors = g_rxErrors;
+	g_rxErrors = 0;
+	sei();
+
+	return errors;
+}
+
+/*
+ * Description :
+ * Send the required string through UART to the other UART device.
+ */
+void UART_sendString(const uint8 *Str)
+{
+	uint8 i = 0;
+
+	/* Send the whole string */
+	while(Str[i] != '\0')
+	{
+		UART_sendByte(Str[i]);
+		i++;
+	}
+	/************************* Another Method *************************
+	while(*Str != '\0')
+	{
+		UART_sendByte(*Str);
+		Str++;
+	}		
+	*******************************************************************/
+}
+
+/*
+ * Description :
+ * Receive the required string until the '#' symbol through UART from the other UART device.
+ * At most a_size - 1 characters are copied to Str with the '\0', return FALSE
+ * if the string was cut, its rest stays in the Rx buffer.
+ */
+uint8 UART_receiveString(uint8 *Str, uint8 a_size)
+{
+	UART_MessageType message;
+	uint8 complete;
+	uint8 i;
+
+	if (a_size == 0)
+	{
+		return FALSE;
+	}
+
+	/* Receive the whole string until the '#' in the Rx buffer */
+	complete = UART_receiveMessage(&message, '#', a_size - 1);
+
+	/* copy it and replace the '#' with '\0' */
+	for (i = 0; i < message.length; i++)
+	{
+		Str[i] = message.data[i];
+	}
+	Str[i] = '\0';
+
+	UART_releaseMessage(&message);
+	return complete;
+}
@@ -0,0 +1,223 @@
+/*
+ * uart.h
+ *
+ *  Created on: Oct 27, 2022
+ *      Author: Mina sobhy
+ *      description: header file for UART
+ */
+
+#ifndef UART_H_
+#define UART_H_
+
+#include "std_types.h"
+#include "board_config.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* rate of the first exchange after the reset, BAUD_negotiate steps up from it */
+#define UART_BAUD_DEFAULT		9600UL
+
+/* U2X = 1: baud rate = F_CPU / (8 * (UBRR + 1)), UBRR is rounded to the nearest */
+#define UART_UBRR(baud)			((((F_CPU) + (4UL * (baud))) / (8UL * (baud))) - 1UL)
+#define UART_BAUD_REAL(baud)	((F_CPU) / (8UL * (UART_UBRR(baud) + 1UL)))
+
+/* error of the real baud rate in 1/1000, the build fails above UART_BAUD_MAX_ERROR */
+#define UART_BAUD_ERROR(baud)	((((UART_BAUD_REAL(baud) > (baud)) ? \
+		(UART_BAUD_REAL(baud) - (baud)) : ((baud) - UART_BAUD_REAL(baud))) * 1000UL) / (baud))
+#define UART_BAUD_MAX_ERROR		20
+
+/*
+ * Baud rates usable at F_CPU from the lowest, ENTRY is called for each of them.
+ * At 1 MHz the UBRR steps are too coarse between 9600 and 62500 baud, and the
+ * fastest rate is F_CPU/8.
+ */
+#if (F_CPU == 8000000UL)
+#define UART_BAUD_TABLE(ENTRY) \
+	ENTRY(9600) ENTRY(19200) ENTRY(38400) ENTRY(76800) ENTRY(125000) ENTRY(250000)
+#elif (F_CPU == 1000000UL)
+#define UART_BAUD_TABLE(ENTRY) \
+	ENTRY(9600) ENTRY(62500) ENTRY(125000)
+#else
+#error "uart.h: no baud rate table for this F_CPU"
+#endif
+
+#define UART_BAUD_ONE(baud)		+ 1
+#define UART_BAUD_COUNT			(0 UART_BAUD_TABLE(UART_BAUD_ONE))
+
+/* bytes of the Rx ring buffer filled by the receive interrupt, a power of 2 up
+ * to 128, the board can change it in board_config.h
+ */
+#ifndef UART_RX_SIZE
+#define UART_RX_SIZE			64
+#endif
+
+#if (UART_RX_SIZE & (UART_RX_SIZE - 1)) || (UART_RX_SIZE < 4) || (UART_RX_SIZE > 128)
+#error "UART_RX_SIZE must be a power of 2 from 4 to 128"
+#endif
+
+/* longest message without its delimiter or length byte, the ring keeps one
+ * slot free to tell a full buffer from an empty one
+ */
+#define UART_MESSAGE_MAX		(UART_RX_SIZE - 2)
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+typedef enum
+{
+  FIVE_BIT, SIX_BIT, SEVEN_BIT, EIGHT_BIT, NINE_BIT = 7
+} UART_BitData ;
+
+typedef enum
+{
+  DISABLED, EVEN_PARITY = 2, ODD_PARITY = 3
+} UART_Parity ;
+
+typedef enum
+{
+  ONE_BIT, TWO_BIT
+} UART_StopBit;
+
+typedef uint32 UART_BaudRate;
+
+typedef struct
+{
+	UART_BitData	bit_data	;
+	UART_Parity		parity		;
+	UART_StopBit	stop_bit	;
+	UART_BaudRate 	baud_rate	;
+
+} UART_ConfigType;
+
+typedef struct
+{
+	UART_BaudRate	baud_rate	;
+	uint16			ubrr		; /* UBRRH:UBRRL with U2X = 1 */
+} UART_BaudType;
+
+/* a received message seen in place in the Rx buffer until UART_releaseMessage */
+typedef struct
+{
+	const uint8 *	data	; /* first byte of the message */
+	uint8			length	; /* bytes of the message at data */
+	uint8			size	; /* bytes taken from the Rx buffer with the delimiter or length byte */
+} UART_MessageType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/* the rates of UART_BAUD_TABLE with their UBRR value, from the lowest */
+extern const UART_BaudType g_uartBaudTable[UART_BAUD_COUNT];
+
+/*
+ * Description :
+ * Functional responsible for Initialize the UART device by:
+ * 1. Setup the Frame format like number of data bits, parity bit type and number of stop bits.
+ * 2. Enable the UART.
+ * 3. Setup the UART baud rate, UART_BAUD_DEFAULT if it isn't in UART_BAUD_TABLE.
+ */
+void UART_init(const UART_ConfigType * Config_Ptr);
+
+/*
+ * Description :
+ * Change the baud rate after the last sent byte is out of the transmitter.
+ * Return FALSE and keep the rate if a_baud isn't in UART_BAUD_TABLE.
+ */
+uint8 UART_setBaudRate(UART_BaudRate a_baud);
+
+/*
+ * Description :
+ * Functional responsible for send byte to another UART device.
+ */
+void UART_sendByte(const uint8 a_data);
+
+/*
+ * Description :
+ * Start sending a_size bytes of a_data from the data register empty interrupt
+ * and return at once, after the block sent before if it isn't out yet. a_data
+ * must not change until UART_isSendDone returns TRUE.
+ */
+void UART_sendBlock(const uint8 * a_data, uint8 a_size);
+
+/*
+ * Description :
+ * Return TRUE when the bytes of the last UART_sendBlock are all in the transmitter.
+ */
+uint8 UART_isSendDone(void);
+
+/*
+ * Description :
+ * Functional responsible for receive byte from another UART device, the bytes
+ * are taken from the Rx buffer filled by the receive interrupt.
+ */
+uint8 UART_receiveByte(void);
+
+/*
+ * Description :
+ * Wait for a message ended by a_delimiter, at most a_max bytes before it
+ * (UART_MESSAGE_MAX if more). Return TRUE with the message before the delimiter,
+ * or FALSE with the first a_max bytes if the delimiter doesn't come after them.
+ * The message stays in the Rx buffer and no other byte can be received until
+ * UART_releaseMessage.
+ */
+uint8 UART_receiveMessage(UART_MessageType * a_message, uint8 a_delimiter, uint8 a_max);
+
+/*
+ * Description :
+ * Wait for a message sent after its length byte, at most a_max bytes
+ * (UART_MESSAGE_MAX if more). Return FALSE with an empty message holding only
+ * the length byte if the length is more than a_max.
+ * The message stays in the Rx buffer until UART_releaseMessage.
+ */
+uint8 UART_receiveFrame(UART_MessageType * a_message, uint8 a_max);
+
+/*
+ * Description :
+ * Free the Rx buffer bytes of a message, its data can't be used after.
+ */
+void UART_releaseMessage(const UART_MessageType * a_message);
+
+/*
+ * Description :
+ * Return TRUE if a received byte is waiting in the Rx buffer, it doesn't block
+ * so the caller can keep doing other work while waiting for the other device.
+ */
+uint8 UART_isDataAvailable(void);
+
+/*
+ * Description :
+ * Receive a byte in a_data, return FALSE if nothing is received in a_timeout_ms.
+ */
+uint8 UART_receiveByteTimeout(uint8 * a_data, uint16 a_timeout_ms);
+
+/*
+ * Description :
+ * Drop the bytes waiting in the Rx buffer.
+ */
+void UART_flush(void);
+
+/*
+ * Description :
+ * Return the number of bytes received with a frame, overrun or parity error
+ * since the last call, at most 255.
+ */
+uint8 UART_takeErrors(void);
+
+/*
+ * Description :
+ * Send the required string through UART to the other UART device.
+ */
+void UART_sendString(const uint8 *STR_PTR);
+
+/*
+ * Description :
+ * Receive the required string until the '#' symbol through UART from the other UART device.
+ * At most a_size - 1 characters are copied to STR_PTR with the '\0', return FALSE
+ * if the string was cut.
+ */
+uint8 UART_receiveString(uint8 *STR_PTR, uint8 a_size); // Receive until #
+
+#endif /* UART_H_ */